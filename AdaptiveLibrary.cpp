@@ -0,0 +1,400 @@
+#include "AdaptiveLibrary.h"
+#include "HashTable.h"
+#include "MediaLibrary.h"
+#include "TwoThreeTree.h"
+
+AdaptiveLibrary::AdaptiveLibrary(int initialBackend)
+{
+	backend = initialBackend;
+	if (backend == BACKEND_HASH_TABLE)
+		libraryPtr = new MediaLibrary<HashTable>;
+	else
+		libraryPtr = new MediaLibrary<TwoThreeTree>;
+
+	policy.isEnabled = true;
+	policy.minPayback = 1; //Moves once the other data structure would have paid for itself
+
+	for (int k = 0; k < NUM_OPERATION_KINDS; k++)
+		numOperations[k] = 0;
+	savings = 0;
+	numMigrations = 0;
+
+	isMigrating = false;
+	isBuilt = false;
+	newLibraryPtr = NULL;
+	newBuildTime = 0;
+	snapshotTime = 0;
+	buildTime = 0;
+	replayTime = 0;
+	migrationTime = 0;
+	numReplayed = 0;
+}
+
+AdaptiveLibrary::~AdaptiveLibrary()
+{
+	waitForMigration();
+	delete libraryPtr;
+}
+
+const char* AdaptiveLibrary::getBackendName(int aBackend)
+{
+	return (aBackend == BACKEND_HASH_TABLE) ? "hash table" : "2-3 tree";
+}
+
+int AdaptiveLibrary::getOtherBackend(int aBackend)
+{
+	return (aBackend == BACKEND_HASH_TABLE) ? BACKEND_TWO_THREE_TREE : BACKEND_HASH_TABLE;
+}
+
+double AdaptiveLibrary::estimateCost(int aBackend, int kind) const
+{
+	if (aBackend == BACKEND_HASH_TABLE)
+	{
+		if (kind == LOOKUP_OPERATIONS)
+			return HASH_LOOKUP_COST;
+		else if (kind == UPDATE_OPERATIONS)
+			return HASH_UPDATE_COST;
+		else
+			return HASH_ORDERED_COST * libraryPtr->getNumberOfItems();
+	}
+	else
+	{
+		if (kind == LOOKUP_OPERATIONS)
+			return TREE_LOOKUP_COST;
+		else if (kind == UPDATE_OPERATIONS)
+			return TREE_UPDATE_COST;
+		else
+			return TREE_ORDERED_COST;
+	}
+}
+
+double AdaptiveLibrary::estimateBuildCost(int aBackend) const
+{
+	return ((aBackend == BACKEND_HASH_TABLE) ? HASH_BUILD_COST : TREE_BUILD_COST) *
+		libraryPtr->getNumberOfItems();
+}
+
+void AdaptiveLibrary::countOperations(int kind, long count) const
+{
+	numOperations[kind] += count;
+	if (!policy.isEnabled || isMigrating) //The operations during a migration would only be saved
+		return;			      //once it is done
+
+	int otherBackend = getOtherBackend(backend);
+	savings += count * (estimateCost(backend, kind) - estimateCost(otherBackend, kind));
+	if (savings < 0)
+		savings = 0;
+	else if (savings >= policy.minPayback * estimateBuildCost(otherBackend))
+	{
+		savings = 0;
+		startMigration(otherBackend);
+	}
+}
+
+void AdaptiveLibrary::startMigration(int newBackend) const
+{
+	migrationStart = std::chrono::steady_clock::now();
+	MediaLibraryInterface* sourcePtr = libraryPtr->snapshot(); //Of the same data structure, and
+	snapshotTime = std::chrono::duration<double, std::milli>( //unaffected by the changes to come
+		std::chrono::steady_clock::now() - migrationStart).count();
+
+	isMigrating = true;
+	isBuilt = false;
+	pendingChanges.clear();
+	migrationThread = std::thread([this, sourcePtr, newBackend]()
+	{
+		std::chrono::steady_clock::time_point buildStart = std::chrono::steady_clock::now();
+		if (newBackend == BACKEND_HASH_TABLE)
+			newLibraryPtr = static_cast<MediaLibrary<TwoThreeTree>*>(sourcePtr)->convert<HashTable>();
+		else
+			newLibraryPtr = static_cast<MediaLibrary<HashTable>*>(sourcePtr)->convert<TwoThreeTree>();
+		delete sourcePtr;
+		newBuildTime = std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now() - buildStart).count();
+
+		isBuilt.store(true, std::memory_order_release); //newLibraryPtr and newBuildTime are
+	});							 //only read once this is seen
+}
+
+void AdaptiveLibrary::checkMigration() const
+{
+	if (isMigrating && isBuilt.load(std::memory_order_acquire))
+		finishMigration();
+}
+
+void AdaptiveLibrary::finishMigration() const
+{
+	migrationThread.join();
+
+	std::chrono::steady_clock::time_point replayStart = std::chrono::steady_clock::now();
+	for (unsigned int i = 0; i < pendingChanges.size(); i++) //In the order they were made on the
+	{							 //old library
+		if (pendingChanges[i].first)
+			newLibraryPtr->addEntry(pendingChanges[i].second);
+		else
+			newLibraryPtr->removeEntry(pendingChanges[i].second);
+	}
+	numReplayed = pendingChanges.size();
+	std::vector<std::pair<bool, MediaEntry> >().swap(pendingChanges);
+	replayTime = std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - replayStart).count();
+
+	delete libraryPtr;
+	libraryPtr = newLibraryPtr;
+	newLibraryPtr = NULL;
+	backend = getOtherBackend(backend);
+	buildTime = newBuildTime;
+	isMigrating = false;
+	numMigrations++;
+
+	migrationTime = std::chrono::duration<double, std::milli>( //Including freeing the old library
+		std::chrono::steady_clock::now() - migrationStart).count();
+}
+
+void AdaptiveLibrary::waitForMigration() const
+{
+	if (isMigrating)
+		finishMigration();
+}
+
+void AdaptiveLibrary::recordChange(const MediaEntry& media, bool isAdded)
+{
+	if (isMigrating)
+		pendingChanges.push_back(std::make_pair(isAdded, media));
+}
+
+bool AdaptiveLibrary::addEntry(const MediaEntry& newMedia)
+{
+	checkMigration();
+	countOperations(UPDATE_OPERATIONS, 1);
+
+	if (!libraryPtr->addEntry(newMedia))
+		return false;
+
+	recordChange(newMedia, true);
+	return true;
+}
+
+bool AdaptiveLibrary::addEntries(const MediaEntry newMedia[], int numEntries)
+{
+	waitForMigration(); //Loading is faster than replaying the entries one at a time
+	return libraryPtr->addEntries(newMedia, numEntries);
+}
+
+bool AdaptiveLibrary::removeEntry(const MediaEntry& newMedia)
+{
+	checkMigration();
+	countOperations(UPDATE_OPERATIONS, 1);
+
+	if (!libraryPtr->removeEntry(newMedia))
+		return false;
+
+	recordChange(newMedia, false);
+	return true;
+}
+
+MediaEntry AdaptiveLibrary::getEntry(const MediaEntry& media) const
+{
+	checkMigration();
+	countOperations(LOOKUP_OPERATIONS, 1);
+	return libraryPtr->getEntry(media);
+}
+
+bool AdaptiveLibrary::contains(const MediaEntry& media) const
+{
+	checkMigration();
+	countOperations(LOOKUP_OPERATIONS, 1);
+	return libraryPtr->contains(media);
+}
+
+int AdaptiveLibrary::containsMany(const MediaEntry media[], int numEntries, bool results[]) const
+{
+	checkMigration();
+	countOperations(LOOKUP_OPERATIONS, numEntries);
+	return libraryPtr->containsMany(media, numEntries, results);
+}
+
+int AdaptiveLibrary::addMany(const MediaEntry media[], int numEntries, bool results[])
+{
+	checkMigration();
+	countOperations(UPDATE_OPERATIONS, numEntries);
+
+	int numAdded = libraryPtr->addMany(media, numEntries, results);
+	for (int i = 0; i < numEntries; i++)
+	{
+		if (results[i])
+			recordChange(media[i], true);
+	}
+
+	return numAdded;
+}
+
+int AdaptiveLibrary::removeMany(const MediaEntry media[], int numEntries, bool results[])
+{
+	checkMigration();
+	countOperations(UPDATE_OPERATIONS, numEntries);
+
+	int numRemoved = libraryPtr->removeMany(media, numEntries, results);
+	for (int i = 0; i < numEntries; i++)
+	{
+		if (results[i])
+			recordChange(media[i], false);
+	}
+
+	return numRemoved;
+}
+
+bool AdaptiveLibrary::hasConcurrentLookups() const
+{
+	return false; //Every lookup is counted, and may start or finish a migration
+}
+
+void AdaptiveLibrary::displayAllMovies() const
+{
+	checkMigration(); //Listings go through every entry of their type either way, so they aren't counted
+	libraryPtr->displayAllMovies();
+}
+
+void AdaptiveLibrary::displayAllMusic() const
+{
+	checkMigration();
+	libraryPtr->displayAllMusic();
+}
+
+void AdaptiveLibrary::displayAllTv() const
+{
+	checkMigration();
+	libraryPtr->displayAllTv();
+}
+
+void AdaptiveLibrary::displayAll() const
+{
+	checkMigration();
+	libraryPtr->displayAll();
+}
+
+void AdaptiveLibrary::display(int offset, int limit) const
+{
+	checkMigration();
+	countOperations(ORDERED_OPERATIONS, 1);
+	libraryPtr->display(offset, limit);
+}
+
+void AdaptiveLibrary::displayRange(const MediaEntry& low, const MediaEntry& high) const
+{
+	checkMigration();
+	countOperations(ORDERED_OPERATIONS, 1);
+	libraryPtr->displayRange(low, high);
+}
+
+void AdaptiveLibrary::displayPrefix(const MediaEntry& prefix) const
+{
+	checkMigration();
+	countOperations(ORDERED_OPERATIONS, 1);
+	libraryPtr->displayPrefix(prefix);
+}
+
+int AdaptiveLibrary::runQuery(const MediaQuery& query, void visit(const MediaEntry&),
+				QueryStatistics& stats) const
+{
+	checkMigration();
+	if (query.getLowPtr() != NULL || query.getHighPtr() != NULL) //Only a range of titles depends
+		countOperations(ORDERED_OPERATIONS, 1);		     //on the data structure
+	return libraryPtr->runQuery(query, visit, stats);
+}
+
+void AdaptiveLibrary::setWordIndex(bool isEnabled)
+{
+	waitForMigration(); //The new library turns its indexes on as the old one had them
+	libraryPtr->setWordIndex(isEnabled);
+}
+
+int AdaptiveLibrary::findWords(const char* text, void visit(const MediaEntry&)) const
+{
+	checkMigration();
+	return libraryPtr->findWords(text, visit);
+}
+
+void AdaptiveLibrary::setFuzzyIndex(bool isEnabled)
+{
+	waitForMigration();
+	libraryPtr->setFuzzyIndex(isEnabled);
+}
+
+void AdaptiveLibrary::setLookupCache(int maxEntries)
+{
+	waitForMigration();
+	libraryPtr->setLookupCache(maxEntries);
+}
+
+int AdaptiveLibrary::findClosest(const char* title, int maxDistance, int maxResults,
+				void visit(const MediaEntry&, int)) const
+{
+	checkMigration();
+	return libraryPtr->findClosest(title, maxDistance, maxResults, visit);
+}
+
+void AdaptiveLibrary::writeToFile(std::ostream& outFile) const
+{
+	checkMigration();
+	libraryPtr->writeToFile(outFile);
+}
+
+MediaLibraryInterface* AdaptiveLibrary::snapshot() const
+{
+	checkMigration();
+	return libraryPtr->snapshot();
+}
+
+MediaLibraryInterface* AdaptiveLibrary::freeze() const
+{
+	checkMigration();
+	return libraryPtr->freeze();
+}
+
+int AdaptiveLibrary::getNumberOfItems() const
+{
+	return libraryPtr->getNumberOfItems();
+}
+
+int AdaptiveLibrary::getNumberOfType(char mediaType) const
+{
+	return libraryPtr->getNumberOfType(mediaType);
+}
+
+void AdaptiveLibrary::displayStatistics(std::ostream& os) const
+{
+	checkMigration();
+
+	os << "Data structure used: " << getBackendName(backend) << std::endl;
+	os << "Operations counted: " << numOperations[LOOKUP_OPERATIONS] << " lookups, "
+	   << numOperations[UPDATE_OPERATIONS] << " updates, " << numOperations[ORDERED_OPERATIONS]
+	   << " ordered" << std::endl;
+	if (policy.isEnabled)
+		os << "Estimated time a " << getBackendName(getOtherBackend(backend)) << " would have saved: "
+		   << savings/1e6 << " ms, of the " << policy.minPayback*estimateBuildCost(getOtherBackend(backend))/1e6
+		   << " ms it has to pay back" << std::endl;
+	else
+		os << "Migrations are off" << std::endl;
+	os << "Migrations: " << numMigrations << std::endl;
+	if (numMigrations > 0)
+		os << "Last migration, to a " << getBackendName(backend) << ": snapshot " << snapshotTime
+		   << " ms, built in the background in " << buildTime << " ms, " << numReplayed
+		   << " changes replayed in " << replayTime << " ms, " << migrationTime << " ms in all"
+		   << std::endl;
+	if (isMigrating)
+		os << "Migration in progress, to a " << getBackendName(getOtherBackend(backend)) << std::endl;
+	os << std::endl << std::endl;
+
+	libraryPtr->displayStatistics(os);
+}
+
+void AdaptiveLibrary::setMigrationPolicy(const MigrationPolicy& newPolicy)
+{
+	policy = newPolicy;
+}
+
+int AdaptiveLibrary::getBackend() const
+{
+	return backend;
+}
@@ -0,0 +1,224 @@
+/*@file AdaptiveLibrary.h*/
+#ifndef _ADAPTIVE_LIBRARY_H
+#define _ADAPTIVE_LIBRARY_H
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "MediaLibraryInterface.h"
+
+const int BACKEND_TWO_THREE_TREE = 0; //Data structures an adaptive library moves between
+const int BACKEND_HASH_TABLE = 1;
+
+const int LOOKUP_OPERATIONS = 0;  //Kinds of operations an adaptive library counts: contains and
+const int UPDATE_OPERATIONS = 1;  //getEntry, adding and removing single entries, and going
+const int ORDERED_OPERATIONS = 2; //through a range, prefix or page of titles
+const int NUM_OPERATION_KINDS = 3;
+
+const double TREE_LOOKUP_COST = 1300;	//Estimated time in ns of an operation of each kind, and of
+const double TREE_UPDATE_COST = 6000;	//building a library per entry, measured on libraries of 0.5M
+const double TREE_ORDERED_COST = 10000; //to 1.5M titles. An ordered operation of a hash-backed library
+const double TREE_BUILD_COST = 3000;	//goes through every entry, so it is estimated per entry too.
+const double HASH_LOOKUP_COST = 1200;
+const double HASH_UPDATE_COST = 2000;
+const double HASH_ORDERED_COST = 30;
+const double HASH_BUILD_COST = 3000;
+
+struct MigrationPolicy //When an adaptive library moves to the other data structure
+{
+	bool isEnabled; //False to stay with the data structure the library starts with
+	double minPayback; //Number of times the other data structure has to pay back the estimated
+};			   //time to build it before the library moves to it
+
+/*
+Media library that moves between a 2-3 tree and a hash table depending on how it is used, so
+the user doesn't have to pick one up front. A hash table makes updates cheaper, while a tree
+answers ranges, prefixes and pages without going through every entry. The library counts the
+lookups, updates and ordered operations made on it, and adds up the time the other data structure
+would have saved on them, estimated from the costs above. The sum never goes below 0, so the
+operations the current data structure is better at only offset those of the recent past. Once it
+reaches policy.minPayback times the estimated time to build the other library, the library
+migrates to it in the background, so a workload has to last long enough to pay for the move.
+A snapshot is taken (in constant time for a tree, by copying a table), and a thread builds the new
+library from it all at once (see MediaLibrary::convert). Until the new library is built, the
+operations keep going to the old one, and the entries added or removed in the meantime are
+recorded. The next operation after the build replays them on the new library, which then
+replaces the old one.
+*/
+class AdaptiveLibrary : public MediaLibraryInterface
+{
+private:
+	//Changed by the const operations too, since the operations counted by any of them can start
+	//or finish a migration
+	mutable MediaLibraryInterface* libraryPtr; //Library the operations go to
+	mutable int backend; //Data structure of *libraryPtr
+	MigrationPolicy policy;
+
+	mutable long numOperations[NUM_OPERATION_KINDS]; //Operations of each kind counted so far
+	mutable double savings; //Estimated time in ns the other data structure would have saved
+	mutable int numMigrations; //Migrations finished so far
+
+	mutable std::thread migrationThread; //Builds the new library while a migration is in progress
+	mutable bool isMigrating; //True from the snapshot until the new library replaces the old one
+	mutable std::atomic<bool> isBuilt; //Set by migrationThread once newLibraryPtr is built
+	mutable MediaLibraryInterface* newLibraryPtr; //Library built by migrationThread
+	mutable double newBuildTime; //Time in ms migrationThread took to build newLibraryPtr
+	mutable std::vector<std::pair<bool, MediaEntry> > pendingChanges; //Entries added (true) or
+									  //removed since the snapshot
+	mutable std::chrono::steady_clock::time_point migrationStart; //When the last migration started
+	mutable double snapshotTime; //Time in ms the last migration took to take the snapshot,
+	mutable double buildTime;    //build the new library, replay the changes, and in all
+	mutable double replayTime;
+	mutable double migrationTime;
+	mutable int numReplayed; //Changes replayed by the last migration
+
+	/*
+	Returns the name of a data structure, used by displayStatistics
+	@param aBackend Either BACKEND_TWO_THREE_TREE or BACKEND_HASH_TABLE
+	@return The name of the data structure
+	*/
+	static const char* getBackendName(int aBackend);
+
+	/*
+	Returns the data structure a library moves to from another one
+	@param aBackend Either BACKEND_TWO_THREE_TREE or BACKEND_HASH_TABLE
+	@return The other one
+	*/
+	static int getOtherBackend(int aBackend);
+
+	/*
+	Estimates the time an operation would take with a data structure
+	@param aBackend The data structure
+	kind The kind of the operation
+	@return The estimated time in ns
+	*/
+	double estimateCost(int aBackend, int kind) const;
+
+	/*
+	Estimates the time it takes to build a library of a data structure from this one
+	@param aBackend The data structure
+	@return The estimated time in ns
+	*/
+	double estimateBuildCost(int aBackend) const;
+
+	/*
+	Counts operations, adding what the other data structure would have saved on them, and
+	starts a migration once that pays back the estimated time to build it
+	@post The operations are counted, and a migration may be started
+	@param kind The kind of the operations
+	count The number of operations
+	*/
+	void countOperations(int kind, long count) const;
+
+	/*
+	Takes a snapshot of the library, and starts the thread building the new library from it
+	@pre No migration is in progress
+	@post The migration is in progress
+	@param newBackend The data structure of the new library
+	*/
+	void startMigration(int newBackend) const;
+
+	/*
+	Finishes the migration in progress if the new library is built, done before every operation
+	@post If the new library was built, it replaced the old one
+	*/
+	void checkMigration() const;
+
+	/*
+	Waits for the new library to be built, replays the changes recorded since the snapshot on
+	it, and replaces the old library with it
+	@pre A migration is in progress
+	@post The operations go to the new library
+	*/
+	void finishMigration() const;
+
+	/*
+	Records an entry added or removed during a migration, to be replayed on the new library
+	@post The change is recorded if a migration is in progress
+	@param media The entry added or removed
+	isAdded True if it was added, false if it was removed
+	*/
+	void recordChange(const MediaEntry& media, bool isAdded);
+
+	//A copy would share the libraries
+	AdaptiveLibrary(const AdaptiveLibrary&);
+	AdaptiveLibrary& operator=(const AdaptiveLibrary&);
+
+public:
+	/*
+	Creates an empty library, with the default policy
+	@param initialBackend The data structure the library starts with
+	*/
+	AdaptiveLibrary(int initialBackend = BACKEND_TWO_THREE_TREE);
+
+	/*
+	Waits for the migration in progress, if any, and deletes the library
+	*/
+	~AdaptiveLibrary();
+
+	//Refer to MediaLibraryInterface.h for details on these functions. Changes to the library
+	//as a whole (addEntries, and turning its indexes and cache on or off) wait for the
+	//migration in progress to finish first. snapshot and freeze return a library of the data
+	//structure currently used.
+	bool addEntry(const MediaEntry& newMedia);
+	bool addEntries(const MediaEntry newMedia[], int numEntries);
+	bool removeEntry(const MediaEntry& newMedia);
+	MediaEntry getEntry(const MediaEntry& media) const;
+	bool contains(const MediaEntry& media) const;
+	int containsMany(const MediaEntry media[], int numEntries, bool results[]) const;
+	int addMany(const MediaEntry media[], int numEntries, bool results[]);
+	int removeMany(const MediaEntry media[], int numEntries, bool results[]);
+	bool hasConcurrentLookups() const;
+	void displayAllMovies() const;
+	void displayAllMusic() const;
+	void displayAllTv() const;
+	void displayAll() const;
+	void display(int offset, int limit) const;
+	void displayRange(const MediaEntry& low, const MediaEntry& high) const;
+	void displayPrefix(const MediaEntry& prefix) const;
+	int runQuery(const MediaQuery& query, void visit(const MediaEntry&), QueryStatistics& stats) const;
+	void setWordIndex(bool isEnabled);
+	int findWords(const char* text, void visit(const MediaEntry&)) const;
+	void setFuzzyIndex(bool isEnabled);
+	void setLookupCache(int maxEntries);
+	int findClosest(const char* title, int maxDistance, int maxResults,
+			void visit(const MediaEntry&, int)) const;
+	void writeToFile(std::ostream& outFile) const;
+	MediaLibraryInterface* snapshot() const;
+	MediaLibraryInterface* freeze() const;
+	int getNumberOfItems() const;
+	int getNumberOfType(char mediaType) const;
+
+	/*
+	Writes out the data structure used, the operations counted, the time the other data
+	structure would have saved so far against the time to build it, the timing of the last
+	migration and whether one is in progress, followed by the statistics of the library, to os
+	@post The statistics are written to os
+	@param os Ostream variable for the output
+	*/
+	void displayStatistics(std::ostream& os) const;
+
+	/*
+	Changes when the library moves to the other data structure
+	@post The library moves under newPolicy, from the savings added up so far
+	@param newPolicy The new policy
+	*/
+	void setMigrationPolicy(const MigrationPolicy& newPolicy);
+
+	/*
+	Returns the data structure the operations currently go to
+	@return Either BACKEND_TWO_THREE_TREE or BACKEND_HASH_TABLE
+	*/
+	int getBackend() const;
+
+	/*
+	Blocks until the migration in progress, if any, is finished
+	@post No migration is in progress
+	*/
+	void waitForMigration() const;
+};
+
+#endif
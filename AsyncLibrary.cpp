@@ -0,0 +1,257 @@
+#include "AsyncLibrary.h"
+#include <algorithm>
+#include <exception>
+
+AsyncLibrary::AsyncLibrary(MediaLibraryInterface* aLibraryPtr, int numReaders)
+	: libraryPtr(aLibraryPtr), readers(aLibraryPtr->hasConcurrentLookups() ? numReaders : 1)
+{
+	isReadingInParallel = libraryPtr->hasConcurrentLookups();
+	numServing = 0;
+	isStopping = false;
+
+	numRequests = 0;
+	numBatches = 0;
+	numReadPhases = 0;
+	numWritePhases = 0;
+	maxBatchSize = 0;
+
+	dispatcher = std::thread(&AsyncLibrary::dispatchLoop, this);
+}
+
+AsyncLibrary::~AsyncLibrary()
+{
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		isStopping = true;
+	}
+	requestQueued.notify_one();
+	dispatcher.join();
+}
+
+void AsyncLibrary::dispatchLoop()
+{
+	std::vector<AsyncRequest> batch;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(queueMutex);
+			requestQueued.wait(lock, [this]() { return (!queue.empty() || isStopping); });
+			if (queue.empty()) //Stopping, and every request was served
+				return;
+
+			batch.swap(queue); //The clients queue the next batch while this one is served
+			numServing = batch.size();
+		}
+
+		serveBatch(batch);
+		batch.clear();
+
+		{
+			std::lock_guard<std::mutex> lock(queueMutex);
+			numServing = 0;
+		}
+		batchServed.notify_all();
+	}
+}
+
+void AsyncLibrary::serveBatch(std::vector<AsyncRequest>& batch)
+{
+	int numPhases[2] = {0, 0}; //Read and write phases of the batch
+
+	int first = 0;
+	while (first < (int)batch.size())
+	{
+		bool isRead = (batch[first].kind == REQUEST_CONTAINS || batch[first].kind == REQUEST_GET_ENTRY);
+		int last = first + 1; //Extends the run as long as the requests are compatible
+		while (last < (int)batch.size() && (isRead ?
+			(batch[last].kind == REQUEST_CONTAINS || batch[last].kind == REQUEST_GET_ENTRY) :
+			(batch[last].kind == batch[first].kind)))
+			last++;
+
+		if (isRead)
+			serveReads(batch, first, last);
+		else
+			serveWrites(batch, first, last);
+		numPhases[isRead ? 0 : 1]++;
+
+		first = last;
+	}
+
+	for (int i = 0; i < (int)batch.size(); i++)
+	{
+		delete batch[i].resultPtr;
+		delete batch[i].entryPtr;
+	}
+
+	std::lock_guard<std::mutex> lock(queueMutex);
+	numRequests += batch.size();
+	numBatches++;
+	numReadPhases += numPhases[0];
+	numWritePhases += numPhases[1];
+	maxBatchSize = std::max(maxBatchSize, (int)batch.size());
+}
+
+void AsyncLibrary::serveReads(std::vector<AsyncRequest>& batch, int first, int last)
+{
+	std::vector<int> lookups; //Positions of the contains requests and of the getEntry requests
+	std::vector<int> entryLookups;
+	for (int i = first; i < last; i++)
+	{
+		if (batch[i].kind == REQUEST_CONTAINS)
+			lookups.push_back(i);
+		else
+			entryLookups.push_back(i);
+	}
+
+	MediaLibraryInterface* library = libraryPtr;
+	auto checkLookups = [&batch, &lookups, library](int begin, int end)
+	{
+		MediaEntry* entries = new MediaEntry[end - begin];
+		bool* results = new bool[end - begin];
+		for (int j = begin; j < end; j++)
+			entries[j - begin] = batch[lookups[j]].media;
+
+		library->containsMany(entries, end - begin, results);
+		for (int j = begin; j < end; j++)
+			batch[lookups[j]].resultPtr->set_value(results[j - begin]);
+
+		delete [] entries;
+		delete [] results;
+	};
+	auto findEntries = [&batch, &entryLookups, library]()
+	{
+		for (int j = 0; j < (int)entryLookups.size(); j++)
+		{
+			AsyncRequest& request = batch[entryLookups[j]];
+			try
+			{
+				request.entryPtr->set_value(library->getEntry(request.media));
+			}
+			catch (...) //Passed on to the client, e.g. a NotFoundException
+			{
+				request.entryPtr->set_exception(std::current_exception());
+			}
+		}
+	};
+
+	int numLookups = lookups.size(); //Each reader gets an equal part, of MIN_READ_CHUNK at least
+	int numChunks = std::max(std::min(readers.getNumThreads(), numLookups / MIN_READ_CHUNK), 1);
+	if (numLookups == 0)
+		numChunks = 0;
+	else if (!isReadingInParallel) //Everything is served by the dispatcher, one after the other
+	{
+		checkLookups(0, numLookups);
+		numChunks = 0;
+	}
+
+	int numSubmitted = entryLookups.empty() ? numChunks - 1 : numChunks; //The dispatcher serves
+	for (int c = 0; c < numSubmitted; c++)				     //the last task itself
+	{
+		int begin = (long)numLookups*c/numChunks;
+		int end = (long)numLookups*(c + 1)/numChunks;
+		readers.submit([&checkLookups, begin, end]()
+		{
+			checkLookups(begin, end);
+		});
+	}
+
+	if (!entryLookups.empty())
+		findEntries();
+	else if (numChunks > 0)
+		checkLookups((long)numLookups*(numChunks - 1)/numChunks, numLookups);
+
+	if (numSubmitted > 0)
+		readers.wait();
+}
+
+void AsyncLibrary::serveWrites(std::vector<AsyncRequest>& batch, int first, int last)
+{
+	int numEntries = last - first;
+	MediaEntry* entries = new MediaEntry[numEntries];
+	bool* results = new bool[numEntries];
+	for (int i = first; i < last; i++)
+		entries[i - first] = batch[i].media;
+
+	if (batch[first].kind == REQUEST_ADD) //Same results as adding or removing them one by one
+		libraryPtr->addMany(entries, numEntries, results);
+	else
+		libraryPtr->removeMany(entries, numEntries, results);
+
+	for (int i = first; i < last; i++)
+		batch[i].resultPtr->set_value(results[i - first]);
+
+	delete [] entries;
+	delete [] results;
+}
+
+void AsyncLibrary::enqueue(int kind, const MediaEntry& media, std::promise<bool>* resultPtr,
+				std::promise<MediaEntry>* entryPtr)
+{
+	bool wasEmpty;
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		wasEmpty = queue.empty();
+		queue.push_back(AsyncRequest());
+		AsyncRequest& request = queue.back();
+		request.kind = kind;
+		request.media = media;
+		request.resultPtr = resultPtr;
+		request.entryPtr = entryPtr;
+	}
+	if (wasEmpty) //Otherwise the dispatcher is busy, and takes the request with the next batch
+		requestQueued.notify_one();
+}
+
+std::future<bool> AsyncLibrary::addEntry(const MediaEntry& newMedia)
+{
+	std::promise<bool>* resultPtr = new std::promise<bool>;
+	std::future<bool> result = resultPtr->get_future();
+	enqueue(REQUEST_ADD, newMedia, resultPtr, NULL);
+
+	return result;
+}
+
+std::future<bool> AsyncLibrary::removeEntry(const MediaEntry& media)
+{
+	std::promise<bool>* resultPtr = new std::promise<bool>;
+	std::future<bool> result = resultPtr->get_future();
+	enqueue(REQUEST_REMOVE, media, resultPtr, NULL);
+
+	return result;
+}
+
+std::future<bool> AsyncLibrary::contains(const MediaEntry& media)
+{
+	std::promise<bool>* resultPtr = new std::promise<bool>;
+	std::future<bool> result = resultPtr->get_future();
+	enqueue(REQUEST_CONTAINS, media, resultPtr, NULL);
+
+	return result;
+}
+
+std::future<MediaEntry> AsyncLibrary::getEntry(const MediaEntry& media)
+{
+	std::promise<MediaEntry>* entryPtr = new std::promise<MediaEntry>;
+	std::future<MediaEntry> entry = entryPtr->get_future();
+	enqueue(REQUEST_GET_ENTRY, media, NULL, entryPtr);
+
+	return entry;
+}
+
+void AsyncLibrary::wait()
+{
+	std::unique_lock<std::mutex> lock(queueMutex);
+	batchServed.wait(lock, [this]() { return (queue.empty() && numServing == 0); });
+}
+
+void AsyncLibrary::displayStatistics(std::ostream& os)
+{
+	std::lock_guard<std::mutex> lock(queueMutex);
+	os << "Requests served: " << numRequests << std::endl;
+	os << "Readers: " << readers.getNumThreads() << std::endl;
+	os << "Batches: " << numBatches << " (" << numReadPhases << " read phases, "
+	   << numWritePhases << " write phases)" << std::endl;
+	if (numBatches > 0)
+		os << "Average batch: " << (double)numRequests/numBatches << " requests, largest: "
+		   << maxBatchSize << std::endl;
+}
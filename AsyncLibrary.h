@@ -0,0 +1,150 @@
+/*@file AsyncLibrary.h*/
+#ifndef _ASYNC_LIBRARY_H
+#define _ASYNC_LIBRARY_H
+
+#include <condition_variable>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "MediaLibraryInterface.h"
+#include "ThreadPool.h"
+
+const int REQUEST_ADD = 0; //Kinds of requests an asynchronous library serves
+const int REQUEST_REMOVE = 1;
+const int REQUEST_CONTAINS = 2;
+const int REQUEST_GET_ENTRY = 3;
+
+const int MIN_READ_CHUNK = 64; //Lookups given to a reader at least, so small batches stay on one
+
+struct AsyncRequest //Request waiting in the queue of an asynchronous library
+{
+	int kind; //One of the kinds above
+	MediaEntry media; //The entry added, removed or looked up
+	std::promise<bool>* resultPtr; //Result of an add, remove or contains, NULL for a getEntry
+	std::promise<MediaEntry>* entryPtr; //Entry found by a getEntry, NULL otherwise
+};
+
+/*
+Front end serving add, remove and lookup requests from any number of threads at once, on top of
+a library that is only used by one thread at a time otherwise. Each request returns a future
+right away and goes into a queue. A dispatcher thread takes every request queued so far as a
+batch, and serves it in the order the requests came in, one phase after the other:
+- A run of lookups (contains and getEntry) is a read phase. Its contains requests are split
+  among the readers of a thread pool, each checking its part with one containsMany, while the
+  dispatcher serves the getEntry requests one after the other, since they go through the lookup
+  cache (or the last part, if there are none). The phase ends once every reader is done.
+- A run of adds, or of removes, is a write phase, made with a single addMany or removeMany on
+  the dispatcher while no reader runs.
+So reads run in parallel with each other but never with a write, and every request sees the
+changes made by the requests queued before it. The more requests are queued while a batch is
+served, the larger the next batch, which makes up for the time spent queueing them.
+*/
+class AsyncLibrary
+{
+private:
+	MediaLibraryInterface* libraryPtr; //Library the requests are served by
+	ThreadPool readers; //Workers serving the lookups of a read phase along with the dispatcher
+	bool isReadingInParallel; //False if the lookups of the library have to be made one at a time
+	std::thread dispatcher; //Takes the batches out of the queue and serves them
+
+	std::mutex queueMutex; //Guards the queue, numServing and isStopping
+	std::condition_variable requestQueued; //Signalled when a request is queued or the library stops
+	std::condition_variable batchServed; //Signalled when the dispatcher is done with a batch
+	std::vector<AsyncRequest> queue; //Requests not taken by the dispatcher yet
+	int numServing; //Requests of the batch being served
+	bool isStopping; //True once the destructor asks the dispatcher to exit
+
+	//Statistics, only changed by the dispatcher and read under queueMutex
+	long numRequests; //Requests served so far
+	long numBatches; //Batches taken from the queue
+	long numReadPhases; //Runs of lookups served
+	long numWritePhases; //Runs of adds or removes served
+	int maxBatchSize; //Largest batch so far
+
+	/*
+	Loop run by the dispatcher: waits for requests, takes all of them as a batch, serves it,
+	and repeats until the library stops and the queue is empty
+	*/
+	void dispatchLoop();
+
+	/*
+	Serves the requests of a batch from first to last, by phases
+	@post Every promise of the batch holds its result, and the promises are deleted
+	@param batch The requests
+	*/
+	void serveBatch(std::vector<AsyncRequest>& batch);
+
+	/*
+	Serves a run of lookups, on the readers of the pool
+	@post The promises of the run hold their results
+	@param batch The requests
+	first, last The run is batch[first] to batch[last - 1]
+	*/
+	void serveReads(std::vector<AsyncRequest>& batch, int first, int last);
+
+	/*
+	Serves a run of adds, or of removes, with a single call to the library
+	@post The promises of the run hold their results
+	@param batch The requests
+	first, last The run is batch[first] to batch[last - 1], all of the same kind
+	*/
+	void serveWrites(std::vector<AsyncRequest>& batch, int first, int last);
+
+	/*
+	Queues a request for the dispatcher
+	@post The request is in the queue
+	@param kind The kind of the request
+	media The entry added, removed or looked up
+	resultPtr, entryPtr The promise receiving its result, the other one being NULL
+	*/
+	void enqueue(int kind, const MediaEntry& media, std::promise<bool>* resultPtr,
+			std::promise<MediaEntry>* entryPtr);
+
+	//A copy would share the queue
+	AsyncLibrary(const AsyncLibrary&);
+	AsyncLibrary& operator=(const AsyncLibrary&);
+
+public:
+	/*
+	Starts serving requests with a library, which isn't used by anything else until this is
+	deleted
+	@param aLibraryPtr Pointer to the library, which is still owned by the caller
+	numReaders The number of threads serving lookups at once, one per hardware thread if it is
+	less than 1. The lookups of libraries whose lookups change them (see hasConcurrentLookups)
+	are all made by the dispatcher.
+	*/
+	AsyncLibrary(MediaLibraryInterface* aLibraryPtr, int numReaders = 0);
+
+	/*
+	Serves the requests still queued, and stops the dispatcher and the readers
+	*/
+	~AsyncLibrary();
+
+	/*
+	Same as in MediaLibraryInterface, served asynchronously
+	@return A future receiving the result of the request, or, for getEntry, the entry found.
+	If getEntry doesn't find the entry, the future throws a NotFoundException.
+	*/
+	std::future<bool> addEntry(const MediaEntry& newMedia);
+	std::future<bool> removeEntry(const MediaEntry& media);
+	std::future<bool> contains(const MediaEntry& media);
+	std::future<MediaEntry> getEntry(const MediaEntry& media);
+
+	/*
+	Blocks until every request queued so far is served
+	@post The queue is empty, and no batch is being served
+	*/
+	void wait();
+
+	/*
+	Writes out the requests served, the number of batches and phases, and the average and
+	largest batch, to os
+	@post The statistics are written to os
+	@param os Ostream variable for the output
+	*/
+	void displayStatistics(std::ostream& os);
+};
+
+#endif
@@ -0,0 +1,53 @@
+#include <cstring>
+#include "BufferedWriter.h"
+
+BufferedWriter::BufferedWriter(std::ostream& os) : outStream(os)
+{
+	block = new char[WRITE_BLOCK_SIZE];
+	blockLength = 0;
+}
+
+BufferedWriter::~BufferedWriter()
+{
+	writeBlock();
+	delete [] block;
+}
+
+void BufferedWriter::writeBlock()
+{
+	if (blockLength > 0)
+	{
+		outStream.write(block, blockLength);
+		blockLength = 0;
+	}
+}
+
+void BufferedWriter::write(const char* data, int length)
+{
+	if (length > WRITE_BLOCK_SIZE - blockLength) //Doesn't fit, so make room
+	{
+		writeBlock();
+		if (length >= WRITE_BLOCK_SIZE) //Copying it into the block wouldn't save a write
+		{
+			outStream.write(data, length);
+			return;
+		}
+	}
+
+	std::memcpy(block + blockLength, data, length);
+	blockLength += length;
+}
+
+void BufferedWriter::put(char c)
+{
+	if (blockLength == WRITE_BLOCK_SIZE)
+		writeBlock();
+
+	block[blockLength++] = c;
+}
+
+void BufferedWriter::flush()
+{
+	writeBlock();
+	outStream.flush();
+}
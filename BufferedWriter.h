@@ -0,0 +1,60 @@
+/*@file BufferedWriter.h*/
+#ifndef _BUFFERED_WRITER_H
+#define _BUFFERED_WRITER_H
+
+#include <ostream>
+
+const int WRITE_BLOCK_SIZE = 1 << 16; //Output is handed to the stream in blocks of this many characters
+
+/*
+Collects output in a large block and hands it to a stream with a single write when the block is
+full, instead of going through the stream for every entry. Used to display and export the
+libraries, where writing entry by entry (and flushing each line) dominated the time.
+*/
+class BufferedWriter
+{
+private:
+	std::ostream& outStream; //The stream the blocks are written to
+	char* block; //Output not written to the stream yet
+	int blockLength; //Number of characters in block
+
+	/*
+	Writes the block to the stream, without flushing the stream
+	@post The block is empty
+	*/
+	void writeBlock();
+
+	//A copy would write the same block twice
+	BufferedWriter(const BufferedWriter&);
+	BufferedWriter& operator=(const BufferedWriter&);
+
+public:
+	/*
+	Creates a writer with an empty block, writing to os
+	*/
+	BufferedWriter(std::ostream& os);
+
+	/*
+	Writes what is left in the block to the stream, without flushing it
+	*/
+	~BufferedWriter();
+
+	/*
+	Adds characters to the block, writing the block to the stream first if they don't fit.
+	Data longer than a whole block is written directly.
+	@post The characters are written, or will be by the next writeBlock
+	@param data The characters to be written
+	length The number of characters
+	c The character to be written
+	*/
+	void write(const char* data, int length);
+	void put(char c);
+
+	/*
+	Writes the block to the stream and flushes the stream, e.g. once the whole output is written
+	@post Everything written so far has been handed to the stream, and the stream is flushed
+	*/
+	void flush();
+};
+
+#endif
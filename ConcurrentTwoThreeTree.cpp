@@ -0,0 +1,397 @@
+#ifndef _CONCURRENT_TWO_THREE_CPP
+#define _CONCURRENT_TWO_THREE_CPP
+
+#include <functional>
+#include <thread>
+#include "ConcurrentTwoThreeTree.h"
+#include "NotFoundException.h"
+
+template <class ItemType>
+ConcurrentTwoThreeTree<ItemType>::ConcurrentTwoThreeTree() : publishedRoot(NULL), version(0)
+{
+	for (int i = 0; i < NUM_READER_SLOTS; i++)
+	{
+		readerSlots[i].numReaders[0] = 0;
+		readerSlots[i].numReaders[1] = 0;
+	}
+}
+
+template <class ItemType>
+ConcurrentTwoThreeTree<ItemType>::~ConcurrentTwoThreeTree()
+{
+	releaseRetired(); //No reader is left, so this doesn't wait
+	tree.postorderDelete(publishedRoot); //The working copy is deleted by its own destructor
+}
+
+template <class ItemType>
+int ConcurrentTwoThreeTree<ItemType>::beginRead() const
+{
+	int slot = std::hash<std::thread::id>()(std::this_thread::get_id()) % NUM_READER_SLOTS;
+
+	while (true)
+	{
+		long readVersion = version.load();
+		int parity = readVersion & 1;
+
+		readerSlots[slot].numReaders[parity]++;
+		if (version.load() == readVersion) //No writer changed the version while registering
+			return slot * 2 + parity;
+
+		readerSlots[slot].numReaders[parity]--; //Register again under the new version
+	}
+}
+
+template <class ItemType>
+void ConcurrentTwoThreeTree<ItemType>::endRead(int ticket) const
+{
+	readerSlots[ticket / 2].numReaders[ticket % 2]--;
+}
+
+template <class ItemType>
+void ConcurrentTwoThreeTree<ItemType>::publish()
+{
+	TriNode<ItemType>* newRoot = tree.rootPtr; //The readers hold a reference to the published
+	if (newRoot != NULL)			   //root, separate from the working copy's
+		newRoot->addReference();
+
+	retiredRoots.push_back(publishedRoot.exchange(newRoot)); //Readers may still be on it
+
+	if ((int)retiredRoots.size() >= MAX_RETIRED_VERSIONS)
+		releaseRetired();
+}
+
+template <class ItemType>
+void ConcurrentTwoThreeTree<ItemType>::releaseRetired()
+{
+	for (int i = 0; i < 2; i++) //Any reader of a retired root is registered under one of the parities
+	{
+		int parity = version++ & 1; //Readers starting from now on use the other parity
+
+		for (int slot = 0; slot < NUM_READER_SLOTS; slot++)
+		{
+			while (readerSlots[slot].numReaders[parity].load() > 0)
+				std::this_thread::yield();
+		}
+	}
+
+	for (int i = 0; i < (int)retiredRoots.size(); i++) //Only deletes the nodes that the newer
+		tree.postorderDelete(retiredRoots[i]);	   //versions don't share
+	retiredRoots.clear();
+}
+
+template <class ItemType>
+bool ConcurrentTwoThreeTree<ItemType>::isEmpty() const
+{
+	return getNumberOfItems() == 0;
+}
+
+template <class ItemType>
+int ConcurrentTwoThreeTree<ItemType>::getHeight() const
+{
+	int ticket = beginRead();
+	int height = tree.getHeightHelper(publishedRoot.load());
+	endRead(ticket);
+
+	return height;
+}
+
+template <class ItemType>
+int ConcurrentTwoThreeTree<ItemType>::getNumberOfItems() const
+{
+	int ticket = beginRead();
+	int numItems = tree.getSubtreeSize(publishedRoot.load());
+	endRead(ticket);
+
+	return numItems;
+}
+
+template <class ItemType>
+bool ConcurrentTwoThreeTree<ItemType>::add(const ItemType& newData)
+{
+	std::lock_guard<std::mutex> lock(writeMutex);
+
+	bool isAdded = tree.add(newData); //Copies the nodes it changes, as they are shared with
+	if (isAdded)			  //the published version
+		publish();
+
+	return isAdded;
+}
+
+template <class ItemType>
+bool ConcurrentTwoThreeTree<ItemType>::remove(const ItemType& anEntry)
+{
+	std::lock_guard<std::mutex> lock(writeMutex);
+
+	bool isRemoved = tree.contains(anEntry) && tree.remove(anEntry); //A search of the working
+	if (isRemoved)							  //copy doesn't copy its path
+		publish();
+
+	return isRemoved;
+}
+
+template <class ItemType>
+void ConcurrentTwoThreeTree<ItemType>::clear()
+{
+	std::lock_guard<std::mutex> lock(writeMutex);
+
+	tree.clear();
+	publish();
+}
+
+template <class ItemType>
+ItemType ConcurrentTwoThreeTree<ItemType>::getEntry(const ItemType& anEntry) const
+{
+	int ticket = beginRead();
+	ItemType* itemPtr = tree.findStoredItem(publishedRoot.load(), anEntry);
+	if (itemPtr == NULL)
+	{
+		endRead(ticket);
+		throw(NotFoundException("getEntry() called with a nonexistant item."));
+	}
+
+	ItemType foundEntry(*itemPtr); //Copied before a writer can release its node
+	endRead(ticket);
+
+	return foundEntry;
+}
+
+template <class ItemType>
+bool ConcurrentTwoThreeTree<ItemType>::findEntry(const ItemType& anEntry, ItemType& foundEntry) const
+{
+	int ticket = beginRead();
+	ItemType* itemPtr = tree.findStoredItem(publishedRoot.load(), anEntry);
+	if (itemPtr != NULL) //Copied before a writer can release its node
+		foundEntry = *itemPtr;
+	endRead(ticket);
+
+	return (itemPtr != NULL);
+}
+
+template <class ItemType>
+bool ConcurrentTwoThreeTree<ItemType>::contains(const ItemType& anEntry) const
+{
+	int ticket = beginRead();
+	bool isFound = tree.findItem(publishedRoot.load(), anEntry) != NULL;
+	endRead(ticket);
+
+	return isFound;
+}
+
+template <class ItemType>
+void ConcurrentTwoThreeTree<ItemType>::traverse(void visit(ItemType&)) const
+{
+	TwoThreeTree<ItemType> snapshot; //visit may take long, so it runs on a snapshot instead
+	getSnapshot(snapshot);		 //of holding up the writers
+	snapshot.traverse(visit);
+}
+
+template <class ItemType>
+bool ConcurrentTwoThreeTree<ItemType>::addAll(const ItemType items[], int numItems)
+{
+	std::lock_guard<std::mutex> lock(writeMutex);
+
+	bool isAdded = tree.addAll(items, numItems);
+	publish();
+
+	return isAdded;
+}
+
+template <class ItemType>
+int ConcurrentTwoThreeTree<ItemType>::addMany(const ItemType items[], int numItems, bool results[])
+{
+	std::lock_guard<std::mutex> lock(writeMutex);
+
+	int numAdded = tree.addMany(items, numItems, results);
+	if (numAdded > 0)
+		publish();
+
+	return numAdded;
+}
+
+template <class ItemType>
+int ConcurrentTwoThreeTree<ItemType>::removeMany(const ItemType items[], int numItems, bool results[])
+{
+	std::lock_guard<std::mutex> lock(writeMutex);
+
+	int numRemoved = tree.removeMany(items, numItems, results); //Only the items found are removed
+	if (numRemoved > 0)
+		publish();
+
+	return numRemoved;
+}
+
+template <class ItemType>
+int ConcurrentTwoThreeTree<ItemType>::containsMany(const ItemType items[], int numItems,
+							bool results[]) const
+{
+	TwoThreeTree<ItemType> snapshot;
+	getSnapshot(snapshot);
+
+	return snapshot.containsMany(items, numItems, results);
+}
+
+template <class ItemType>
+template <class Visitor>
+bool ConcurrentTwoThreeTree<ItemType>::forEach(Visitor&& visit) const
+{
+	TwoThreeTree<ItemType> snapshot;
+	getSnapshot(snapshot);
+
+	return snapshot.forEach(visit);
+}
+
+template <class ItemType>
+void ConcurrentTwoThreeTree<ItemType>::rangeTraverse(const ItemType* lowPtr, const ItemType* highPtr,
+							void visit(ItemType&)) const
+{
+	TwoThreeTree<ItemType> snapshot;
+	getSnapshot(snapshot);
+	snapshot.rangeTraverse(lowPtr, highPtr, visit);
+}
+
+template <class ItemType>
+void ConcurrentTwoThreeTree<ItemType>::pageTraverse(int offset, int limit, void visit(ItemType&)) const
+{
+	TwoThreeTree<ItemType> snapshot;
+	getSnapshot(snapshot);
+	snapshot.pageTraverse(offset, limit, visit);
+}
+
+template <class ItemType>
+const ItemType* ConcurrentTwoThreeTree<ItemType>::select(int index) const
+{
+	TwoThreeTree<ItemType> snapshot;
+	getSnapshot(snapshot);
+
+	return snapshot.select(index);
+}
+
+template <class ItemType>
+int ConcurrentTwoThreeTree<ItemType>::rank(const ItemType& anEntry) const
+{
+	TwoThreeTree<ItemType> snapshot;
+	getSnapshot(snapshot);
+
+	return snapshot.rank(anEntry);
+}
+
+template <class ItemType>
+template <class Visitor>
+bool ConcurrentTwoThreeTree<ItemType>::forEachInRange(const ItemType* lowPtr, const ItemType* highPtr,
+							Visitor&& visit) const
+{
+	TwoThreeTree<ItemType> snapshot;
+	getSnapshot(snapshot);
+
+	return snapshot.forEachInRange(lowPtr, highPtr, visit);
+}
+
+template <class ItemType>
+bool ConcurrentTwoThreeTree<ItemType>::isOrdered() const
+{
+	return true;
+}
+
+template <class ItemType>
+void ConcurrentTwoThreeTree<ItemType>::writeToFile(std::ostream& outFile) const
+{
+	TwoThreeTree<ItemType> snapshot;
+	getSnapshot(snapshot);
+	snapshot.writeToFile(outFile);
+}
+
+template <class ItemType>
+void ConcurrentTwoThreeTree<ItemType>::writeToFile(std::ostream& outFile, ThreadPool& pool) const
+{
+	TwoThreeTree<ItemType> snapshot;
+	getSnapshot(snapshot);
+	snapshot.writeToFile(outFile, pool);
+}
+
+template <class ItemType>
+void ConcurrentTwoThreeTree<ItemType>::displayStatistics(std::ostream& os) const
+{
+	TwoThreeTree<ItemType> snapshot;
+	getSnapshot(snapshot);
+	snapshot.displayStatistics(os);
+}
+
+template <class ItemType>
+void ConcurrentTwoThreeTree<ItemType>::displayStatistics(std::ostream& os, ThreadPool& pool) const
+{
+	TwoThreeTree<ItemType> snapshot;
+	getSnapshot(snapshot);
+	snapshot.displayStatistics(os, pool);
+}
+
+template <class ItemType>
+void ConcurrentTwoThreeTree<ItemType>::getSnapshot(TwoThreeTree<ItemType>& aTree) const
+{
+	aTree.clear();
+
+	int ticket = beginRead();
+	aTree.rootPtr = publishedRoot.load(); //The reference keeps the nodes alive after the
+	if (aTree.rootPtr != NULL)	      //reader is gone
+		aTree.rootPtr->addReference();
+	endRead(ticket);
+}
+
+template <class ItemType>
+void ConcurrentTwoThreeTree<ItemType>::takeSnapshot(const ConcurrentTwoThreeTree<ItemType>& otherTree)
+{
+	if (this != &otherTree)
+	{
+		TwoThreeTree<ItemType> snapshot;
+		otherTree.getSnapshot(snapshot);
+
+		std::lock_guard<std::mutex> lock(writeMutex);
+		tree.takeSnapshot(snapshot);
+		publish();
+	}
+}
+
+template <class ItemType>
+void ConcurrentTwoThreeTree<ItemType>::mergeFrom(const ConcurrentTwoThreeTree<ItemType>& otherTree)
+{
+	if (this != &otherTree) //Every item is already in the tree
+	{
+		TwoThreeTree<ItemType> snapshot;
+		otherTree.getSnapshot(snapshot);
+
+		std::lock_guard<std::mutex> lock(writeMutex);
+		tree.mergeFrom(snapshot);
+		publish();
+	}
+}
+
+template <class ItemType>
+void ConcurrentTwoThreeTree<ItemType>::intersectWith(const ConcurrentTwoThreeTree<ItemType>& otherTree)
+{
+	if (this != &otherTree) //The intersection with itself is the tree itself
+	{
+		TwoThreeTree<ItemType> snapshot;
+		otherTree.getSnapshot(snapshot);
+
+		std::lock_guard<std::mutex> lock(writeMutex);
+		tree.intersectWith(snapshot);
+		publish();
+	}
+}
+
+template <class ItemType>
+void ConcurrentTwoThreeTree<ItemType>::difference(const ConcurrentTwoThreeTree<ItemType>& otherTree)
+{
+	if (this == &otherTree)
+		clear();
+	else
+	{
+		TwoThreeTree<ItemType> snapshot;
+		otherTree.getSnapshot(snapshot);
+
+		std::lock_guard<std::mutex> lock(writeMutex);
+		tree.difference(snapshot);
+		publish();
+	}
+}
+
+#endif
@@ -0,0 +1,169 @@
+/*@file ConcurrentTwoThreeTree.h*/
+#ifndef _CONCURRENT_TWO_THREE_TREE_H
+#define _CONCURRENT_TWO_THREE_TREE_H
+
+#include "BalancedSearchTreeInterface.h"
+#include "TwoThreeTree.h"
+#include "ThreadPool.h"
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+const int NUM_READER_SLOTS = 16; //Readers are spread over this many counters so they don't all
+				 //contend for the same cache line
+const int MAX_RETIRED_VERSIONS = 64; //Versions replaced before the writer waits for their readers
+
+/*
+2-3 tree that can be read and modified by several threads at once. Readers never lock: they
+register with a version-validated reader counter and descend the latest published version of
+the tree. Writers take turns on a private working copy and modify it by path copying (see
+TwoThreeTree::takeSnapshot), so a published version is never changed. A writer then publishes
+its copy and retires the old version. Retired versions are released in batches, once the
+readers that may still be on them are gone, so a writer only waits for the readers once every
+MAX_RETIRED_VERSIONS versions.
+
+This is a copy-on-write snapshot tree, not a tree with a lock per node: every change updates the
+subtree sizes up to the root, so writers would meet at the root anyway. Copying the path makes a
+change slower than in a TwoThreeTree behind a single lock, and short mixed operations are faster
+on the locked tree. What the copies buy is that a reader never holds up a writer, however long it
+takes: a scan, page or export runs on a snapshot taken in constant time. While another thread
+scans 4000000 entries over and over, the longest change here is a few milliseconds, where the
+locked tree waits for a whole scan (see the snapshots section of the benchmark).
+*/
+template <class ItemType>
+class ConcurrentTwoThreeTree : public BalancedSearchTreeInterface<ItemType>
+{
+private:
+	struct ReaderSlot
+	{
+		alignas(64) std::atomic<int> numReaders[2]; //Readers registered under an even or odd version
+	};
+
+	TwoThreeTree<ItemType> tree; //Working copy modified by the writers
+	std::atomic<TriNode<ItemType>*> publishedRoot; //Version of the tree read by the readers
+	std::atomic<long> version; //Changed twice every time the retired versions are released
+	mutable ReaderSlot readerSlots[NUM_READER_SLOTS]; //Counters of the readers in progress
+	std::mutex writeMutex; //Writers take turns modifying the working copy
+	std::vector<TriNode<ItemType>*> retiredRoots; //Versions replaced but not released yet,
+						      //guarded by writeMutex
+
+	/*
+	Registers the calling thread as a reader. The counter is chosen by the parity of the
+	version, which is checked again afterwards: if a writer changed it in the meantime, the
+	reader registers again so it can't hold up the writer waiting for that parity.
+	@post Nodes reachable from publishedRoot won't be deleted until endRead is called
+	@return Ticket identifying the counter, to be passed to endRead
+	*/
+	int beginRead() const;
+
+	/*
+	Unregisters a reader
+	@post The reader no longer holds up the writers
+	@param ticket The ticket returned by beginRead
+	*/
+	void endRead(int ticket) const;
+
+	/*
+	Publishes the working copy as the version read by the readers, and retires the previous
+	version. Once MAX_RETIRED_VERSIONS versions are retired, they are all released.
+	@pre The caller holds writeMutex
+	@post The readers see the working copy
+	*/
+	void publish();
+
+	/*
+	Waits for the readers of the retired versions to finish, then releases them. The version
+	is changed, and the readers of the old parity waited for, twice, so the readers that start
+	in the meantime can't keep the writer waiting indefinitely.
+	@pre The caller holds writeMutex, or is the destructor
+	@post Nodes used only by the retired versions are deleted, and none is retired
+	*/
+	void releaseRetired();
+
+	//The tree is shared between threads by reference, so it can't be copied
+	ConcurrentTwoThreeTree(const ConcurrentTwoThreeTree<ItemType>&);
+	ConcurrentTwoThreeTree<ItemType>& operator=(const ConcurrentTwoThreeTree<ItemType>&);
+
+public:
+	ConcurrentTwoThreeTree();
+	virtual ~ConcurrentTwoThreeTree();
+
+	//These are all specified in BalancedSearchTreeInterface.h. The readers run on the version
+	//of the tree published when they start, and are not blocked by the writers. The items
+	//are shared between the readers, so visit must not modify them. remove checks the working
+	//copy first, so removing an item that isn't there copies nothing.
+	bool isEmpty() const;
+	int getHeight() const;
+	int getNumberOfItems() const;
+	bool add(const ItemType& newData);
+	bool remove(const ItemType& anEntry);
+	void clear();
+	ItemType getEntry(const ItemType& anEntry) const;
+	bool findEntry(const ItemType& anEntry, ItemType& foundEntry) const; //See TwoThreeTree
+	bool contains(const ItemType& anEntry) const;
+	void traverse(void visit(ItemType&)) const;
+
+	/*
+	Same as in TwoThreeTree. Each change is made to the working copy, which is published once
+	at the end, so the nodes copied by one item are changed in place by the next ones.
+	*/
+	bool addAll(const ItemType items[], int numItems);
+	int addMany(const ItemType items[], int numItems, bool results[]);
+	int removeMany(const ItemType items[], int numItems, bool results[]);
+
+	/*
+	Same as in TwoThreeTree, run on a snapshot like traverse, so they don't hold up the writers
+	no matter how long they take
+	*/
+	int containsMany(const ItemType items[], int numItems, bool results[]) const;
+	template <class Visitor>
+	bool forEach(Visitor&& visit) const;
+	void rangeTraverse(const ItemType* lowPtr, const ItemType* highPtr, void visit(ItemType&)) const;
+	void pageTraverse(int offset, int limit, void visit(ItemType&)) const;
+	template <class Visitor>
+	bool forEachInRange(const ItemType* lowPtr, const ItemType* highPtr, Visitor&& visit) const;
+	bool isOrdered() const;
+	void writeToFile(std::ostream& outFile) const;
+	void writeToFile(std::ostream& outFile, ThreadPool& pool) const;
+	void displayStatistics(std::ostream& os) const;
+	void displayStatistics(std::ostream& os, ThreadPool& pool) const;
+
+	/*
+	Same as in TwoThreeTree, run on a snapshot. The nodes of the snapshot are those of the
+	published version, so the item select points to stays valid until a writer retires it, as
+	do the items visited by forEachInRange.
+	*/
+	const ItemType* select(int index) const;
+	int rank(const ItemType& anEntry) const;
+
+	/*
+	Replaces the contents of aTree with a snapshot of the current version of the tree, in
+	constant time. Readers that need more than a lookup (ranges, paging, iterators) run on the
+	snapshot, which doesn't hold up the writers.
+	@post aTree holds the items of the tree, and is unaffected by later changes to it
+	@param aTree The tree receiving the snapshot
+	*/
+	void getSnapshot(TwoThreeTree<ItemType>& aTree) const;
+
+	/*
+	Replaces the contents of the tree with a snapshot of otherTree in constant time, as in
+	TwoThreeTree
+	@post The tree holds the same items as otherTree
+	@param otherTree The tree to be snapshotted
+	*/
+	void takeSnapshot(const ConcurrentTwoThreeTree<ItemType>& otherTree);
+
+	/*
+	Same as in TwoThreeTree, with a snapshot of otherTree. The result is published once.
+	@post The tree holds the union, intersection, or difference of the two trees
+	@param otherTree The other operand, which is unchanged
+	*/
+	void mergeFrom(const ConcurrentTwoThreeTree<ItemType>& otherTree);
+	void intersectWith(const ConcurrentTwoThreeTree<ItemType>& otherTree);
+	void difference(const ConcurrentTwoThreeTree<ItemType>& otherTree);
+};
+
+#include "ConcurrentTwoThreeTree.cpp"
+
+#endif
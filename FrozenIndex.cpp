@@ -0,0 +1,439 @@
+#ifndef _FROZEN_INDEX_CPP
+#define _FROZEN_INDEX_CPP
+
+#include <algorithm>
+#include <sstream>
+#include "FrozenIndex.h"
+#include "NotFoundException.h"
+
+template <class ItemType>
+FrozenIndex<ItemType>::FrozenIndex() //Default state of the index is empty
+{
+	items = NULL;
+	keyPrefixes = NULL;
+	sortedIndex = NULL;
+	numItems = 0;
+}
+
+template <class ItemType>
+FrozenIndex<ItemType>::FrozenIndex(const FrozenIndex<ItemType>& otherIndex)
+{
+	copyIndex(otherIndex);
+}
+
+template <class ItemType>
+FrozenIndex<ItemType>::~FrozenIndex()
+{
+	eraseIndex();
+}
+
+template <class ItemType>
+void FrozenIndex<ItemType>::copyIndex(const FrozenIndex<ItemType>& otherIndex)
+{
+	numItems = otherIndex.numItems;
+	if (numItems == 0)
+	{
+		items = NULL;
+		keyPrefixes = NULL;
+		sortedIndex = NULL;
+		return;
+	}
+
+	items = new ItemType[numItems];
+	keyPrefixes = new unsigned long long[numItems+1];
+	sortedIndex = new int[numItems+1];
+
+	for (int i = 0; i < numItems; i++)
+		items[i] = otherIndex.items[i];
+	for (int k = 1; k <= numItems; k++)
+	{
+		keyPrefixes[k] = otherIndex.keyPrefixes[k];
+		sortedIndex[k] = otherIndex.sortedIndex[k];
+	}
+}
+
+template <class ItemType>
+void FrozenIndex<ItemType>::eraseIndex()
+{
+	delete [] items;
+	delete [] keyPrefixes;
+	delete [] sortedIndex;
+
+	items = NULL;
+	keyPrefixes = NULL;
+	sortedIndex = NULL;
+	numItems = 0;
+}
+
+template <class ItemType>
+int FrozenIndex<ItemType>::fillEytzinger(int sortedPos, int k)
+{
+	if (k <= numItems)
+	{
+		sortedPos = fillEytzinger(sortedPos, 2*k); //Smaller items are in the left subtree
+
+		keyPrefixes[k] = items[sortedPos].getKeyPrefix();
+		sortedIndex[k] = sortedPos++;
+
+		sortedPos = fillEytzinger(sortedPos, 2*k+1);
+	}
+
+	return sortedPos;
+}
+
+template <class ItemType>
+bool FrozenIndex<ItemType>::addAll(const ItemType newItems[], int numNewItems)
+{
+	if (numItems > 0) //The index is immutable once built
+		return false;
+	if (numNewItems <= 0)
+		return true;
+
+	numItems = numNewItems;
+	items = new ItemType[numItems];
+	keyPrefixes = new unsigned long long[numItems+1]; //Index 0 is unused
+	sortedIndex = new int[numItems+1];
+
+	for (int i = 0; i < numItems; i++)
+		items[i] = newItems[i];
+	std::stable_sort(items, items + numItems); //Already sorted when it comes from a tree
+
+	fillEytzinger(0, 1);
+
+	return true;
+}
+
+template <class ItemType>
+bool FrozenIndex<ItemType>::add(const ItemType&)
+{
+	return false;
+}
+
+template <class ItemType>
+bool FrozenIndex<ItemType>::remove(const ItemType&)
+{
+	return false;
+}
+
+template <class ItemType>
+int FrozenIndex<ItemType>::searchPrefixes(unsigned long long keyPrefix, bool isUpperBound) const
+{
+	int k = 1;
+	if (isUpperBound)
+	{
+		while (k <= numItems) //Go right while the prefix is too small. The comparison gives the
+		{		      //next index directly, so there is nothing to mispredict.
+			__builtin_prefetch(keyPrefixes + 8*k); //The 8 descendants 3 levels down share
+			k = 2*k + (keyPrefixes[k] <= keyPrefix); //a cache line
+		}
+	}
+	else
+	{
+		while (k <= numItems)
+		{
+			__builtin_prefetch(keyPrefixes + 8*k);
+			k = 2*k + (keyPrefixes[k] < keyPrefix);
+		}
+	}
+
+	//k went right after the last candidate, then only left. Undo those left moves
+	//and the final right move to get back to it.
+	return k >> __builtin_ffs(~k);
+}
+
+template <class ItemType>
+int FrozenIndex<ItemType>::lowerBoundIndex(const ItemType& anEntry) const
+{
+	unsigned long long keyPrefix = anEntry.getKeyPrefix();
+
+	return resolveLowerBound(anEntry, keyPrefix, searchPrefixes(keyPrefix, false));
+}
+
+template <class ItemType>
+int FrozenIndex<ItemType>::resolveLowerBound(const ItemType& anEntry, unsigned long long keyPrefix, int k) const
+{
+	if (k == 0) //Every item is smaller
+		return numItems;
+	else if (keyPrefixes[k] != keyPrefix) //No item has the same prefix, so the first item
+		return sortedIndex[k];	      //with a larger one is the bound
+	else //The items sharing the prefix are compared in full
+	{
+		int first = sortedIndex[k];
+		if (!(items[first] < anEntry)) //Usually the only one, e.g. when anEntry is in the index
+			return first;
+
+		int upperK = searchPrefixes(keyPrefix, true);
+		int last = (upperK == 0) ? numItems : sortedIndex[upperK];
+
+		return std::lower_bound(items + first, items + last, anEntry) - items;
+	}
+}
+
+template <class ItemType>
+int FrozenIndex<ItemType>::containsMany(const ItemType items[], int numItems, bool results[]) const
+{
+	const int GROUP_SIZE = 16; //Number of searches going down together
+	unsigned long long groupPrefixes[GROUP_SIZE];
+	int groupKs[GROUP_SIZE];
+
+	int numFound = 0;
+	for (int first = 0; first < numItems; first += GROUP_SIZE)
+	{
+		int groupSize = std::min(GROUP_SIZE, numItems - first);
+		for (int i = 0; i < groupSize; i++)
+		{
+			groupPrefixes[i] = items[first + i].getKeyPrefix();
+			groupKs[i] = 1;
+		}
+
+		bool isDescending = true; //Same as searchPrefixes, except each level is done for the
+		while (isDescending)	  //whole group before moving to the next one
+		{
+			isDescending = false;
+			for (int i = 0; i < groupSize; i++)
+			{
+				int k = groupKs[i];
+				if (k <= this->numItems) //The bottom level may be partly empty
+				{
+					__builtin_prefetch(keyPrefixes + 8*k);
+					groupKs[i] = 2*k + (keyPrefixes[k] < groupPrefixes[i]);
+					isDescending = true;
+				}
+			}
+		}
+
+		for (int i = 0; i < groupSize; i++)
+		{
+			int index = resolveLowerBound(items[first + i], groupPrefixes[i],
+							groupKs[i] >> __builtin_ffs(~groupKs[i]));
+			results[first + i] = (index < this->numItems && this->items[index] == items[first + i]);
+			if (results[first + i])
+				numFound++;
+		}
+	}
+
+	return numFound;
+}
+
+template <class ItemType>
+int FrozenIndex<ItemType>::addMany(const ItemType[], int numItems, bool results[])
+{
+	for (int i = 0; i < numItems; i++)
+		results[i] = false;
+
+	return 0;
+}
+
+template <class ItemType>
+int FrozenIndex<ItemType>::removeMany(const ItemType items[], int numItems, bool results[])
+{
+	return addMany(items, numItems, results);
+}
+
+template <class ItemType>
+bool FrozenIndex<ItemType>::isEmpty() const
+{
+	return numItems == 0;
+}
+
+template <class ItemType>
+int FrozenIndex<ItemType>::getNumberOfItems() const
+{
+	return numItems;
+}
+
+template <class ItemType>
+ItemType FrozenIndex<ItemType>::getEntry(const ItemType& anEntry) const
+{
+	int index = lowerBoundIndex(anEntry);
+	if (index < numItems && items[index] == anEntry) //The item stored, whose title can differ in
+		return items[index];			     //case and punctuation
+	else //Throw exception if the entry does not exist
+		throw(NotFoundException("getEntry() called with a nonexistant item."));
+}
+
+template <class ItemType>
+bool FrozenIndex<ItemType>::findEntry(const ItemType& anEntry, ItemType& foundEntry) const
+{
+	int index = lowerBoundIndex(anEntry);
+	bool isFound = (index < numItems && items[index] == anEntry);
+	if (isFound)
+		foundEntry = items[index];
+
+	return isFound;
+}
+
+template <class ItemType>
+bool FrozenIndex<ItemType>::contains(const ItemType& anEntry) const
+{
+	int index = lowerBoundIndex(anEntry);
+	return (index < numItems && items[index] == anEntry);
+}
+
+template <class ItemType>
+void FrozenIndex<ItemType>::traverse(void visit(ItemType&)) const
+{
+	for (int i = 0; i < numItems; i++)
+		visit(items[i]);
+}
+
+template <class ItemType>
+template <class Visitor>
+bool FrozenIndex<ItemType>::forEach(Visitor&& visit) const
+{
+	for (int i = 0; i < numItems; i++)
+	{
+		if (!visit(items[i]))
+			return false;
+	}
+
+	return true;
+}
+
+template <class ItemType>
+void FrozenIndex<ItemType>::rangeTraverse(const ItemType* lowPtr, const ItemType* highPtr,
+						void visit(ItemType&)) const
+{
+	int first = (lowPtr == NULL) ? 0 : lowerBoundIndex(*lowPtr);
+	int last = (highPtr == NULL) ? numItems : lowerBoundIndex(*highPtr);
+
+	for (int i = first; i < last; i++) //The range is contiguous in the sorted array
+		visit(items[i]);
+}
+
+template <class ItemType>
+template <class Visitor>
+bool FrozenIndex<ItemType>::forEachInRange(const ItemType* lowPtr, const ItemType* highPtr,
+						Visitor&& visit) const
+{
+	int first = (lowPtr == NULL) ? 0 : lowerBoundIndex(*lowPtr);
+	int last = (highPtr == NULL) ? numItems : lowerBoundIndex(*highPtr);
+
+	for (int i = first; i < last; i++)
+	{
+		if (!visit(items[i]))
+			return false;
+	}
+
+	return true;
+}
+
+template <class ItemType>
+bool FrozenIndex<ItemType>::isOrdered() const
+{
+	return true;
+}
+
+template <class ItemType>
+void FrozenIndex<ItemType>::pageTraverse(int offset, int limit, void visit(ItemType&)) const
+{
+	int first = std::max(offset, 0);
+	int last = std::min(offset + limit, numItems);
+
+	for (int i = first; i < last; i++)
+		visit(items[i]);
+}
+
+template <class ItemType>
+const ItemType* FrozenIndex<ItemType>::select(int index) const
+{
+	if (index < 0 || index >= numItems)
+		return NULL;
+
+	return items + index;
+}
+
+template <class ItemType>
+int FrozenIndex<ItemType>::rank(const ItemType& anEntry) const
+{
+	return lowerBoundIndex(anEntry);
+}
+
+template <class ItemType>
+typename FrozenIndex<ItemType>::iterator FrozenIndex<ItemType>::begin() const
+{
+	return items;
+}
+
+template <class ItemType>
+typename FrozenIndex<ItemType>::iterator FrozenIndex<ItemType>::end() const
+{
+	return items + numItems;
+}
+
+template <class ItemType>
+void FrozenIndex<ItemType>::writeRange(int first, int last, BufferedWriter& writer) const
+{
+	for (int i = first; i < last; i++)
+		items[i].writeToFile(writer);
+}
+
+template <class ItemType>
+void FrozenIndex<ItemType>::writeToFile(std::ostream& outFile) const
+{
+	BufferedWriter writer(outFile);
+	writeRange(0, numItems, writer);
+}
+
+template <class ItemType>
+void FrozenIndex<ItemType>::writeToFile(std::ostream& outFile, ThreadPool& pool) const
+{
+	if (pool.getNumThreads() <= 1 || numItems < MIN_PARALLEL_ITEMS) //Not worth splitting
+	{
+		writeToFile(outFile);
+		return;
+	}
+
+	int numRanges = pool.getNumThreads();
+	std::ostringstream* buffers = new std::ostringstream[numRanges];
+	for (int i = 0; i < numRanges; i++) //Each worker writes its range of the array to its own buffer
+	{
+		int first = (long)numItems*i/numRanges;
+		int last = (long)numItems*(i+1)/numRanges;
+		std::ostringstream* bufferPtr = &buffers[i];
+		pool.submit([this, first, last, bufferPtr]()
+		{
+			BufferedWriter writer(*bufferPtr);
+			writeRange(first, last, writer);
+		});
+	}
+	pool.wait();
+
+	for (int i = 0; i < numRanges; i++) //Write the buffers in sorted order
+		outFile << buffers[i].str();
+
+	delete [] buffers;
+}
+
+template <class ItemType>
+void FrozenIndex<ItemType>::displayStatistics(std::ostream& os) const
+{
+	int searchDepth = 0; //Number of levels of the implicit tree
+	for (int k = numItems; k > 0; k /= 2)
+		searchDepth++;
+
+	long indexBytes = (long)numItems*(sizeof(ItemType) + sizeof(unsigned long long) + sizeof(int));
+
+	os << "Number of items: " << numItems << std::endl;
+	os << "Search depth: " << searchDepth << std::endl;
+	os << "Index size in bytes, excluding the titles: " << indexBytes << std::endl;
+	os << std::endl << std::endl;
+}
+
+template <class ItemType>
+void FrozenIndex<ItemType>::displayStatistics(std::ostream& os, ThreadPool&) const
+{
+	displayStatistics(os);
+}
+
+template <class ItemType>
+void FrozenIndex<ItemType>::takeSnapshot(const FrozenIndex<ItemType>& otherIndex)
+{
+	if (this != &otherIndex)
+	{
+		eraseIndex();
+		copyIndex(otherIndex);
+	}
+}
+
+#endif
@@ -0,0 +1,178 @@
+/*@file FrozenIndex.h*/
+#ifndef _FROZEN_INDEX_H
+#define _FROZEN_INDEX_H
+
+#include "ThreadPool.h"
+#include "BufferedWriter.h"
+#include <iostream>
+
+/*
+Read-only index of items, built once from all of its items. The items are kept in a sorted array,
+and their key prefixes (see MediaEntry::getKeyPrefix) in a separate array in Eytzinger order: the
+root of an implicit binary search tree at index 1, and the children of index k at 2k and 2k+1.
+A search walks down that array without branching on the comparisons, prefetching the nodes a few
+levels below, and only looks at the items themselves to break ties between equal prefixes.
+*/
+template <class ItemType>
+class FrozenIndex
+{
+private:
+	ItemType* items; //The items in sorted order
+	unsigned long long* keyPrefixes; //Key prefixes of the items in Eytzinger order, from index 1
+	int* sortedIndex; //Index in items of the item at each Eytzinger index
+	int numItems; //Number of items in the index
+
+	/*
+	Fills keyPrefixes and sortedIndex for the subtree rooted at Eytzinger index k, with an
+	inorder traversal of the implicit tree
+	@post The subtree rooted at k refers to the items starting at sortedPos, in order
+	@param sortedPos The index in items of the first item of the subtree
+	k The Eytzinger index of the root of the subtree
+	@return The index in items following the last item of the subtree
+	*/
+	int fillEytzinger(int sortedPos, int k);
+
+	/*
+	Finds the first key prefix that is >= keyPrefix, or > keyPrefix if isUpperBound is true
+	@param keyPrefix The key prefix to be looked for
+	isUpperBound True to skip the prefixes equal to keyPrefix
+	@return The Eytzinger index of the prefix found, 0 if there is none
+	*/
+	int searchPrefixes(unsigned long long keyPrefix, bool isUpperBound) const;
+
+	/*
+	Finds the position of the first item >= anEntry in the sorted array
+	@param anEntry The item to be looked for
+	@return The index in items of the first item >= anEntry, numItems if there is none
+	*/
+	int lowerBoundIndex(const ItemType& anEntry) const;
+
+	/*
+	Finishes lowerBoundIndex once searchPrefixes has found the first key prefix >= the one of
+	anEntry
+	@param anEntry The item to be looked for
+	keyPrefix The key prefix of anEntry
+	k The Eytzinger index found by searchPrefixes
+	@return The index in items of the first item >= anEntry, numItems if there is none
+	*/
+	int resolveLowerBound(const ItemType& anEntry, unsigned long long keyPrefix, int k) const;
+
+	/*
+	Writes out the items at the indexes first through last-1 to writer
+	@post The items in the range are written to writer
+	@param first The first index of the range
+	last The index one past the end of the range
+	writer The writer collecting the output for the file
+	*/
+	void writeRange(int first, int last, BufferedWriter& writer) const;
+
+	/*
+	Copies the contents of otherIndex, used by the copy constructor and takeSnapshot
+	@pre The index holds no memory of its own
+	@post The index is identical to otherIndex
+	@param otherIndex The index to be copied
+	*/
+	void copyIndex(const FrozenIndex<ItemType>& otherIndex);
+
+	/*
+	Deletes the arrays of the index
+	@post The index is empty
+	*/
+	void eraseIndex();
+
+public:
+	typedef const ItemType* iterator; //The sorted array is iterated directly
+	typedef const ItemType* const_iterator;
+
+	FrozenIndex();
+	FrozenIndex(const FrozenIndex<ItemType>& otherIndex);
+	virtual ~FrozenIndex();
+
+	/*
+	Builds the index out of the array items, which doesn't have to be sorted. An index can only
+	be built once.
+	@post If the index was empty, it holds every item of items
+	@param newItems The array of items
+	numNewItems The number of items in the array
+	@return True if the index was built, false if it already had items
+	*/
+	bool addAll(const ItemType newItems[], int numNewItems);
+
+	/*
+	The index can't be modified once it is built, so these always fail
+	@return False
+	*/
+	bool add(const ItemType& newData);
+	bool remove(const ItemType& anEntry);
+
+	/*
+	Same as contains for every item of an array. The searches of a group of items go down
+	the implicit tree together, one level at a time, so their cache misses overlap. Adding
+	and removing fail for every item, as add and remove do.
+	@post results[i] is what contains, add or remove returned for items[i]
+	@param items The array of items
+	numItems The number of items in the array
+	results Array of numItems flags receiving the result for each item
+	@return The number of items found, added or removed
+	*/
+	int containsMany(const ItemType items[], int numItems, bool results[]) const;
+	int addMany(const ItemType items[], int numItems, bool results[]);
+	int removeMany(const ItemType items[], int numItems, bool results[]);
+
+	/*
+	Same as in the other data structures
+	*/
+	bool isEmpty() const;
+	int getNumberOfItems() const;
+	ItemType getEntry(const ItemType& anEntry) const;
+	bool findEntry(const ItemType& anEntry, ItemType& foundEntry) const;
+	bool contains(const ItemType& anEntry) const;
+	void traverse(void visit(ItemType&)) const;
+	template <class Visitor>
+	bool forEach(Visitor&& visit) const;
+	void rangeTraverse(const ItemType* lowPtr, const ItemType* highPtr, void visit(ItemType&)) const;
+	void pageTraverse(int offset, int limit, void visit(ItemType&)) const;
+	template <class Visitor>
+	bool forEachInRange(const ItemType* lowPtr, const ItemType* highPtr, Visitor&& visit) const;
+	bool isOrdered() const;
+	iterator begin() const;
+	iterator end() const;
+
+	/*
+	Same as in TwoThreeTree: the item is found by its index in the array, and the rank is the
+	index of the lower bound
+	*/
+	const ItemType* select(int index) const;
+	int rank(const ItemType& anEntry) const;
+
+	/*
+	Writes out the items of the index in sorted order to outFile. With a pool, the array is split
+	into ranges written concurrently to their own buffers, which are then written out in order.
+	@post The items are written to outFile
+	@param outFile Ostream variable storing the file
+	pool The thread pool processing the ranges
+	*/
+	void writeToFile(std::ostream& outFile) const;
+	void writeToFile(std::ostream& outFile, ThreadPool& pool) const;
+
+	/*
+	Writes out the number of items, the depth of a search and the size of the index in bytes
+	to os
+	@post The statistics of the index are written to os
+	@param os Ostream variable for the output
+	pool Unused, the statistics take constant time
+	*/
+	void displayStatistics(std::ostream& os) const;
+	void displayStatistics(std::ostream& os, ThreadPool& pool) const;
+
+	/*
+	Replaces the contents of the index with a copy of otherIndex
+	@post The index is identical to otherIndex
+	@param otherIndex The index to be copied
+	*/
+	void takeSnapshot(const FrozenIndex<ItemType>& otherIndex);
+};
+
+#include "FrozenIndex.cpp"
+
+#endif
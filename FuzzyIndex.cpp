@@ -0,0 +1,239 @@
+#include "FuzzyIndex.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+FuzzyIndex::FuzzyIndex()
+{
+	numRemoved = 0;
+}
+
+void FuzzyIndex::getKey(const char* text, std::string& key)
+{
+	key.clear();
+	for (int i = 0; text[i] != '\0'; i++)
+	{
+		if (isalpha(text[i]))
+			key += toupper(text[i]);
+	}
+}
+
+void FuzzyIndex::getKey(const MediaEntry& media, std::string& key)
+{
+	key.clear();
+	for (int i = 0; i < media.length(); i++)
+	{
+		if (isalpha(media[i]))
+			key += toupper(media[i]);
+	}
+}
+
+void FuzzyIndex::getTrigrams(const std::string& key, std::vector<int>& trigrams)
+{
+	trigrams.clear();
+
+	int length = key.length();
+	for (int i = -2; i < length; i++) //Padding, coded as 0, makes the first and last letters
+	{				  //start and end trigrams of their own
+		int trigram = 0;
+		for (int j = i; j < i + 3; j++)
+		{
+			int code = (j >= 0 && j < length) ? key[j] - 'A' + 1 : 0;
+			trigram = trigram*TRIGRAM_ALPHABET_SIZE + code;
+		}
+		trigrams.push_back(trigram);
+	}
+
+	std::sort(trigrams.begin(), trigrams.end()); //A trigram repeated in a title only lists it once
+	trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+}
+
+int FuzzyIndex::getEditDistance(const std::string& key, const std::string& otherKey, int maxDistance)
+{
+	int length = key.length();
+	int otherLength = otherKey.length();
+	if (std::abs(length - otherLength) > maxDistance) //Each edit changes the length by 1 at most
+		return maxDistance + 1;
+
+	std::vector<int> row(otherLength + 1); //Distances from a prefix of key to each prefix of otherKey
+	for (int j = 0; j <= otherLength; j++)
+		row[j] = j;
+
+	for (int i = 1; i <= length; i++)
+	{
+		int diagonal = row[0]; //Distance between the prefixes one letter shorter each
+		row[0] = i;
+		int rowMin = row[0];
+		for (int j = 1; j <= otherLength; j++)
+		{
+			int above = row[j];
+			int replaced = diagonal + (key[i-1] != otherKey[j-1]);
+			row[j] = std::min(std::min(above, row[j-1]) + 1, replaced);
+			diagonal = above;
+			rowMin = std::min(rowMin, row[j]);
+		}
+
+		if (rowMin > maxDistance) //Distances never decrease from one row to the next
+			return maxDistance + 1;
+	}
+
+	return std::min(row[otherLength], maxDistance + 1);
+}
+
+void FuzzyIndex::add(const MediaEntry& newMedia)
+{
+	std::string key;
+	getKey(newMedia, key);
+	if (key.empty())
+		return;
+
+	int id = entries.size(); //Ids only grow, so each list stays sorted by appending to it
+	entries.push_back(newMedia);
+	keys.push_back(key);
+	isRemoved.push_back(false);
+
+	std::vector<int> trigrams;
+	getTrigrams(key, trigrams);
+	for (unsigned int i = 0; i < trigrams.size(); i++)
+		postings[trigrams[i]].push_back(id);
+}
+
+bool FuzzyIndex::remove(const MediaEntry& media)
+{
+	std::string key;
+	getKey(media, key);
+	if (key.empty())
+		return false;
+
+	std::vector<int> trigrams;
+	getTrigrams(key, trigrams);
+
+	int shortest = trigrams[0]; //Every list of its trigrams has its id, so look in the shortest one
+	for (unsigned int i = 1; i < trigrams.size(); i++)
+	{
+		if (postings[trigrams[i]].size() < postings[shortest].size())
+			shortest = trigrams[i];
+	}
+
+	int id = -1;
+	for (unsigned int i = 0; i < postings[shortest].size() && id < 0; i++)
+	{
+		if (entries[postings[shortest][i]] == media)
+			id = postings[shortest][i];
+	}
+
+	if (id < 0)
+		return false;
+
+	for (unsigned int i = 0; i < trigrams.size(); i++)
+	{
+		std::vector<int>& list = postings[trigrams[i]];
+		list.erase(std::lower_bound(list.begin(), list.end(), id));
+	}
+
+	entries[id] = MediaEntry(); //Frees the title until the ids are compacted
+	keys[id].clear();
+	isRemoved[id] = true;
+	numRemoved++;
+
+	if (numRemoved > MIN_COMPACT_SIZE && 2*numRemoved > (int)entries.size())
+		compact();
+
+	return true;
+}
+
+void FuzzyIndex::compact()
+{
+	std::vector<MediaEntry> oldEntries;
+	oldEntries.swap(entries);
+	std::vector<bool> oldIsRemoved;
+	oldIsRemoved.swap(isRemoved);
+
+	clear();
+	for (unsigned int id = 0; id < oldEntries.size(); id++) //Adding them in the same order keeps
+	{							  //the order of the ids
+		if (!oldIsRemoved[id])
+			add(oldEntries[id]);
+	}
+}
+
+void FuzzyIndex::clear()
+{
+	entries.clear();
+	keys.clear();
+	isRemoved.clear();
+	for (int i = 0; i < NUM_TRIGRAMS; i++)
+		std::vector<int>().swap(postings[i]); //Frees the memory of the lists too
+	numRemoved = 0;
+}
+
+int FuzzyIndex::getNumberOfItems() const
+{
+	return entries.size() - numRemoved;
+}
+
+int FuzzyIndex::find(const char* text, int maxDistance, int maxResults,
+			void visit(const MediaEntry&, int), int& numCandidates) const
+{
+	numCandidates = 0;
+
+	std::string key;
+	getKey(text, key);
+	if (key.empty() || maxResults <= 0)
+		return 0;
+
+	std::vector<int> trigrams;
+	getTrigrams(key, trigrams);
+	int minShared = trigrams.size() - 3*maxDistance; //Trigrams a close enough title still has
+
+	std::vector<std::pair<int, int> > found; //Distance and id of the entries close enough
+	std::vector<int> candidates;
+	if (minShared > 0)
+	{
+		std::vector<unsigned short> numShared(entries.size(), 0); //Trigrams shared by each title,
+		for (unsigned int i = 0; i < trigrams.size(); i++)	  //up to minShared
+		{
+			const std::vector<int>& list = postings[trigrams[i]];
+			for (unsigned int j = 0; j < list.size(); j++)
+			{
+				if (numShared[list[j]] < minShared && ++numShared[list[j]] == minShared)
+					candidates.push_back(list[j]);
+			}
+		}
+	}
+	else //Every title could be close enough
+	{
+		for (unsigned int id = 0; id < entries.size(); id++)
+		{
+			if (!isRemoved[id])
+				candidates.push_back(id);
+		}
+	}
+
+	for (unsigned int c = 0; c < candidates.size(); c++)
+	{
+		const std::string& candidateKey = keys[candidates[c]];
+		if (std::abs((int)candidateKey.length() - (int)key.length()) > maxDistance)
+			continue;
+
+		numCandidates++;
+		int distance = getEditDistance(key, candidateKey, maxDistance);
+		if (distance <= maxDistance)
+			found.push_back(std::make_pair(distance, candidates[c]));
+	}
+
+	const std::vector<MediaEntry>& entriesRef = entries;
+	int numFound = std::min((int)found.size(), maxResults);
+	std::partial_sort(found.begin(), found.begin() + numFound, found.end(),
+		[&entriesRef](const std::pair<int, int>& one, const std::pair<int, int>& other)
+	{
+		if (one.first != other.first)
+			return one.first < other.first;
+		return entriesRef[one.second] < entriesRef[other.second];
+	});
+
+	for (int i = 0; i < numFound; i++)
+		visit(entries[found[i].second], found[i].first);
+
+	return numFound;
+}
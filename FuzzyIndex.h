@@ -0,0 +1,113 @@
+/*@file FuzzyIndex.h*/
+#ifndef _FUZZY_INDEX_H
+#define _FUZZY_INDEX_H
+
+#include <string>
+#include <vector>
+#include "MediaEntry.h"
+#include "WordIndex.h"
+
+const int TRIGRAM_ALPHABET_SIZE = 27; //The letters, and the padding put around each title
+const int NUM_TRIGRAMS = TRIGRAM_ALPHABET_SIZE*TRIGRAM_ALPHABET_SIZE*TRIGRAM_ALPHABET_SIZE;
+
+/*
+Trigram index of the titles, to find the titles closest to a title with typos in it, e.g.
+"Spongebob Squarepants" for "Spongebob Squarpants". Titles are compared as in MediaEntry, on
+their letters in upper case, and the distance between two titles is the number of letters to
+insert, delete or replace to turn one into the other (the edit distance). Every entry gets an
+id in the order it was added, and each trigram (three letters in a row, the title being padded
+on both sides) maps to the sorted list of the ids of the titles having it. A title within k
+edits of another one shares all but at most 3k of its trigrams, since an edit changes three
+trigrams at most, so only the titles sharing enough trigrams with the title looked for have
+their edit distance computed.
+*/
+class FuzzyIndex
+{
+private:
+	std::vector<MediaEntry> entries; //The entries by id
+	std::vector<std::string> keys; //The letters of the title of each entry in upper case
+	std::vector<bool> isRemoved; //Whether the entry of each id was removed
+	std::vector<int> postings[NUM_TRIGRAMS]; //The ids of the titles having each trigram
+	int numRemoved; //Number of ids whose entry was removed
+
+	/*
+	Computes the distinct trigrams of a key, padded on both sides
+	@post trigrams holds the codes of the trigrams, sorted
+	@param key Letters in upper case
+	trigrams Receives the codes, from 0 to NUM_TRIGRAMS-1
+	*/
+	static void getTrigrams(const std::string& key, std::vector<int>& trigrams);
+
+	/*
+	Renumbers the entries left, so removed entries no longer take up ids
+	@post No id is removed, and the ids keep the order of the entries
+	*/
+	void compact();
+
+public:
+	FuzzyIndex();
+
+	/*
+	Returns the letters of a title in upper case, which is what titles are compared on
+	@post key holds the letters
+	@param text The title
+	media The entry whose title is used
+	key Receives the letters
+	*/
+	static void getKey(const char* text, std::string& key);
+	static void getKey(const MediaEntry& media, std::string& key);
+
+	/*
+	Computes the edit distance of two keys, giving up as soon as it exceeds maxDistance
+	@param key One of the keys
+	otherKey The other key
+	maxDistance The largest distance of interest
+	@return The edit distance, or maxDistance+1 if it is larger than maxDistance
+	*/
+	static int getEditDistance(const std::string& key, const std::string& otherKey, int maxDistance);
+
+	/*
+	Adds an entry to the index. Titles without any letter can't be found, so they aren't kept.
+	@post newMedia gets the next id, which is added to the list of each of its trigrams
+	@param newMedia The entry to be added
+	*/
+	void add(const MediaEntry& newMedia);
+
+	/*
+	Removes an entry from the index. Its id is found in the shortest list of its trigrams.
+	@post If it was in the index, media is no longer in any list
+	@param media The entry to be removed
+	@return True if the removal was successful, false otherwise
+	*/
+	bool remove(const MediaEntry& media);
+
+	/*
+	Removes every entry from the index
+	@post The index is empty
+	*/
+	void clear();
+
+	/*
+	Returns the number of entries in the index
+	@return The number of entries added and not removed
+	*/
+	int getNumberOfItems() const;
+
+	/*
+	Finds up to maxResults entries whose titles are within maxDistance edits of text, closest
+	first, and equally close ones in sorted order. Only the entries sharing enough trigrams with
+	text, and whose titles are close enough in length, are candidates whose distance is computed.
+	With too few trigrams left to require, e.g. for a short text, every title is a candidate.
+	@post visit is executed for every entry found, with its distance
+	@param text The title looked for
+	maxDistance The largest edit distance of the entries found
+	maxResults The maximum number of entries found
+	visit Function executed for every entry found
+	numCandidates Receives the number of entries whose distance was computed
+	@return The number of entries found
+	*/
+	int find(const char* text, int maxDistance, int maxResults,
+			void visit(const MediaEntry&, int), int& numCandidates) const;
+};
+
+#endif
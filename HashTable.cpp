@@ -3,7 +3,9 @@
 
 #include <cctype>
 #include <cmath>
+#include <algorithm>
 #include <cstdlib>
+#include <sstream>
 #include "HashTable.h"
 #include "NotFoundException.h"
 
@@ -22,6 +24,12 @@ HashTable<ItemType>::HashTable(int initialSize)
 
 template <class ItemType>
 HashTable<ItemType>::HashTable(const HashTable<ItemType>& otherTable) //Copy contents of the other table
+{
+	copyTable(otherTable);
+}
+
+template <class ItemType>
+void HashTable<ItemType>::copyTable(const HashTable<ItemType>& otherTable)
 {
 	tableSize = otherTable.tableSize;
 	numCollisions = otherTable.numCollisions;
@@ -61,6 +69,18 @@ HashTable<ItemType>::HashTable(const HashTable<ItemType>& otherTable) //Copy con
 	}
 }
 
+template <class ItemType>
+void HashTable<ItemType>::takeSnapshot(const HashTable<ItemType>& otherTable)
+{
+	if (this != &otherTable)
+	{
+		eraseTable(); //Replace the current table with a copy of the other one
+		delete [] table;
+
+		copyTable(otherTable);
+	}
+}
+
 template <class ItemType>
 HashTable<ItemType>::~HashTable()
 {
@@ -81,8 +101,10 @@ int HashTable<ItemType>::getCharCode(char c) const
 template <class ItemType>
 int HashTable<ItemType>::h(const ItemType& item, int index) const
 {
-	if (index == 0) //Base case, see design write-up for more details
-		return ((getCharCode(item[0])) % tableSize);
+	if (index < 0) //Base case, see design write-up for more details
+		return 0;
+	else if (toupper((unsigned char)item[index]) < 'A' || toupper((unsigned char)item[index]) > 'Z')
+		return h(item, index-1); //Skipped, as MediaEntry::getNextChar does in the comparisons
 	else //Recursive definition utilizing Horner's rule and modulus properties
 		return (((h(item, index-1)*(64 % tableSize)) % tableSize
 				 + (getCharCode(item[index])) % tableSize) % tableSize);
@@ -174,38 +196,41 @@ void HashTable<ItemType>::expandTable()
 
 	table = new Node<ItemType>*[tableSize]; //Create the new table
 
-	numCollisions = 0; //Reset the number of collisions and entries
-	numEntries = 0;
+	numCollisions = 0; //Reset the number of collisions, the entries stay the same
 
 	for (int i = 0; i < tableSize; i++) //Reallocate the new values
 		table[i] = NULL;
 
 	for (int i = 0; i < oldTableSize; i++) //Rehash the entries in the old table to the new table
 	{
-		if (oldTable[i] != NULL) //Entry exists
-		{
-			Node<ItemType>* current = oldTable[i];
-			Node<ItemType>* trailCurrent = NULL;
-			do //Rehash entries in old table while simultaneously deleting the chain
-			{
-				add(current->item); //Call the function add
-				trailCurrent = current;
-				current = current->next;
-
-				delete trailCurrent; //Delete the nodes along the way
-			} while (current != NULL);
+		Node<ItemType>* current = oldTable[i];
+		while (current != NULL) //Move the nodes of the chain to their new addresses, which
+		{			//doesn't copy the items or check the chains again
+			Node<ItemType>* nextPtr = current->next;
+			int tableIndex = h(current->item, current->item.length()-1);
+			if (table[tableIndex] != NULL)
+				numCollisions++;
+
+			current->next = table[tableIndex];
+			table[tableIndex] = current;
+			current = nextPtr;
 		}
 	}
 
 	delete [] oldTable; //Deallocate the old table's dynamic memory
-
-	numEntries--; //Since it will pop back to the original add function, one item will be counted twice.
 }
 
 template <class ItemType>
 bool HashTable<ItemType>::add(const ItemType& newItem)
 {
-	int tableIndex = h(newItem, newItem.length()-1);
+	addAtIndex(h(newItem, newItem.length()-1), newItem);
+
+	return true;
+}
+
+template <class ItemType>
+void HashTable<ItemType>::addAtIndex(int tableIndex, const ItemType& newItem)
+{
 	if (table[tableIndex] == NULL) //No entry exists, so create a new head node
 	{
 		table[tableIndex] = new Node<ItemType>;
@@ -218,13 +243,21 @@ bool HashTable<ItemType>::add(const ItemType& newItem)
 		insertIntoChain(tableIndex, newItem); //Put item in the first slot of the linked chain
 
 		int listLength = listSize(tableIndex);
-		if ((listLength-1) == MAX_COL_SIZE) //Check if the new entry has exceeded the max allowable
-		{				   //number of collisions. Resize the table if so
+		if ((listLength-1) == MAX_COL_SIZE && 2*numEntries >= tableSize) //Check if the new entry has
+		{	//exceeded the max allowable number of collisions. Resize the table if so, unless it is
+			//less than half full: equal items share a chain whatever the size of the table
 			expandTable();
 		}
 	}
 
 	numEntries++;
+}
+
+template <class ItemType>
+bool HashTable<ItemType>::addAll(const ItemType items[], int numItems)
+{
+	for (int i = 0; i < numItems; i++) //Order does not matter for a table, so add each item
+		add(items[i]);
 
 	return true;
 }
@@ -294,6 +327,185 @@ bool HashTable<ItemType>::remove(const ItemType& entry)
 }
 
 
+template <class ItemType>
+bool HashTable<ItemType>::isInChain(const Node<ItemType>* chainPtr, const ItemType& item) const
+{
+	while (chainPtr != NULL && !(chainPtr->item == item))
+		chainPtr = chainPtr->next;
+
+	return chainPtr != NULL;
+}
+
+template <class ItemType>
+void HashTable<ItemType>::prefetchGroup(const ItemType items[], int numItems, int tableIndexes[]) const
+{
+	for (int i = 0; i < numItems; i++) //Hashing the group gives the slots time to arrive
+	{
+		tableIndexes[i] = h(items[i], items[i].length()-1);
+		__builtin_prefetch(&table[tableIndexes[i]]);
+	}
+
+	for (int i = 0; i < numItems; i++)
+	{
+		if (table[tableIndexes[i]] != NULL)
+			__builtin_prefetch(table[tableIndexes[i]]);
+	}
+}
+
+template <class ItemType>
+int HashTable<ItemType>::containsMany(const ItemType items[], int numItems, bool results[]) const
+{
+	int numFound = 0;
+	int tableIndexes[TABLE_PROBE_GROUP_SIZE];
+	for (int first = 0; first < numItems; first += TABLE_PROBE_GROUP_SIZE)
+	{
+		int groupSize = std::min(TABLE_PROBE_GROUP_SIZE, numItems - first);
+		prefetchGroup(items + first, groupSize, tableIndexes);
+
+		for (int i = 0; i < groupSize; i++)
+		{
+			results[first + i] = isInChain(table[tableIndexes[i]], items[first + i]);
+			if (results[first + i])
+				numFound++;
+		}
+	}
+
+	return numFound;
+}
+
+template <class ItemType>
+int HashTable<ItemType>::addMany(const ItemType items[], int numItems, bool results[])
+{
+	int tableIndexes[TABLE_PROBE_GROUP_SIZE];
+	for (int first = 0; first < numItems; first += TABLE_PROBE_GROUP_SIZE)
+	{
+		int groupSize = std::min(TABLE_PROBE_GROUP_SIZE, numItems - first);
+		prefetchGroup(items + first, groupSize, tableIndexes);
+
+		int groupTableSize = tableSize;
+		for (int i = 0; i < groupSize; i++)
+		{
+			if (tableSize != groupTableSize) //The table was expanded, so the addresses changed
+				tableIndexes[i] = h(items[first + i], items[first + i].length()-1);
+
+			addAtIndex(tableIndexes[i], items[first + i]);
+			results[first + i] = true; //Same as add, which always succeeds
+		}
+	}
+
+	return numItems;
+}
+
+template <class ItemType>
+int HashTable<ItemType>::removeMany(const ItemType items[], int numItems, bool results[])
+{
+	int numRemoved = 0;
+	int tableIndexes[TABLE_PROBE_GROUP_SIZE];
+	for (int first = 0; first < numItems; first += TABLE_PROBE_GROUP_SIZE)
+	{
+		int groupSize = std::min(TABLE_PROBE_GROUP_SIZE, numItems - first);
+		prefetchGroup(items + first, groupSize, tableIndexes); //Removing never moves the entries
+
+		for (int i = 0; i < groupSize; i++)
+		{
+			results[first + i] = removeFromChain(tableIndexes[i], items[first + i]);
+			if (results[first + i])
+				numRemoved++;
+		}
+	}
+
+	return numRemoved;
+}
+
+template <class ItemType>
+const Node<ItemType>* HashTable<ItemType>::getChain(const ItemType& item, int otherIndex,
+							const HashTable<ItemType>& otherTable) const
+{
+	if (tableSize == otherTable.tableSize) //Same size, so the same hash function: the item
+		return table[otherIndex];      //belongs at the same address in both tables
+	else
+		return table[h(item, item.length()-1)];
+}
+
+template <class ItemType>
+void HashTable<ItemType>::filterTable(const HashTable<ItemType>& otherTable, bool keepCommon)
+{
+	for (int i = 0; i < tableSize; i++)
+	{
+		int chainLength = listSize(i);
+		Node<ItemType>** linkPtr = &table[i]; //Link pointing to the current node
+
+		while (*linkPtr != NULL)
+		{
+			Node<ItemType>* current = *linkPtr;
+			if (otherTable.isInChain(otherTable.getChain(current->item, i, *this), current->item)
+				== keepCommon)
+				linkPtr = &current->next; //Keep the node
+			else //Unlink and delete the node, same as removeFromChain
+			{
+				if (chainLength > 1)
+					numCollisions--;
+				chainLength--;
+
+				*linkPtr = current->next;
+				delete current;
+				numEntries--;
+			}
+		}
+	}
+}
+
+template <class ItemType>
+void HashTable<ItemType>::mergeFrom(const HashTable<ItemType>& otherTable)
+{
+	if (this == &otherTable) //Every entry is already in the table
+		return;
+
+	for (int i = 0; i < otherTable.tableSize; i++)
+	{
+		for (const Node<ItemType>* current = otherTable.table[i]; current != NULL; current = current->next)
+		{
+			int tableIndex = i; //Same address as in otherTable, unless the sizes differ
+			if (tableSize != otherTable.tableSize)
+				tableIndex = h(current->item, current->item.length()-1);
+
+			if (!isInChain(table[tableIndex], current->item))
+				addAtIndex(tableIndex, current->item); //May expand the table, after which
+		}						       //the sizes differ
+	}
+}
+
+template <class ItemType>
+void HashTable<ItemType>::intersectWith(const HashTable<ItemType>& otherTable)
+{
+	if (this != &otherTable) //The intersection with itself is the table itself
+		filterTable(otherTable, true);
+}
+
+template <class ItemType>
+void HashTable<ItemType>::difference(const HashTable<ItemType>& otherTable)
+{
+	if (this == &otherTable)
+		clear();
+	else if (otherTable.numEntries >= numEntries)
+		filterTable(otherTable, false);
+	else //Fewer entries to remove than to filter, so each is looked up in the table instead
+	{
+		for (int i = 0; i < otherTable.tableSize; i++)
+		{
+			for (const Node<ItemType>* current = otherTable.table[i]; current != NULL;
+				current = current->next)
+			{
+				int tableIndex = i; //Same address as in otherTable, unless the sizes differ
+				if (tableSize != otherTable.tableSize)
+					tableIndex = h(current->item, current->item.length()-1);
+
+				removeFromChain(tableIndex, current->item);
+			}
+		}
+	}
+}
+
 template <class ItemType>
 void HashTable<ItemType>::eraseTable()
 {
@@ -324,6 +536,21 @@ void HashTable<ItemType>::clear()
 	numEntries = 0;
 }
 
+template <class ItemType>
+bool HashTable<ItemType>::findEntry(const ItemType& entry, ItemType& foundEntry) const
+{
+	int tableIndex = h(entry, entry.length()-1); //Same as getEntry
+	Node<ItemType>* current = table[tableIndex];
+
+	while (current != NULL && (current->item != entry))
+		current = current->next;
+
+	if (current != NULL)
+		foundEntry = current->item;
+
+	return (current != NULL);
+}
+
 template <class ItemType>
 ItemType HashTable<ItemType>::getEntry(const ItemType& entry) const
 {
@@ -369,6 +596,127 @@ void HashTable<ItemType>::traverse(void visit(ItemType&)) const
 	}
 }
 
+template <class ItemType>
+template <class Visitor>
+bool HashTable<ItemType>::forEach(Visitor&& visit) const
+{
+	for (int i = 0; i < tableSize; i++)
+	{
+		for (Node<ItemType>* current = table[i]; current != NULL; current = current->next)
+		{
+			if (!visit(current->item))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+template <class ItemType>
+template <class Visitor>
+bool HashTable<ItemType>::forEachInRange(const ItemType* lowPtr, const ItemType* highPtr,
+						Visitor&& visit) const
+{
+	for (int i = 0; i < tableSize; i++)
+	{
+		for (Node<ItemType>* current = table[i]; current != NULL; current = current->next)
+		{
+			if ((lowPtr == NULL || !(current->item < *lowPtr)) &&
+					(highPtr == NULL || current->item < *highPtr))
+			{
+				if (!visit(current->item))
+					return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+template <class ItemType>
+bool HashTable<ItemType>::isOrdered() const
+{
+	return false;
+}
+
+template <class ItemType>
+void HashTable<ItemType>::rangeTraverse(const ItemType* lowPtr, const ItemType* highPtr,
+						void visit(ItemType&)) const
+{
+	for (int i = 0; i < tableSize; i++) //Same as traverse, except only the entries in the range
+	{				    //are visited
+		for (Node<ItemType>* current = table[i]; current != NULL; current = current->next)
+		{
+			if ((lowPtr == NULL || !(current->item < *lowPtr)) &&
+					(highPtr == NULL || current->item < *highPtr))
+				visit(current->item);
+		}
+	}
+}
+
+template <class ItemType>
+void HashTable<ItemType>::pageTraverse(int offset, int limit, void visit(ItemType&)) const
+{
+	int position = 0;
+	int end = offset + limit;
+
+	for (int i = 0; i < tableSize && position < end; i++) //Stop once the page has been visited
+	{
+		for (Node<ItemType>* current = table[i]; current != NULL && position < end;
+				current = current->next)
+		{
+			if (position >= offset)
+				visit(current->item);
+			position++;
+		}
+	}
+}
+
+template <class ItemType>
+const ItemType* HashTable<ItemType>::select(int index) const
+{
+	if (index < 0)
+		return NULL;
+
+	int position = 0;
+	for (int i = 0; i < tableSize; i++)
+	{
+		for (Node<ItemType>* current = table[i]; current != NULL; current = current->next)
+		{
+			if (position == index)
+				return &(current->item);
+			position++;
+		}
+	}
+
+	return NULL;
+}
+
+template <class ItemType>
+int HashTable<ItemType>::rank(const ItemType& anEntry) const
+{
+	int numSmaller = 0;
+	for (int i = 0; i < tableSize; i++)
+	{
+		for (Node<ItemType>* current = table[i]; current != NULL; current = current->next)
+			numSmaller += (current->item < anEntry);
+	}
+
+	return numSmaller;
+}
+
+template <class ItemType>
+typename HashTable<ItemType>::iterator HashTable<ItemType>::begin() const
+{
+	return iterator(table, tableSize, 0);
+}
+
+template <class ItemType>
+typename HashTable<ItemType>::iterator HashTable<ItemType>::end() const
+{
+	return iterator(table, tableSize, tableSize);
+}
+
 /* IGNORE
 template <class ItemType>
 void HashTable<ItemType>::displayTable() const
@@ -392,14 +740,21 @@ void HashTable<ItemType>::displayTable() const
 template <class ItemType>
 void HashTable<ItemType>::writeToFile(std::ostream& outFile) const
 {
-	for (int i = 0; i < tableSize; i++)
+	BufferedWriter writer(outFile);
+	writeRange(0, tableSize, writer);
+}
+
+template <class ItemType>
+void HashTable<ItemType>::writeRange(int first, int last, BufferedWriter& writer) const
+{
+	for (int i = first; i < last; i++)
 	{
 		Node<ItemType>* current = table[i];
 		if (current != NULL)
 		{
-			do //Write the contents of the item to the file outFile
+			do //Write the contents of the item to writer
 			{ //by calling the function write file for each item in the chain
-				(current->item).writeToFile(outFile);
+				(current->item).writeToFile(writer);
 				current = current->next;
 			} while (current != NULL);
 		}
@@ -408,9 +763,15 @@ void HashTable<ItemType>::writeToFile(std::ostream& outFile) const
 
 template <class ItemType>
 int HashTable<ItemType>::getOtherStats(int& numOccupied) const
+{
+	return getRangeStats(0, tableSize, numOccupied);
+}
+
+template <class ItemType>
+int HashTable<ItemType>::getRangeStats(int first, int last, int& numOccupied) const
 {
 	int max = 0; //Assume that the table is empty initially
-	for (int i = 0; i < tableSize; i++)
+	for (int i = first; i < last; i++)
 	{
 		if (table[i] != NULL) //Get the maximum collision size while simultaneously
 		{                     //getting the number of occupied entries
@@ -440,5 +801,89 @@ void HashTable<ItemType>::displayStatistics(std::ostream& os) const
 	os << std::endl << std::endl;
 }
 
+template <class ItemType>
+int HashTable<ItemType>::getNumRanges(const ThreadPool& pool) const
+{
+	if (pool.getNumThreads() > 1 && numEntries >= MIN_PARALLEL_ITEMS)
+		return 4*pool.getNumThreads(); //Several ranges per worker so that uneven ranges even out
+	else
+		return 1;
+}
+
+template <class ItemType>
+void HashTable<ItemType>::writeToFile(std::ostream& outFile, ThreadPool& pool) const
+{
+	int numRanges = getNumRanges(pool);
+	if (numRanges == 1) //Not worth splitting
+	{
+		writeToFile(outFile);
+		return;
+	}
+
+	std::ostringstream* buffers = new std::ostringstream[numRanges];
+	for (int i = 0; i < numRanges; i++) //Each worker writes its range of addresses to its own buffer
+	{
+		int first = (long)tableSize*i/numRanges;
+		int last = (long)tableSize*(i+1)/numRanges;
+		std::ostringstream* bufferPtr = &buffers[i];
+		pool.submit([this, first, last, bufferPtr]()
+		{
+			BufferedWriter writer(*bufferPtr);
+			writeRange(first, last, writer);
+		});
+	}
+	pool.wait();
+
+	for (int i = 0; i < numRanges; i++) //Write the buffers in table order
+		outFile << buffers[i].str();
+
+	delete [] buffers;
+}
+
+template <class ItemType>
+void HashTable<ItemType>::displayStatistics(std::ostream& os, ThreadPool& pool) const
+{
+	int numRanges = getNumRanges(pool);
+	if (numRanges == 1) //Not worth splitting
+	{
+		displayStatistics(os);
+		return;
+	}
+
+	int* maxColSizes = new int[numRanges];
+	int* numOccupied = new int[numRanges];
+	for (int i = 0; i < numRanges; i++) //Each worker gathers the statistics of its range
+	{
+		int first = (long)tableSize*i/numRanges;
+		int last = (long)tableSize*(i+1)/numRanges;
+		int* maxPtr = &maxColSizes[i];
+		int* occupiedPtr = &numOccupied[i];
+		pool.submit([this, first, last, maxPtr, occupiedPtr]()
+		{
+			*occupiedPtr = 0;
+			*maxPtr = getRangeStats(first, last, *occupiedPtr);
+		});
+	}
+	pool.wait();
+
+	int maxColSize = 0;
+	int numOccupiedEntries = 0;
+	for (int i = 0; i < numRanges; i++) //Combine the statistics of the ranges
+	{
+		maxColSize = std::max(maxColSize, maxColSizes[i]);
+		numOccupiedEntries += numOccupied[i];
+	}
+
+	os << "Table size: " << tableSize << std::endl;
+	os << "Number of collisions: " << numCollisions << std::endl;
+	os << "Maximum collision size: " << maxColSize << std::endl;
+	os << "Number of occupied entries: " << numOccupiedEntries << std::endl;
+	os << "Number of items: " << numEntries << std::endl;
+	os << std::endl << std::endl;
+
+	delete [] maxColSizes;
+	delete [] numOccupied;
+}
+
 
 #endif
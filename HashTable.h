@@ -3,10 +3,13 @@
 #define _HASH_TABLE_H
 
 #include "TableInterface.h"
+#include "ThreadPool.h"
+#include "BufferedWriter.h"
 #include <iostream>
 
 const int MAX_COL_SIZE = 10; //Maximum allowable collision size for any entry in the table
 const int DEFAULT_SIZE = 31; //Default table size, make sure it is a prime number
+const int TABLE_PROBE_GROUP_SIZE = 16; //Number of probes a batch operation overlaps
 
 template <class ItemType> //Struct for the node used in separate chaining
 struct Node
@@ -15,6 +18,8 @@ struct Node
 	Node<ItemType>* next;
 };
 
+#include "HashTableIterator.h"
+
 template <class ItemType>
 class HashTable : public TableInterface<ItemType>
 {
@@ -32,7 +37,8 @@ private:
 	int getCharCode(char c) const;
 
 	/*
-	Hash function to compute the table address of an item containing a string phrase
+	Hash function to compute the table address of an item containing a string phrase. Items are
+	only compared on their letters, so only the letters are hashed and equal items get the same address.
 	@param item The item whose address is to be computed
 	index Used to facilitate the recursive definition of h. See the design write-up for more details
 	@return Table address for item to be inserted
@@ -61,6 +67,14 @@ private:
 	*/
 	void insertIntoChain(int tableIndex, const ItemType& item);
 
+	/*
+	Adds newItem to the table at address tableIndex, which has to be its hash address
+	@post newItem is in the table. The table is expanded if the chain has grown too long.
+	@param tableIndex The address of newItem
+	newItem The item to be added
+	*/
+	void addAtIndex(int tableIndex, const ItemType& newItem);
+
 	/*
 	Function removes an item from the linked chain at address tableIndex
 	@post item is removed from the chain if it exists, otherwise nothing happens
@@ -71,6 +85,54 @@ private:
 	bool removeFromChain(int tableIndex, const ItemType& item);
 
 
+	/*
+	Checks if item is stored in the chain starting at chainPtr
+	@param chainPtr Pointer to the head of the chain
+	item The item to be looked for
+	@return True if the chain has the item, false if not
+	*/
+	bool isInChain(const Node<ItemType>* chainPtr, const ItemType& item) const;
+
+	/*
+	Computes the addresses of up to TABLE_PROBE_GROUP_SIZE items and prefetches their slots of the
+	table, then the heads of their chains, so the cache misses of the whole group overlap instead
+	of following one another
+	@post tableIndexes[i] is the address of items[i], and the memory it leads to is being loaded
+	@param items The items to be probed
+	numItems The number of items, at most TABLE_PROBE_GROUP_SIZE
+	tableIndexes Array receiving the addresses
+	*/
+	void prefetchGroup(const ItemType items[], int numItems, int tableIndexes[]) const;
+
+	/*
+	Returns the chain of this table where item belongs. item is stored at address otherIndex of
+	otherTable, so if both tables have the same size it is not hashed again.
+	@param item The item to be located
+	otherIndex The address of item in otherTable
+	otherTable The table item comes from
+	@return Pointer to the head of the chain, NULL if it is empty
+	*/
+	const Node<ItemType>* getChain(const ItemType& item, int otherIndex,
+					const HashTable<ItemType>& otherTable) const;
+
+	/*
+	Removes, in a single pass over the table, the entries that are in otherTable (keepCommon is
+	false) or those that aren't (keepCommon is true). Each entry is looked up in the chain of
+	otherTable at the same address when the tables have the same size.
+	@post The table only has the entries that are, or aren't, in otherTable
+	@param otherTable The table the entries are checked against
+	keepCommon True to keep the entries that are in otherTable, false to keep the others
+	*/
+	void filterTable(const HashTable<ItemType>& otherTable, bool keepCommon);
+
+	/*
+	Copies the contents of otherTable, used by the copy constructor and takeSnapshot
+	@pre The table holds no memory of its own
+	@post The table is identical to otherTable
+	@param otherTable The table to be copied
+	*/
+	void copyTable(const HashTable<ItemType>& otherTable);
+
 	/*
 	Function clears the table of all entries.
 	@post Table is empty and all linked chains have been deleted
@@ -80,8 +142,8 @@ private:
 
 	/*
 	Function creates a new table 2x the size of the original.
-	@post A new table 2x the size of the original is created, with all of the entries from the original
-	rehashed into their new addresses. The old table is deleted.
+	@post A new table 2x the size of the original is created, with all of the nodes from the original
+	moved to the new addresses of their entries. The old table is deleted.
 	*/
 	void expandTable();
 
@@ -100,7 +162,36 @@ private:
 	*/
 	int getOtherStats(int& numOccupied) const;
 
+	/*
+	Same as getOtherStats, except only the addresses first through last-1 are considered
+	@param first The first address of the range
+	last The address one past the end of the range
+	numOccupied The number of occupied entries in the range
+	@return The maximum collision size in the range
+	*/
+	int getRangeStats(int first, int last, int& numOccupied) const;
+
+	/*
+	Writes out the entries stored at the addresses first through last-1 to writer
+	@post The entries in the range are written to writer
+	@param first The first address of the range
+	last The address one past the end of the range
+	writer The writer collecting the output for the file
+	*/
+	void writeRange(int first, int last, BufferedWriter& writer) const;
+
+	/*
+	Returns the number of address ranges the table should be split into so that every
+	worker of pool gets several of them
+	@param pool The pool that will process the ranges
+	@return The number of ranges, or 1 if the table is too small to be worth splitting
+	*/
+	int getNumRanges(const ThreadPool& pool) const;
+
 public:
+	typedef HashTableIterator<ItemType> iterator; //Iterators only give read access to the entries
+	typedef HashTableIterator<ItemType> const_iterator;
+
 	HashTable(int initialSize = DEFAULT_SIZE);
 	HashTable(const HashTable<ItemType>& otherTable); //Copy constructor
 	virtual ~HashTable(); //Destructor
@@ -123,6 +214,100 @@ public:
 	bool contains(const ItemType& entry) const;
 	void traverse(void visit(ItemType&)) const;
 
+	/*
+	Same as getEntry, telling whether the entry was found instead of throwing an exception
+	@post If entry is in the table, foundEntry is the item stored
+	@param entry The item to be retrieved
+	foundEntry Receives the item found
+	@return True if entry is in the table, false otherwise
+	*/
+	bool findEntry(const ItemType& entry, ItemType& foundEntry) const;
+
+	/*
+	Same as contains, add and remove for every item of an array, e.g. to check millions of
+	entries. The items are hashed in groups whose chains are prefetched together (see
+	prefetchGroup) before the group is resolved.
+	@post results[i] is what contains, add or remove returned for items[i]
+	@param items The array of items
+	numItems The number of items in the array
+	results Array of numItems flags receiving the result for each item
+	@return The number of items found, added or removed
+	*/
+	int containsMany(const ItemType items[], int numItems, bool results[]) const;
+	int addMany(const ItemType items[], int numItems, bool results[]);
+	int removeMany(const ItemType items[], int numItems, bool results[]);
+
+	/*
+	Traverses the table in table order with any callable, e.g. a lambda, which can be inlined,
+	hold state, and stop the traversal early by returning false
+	@post visit is executed for every entry, up to the first call returning false
+	@param visit Callable taking a const ItemType& and returning true to continue, false to stop
+	@return False if visit stopped the traversal, true otherwise
+	*/
+	template <class Visitor>
+	bool forEach(Visitor&& visit) const;
+
+
+	/*
+	Returns an iterator at the first entry of the table, or the end iterator, so the table
+	can be used in a range-based for loop. Adding or removing entries invalidates the iterators.
+	@return The iterator at the first entry or at the end, respectively
+	*/
+	iterator begin() const;
+	iterator end() const;
+
+
+	/*
+	Traverses the entries of the table lying in the range [*lowPtr, *highPtr). Since the
+	table is unordered, every entry is checked and the visits are not in sorted order.
+	@post Visit is executed for every entry in the range
+	@param lowPtr Pointer to the inclusive lower bound, NULL if there is no lower bound
+	highPtr Pointer to the exclusive upper bound, NULL if there is no upper bound
+	visit(ItemType&) A client defined function that performs an action on an item of the table
+	*/
+	void rangeTraverse(const ItemType* lowPtr, const ItemType* highPtr, void visit(ItemType&)) const;
+
+	/*
+	Same as rangeTraverse, with any callable as in forEach
+	@post visit is executed for every entry in the range, up to the first call returning false
+	@param lowPtr Pointer to the inclusive lower bound, NULL if there is no lower bound
+	highPtr Pointer to the exclusive upper bound, NULL if there is no upper bound
+	visit Callable taking a const ItemType& and returning true to continue, false to stop
+	@return False if visit stopped the traversal, true otherwise
+	*/
+	template <class Visitor>
+	bool forEachInRange(const ItemType* lowPtr, const ItemType* highPtr, Visitor&& visit) const;
+
+	/*
+	Same as in TwoThreeTree. The entries are in table order, so this is always false.
+	*/
+	bool isOrdered() const;
+
+	/*
+	Traverses up to limit entries, skipping the first offset entries of the table. The
+	entries are in table order, so a page is only stable while the table is unchanged.
+	@post Visit is executed for the entries at the positions offset through offset+limit-1
+	@param offset Number of entries to skip
+	limit The maximum number of entries to be visited
+	visit(ItemType&) A client defined function that performs an action on an item of the table
+	*/
+	void pageTraverse(int offset, int limit, void visit(ItemType&)) const;
+
+	/*
+	Same as in TwoThreeTree, by going through the table: select takes the entries in table
+	order, as pageTraverse does, and rank counts the entries smaller than anEntry
+	*/
+	const ItemType* select(int index) const;
+	int rank(const ItemType& anEntry) const;
+
+	/*
+	Adds every item of the array items into the table
+	@post Every item of items is stored in the table
+	@param items The array of items to be added
+	numItems The number of items in the array
+	@return True if addition was successful, false if not
+	*/
+	bool addAll(const ItemType items[], int numItems);
 
 /*
 IGNORE USED FOR DEBUGGING
@@ -145,6 +330,40 @@ IGNORE USED FOR DEBUGGING
 	*/
 	void displayStatistics(std::ostream& os) const;
 
+
+	/*
+	Same as writeToFile and displayStatistics, except the table is split into ranges of addresses
+	which are processed concurrently by the workers of pool. Each range is written to its own buffer,
+	and the buffers are written out in table order. Small tables are processed by this thread.
+	@post Same as writeToFile and displayStatistics, respectively
+	@param outFile Ostream variable storing the file
+	os Ostream variable for the output
+	pool The thread pool processing the ranges
+	*/
+	void writeToFile(std::ostream& outFile, ThreadPool& pool) const;
+	void displayStatistics(std::ostream& os, ThreadPool& pool) const;
+
+
+	/*
+	Replaces the contents of the table with a snapshot of otherTable. The chains can't be shared,
+	so unlike the 2-3 tree, the snapshot is a full copy of the table.
+	@post The table is identical to otherTable
+	@param otherTable The table to be snapshotted
+	*/
+	void takeSnapshot(const HashTable<ItemType>& otherTable);
+
+
+	/*
+	Set operations with otherTable, each done in a single pass over the chains of one of the
+	tables. mergeFrom adds the entries of otherTable that aren't in the table yet, intersectWith
+	keeps only the entries also in otherTable, and difference removes the entries in otherTable,
+	going through the chains of otherTable when it has fewer entries.
+	@post The table holds the union, intersection, or difference of the two tables
+	@param otherTable The other operand, which is unchanged
+	*/
+	void mergeFrom(const HashTable<ItemType>& otherTable);
+	void intersectWith(const HashTable<ItemType>& otherTable);
+	void difference(const HashTable<ItemType>& otherTable);
 };
 
 
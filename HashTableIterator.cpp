@@ -0,0 +1,75 @@
+#ifndef _HASH_TABLE_ITERATOR_CPP
+#define _HASH_TABLE_ITERATOR_CPP
+
+#include "HashTableIterator.h"
+
+template <class ItemType>
+HashTableIterator<ItemType>::HashTableIterator(Node<ItemType>** aTable, int aTableSize, int startIndex)
+{
+	table = aTable;
+	tableSize = aTableSize;
+	tableIndex = startIndex;
+	current = NULL;
+
+	findNextChain();
+}
+
+template <class ItemType>
+void HashTableIterator<ItemType>::findNextChain()
+{
+	while (tableIndex < tableSize && table[tableIndex] == NULL) //Skip the empty addresses
+		tableIndex++;
+
+	if (tableIndex < tableSize)
+		current = table[tableIndex];
+	else //Reached the end of the table
+		current = NULL;
+}
+
+template <class ItemType>
+const ItemType& HashTableIterator<ItemType>::operator*() const
+{
+	return current->item;
+}
+
+template <class ItemType>
+const ItemType* HashTableIterator<ItemType>::operator->() const
+{
+	return &(current->item);
+}
+
+template <class ItemType>
+HashTableIterator<ItemType>& HashTableIterator<ItemType>::operator++()
+{
+	current = current->next;
+	if (current == NULL) //End of the chain, so move on to the next one
+	{
+		tableIndex++;
+		findNextChain();
+	}
+
+	return *this;
+}
+
+template <class ItemType>
+HashTableIterator<ItemType> HashTableIterator<ItemType>::operator++(int)
+{
+	HashTableIterator<ItemType> previous = *this;
+	++(*this);
+
+	return previous;
+}
+
+template <class ItemType>
+bool HashTableIterator<ItemType>::operator==(const HashTableIterator<ItemType>& otherIterator) const
+{
+	return (current == otherIterator.current);
+}
+
+template <class ItemType>
+bool HashTableIterator<ItemType>::operator!=(const HashTableIterator<ItemType>& otherIterator) const
+{
+	return !(*this == otherIterator);
+}
+
+#endif
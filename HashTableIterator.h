@@ -0,0 +1,71 @@
+/*@file HashTableIterator.h*/
+#ifndef _HASH_TABLE_ITERATOR_H
+#define _HASH_TABLE_ITERATOR_H
+
+#include <cstddef>
+#include <iterator>
+
+template <class ItemType> //Chain node, defined in HashTable.h
+struct Node;
+
+/*
+Forward iterator visiting the entries of a hash table in table order, i.e. every
+linked chain from the first address of the table to the last.
+*/
+template <class ItemType>
+class HashTableIterator
+{
+public:
+	typedef std::forward_iterator_tag iterator_category;
+	typedef ItemType value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef const ItemType* pointer;
+	typedef const ItemType& reference;
+
+private:
+	Node<ItemType>** table; //The table being iterated over
+	int tableSize; //Size of the table
+	int tableIndex; //Address of the chain holding the current entry, tableSize at the end
+	Node<ItemType>* current; //Node of the current entry, NULL at the end
+
+	/*
+	Moves the iterator to the head of the first nonempty chain at or after the address
+	tableIndex, or to the end if there is none
+	@post current points to the head of that chain, or is NULL at the end
+	*/
+	void findNextChain();
+
+public:
+	/*
+	Creates an iterator at the first entry of aTable, starting the search at the address
+	startIndex. Passing startIndex = tableSize creates the end iterator.
+	*/
+	HashTableIterator(Node<ItemType>** aTable = NULL, int aTableSize = 0, int startIndex = 0);
+
+	/*
+	Returns the current entry
+	@pre The iterator is not at the end
+	@return A reference to the current entry
+	*/
+	const ItemType& operator*() const;
+	const ItemType* operator->() const;
+
+	/*
+	Moves the iterator to the next entry of the chain, or to the head of the next
+	nonempty chain once the chain ends
+	@pre The iterator is not at the end
+	@return The iterator after (prefix) or before (postfix) the move
+	*/
+	HashTableIterator<ItemType>& operator++();
+	HashTableIterator<ItemType> operator++(int);
+
+	/*
+	Two iterators are equal if they are at the same entry, or both at the end
+	*/
+	bool operator==(const HashTableIterator<ItemType>& otherIterator) const;
+	bool operator!=(const HashTableIterator<ItemType>& otherIterator) const;
+};
+
+#include "HashTableIterator.cpp"
+
+#endif
@@ -0,0 +1,460 @@
+#ifndef _HYBRID_INDEX_CPP
+#define _HYBRID_INDEX_CPP
+
+#include "HybridIndex.h"
+#include "NotFoundException.h"
+
+template <class ItemType>
+ItemHandle<ItemType>::ItemHandle()
+{
+	itemPtr = NULL;
+	keyPrefix = 0;
+}
+
+template <class ItemType>
+ItemHandle<ItemType>::ItemHandle(const ItemType* anItemPtr)
+{
+	itemPtr = const_cast<ItemType*>(anItemPtr); //See the header, the item isn't changed
+	keyPrefix = (anItemPtr != NULL) ? anItemPtr->getKeyPrefix() : 0;
+}
+
+template <class ItemType>
+ItemType* ItemHandle<ItemType>::getItemPtr() const
+{
+	return itemPtr;
+}
+
+template <class ItemType>
+int ItemHandle<ItemType>::length() const
+{
+	return itemPtr->length();
+}
+
+template <class ItemType>
+const char& ItemHandle<ItemType>::operator[](int index) const
+{
+	return (*itemPtr)[index];
+}
+
+template <class ItemType>
+unsigned long long ItemHandle<ItemType>::getKeyPrefix() const
+{
+	return keyPrefix;
+}
+
+template <class ItemType>
+void ItemHandle<ItemType>::writeToFile(std::ostream& outFile) const
+{
+	itemPtr->writeToFile(outFile);
+}
+
+template <class ItemType>
+void ItemHandle<ItemType>::writeToFile(BufferedWriter& writer) const
+{
+	itemPtr->writeToFile(writer);
+}
+
+template <class ItemType>
+bool ItemHandle<ItemType>::operator==(const ItemHandle<ItemType>& otherHandle) const
+{
+	if (keyPrefix != otherHandle.keyPrefix) //Equal items have the same prefix
+		return false;
+	return (*itemPtr == *(otherHandle.itemPtr));
+}
+
+template <class ItemType>
+bool ItemHandle<ItemType>::operator<=(const ItemHandle<ItemType>& otherHandle) const
+{
+	if (keyPrefix != otherHandle.keyPrefix) //Ordered as their prefixes
+		return (keyPrefix < otherHandle.keyPrefix);
+	return (*itemPtr <= *(otherHandle.itemPtr));
+}
+
+template <class ItemType>
+bool ItemHandle<ItemType>::operator>=(const ItemHandle<ItemType>& otherHandle) const
+{
+	if (keyPrefix != otherHandle.keyPrefix) //Ordered as their prefixes
+		return (keyPrefix > otherHandle.keyPrefix);
+	return (*itemPtr >= *(otherHandle.itemPtr));
+}
+
+template <class ItemType>
+bool ItemHandle<ItemType>::operator<(const ItemHandle<ItemType>& otherHandle) const
+{
+	if (keyPrefix != otherHandle.keyPrefix) //Ordered as their prefixes
+		return (keyPrefix < otherHandle.keyPrefix);
+	return (*itemPtr < *(otherHandle.itemPtr));
+}
+
+template <class ItemType>
+bool ItemHandle<ItemType>::operator>(const ItemHandle<ItemType>& otherHandle) const
+{
+	if (keyPrefix != otherHandle.keyPrefix) //Ordered as their prefixes
+		return (keyPrefix > otherHandle.keyPrefix);
+	return (*itemPtr > *(otherHandle.itemPtr));
+}
+
+template <class ItemType>
+bool ItemHandle<ItemType>::operator!=(const ItemHandle<ItemType>& otherHandle) const
+{
+	return !(*this == otherHandle);
+}
+
+template <class ItemType>
+HybridIndex<ItemType>::HybridIndex() //Default state of the index is empty
+{
+}
+
+template <class ItemType>
+HybridIndex<ItemType>::HybridIndex(const HybridIndex<ItemType>& otherIndex)
+{
+	copyIndex(otherIndex);
+}
+
+template <class ItemType>
+HybridIndex<ItemType>::~HybridIndex()
+{
+	eraseIndex();
+}
+
+template <class ItemType>
+void HybridIndex<ItemType>::copyIndex(const HybridIndex<ItemType>& otherIndex)
+{
+	int numItems = otherIndex.getNumberOfItems();
+	const ItemType** itemPtrs = new const ItemType*[numItems > 0 ? numItems : 1];
+	ItemHandle<ItemType>* handles = new ItemHandle<ItemType>[numItems > 0 ? numItems : 1];
+
+	int i = 0;
+	otherIndex.forEach([itemPtrs, &i](const ItemType& item)
+	{
+		itemPtrs[i++] = &item;
+		return true;
+	});
+
+	for (i = 0; i < numItems; i++) //The items of otherIndex are all different, and in order, so
+	{				//the tree is built bottom-up
+		handles[i] = ItemHandle<ItemType>(new ItemType(*itemPtrs[i]));
+		table.add(handles[i]);
+	}
+	tree.addAll(handles, numItems);
+
+	delete [] itemPtrs;
+	delete [] handles;
+}
+
+template <class ItemType>
+void HybridIndex<ItemType>::eraseIndex()
+{
+	tree.forEach([](const ItemHandle<ItemType>& handle)
+	{
+		delete handle.getItemPtr(); //The handles left are only deleted, not compared
+		return true;
+	});
+
+	table.clear();
+	tree.clear();
+}
+
+template <class ItemType>
+bool HybridIndex<ItemType>::isEmpty() const
+{
+	return table.isEmpty();
+}
+
+template <class ItemType>
+int HybridIndex<ItemType>::getNumberOfItems() const
+{
+	return table.getNumberOfItems();
+}
+
+template <class ItemType>
+bool HybridIndex<ItemType>::add(const ItemType& newData)
+{
+	if (contains(newData))
+		return false;
+
+	ItemHandle<ItemType> handle(new ItemType(newData)); //The only copy of the item
+	table.add(handle);
+	tree.add(handle);
+
+	return true;
+}
+
+template <class ItemType>
+bool HybridIndex<ItemType>::remove(const ItemType& anEntry)
+{
+	ItemHandle<ItemType> probe(&anEntry);
+	ItemType* itemPtr; //Deleted once neither data structure has it
+	try
+	{
+		itemPtr = table.getEntry(probe).getItemPtr();
+	}
+	catch (NotFoundException&) //Not in the index
+	{
+		return false;
+	}
+
+	table.remove(probe);
+	tree.remove(probe);
+	delete itemPtr;
+
+	return true;
+}
+
+template <class ItemType>
+void HybridIndex<ItemType>::clear()
+{
+	eraseIndex();
+}
+
+template <class ItemType>
+ItemType HybridIndex<ItemType>::getEntry(const ItemType& anEntry) const
+{
+	return *(table.getEntry(ItemHandle<ItemType>(&anEntry)).getItemPtr());
+}
+
+template <class ItemType>
+bool HybridIndex<ItemType>::findEntry(const ItemType& anEntry, ItemType& foundEntry) const
+{
+	ItemHandle<ItemType> handle;
+	bool isFound = table.findEntry(ItemHandle<ItemType>(&anEntry), handle);
+	if (isFound)
+		foundEntry = *handle.getItemPtr();
+
+	return isFound;
+}
+
+template <class ItemType>
+bool HybridIndex<ItemType>::contains(const ItemType& anEntry) const
+{
+	return table.contains(ItemHandle<ItemType>(&anEntry));
+}
+
+template <class ItemType>
+void HybridIndex<ItemType>::traverse(void visit(ItemType&)) const
+{
+	tree.forEach([visit](const ItemHandle<ItemType>& handle)
+	{
+		visit(*handle.getItemPtr());
+		return true;
+	});
+}
+
+template <class ItemType>
+bool HybridIndex<ItemType>::addAll(const ItemType items[], int numItems)
+{
+	ItemHandle<ItemType>* handles = new ItemHandle<ItemType>[numItems > 0 ? numItems : 1];
+	int numHandles = 0;
+
+	for (int i = 0; i < numItems; i++)
+	{
+		if (!contains(items[i])) //Also skips an item equal to an earlier one of the array
+		{
+			handles[numHandles] = ItemHandle<ItemType>(new ItemType(items[i]));
+			table.add(handles[numHandles]);
+			numHandles++;
+		}
+	}
+
+	tree.addAll(handles, numHandles);
+
+	delete [] handles;
+
+	return true;
+}
+
+template <class ItemType>
+int HybridIndex<ItemType>::containsMany(const ItemType items[], int numItems, bool results[]) const
+{
+	ItemHandle<ItemType>* probes = new ItemHandle<ItemType>[numItems > 0 ? numItems : 1];
+	for (int i = 0; i < numItems; i++)
+		probes[i] = ItemHandle<ItemType>(&items[i]);
+
+	int numFound = table.containsMany(probes, numItems, results);
+
+	delete [] probes;
+
+	return numFound;
+}
+
+template <class ItemType>
+int HybridIndex<ItemType>::addMany(const ItemType items[], int numItems, bool results[])
+{
+	int numAdded = 0;
+	for (int i = 0; i < numItems; i++)
+	{
+		results[i] = add(items[i]);
+		if (results[i])
+			numAdded++;
+	}
+
+	return numAdded;
+}
+
+template <class ItemType>
+int HybridIndex<ItemType>::removeMany(const ItemType items[], int numItems, bool results[])
+{
+	int numRemoved = 0;
+	for (int i = 0; i < numItems; i++)
+	{
+		results[i] = remove(items[i]);
+		if (results[i])
+			numRemoved++;
+	}
+
+	return numRemoved;
+}
+
+template <class ItemType>
+template <class Visitor>
+bool HybridIndex<ItemType>::forEach(Visitor&& visit) const
+{
+	return tree.forEach([&visit](const ItemHandle<ItemType>& handle)
+	{
+		return visit(*handle.getItemPtr());
+	});
+}
+
+template <class ItemType>
+void HybridIndex<ItemType>::rangeTraverse(const ItemType* lowPtr, const ItemType* highPtr,
+						void visit(ItemType&)) const
+{
+	forEachInRange(lowPtr, highPtr, [visit](ItemType& item)
+	{
+		visit(item);
+		return true;
+	});
+}
+
+template <class ItemType>
+void HybridIndex<ItemType>::pageTraverse(int offset, int limit, void visit(ItemType&)) const
+{
+	const ItemHandle<ItemType>* firstPtr = tree.select(offset < 0 ? 0 : offset);
+	if (firstPtr == NULL || limit <= 0)
+		return;
+
+	int numVisited = 0; //The items are all different, so the page starts at the first item >= firstPtr
+	tree.forEachInRange(firstPtr, NULL, [visit, limit, &numVisited](const ItemHandle<ItemType>& handle)
+	{
+		visit(*handle.getItemPtr());
+		return (++numVisited < limit);
+	});
+}
+
+template <class ItemType>
+const ItemType* HybridIndex<ItemType>::select(int index) const
+{
+	const ItemHandle<ItemType>* handlePtr = tree.select(index);
+
+	return (handlePtr != NULL) ? handlePtr->getItemPtr() : NULL;
+}
+
+template <class ItemType>
+int HybridIndex<ItemType>::rank(const ItemType& anEntry) const
+{
+	return tree.rank(ItemHandle<ItemType>(&anEntry));
+}
+
+template <class ItemType>
+template <class Visitor>
+bool HybridIndex<ItemType>::forEachInRange(const ItemType* lowPtr, const ItemType* highPtr,
+						Visitor&& visit) const
+{
+	ItemHandle<ItemType> low(lowPtr);
+	ItemHandle<ItemType> high(highPtr);
+
+	return tree.forEachInRange((lowPtr != NULL) ? &low : NULL, (highPtr != NULL) ? &high : NULL,
+		[&visit](const ItemHandle<ItemType>& handle)
+	{
+		return visit(*handle.getItemPtr());
+	});
+}
+
+template <class ItemType>
+bool HybridIndex<ItemType>::isOrdered() const
+{
+	return true;
+}
+
+template <class ItemType>
+void HybridIndex<ItemType>::writeToFile(std::ostream& outFile) const
+{
+	tree.writeToFile(outFile);
+}
+
+template <class ItemType>
+void HybridIndex<ItemType>::writeToFile(std::ostream& outFile, ThreadPool& pool) const
+{
+	tree.writeToFile(outFile, pool);
+}
+
+template <class ItemType>
+void HybridIndex<ItemType>::displayStatistics(std::ostream& os) const
+{
+	table.displayStatistics(os);
+	tree.displayStatistics(os);
+}
+
+template <class ItemType>
+void HybridIndex<ItemType>::displayStatistics(std::ostream& os, ThreadPool& pool) const
+{
+	table.displayStatistics(os, pool);
+	tree.displayStatistics(os, pool);
+}
+
+template <class ItemType>
+void HybridIndex<ItemType>::takeSnapshot(const HybridIndex<ItemType>& otherIndex)
+{
+	if (this != &otherIndex)
+	{
+		eraseIndex();
+		copyIndex(otherIndex);
+	}
+}
+
+template <class ItemType>
+void HybridIndex<ItemType>::filterIndex(const HybridIndex<ItemType>& otherIndex, bool keepCommon)
+{
+	int numItems = getNumberOfItems();
+	ItemType** removedPtrs = new ItemType*[numItems > 0 ? numItems : 1];
+	int numRemoved = 0;
+
+	tree.forEach([&otherIndex, keepCommon, removedPtrs, &numRemoved](const ItemHandle<ItemType>& handle)
+	{
+		if (otherIndex.contains(*handle.getItemPtr()) != keepCommon) //Removed once the traversal
+			removedPtrs[numRemoved++] = handle.getItemPtr();	    //is done
+		return true;
+	});
+
+	for (int i = 0; i < numRemoved; i++)
+		remove(*removedPtrs[i]);
+
+	delete [] removedPtrs;
+}
+
+template <class ItemType>
+void HybridIndex<ItemType>::mergeFrom(const HybridIndex<ItemType>& otherIndex)
+{
+	if (this == &otherIndex) //Every item is already in the index
+		return;
+
+	otherIndex.forEach([this](const ItemType& item)
+	{
+		add(item); //Skipped if the item is already in the index
+		return true;
+	});
+}
+
+template <class ItemType>
+void HybridIndex<ItemType>::intersectWith(const HybridIndex<ItemType>& otherIndex)
+{
+	filterIndex(otherIndex, true);
+}
+
+template <class ItemType>
+void HybridIndex<ItemType>::difference(const HybridIndex<ItemType>& otherIndex)
+{
+	filterIndex(otherIndex, false);
+}
+
+#endif
@@ -0,0 +1,191 @@
+/*@file HybridIndex.h*/
+#ifndef _HYBRID_INDEX_H
+#define _HYBRID_INDEX_H
+
+#include "HashTable.h"
+#include "TwoThreeTree.h"
+#include "ThreadPool.h"
+#include "BufferedWriter.h"
+#include <iostream>
+
+/*
+Pointer to an item of a HybridIndex, stored by both of its data structures in place of the item.
+A handle hashes, compares and is written out as the item it points to. It also keeps the key
+prefix of the item (see MediaEntry::getKeyPrefix), so handles whose prefixes differ are compared
+without loading their items, e.g. along a chain of the table.
+*/
+template <class ItemType>
+class ItemHandle
+{
+private:
+	ItemType* itemPtr; //The item, NULL for a default handle
+	unsigned long long keyPrefix; //Key prefix of the item, 0 for a default handle
+
+public:
+	ItemHandle();
+
+	/*
+	Creates a handle to an item. A handle to a const item, e.g. to look an item up, is only
+	compared and hashed, so the item is never changed through it.
+	@param anItemPtr Pointer to the item
+	*/
+	ItemHandle(const ItemType* anItemPtr);
+
+	/*
+	Returns the item the handle points to
+	@return Pointer to the item
+	*/
+	ItemType* getItemPtr() const;
+
+	//Same as for the item, as needed by the hash table and the 2-3 tree
+	int length() const;
+	const char& operator[](int index) const;
+	unsigned long long getKeyPrefix() const;
+	void writeToFile(std::ostream& outFile) const;
+	void writeToFile(BufferedWriter& writer) const;
+	bool operator==(const ItemHandle<ItemType>& otherHandle) const;
+	bool operator<=(const ItemHandle<ItemType>& otherHandle) const;
+	bool operator>=(const ItemHandle<ItemType>& otherHandle) const;
+	bool operator<(const ItemHandle<ItemType>& otherHandle) const;
+	bool operator>(const ItemHandle<ItemType>& otherHandle) const;
+	bool operator!=(const ItemHandle<ItemType>& otherHandle) const;
+};
+
+/*
+Index holding a single copy of each item, reachable both from a hash table and from a 2-3 tree
+of handles to it. Lookups, and the checks made by add and remove, go through the table in
+constant expected time. Traversals, ranges, pages and files go through the tree in sorted order.
+That way, neither data structure has to be picked over the other. Every change is made to
+both. Like the radix tree, an item equal to one already in the index isn't added, so each item
+has exactly one handle in each data structure.
+*/
+template <class ItemType>
+class HybridIndex
+{
+private:
+	HashTable<ItemHandle<ItemType> > table; //Handles to the items, for the lookups
+	TwoThreeTree<ItemHandle<ItemType> > tree; //Handles to the items in order, for the traversals
+
+	/*
+	Copies the items of otherIndex, used by the copy constructor and takeSnapshot
+	@pre The index is empty
+	@post The index holds a copy of every item of otherIndex
+	@param otherIndex The index to be copied
+	*/
+	void copyIndex(const HybridIndex<ItemType>& otherIndex);
+
+	/*
+	Deletes every item, and empties both data structures
+	@post The index is empty
+	*/
+	void eraseIndex();
+
+	/*
+	Removes the items that are in otherIndex, or the ones that aren't, used by intersectWith
+	and difference. Each item is looked up in the table of otherIndex.
+	@post Only the items that are in otherIndex, or only those that aren't, are left
+	@param otherIndex The other operand, which is unchanged
+	keepCommon True to keep the items in otherIndex, false to keep the others
+	*/
+	void filterIndex(const HybridIndex<ItemType>& otherIndex, bool keepCommon);
+
+public:
+	HybridIndex();
+	HybridIndex(const HybridIndex<ItemType>& otherIndex);
+	virtual ~HybridIndex();
+
+	/*
+	Same as in the other data structures. contains and getEntry use the table, and add and
+	remove check the table before changing both data structures. getEntry returns the item
+	stored in the index.
+	*/
+	bool isEmpty() const;
+	int getNumberOfItems() const;
+	bool add(const ItemType& newData);
+	bool remove(const ItemType& anEntry);
+	void clear();
+	ItemType getEntry(const ItemType& anEntry) const;
+	bool findEntry(const ItemType& anEntry, ItemType& foundEntry) const;
+	bool contains(const ItemType& anEntry) const;
+	void traverse(void visit(ItemType&)) const;
+
+	/*
+	Adds every item of the array items into the index, skipping the ones already in it. The
+	handles are added to the table one at a time, and given to the tree all at once, so it is
+	built bottom-up if it was empty and the items are in ascending order.
+	@post Every item of items is stored in the index
+	@param items The array of items to be added
+	numItems The number of items in the array
+	@return True if addition was successful, false if not
+	*/
+	bool addAll(const ItemType items[], int numItems);
+
+	/*
+	Same as contains, add and remove for every item of an array. The lookups are done by the
+	table in groups (see HashTable::containsMany). Adding and removing change both data
+	structures one item at a time.
+	@post results[i] is what contains, add or remove returned for items[i]
+	@param items The array of items
+	numItems The number of items in the array
+	results Array of numItems flags receiving the result for each item
+	@return The number of items found, added or removed
+	*/
+	int containsMany(const ItemType items[], int numItems, bool results[]) const;
+	int addMany(const ItemType items[], int numItems, bool results[]);
+	int removeMany(const ItemType items[], int numItems, bool results[]);
+
+	/*
+	Same as in TwoThreeTree, done by the tree. A page is found with select, so only the items
+	of the page are visited.
+	*/
+	template <class Visitor>
+	bool forEach(Visitor&& visit) const;
+	void rangeTraverse(const ItemType* lowPtr, const ItemType* highPtr, void visit(ItemType&)) const;
+	void pageTraverse(int offset, int limit, void visit(ItemType&)) const;
+	template <class Visitor>
+	bool forEachInRange(const ItemType* lowPtr, const ItemType* highPtr, Visitor&& visit) const;
+	bool isOrdered() const;
+	const ItemType* select(int index) const;
+	int rank(const ItemType& anEntry) const;
+
+	/*
+	Writes out the items in sorted order to outFile, using the tree. With a pool, the subtrees
+	are written concurrently as in TwoThreeTree.
+	@post The items are written to outFile
+	@param outFile Ostream variable storing the file
+	pool The thread pool processing the subtrees
+	*/
+	void writeToFile(std::ostream& outFile) const;
+	void writeToFile(std::ostream& outFile, ThreadPool& pool) const;
+
+	/*
+	Writes out the statistics of the table, then those of the tree, to os
+	@post The statistics of both data structures are written to os
+	@param os Ostream variable for the output
+	pool The thread pool gathering the statistics
+	*/
+	void displayStatistics(std::ostream& os) const;
+	void displayStatistics(std::ostream& os, ThreadPool& pool) const;
+
+	/*
+	Replaces the contents of the index with a copy of otherIndex. The handles point to the items
+	of their own index, so the items are copied.
+	@post The index holds the same items as otherIndex
+	@param otherIndex The index to be copied
+	*/
+	void takeSnapshot(const HybridIndex<ItemType>& otherIndex);
+
+	/*
+	Same as in TwoThreeTree. Each item of one index is looked up in the table of the other one,
+	so each operation takes expected linear time, plus the time to change the tree.
+	@post The index holds the union, intersection, or difference of the two indexes
+	@param otherIndex The other operand, which is unchanged
+	*/
+	void mergeFrom(const HybridIndex<ItemType>& otherIndex);
+	void intersectWith(const HybridIndex<ItemType>& otherIndex);
+	void difference(const HybridIndex<ItemType>& otherIndex);
+};
+
+#include "HybridIndex.cpp"
+
+#endif
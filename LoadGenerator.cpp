@@ -0,0 +1,146 @@
+#include "LoadGenerator.h"
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <random>
+#include <thread>
+#include "NotFoundException.h"
+
+struct PendingRequest //Request a client is waiting for
+{
+	std::future<bool> result; //Set unless the request is a getEntry
+	std::future<MediaEntry> entry; //Set if the request is a getEntry
+	std::chrono::steady_clock::time_point submitTime;
+};
+
+LoadGenerator::LoadGenerator(const LoadProfile& aProfile)
+{
+	profile = aProfile;
+	elapsedTime = 0;
+	numFound = 0;
+}
+
+void LoadGenerator::getMedia(int title, MediaEntry& media)
+{
+	char text[16] = "Load ";
+	int length = 5;
+	do //The digits of title in base 26, as letters
+	{
+		text[length++] = 'a' + title % 26;
+		title /= 26;
+	} while (title > 0);
+	text[length] = '\0';
+
+	media.setTitle(text);
+	media.setMediaType('S');
+}
+
+void LoadGenerator::runClient(AsyncLibrary& library, int clientNumber,
+				std::vector<double>& clientLatencies, long& numClientFound) const
+{
+	std::minstd_rand random(clientNumber + 1);
+	std::uniform_int_distribution<int> titles(0, profile.numTitles - 1);
+	std::uniform_real_distribution<double> kinds(0, 1);
+
+	std::deque<PendingRequest> pending;
+	MediaEntry media;
+	numClientFound = 0;
+	for (int i = 0; i < profile.numRequests || !pending.empty(); i++)
+	{
+		if (i < profile.numRequests) //Submits the next request
+		{
+			getMedia(titles(random), media);
+			double kind = kinds(random);
+
+			pending.push_back(PendingRequest());
+			PendingRequest& request = pending.back();
+			request.submitTime = std::chrono::steady_clock::now();
+			if (kind < profile.readShare*0.75)
+				request.result = library.contains(media);
+			else if (kind < profile.readShare)
+				request.entry = library.getEntry(media);
+			else if (kind < (1 + profile.readShare)/2)
+				request.result = library.addEntry(media);
+			else
+				request.result = library.removeEntry(media);
+		}
+
+		if ((int)pending.size() < profile.maxOutstanding && i < profile.numRequests)
+			continue;
+
+		PendingRequest& oldest = pending.front(); //Requests are served in the order they come,
+		if (oldest.result.valid())		  //so the oldest one is done first
+			numClientFound += oldest.result.get();
+		else
+		{
+			try
+			{
+				oldest.entry.get();
+				numClientFound++;
+			}
+			catch (NotFoundException&)
+			{
+			}
+		}
+		clientLatencies.push_back(std::chrono::duration<double, std::micro>(
+			std::chrono::steady_clock::now() - oldest.submitTime).count());
+		pending.pop_front();
+	}
+}
+
+void LoadGenerator::run(AsyncLibrary& library)
+{
+	MediaEntry media; //Half of the lookups and removes find their title
+	for (int title = 0; title < profile.numTitles; title += 2)
+	{
+		getMedia(title, media);
+		library.addEntry(media);
+	}
+	library.wait();
+
+	std::vector<std::vector<double> > clientLatencies(profile.numClients);
+	std::vector<long> numClientFound(profile.numClients);
+	std::vector<std::thread> clients;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int c = 0; c < profile.numClients; c++)
+		clients.push_back(std::thread(&LoadGenerator::runClient, this, std::ref(library), c,
+						std::ref(clientLatencies[c]), std::ref(numClientFound[c])));
+	for (int c = 0; c < profile.numClients; c++)
+		clients[c].join();
+	elapsedTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	latencies.clear();
+	numFound = 0;
+	for (int c = 0; c < profile.numClients; c++)
+	{
+		latencies.insert(latencies.end(), clientLatencies[c].begin(), clientLatencies[c].end());
+		numFound += numClientFound[c];
+	}
+	std::sort(latencies.begin(), latencies.end());
+}
+
+double LoadGenerator::getThroughput() const
+{
+	return (elapsedTime > 0) ? latencies.size()*1000.0/elapsedTime : 0;
+}
+
+double LoadGenerator::getLatency(double percentile) const
+{
+	if (latencies.empty())
+		return 0;
+
+	int position = (int)(percentile/100*latencies.size()); //Nearest rank
+	return latencies[std::min(position, (int)latencies.size() - 1)];
+}
+
+void LoadGenerator::displayResults(std::ostream& os) const
+{
+	os << "Clients: " << profile.numClients << ", " << profile.maxOutstanding
+	   << " requests in flight each" << std::endl;
+	os << "Requests: " << latencies.size() << " in " << elapsedTime << " ms, "
+	   << numFound << " found, added or removed" << std::endl;
+	os << "Throughput: " << getThroughput() << " requests per second" << std::endl;
+	os << "Latency (us): median " << getLatency(50) << ", 99th percentile " << getLatency(99)
+	   << ", 99.9th percentile " << getLatency(99.9) << ", largest " << getLatency(100) << std::endl;
+}
@@ -0,0 +1,88 @@
+/*@file LoadGenerator.h*/
+#ifndef _LOAD_GENERATOR_H
+#define _LOAD_GENERATOR_H
+
+#include <iostream>
+#include <vector>
+#include "AsyncLibrary.h"
+
+struct LoadProfile //Requests a load generator submits
+{
+	int numClients; //Threads submitting requests at once
+	int numRequests; //Requests submitted by each client
+	int maxOutstanding; //Requests a client submits before waiting for the oldest one
+	int numTitles; //Titles the requests are drawn from, half of which are added beforehand
+	double readShare; //Share of lookups among the requests (3 contains for 1 getEntry), the
+};			  //rest being half adds and half removes
+
+/*
+Measures how an asynchronous library holds up under many clients: each client is a thread
+submitting random requests for made-up titles, keeping up to profile.maxOutstanding of them in
+flight. The latency of a request is the time from its submission to its result, and the
+throughput is the number of requests served per second by all the clients together.
+*/
+class LoadGenerator
+{
+private:
+	LoadProfile profile; //Requests submitted by run
+	std::vector<double> latencies; //Latency of every request in microseconds, sorted
+	double elapsedTime; //Time in ms the last run took
+	long numFound; //Lookups, adds and removes of the last run whose result was true
+
+	/*
+	Builds the title of a request, made of letters since titles are compared on their letters
+	@post media holds the title, as a song
+	@param title The number of the title, from 0 to profile.numTitles - 1
+	media The entry receiving it
+	*/
+	static void getMedia(int title, MediaEntry& media);
+
+	/*
+	Loop run by every client
+	@post The latencies of the client's requests are in clientLatencies
+	@param library The library the requests are submitted to
+	clientNumber The number of the client, seeding its requests
+	clientLatencies Vector receiving the latencies
+	numClientFound Receives the number of requests of the client whose result was true
+	*/
+	void runClient(AsyncLibrary& library, int clientNumber, std::vector<double>& clientLatencies,
+			long& numClientFound) const;
+
+public:
+	/*
+	Creates a generator submitting the requests of a profile
+	@param aProfile The profile
+	*/
+	LoadGenerator(const LoadProfile& aProfile);
+
+	/*
+	Adds half of the titles to the library, then has the clients submit their requests and
+	waits for all of them to be served
+	@post The latencies and the elapsed time are those of this run
+	@param library The library, whose entries are changed by the requests
+	*/
+	void run(AsyncLibrary& library);
+
+	/*
+	Returns the throughput of the last run
+	@return The number of requests served per second
+	*/
+	double getThroughput() const;
+
+	/*
+	Returns a percentile of the latencies of the last run, e.g. 99 for the tail latency
+	@param percentile The percentile, from 0 to 100
+	@return The latency in microseconds
+	*/
+	double getLatency(double percentile) const;
+
+	/*
+	Writes out the throughput and the median, 99th, 99.9th percentile and largest latencies of
+	the last run to os
+	@post The results are written to os
+	@param os Ostream variable for the output
+	*/
+	void displayResults(std::ostream& os) const;
+};
+
+#endif
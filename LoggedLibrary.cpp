@@ -0,0 +1,445 @@
+#include "LoggedLibrary.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
+
+LoggedLibrary::LoggedLibrary(MediaLibraryInterface* aLibraryPtr, const char* aFileName)
+	: fileName(aFileName)
+{
+	libraryPtr = aLibraryPtr;
+	policy.commitWindow = DEFAULT_COMMIT_WINDOW;
+	policy.checkpointSize = DEFAULT_CHECKPOINT_SIZE;
+	isCheckpointing = false;
+	hasCheckpointFailed = false;
+	numCheckpoints = 0;
+	checkpointTime = 0;
+
+	long long checkpointGeneration = readCheckpointGeneration(getCheckpointName(aFileName));
+	long long lastGeneration = checkpointGeneration;
+	bool hasLogs = false;
+	numRecovered = 0;
+
+	const std::string logNames[] = {fileName + ".wal.old", fileName + ".wal"}; //Oldest first
+	for (int i = 0; i < 2; i++)
+	{
+		long long logGeneration = WriteAheadLog::readGeneration(logNames[i].c_str());
+		if (logGeneration < 0)
+			continue;
+
+		hasLogs = true;
+		if (logGeneration >= checkpointGeneration) //Otherwise the checkpoint has its changes
+		{
+			numRecovered += WriteAheadLog::replay(logNames[i].c_str(), *libraryPtr);
+			lastGeneration = std::max(lastGeneration, logGeneration);
+		}
+	}
+
+	logPtr = NULL;
+	if (hasLogs && !writeCheckpoint(*libraryPtr, fileName, lastGeneration + 1))
+	{ //Starting a new log would truncate the changes just replayed
+		std::cerr << "The changes recovered from the logs of " << fileName << " could not be written "
+			  << "out. They are kept for the next time, and no change can be made." << std::endl;
+		return;
+	}
+
+	if (hasLogs) //The replayed changes are in the checkpoint
+		std::remove(logNames[0].c_str());
+	logPtr = new WriteAheadLog(logNames[1].c_str(), lastGeneration + 1, policy.commitWindow);
+}
+
+LoggedLibrary::~LoggedLibrary()
+{
+	if (checkpointThread.joinable())
+		checkpointThread.join();
+
+	delete logPtr;
+	delete libraryPtr;
+}
+
+bool LoggedLibrary::canLog() const
+{
+	return (logPtr != NULL && !logPtr->hasFailed());
+}
+
+long LoggedLibrary::logChange(bool isAdded, const MediaEntry& media)
+{
+	return logPtr->append(isAdded, media);
+}
+
+void LoggedLibrary::checkLogSize()
+{
+	if (policy.checkpointSize > 0 && logPtr->getSize() >= policy.checkpointSize)
+		startCheckpoint();
+}
+
+bool LoggedLibrary::startCheckpoint()
+{
+	if (isCheckpointing || hasCheckpointFailed) //The log goes on growing until the checkpoint
+		return false;			    //is written out, or the library is opened again
+	if (checkpointThread.joinable())
+		checkpointThread.join();
+
+	std::string oldLogName = fileName + ".wal.old";
+	MediaLibraryInterface* snapshotPtr = libraryPtr->snapshot(); //In constant time for a tree
+	if (!logPtr->rotate(oldLogName.c_str()))
+	{
+		delete snapshotPtr;
+		return false;
+	}
+	long long generation = logPtr->getGeneration();
+	isCheckpointing = true;
+
+	checkpointThread = std::thread([this, snapshotPtr, oldLogName, generation]()
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		bool isWritten = writeCheckpoint(*snapshotPtr, fileName, generation);
+		if (isWritten) //Only once the checkpoint has its changes
+		{
+			std::remove(oldLogName.c_str());
+			WriteAheadLog::syncDirectory(oldLogName.c_str());
+		}
+		else //Rotating the log again would replace the old log
+		{
+			std::cerr << "The checkpoint of " << fileName << " could not be written out, the log "
+				  << "is kept instead." << std::endl;
+			hasCheckpointFailed = true;
+		}
+		delete snapshotPtr;
+
+		if (isWritten)
+		{
+			std::lock_guard<std::mutex> lock(statisticsMutex);
+			numCheckpoints++;
+			checkpointTime = std::chrono::duration<double, std::milli>(
+				std::chrono::steady_clock::now() - start).count();
+		}
+		isCheckpointing = false;
+	});
+
+	return true;
+}
+
+bool LoggedLibrary::writeCheckpoint(const MediaLibraryInterface& library, const std::string& aFileName,
+					long long generation)
+{
+	std::string checkpointName = getCheckpointName(aFileName.c_str());
+	std::string tempName = checkpointName + ".tmp";
+
+	std::ofstream outFile(tempName.c_str());
+	library.writeToFile(outFile); //Entries, then the empty line ending them, as in a library file
+	outFile << CHECKPOINT_TRAILER << generation << std::endl;
+	bool isWritten = outFile.good();
+	outFile.close();
+
+	if (!isWritten || outFile.fail() || !WriteAheadLog::syncFile(tempName.c_str()) ||
+		std::rename(tempName.c_str(), checkpointName.c_str()) != 0) //The last checkpoint is
+	{									  //replaced at once
+		std::remove(tempName.c_str());
+		return false;
+	}
+	WriteAheadLog::syncDirectory(checkpointName.c_str());
+
+	return true;
+}
+
+long long LoggedLibrary::readCheckpointGeneration(const std::string& checkpointName)
+{
+	std::ifstream inFile(checkpointName.c_str());
+	std::string line;
+	while (std::getline(inFile, line) && !line.empty()) //Skips the entries
+		;
+
+	size_t trailerLength = std::strlen(CHECKPOINT_TRAILER);
+	while (std::getline(inFile, line))
+	{
+		if (line.compare(0, trailerLength, CHECKPOINT_TRAILER) == 0)
+			return std::atoll(line.c_str() + trailerLength);
+	}
+
+	return 0;
+}
+
+bool LoggedLibrary::addEntry(const MediaEntry& newMedia)
+{
+	long recordNumber;
+	{
+		std::lock_guard<std::mutex> lock(libraryMutex);
+		if (!canLog() || !libraryPtr->addEntry(newMedia)) //A change that can't be logged isn't made
+			return false;
+		recordNumber = logChange(true, newMedia);
+		checkLogSize();
+	}
+
+	return logPtr->waitDurable(recordNumber); //Other changes can be made and logged in the meantime
+}
+
+bool LoggedLibrary::addEntries(const MediaEntry newMedia[], int numEntries)
+{
+	long recordNumber = 0;
+	{
+		std::lock_guard<std::mutex> lock(libraryMutex);
+		if (!canLog() || !libraryPtr->addEntries(newMedia, numEntries))
+			return false;
+		for (int i = 0; i < numEntries; i++)
+			recordNumber = logChange(true, newMedia[i]);
+		checkLogSize();
+	}
+
+	return logPtr->waitDurable(recordNumber);
+}
+
+bool LoggedLibrary::removeEntry(const MediaEntry& newMedia)
+{
+	long recordNumber;
+	{
+		std::lock_guard<std::mutex> lock(libraryMutex);
+		if (!canLog() || !libraryPtr->removeEntry(newMedia))
+			return false;
+		recordNumber = logChange(false, newMedia);
+		checkLogSize();
+	}
+
+	return logPtr->waitDurable(recordNumber);
+}
+
+MediaEntry LoggedLibrary::getEntry(const MediaEntry& media) const
+{
+	return libraryPtr->getEntry(media);
+}
+
+bool LoggedLibrary::contains(const MediaEntry& media) const
+{
+	return libraryPtr->contains(media);
+}
+
+int LoggedLibrary::containsMany(const MediaEntry media[], int numEntries, bool results[]) const
+{
+	return libraryPtr->containsMany(media, numEntries, results);
+}
+
+int LoggedLibrary::addMany(const MediaEntry media[], int numEntries, bool results[])
+{
+	int numAdded;
+	long recordNumber = 0;
+	{
+		std::lock_guard<std::mutex> lock(libraryMutex);
+		if (!canLog())
+			return refuseMany(numEntries, results);
+		numAdded = libraryPtr->addMany(media, numEntries, results);
+		for (int i = 0; i < numEntries; i++)
+		{
+			if (results[i])
+				recordNumber = logChange(true, media[i]);
+		}
+		checkLogSize();
+	}
+	if (!logPtr->waitDurable(recordNumber)) //A single wait, so the batch is synced as one group
+		return refuseMany(numEntries, results);
+
+	return numAdded;
+}
+
+int LoggedLibrary::removeMany(const MediaEntry media[], int numEntries, bool results[])
+{
+	int numRemoved;
+	long recordNumber = 0;
+	{
+		std::lock_guard<std::mutex> lock(libraryMutex);
+		if (!canLog())
+			return refuseMany(numEntries, results);
+		numRemoved = libraryPtr->removeMany(media, numEntries, results);
+		for (int i = 0; i < numEntries; i++)
+		{
+			if (results[i])
+				recordNumber = logChange(false, media[i]);
+		}
+		checkLogSize();
+	}
+	if (!logPtr->waitDurable(recordNumber))
+		return refuseMany(numEntries, results);
+
+	return numRemoved;
+}
+
+int LoggedLibrary::refuseMany(int numEntries, bool results[])
+{
+	for (int i = 0; i < numEntries; i++)
+		results[i] = false;
+
+	return 0;
+}
+
+bool LoggedLibrary::hasConcurrentLookups() const
+{
+	return libraryPtr->hasConcurrentLookups();
+}
+
+void LoggedLibrary::displayAllMovies() const
+{
+	libraryPtr->displayAllMovies();
+}
+
+void LoggedLibrary::displayAllMusic() const
+{
+	libraryPtr->displayAllMusic();
+}
+
+void LoggedLibrary::displayAllTv() const
+{
+	libraryPtr->displayAllTv();
+}
+
+void LoggedLibrary::displayAll() const
+{
+	libraryPtr->displayAll();
+}
+
+void LoggedLibrary::display(int offset, int limit) const
+{
+	libraryPtr->display(offset, limit);
+}
+
+void LoggedLibrary::displayRange(const MediaEntry& low, const MediaEntry& high) const
+{
+	libraryPtr->displayRange(low, high);
+}
+
+void LoggedLibrary::displayPrefix(const MediaEntry& prefix) const
+{
+	libraryPtr->displayPrefix(prefix);
+}
+
+int LoggedLibrary::runQuery(const MediaQuery& query, void visit(const MediaEntry&), QueryStatistics& stats) const
+{
+	return libraryPtr->runQuery(query, visit, stats);
+}
+
+void LoggedLibrary::setWordIndex(bool isEnabled)
+{
+	libraryPtr->setWordIndex(isEnabled);
+}
+
+int LoggedLibrary::findWords(const char* text, void visit(const MediaEntry&)) const
+{
+	return libraryPtr->findWords(text, visit);
+}
+
+void LoggedLibrary::setFuzzyIndex(bool isEnabled)
+{
+	libraryPtr->setFuzzyIndex(isEnabled);
+}
+
+void LoggedLibrary::setLookupCache(int maxEntries)
+{
+	libraryPtr->setLookupCache(maxEntries);
+}
+
+int LoggedLibrary::findClosest(const char* title, int maxDistance, int maxResults,
+				void visit(const MediaEntry&, int)) const
+{
+	return libraryPtr->findClosest(title, maxDistance, maxResults, visit);
+}
+
+void LoggedLibrary::writeToFile(std::ostream& outFile) const
+{
+	libraryPtr->writeToFile(outFile);
+}
+
+MediaLibraryInterface* LoggedLibrary::snapshot() const
+{
+	return libraryPtr->snapshot();
+}
+
+MediaLibraryInterface* LoggedLibrary::freeze() const
+{
+	return libraryPtr->freeze();
+}
+
+int LoggedLibrary::getNumberOfItems() const
+{
+	return libraryPtr->getNumberOfItems();
+}
+
+int LoggedLibrary::getNumberOfType(char mediaType) const
+{
+	return libraryPtr->getNumberOfType(mediaType);
+}
+
+void LoggedLibrary::displayStatistics(std::ostream& os) const
+{
+	if (logPtr != NULL)
+		logPtr->displayStatistics(os);
+	else
+		os << "No log: the changes recovered could not be written out." << std::endl;
+	os << "Changes recovered when opened: " << numRecovered << std::endl;
+	{
+		std::lock_guard<std::mutex> lock(statisticsMutex);
+		os << "Checkpoints: " << numCheckpoints;
+		if (numCheckpoints > 0)
+			os << " (the last one took " << checkpointTime << " ms)";
+		if (hasCheckpointFailed)
+			os << ", then one failed";
+		os << std::endl;
+	}
+	os << std::endl << std::endl;
+
+	libraryPtr->displayStatistics(os);
+}
+
+void LoggedLibrary::setDurabilityPolicy(const DurabilityPolicy& newPolicy)
+{
+	std::lock_guard<std::mutex> lock(libraryMutex);
+	policy = newPolicy;
+	if (logPtr != NULL)
+		logPtr->setCommitWindow(policy.commitWindow);
+}
+
+bool LoggedLibrary::checkpoint()
+{
+	std::lock_guard<std::mutex> lock(libraryMutex);
+	if (checkpointThread.joinable()) //The last checkpoint is written out first
+		checkpointThread.join();
+	if (!canLog() || !startCheckpoint())
+		return false;
+	checkpointThread.join();
+
+	return !hasCheckpointFailed;
+}
+
+long LoggedLibrary::getNumberRecovered() const
+{
+	return numRecovered;
+}
+
+std::string LoggedLibrary::getCheckpointName(const char* aFileName)
+{
+	return std::string(aFileName) + ".ckpt";
+}
+
+bool LoggedLibrary::hasFiles(const char* aFileName)
+{
+	std::string name(aFileName);
+	const std::string fileNames[] = {getCheckpointName(aFileName), name + ".wal", name + ".wal.old"};
+	for (int i = 0; i < 3; i++)
+	{
+		std::ifstream inFile(fileNames[i].c_str());
+		if (inFile)
+			return true;
+	}
+
+	return false;
+}
+
+void LoggedLibrary::removeFiles(const char* aFileName)
+{
+	std::string name(aFileName);
+	std::remove(getCheckpointName(aFileName).c_str());
+	std::remove((name + ".wal").c_str());
+	std::remove((name + ".wal.old").c_str());
+	WriteAheadLog::syncDirectory(aFileName);
+}
@@ -0,0 +1,230 @@
+/*@file LoggedLibrary.h*/
+#ifndef _LOGGED_LIBRARY_H
+#define _LOGGED_LIBRARY_H
+
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "MediaLibraryInterface.h"
+#include "WriteAheadLog.h"
+
+const int DEFAULT_COMMIT_WINDOW = 0; //Microseconds the log waits for more changes before a sync
+const long DEFAULT_CHECKPOINT_SIZE = 16 << 20; //Bytes of log after which a checkpoint is taken
+const char CHECKPOINT_TRAILER[] = "Log generation: "; //Line ending a checkpoint, after the entries
+
+struct DurabilityPolicy //How a logged library makes its changes durable
+{
+	int commitWindow; //See WriteAheadLog.h, 0 to sync as soon as a sync is free
+	long checkpointSize; //Size in bytes the log reaches before a checkpoint, 0 for no checkpoints
+};			     //but the ones asked for
+
+/*
+Media library whose entries added or removed are logged (see WriteAheadLog.h), so that they
+survive a crash before the library is written out. The files of a library opened from
+fileName are kept next to it, without changing it:
+- fileName.wal, the log of the changes made since the last checkpoint,
+- fileName.ckpt, the last checkpoint, a library file holding every entry up to it, followed by
+  a line with the generation of the log it goes on with,
+- fileName.wal.old, the log of the changes up to the checkpoint being written out, if any.
+A change is made to the library and then logged, one change after the other, and returns once
+its record is durable; the changes made from several threads at once share syncs. Once the log
+reaches policy.checkpointSize, a snapshot of the library is taken, the log is rotated to
+fileName.wal.old, and a thread writes the snapshot out as the new checkpoint and then removes
+the old log, so the log doesn't grow without end while the changes go on. After a crash, the
+library is opened from the checkpoint instead of fileName, and the logs not in it are replayed
+(see the constructor). Lookups and listings go to the library directly, and can't be made while
+the library changes, as with the library alone.
+A file is only replaced or removed once what replaces it is durable. If the log fails (see
+WriteAheadLog.h), the changes being logged return false, or no results for a batch, even though
+they were made to the library, and the changes after them are refused. If a checkpoint can't be
+written out, the old log is kept and no other checkpoint is taken, so the log grows until the
+library is opened again.
+*/
+class LoggedLibrary : public MediaLibraryInterface
+{
+private:
+	MediaLibraryInterface* libraryPtr; //Library the changes are made to
+	std::string fileName; //File the library was opened from, which the log files are named after
+	DurabilityPolicy policy;
+	WriteAheadLog* logPtr; //Log of the changes since the last checkpoint, NULL if the recovered
+			       //changes couldn't be written out, so the logs are kept
+	long numRecovered; //Changes replayed when the library was opened
+
+	std::mutex libraryMutex; //Orders the changes, and their records in the log
+	std::thread checkpointThread; //Writes out the last checkpoint
+	std::atomic<bool> isCheckpointing; //True from the snapshot until the old log is removed
+	std::atomic<bool> hasCheckpointFailed; //True once a checkpoint couldn't be written out
+
+	mutable std::mutex statisticsMutex; //Guards the statistics of the checkpoints
+	int numCheckpoints; //Checkpoints written out so far
+	double checkpointTime; //Time in ms it took to write out the last checkpoint
+
+	/*
+	Returns whether the changes can be logged, and so be made to the library
+	@return False if the log couldn't be started or failed, true otherwise
+	*/
+	bool canLog() const;
+
+	/*
+	Logs a change made to the library
+	@pre libraryMutex is locked, and the change is made
+	@post The change is in the log, but may not be durable yet
+	@param isAdded True if the entry was added, false if it was removed
+	media The entry
+	@return The number of its record, to wait for with WriteAheadLog::waitDurable
+	*/
+	long logChange(bool isAdded, const MediaEntry& media);
+
+	/*
+	Starts a checkpoint if the log is large enough. Only called once every entry of a change is
+	logged: replaying a record the snapshot already holds would add its entry twice to a tree.
+	@pre libraryMutex is locked
+	*/
+	void checkLogSize();
+
+	/*
+	Reports every change of a batch as not made, when the log can't make it durable
+	@post results holds false for each entry
+	@param numEntries The number of entries of the batch
+	results Array of numEntries flags
+	@return 0, the number of entries added or removed to report
+	*/
+	static int refuseMany(int numEntries, bool results[]);
+
+	/*
+	Takes a snapshot of the library and rotates the log, then starts the thread writing out the
+	checkpoint, unless one is being written out already or one failed
+	@pre libraryMutex is locked
+	@post A checkpoint is being written out
+	@return True if the checkpoint was started, false otherwise
+	*/
+	bool startCheckpoint();
+
+	/*
+	Writes out a checkpoint, replacing the last one only once it is written out and synced
+	@post The checkpoint file holds the entries of library and the generation, or is left as it
+	was if the checkpoint couldn't be written out
+	@param library The library, or a snapshot of it
+	aFileName The file the library was opened from
+	generation The generation of the log going on from the checkpoint
+	@return True if the checkpoint replaced the last one, false otherwise
+	*/
+	static bool writeCheckpoint(const MediaLibraryInterface& library, const std::string& aFileName,
+					long long generation);
+
+	/*
+	Reads the generation of the log going on from a checkpoint
+	@param checkpointName The name of the checkpoint file
+	@return The generation, or 0 if there is no checkpoint
+	*/
+	static long long readCheckpointGeneration(const std::string& checkpointName);
+
+	//A copy would share the library and the log
+	LoggedLibrary(const LoggedLibrary&);
+	LoggedLibrary& operator=(const LoggedLibrary&);
+
+public:
+	/*
+	Starts logging the changes made to a library, with the default policy. The changes left in
+	the logs of a session that wasn't saved are replayed first, and written out as a checkpoint.
+	If the checkpoint can't be written out, the logs are kept for the next time, and every change
+	is refused.
+	@pre The library holds the checkpoint of aFileName if there is one (see getCheckpointName),
+	and the contents of aFileName otherwise
+	@post The library is up to date with the logs, and a new log is started
+	@param aLibraryPtr Pointer to the library, which is deleted with this one
+	aFileName The file the library was opened from, or would be saved to
+	*/
+	LoggedLibrary(MediaLibraryInterface* aLibraryPtr, const char* aFileName);
+
+	/*
+	Waits for the checkpoint being written out, syncs the log, and deletes the library. The log
+	files are kept, see removeFiles.
+	*/
+	~LoggedLibrary();
+
+	//Refer to MediaLibraryInterface.h for details on these functions. The changes return once
+	//they are logged and durable, and fail if the log does; snapshot and freeze return libraries
+	//that aren't logged.
+	bool addEntry(const MediaEntry& newMedia);
+	bool addEntries(const MediaEntry newMedia[], int numEntries);
+	bool removeEntry(const MediaEntry& newMedia);
+	MediaEntry getEntry(const MediaEntry& media) const;
+	bool contains(const MediaEntry& media) const;
+	int containsMany(const MediaEntry media[], int numEntries, bool results[]) const;
+	int addMany(const MediaEntry media[], int numEntries, bool results[]);
+	int removeMany(const MediaEntry media[], int numEntries, bool results[]);
+	bool hasConcurrentLookups() const;
+	void displayAllMovies() const;
+	void displayAllMusic() const;
+	void displayAllTv() const;
+	void displayAll() const;
+	void display(int offset, int limit) const;
+	void displayRange(const MediaEntry& low, const MediaEntry& high) const;
+	void displayPrefix(const MediaEntry& prefix) const;
+	int runQuery(const MediaQuery& query, void visit(const MediaEntry&), QueryStatistics& stats) const;
+	void setWordIndex(bool isEnabled);
+	int findWords(const char* text, void visit(const MediaEntry&)) const;
+	void setFuzzyIndex(bool isEnabled);
+	void setLookupCache(int maxEntries);
+	int findClosest(const char* title, int maxDistance, int maxResults,
+			void visit(const MediaEntry&, int)) const;
+	void writeToFile(std::ostream& outFile) const;
+	MediaLibraryInterface* snapshot() const;
+	MediaLibraryInterface* freeze() const;
+	int getNumberOfItems() const;
+	int getNumberOfType(char mediaType) const;
+
+	/*
+	Writes out the statistics of the log and of the checkpoints, followed by the statistics of
+	the library, to os
+	@post The statistics are written to os
+	@param os Ostream variable for the output
+	*/
+	void displayStatistics(std::ostream& os) const;
+
+	/*
+	Changes how the changes are made durable
+	@post The next syncs and checkpoints follow newPolicy
+	@param newPolicy The new policy
+	*/
+	void setDurabilityPolicy(const DurabilityPolicy& newPolicy);
+
+	/*
+	Writes out a checkpoint of the library as it is, and empties the log
+	@post The checkpoint is written out
+	@return True if it was written out, false if it failed or the log did
+	*/
+	bool checkpoint();
+
+	/*
+	Returns the number of changes replayed from the logs when the library was opened
+	@return The number of changes
+	*/
+	long getNumberRecovered() const;
+
+	/*
+	Returns the name of the checkpoint of a library file, to open the library from after a crash
+	@param aFileName The library file
+	@return The name of its checkpoint file, which may not exist
+	*/
+	static std::string getCheckpointName(const char* aFileName);
+
+	/*
+	Tells if a library file has a checkpoint or logs, left by a session that wasn't saved
+	@param aFileName The library file
+	@return True if any of them exists, false otherwise
+	*/
+	static bool hasFiles(const char* aFileName);
+
+	/*
+	Removes the checkpoint and the logs of a library file, once the library is saved and deleted
+	@post The files are removed
+	@param aFileName The library file
+	*/
+	static void removeFiles(const char* aFileName);
+};
+
+#endif
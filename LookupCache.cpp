@@ -0,0 +1,186 @@
+#include "LookupCache.h"
+
+LookupCache::LookupCache(int maxEntries)
+{
+	capacity = maxEntries;
+	numBuckets = 1;
+	while (numBuckets < capacity) //A power of 2, so the bucket is found with a mask
+		numBuckets *= 2;
+
+	entries = new MediaEntry[capacity];
+	keys = new std::string[capacity];
+	hashes = new unsigned int[capacity];
+	isFound = new bool[capacity];
+	isReferenced = new bool[capacity];
+	nextSlot = new int[capacity];
+	bucketHeads = new int[numBuckets];
+	for (int i = 0; i < numBuckets; i++)
+		bucketHeads[i] = -1;
+
+	numUsed = 0;
+	clockHand = 0;
+	lookupHash = 0;
+
+	numHits = 0;
+	numMisses = 0;
+	numEvictions = 0;
+	numInvalidations = 0;
+}
+
+LookupCache::~LookupCache()
+{
+	delete [] entries;
+	delete [] keys;
+	delete [] hashes;
+	delete [] isFound;
+	delete [] isReferenced;
+	delete [] nextSlot;
+	delete [] bucketHeads;
+}
+
+unsigned int LookupCache::getKey(const MediaEntry& media, std::string& key)
+{
+	key.resize(media.length() + 1);
+	key.resize(media.getSortKey((unsigned char*)&key[0]));
+
+	unsigned int hash = 2166136261u; //FNV-1a
+	for (unsigned int i = 0; i < key.length(); i++)
+	{
+		hash ^= (unsigned char)key[i];
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+int LookupCache::findSlot(const std::string& key, unsigned int hash) const
+{
+	int slot = bucketHeads[hash & (numBuckets - 1)];
+	while (slot >= 0 && (hashes[slot] != hash || keys[slot] != key)) //Different hashes mean
+		slot = nextSlot[slot];					  //different keys
+
+	return slot;
+}
+
+void LookupCache::linkSlot(int slot)
+{
+	int bucket = hashes[slot] & (numBuckets - 1);
+	nextSlot[slot] = bucketHeads[bucket];
+	bucketHeads[bucket] = slot;
+}
+
+void LookupCache::unlinkSlot(int slot)
+{
+	int* linkPtr = &bucketHeads[hashes[slot] & (numBuckets - 1)]; //The link pointing to slot
+	while (*linkPtr != slot)
+		linkPtr = &nextSlot[*linkPtr];
+
+	*linkPtr = nextSlot[slot];
+}
+
+bool LookupCache::find(const MediaEntry& media, const MediaEntry*& foundPtr)
+{
+	lookupHash = getKey(media, lookupKey);
+	int slot = findSlot(lookupKey, lookupHash);
+	if (slot < 0)
+	{
+		numMisses++;
+		return false;
+	}
+
+	numHits++;
+	isReferenced[slot] = true;
+	foundPtr = isFound[slot] ? &entries[slot] : NULL;
+	return true;
+}
+
+void LookupCache::insert(const MediaEntry& media, const MediaEntry* foundPtr)
+{
+	int slot;
+	if (numUsed < capacity)
+		slot = numUsed++;
+	else //Every slot is used, so the hand picks one
+	{
+		while (isReferenced[clockHand]) //Spared once, and reused if not looked up again before
+		{				//the hand comes back
+			isReferenced[clockHand] = false;
+			clockHand = (clockHand + 1) % capacity;
+		}
+
+		slot = clockHand;
+		clockHand = (clockHand + 1) % capacity;
+
+		unlinkSlot(slot);
+		numEvictions++;
+	}
+
+	entries[slot] = (foundPtr != NULL) ? *foundPtr : media;
+	keys[slot].swap(lookupKey); //The key of the entry evicted, if any, is the next one to reuse
+	hashes[slot] = lookupHash;
+	isFound[slot] = (foundPtr != NULL);
+	isReferenced[slot] = false; //Only kept past the hand if it is looked up again
+	linkSlot(slot);
+}
+
+void LookupCache::invalidate(const MediaEntry& media)
+{
+	std::string key;
+	int slot = findSlot(key, getKey(media, key));
+	if (slot < 0)
+		return;
+
+	unlinkSlot(slot);
+	numInvalidations++;
+
+	numUsed--; //The last used slot moves into the freed one, so the used slots stay first
+	if (slot != numUsed)
+	{
+		unlinkSlot(numUsed);
+		entries[slot] = entries[numUsed];
+		keys[slot].swap(keys[numUsed]);
+		hashes[slot] = hashes[numUsed];
+		isFound[slot] = isFound[numUsed];
+		isReferenced[slot] = isReferenced[numUsed];
+		linkSlot(slot);
+	}
+	entries[numUsed] = MediaEntry(); //Frees the title and the key
+	std::string().swap(keys[numUsed]);
+
+	if (clockHand >= numUsed)
+		clockHand = 0;
+}
+
+void LookupCache::clear()
+{
+	for (int i = 0; i < numUsed; i++)
+	{
+		entries[i] = MediaEntry();
+		std::string().swap(keys[i]);
+	}
+	for (int i = 0; i < numBuckets; i++)
+		bucketHeads[i] = -1;
+
+	numInvalidations += numUsed;
+	numUsed = 0;
+	clockHand = 0;
+}
+
+int LookupCache::getCapacity() const
+{
+	return capacity;
+}
+
+void LookupCache::displayStatistics(std::ostream& os) const
+{
+	long numLookups = numHits + numMisses;
+
+	os << "Lookup cache capacity: " << capacity << std::endl;
+	os << "Entries cached: " << numUsed << std::endl;
+	os << "Cache hits: " << numHits << std::endl;
+	os << "Cache misses: " << numMisses << std::endl;
+	if (numLookups > 0)
+		os << "Hit rate: " << (100.0*numHits)/numLookups << "%" << std::endl;
+	os << "Cache evictions: " << numEvictions << std::endl;
+	os << "Cache invalidations: " << numInvalidations << std::endl;
+	os << std::endl << std::endl;
+}
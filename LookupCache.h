@@ -0,0 +1,134 @@
+/*@file LookupCache.h*/
+#ifndef _LOOKUP_CACHE_H
+#define _LOOKUP_CACHE_H
+
+#include <iostream>
+#include <string>
+#include "MediaEntry.h"
+
+/*
+Fixed-size cache of the results of looking entries up in a library, for libraries where a few
+popular titles get most of the lookups. An entry is cached with what the lookup found: an entry
+equal to it, or nothing. Each slot keeps the sort key of its entry (see MediaEntry::getSortKey)
+and its hash, so a lookup goes through the title once and then only compares bytes. Sort keys
+are equal for equal entries, and the entry cached is the one found in the library, so it is
+spelled as stored there whichever spelling was looked up.
+Once every slot is used, the CLOCK policy picks the slot to reuse: a hand goes around the
+slots, sparing (and clearing the mark of) those looked up since it last passed them, so popular
+entries stay cached like with LRU, without having to reorder a list on every hit.
+*/
+class LookupCache
+{
+private:
+	MediaEntry* entries; //The entry cached in each slot
+	std::string* keys; //The sort key of the entry of each slot
+	unsigned int* hashes; //The hash of the sort key of each slot
+	bool* isFound; //Whether the lookup of each slot found the entry
+	bool* isReferenced; //Whether each slot was looked up since the hand last passed it
+	int* nextSlot; //Next slot in the same bucket, -1 at the end of the bucket
+	int* bucketHeads; //First slot of each bucket, -1 if the bucket is empty
+	int capacity; //Number of slots
+	int numBuckets; //Number of buckets, a power of 2 at least as large as capacity
+	int numUsed; //Number of slots used so far, which are the first ones
+	int clockHand; //Next slot the hand looks at
+	std::string lookupKey; //Sort key of the entry last looked up, which insert reuses
+	unsigned int lookupHash; //Hash of lookupKey
+
+	long numHits; //Lookups answered by the cache
+	long numMisses; //Lookups that had to go to the library
+	long numEvictions; //Entries dropped to make room for others
+	long numInvalidations; //Entries dropped because the library changed
+
+	/*
+	Computes the sort key of an entry and its hash
+	@post key holds the sort key of media
+	@param media The entry looked up
+	key Receives the sort key
+	@return The hash of the sort key
+	*/
+	static unsigned int getKey(const MediaEntry& media, std::string& key);
+
+	/*
+	Returns the slot caching an entry
+	@param key The sort key of the entry looked for
+	hash The hash of key
+	@return The slot, -1 if the entry isn't cached
+	*/
+	int findSlot(const std::string& key, unsigned int hash) const;
+
+	/*
+	Adds a slot to the bucket of its hash
+	@post The slot can be found
+	@param slot The slot to be added
+	*/
+	void linkSlot(int slot);
+
+	/*
+	Removes a slot from its bucket
+	@post The slot can no longer be found
+	@param slot The slot to be removed
+	*/
+	void unlinkSlot(int slot);
+
+	//A copy would share the slots
+	LookupCache(const LookupCache&);
+	LookupCache& operator=(const LookupCache&);
+
+public:
+	/*
+	Creates an empty cache
+	@pre maxEntries > 0
+	@param maxEntries The number of entries the cache holds at most
+	*/
+	LookupCache(int maxEntries);
+	~LookupCache();
+
+	/*
+	Looks an entry up in the cache
+	@post The entry is marked as recently used if it is cached, and the hit or miss is counted
+	@param media The entry looked for
+	foundPtr Receives a pointer to the entry found in the library, NULL if the library doesn't
+	have it. The pointer is valid until the cache is next changed.
+	@return True if the cache knows whether the library has media, false otherwise
+	*/
+	bool find(const MediaEntry& media, const MediaEntry*& foundPtr);
+
+	/*
+	Caches the result of looking an entry up in the library, reusing the slot picked by the
+	hand if every slot is used
+	@pre The last call to find was with media, and returned false
+	@post media is cached with foundPtr
+	@param media The entry looked up
+	foundPtr Pointer to the entry found in the library, NULL if the library doesn't have it
+	*/
+	void insert(const MediaEntry& media, const MediaEntry* foundPtr);
+
+	/*
+	Drops an entry from the cache, once it was added to or removed from the library
+	@post media isn't cached
+	@param media The entry added or removed
+	*/
+	void invalidate(const MediaEntry& media);
+
+	/*
+	Drops every entry from the cache, once the library changed as a whole
+	@post The cache is empty. The counters are kept.
+	*/
+	void clear();
+
+	/*
+	Returns the number of entries the cache holds at most
+	@return The capacity of the cache
+	*/
+	int getCapacity() const;
+
+	/*
+	Writes out the capacity of the cache, its number of entries, and the number of hits,
+	misses, evictions and invalidations, to the ostream variable os
+	@post The statistics are written to os
+	@param os Ostream variable for the output
+	*/
+	void displayStatistics(std::ostream& os) const;
+};
+
+#endif
@@ -1,11 +1,14 @@
 #include "MediaEntry.h"
 #include <cstring>
 #include <cassert>
+#include <cctype>
+
+std::atomic<long> MediaEntry::numTitleAllocations(0);
+std::atomic<long> MediaEntry::numTitleBytesCopied(0);
 
 std::ostream& operator<<(std::ostream& os, const MediaEntry& entry)
 {
-	for (int i = 0; i < entry.titleLength; i++) //Output the title of the media entry
-		os << entry.title[i];
+	os.write(entry.title, entry.titleLength); //Output the title of the media entry
 
 	return os;
 }
@@ -15,6 +18,7 @@ MediaEntry::MediaEntry()
 	title = NULL;
 	type = 'S'; //Default type is S (Song)
 	titleLength = 0;
+	keyPrefix = 0;
 }
 
 MediaEntry::MediaEntry(const char* mediaTitle, char mediaType)
@@ -46,11 +50,15 @@ void MediaEntry::copyEntry(const MediaEntry& otherEntry)
 		title = new char[titleLength+1];
 		for (int i = 0; i < titleLength; i++)
 			title[i] = otherEntry.title[i];
+
+		numTitleAllocations++;
+		numTitleBytesCopied += titleLength;
 	}
 	else
 		title = NULL;
 
 	type = otherEntry.type; //Copy its type as well
+	keyPrefix = otherEntry.keyPrefix;
 }
 
 int MediaEntry::length() const
@@ -63,6 +71,63 @@ char MediaEntry::getMediaType() const
 	return type;
 }
 
+unsigned long long MediaEntry::getKeyPrefix() const
+{
+	return keyPrefix;
+}
+
+int MediaEntry::getSortKey(unsigned char key[]) const
+{
+	int keyLength = 0;
+	for (int i = 0; i < titleLength; i++) //Same characters compareTitles goes through, in upper case
+	{
+		char upperChar = toupper(title[i]);
+		key[keyLength] = upperChar; //Overwritten by the next character unless it is a letter,
+		keyLength += (upperChar >= 'A' && upperChar <= 'Z'); //which saves a hard to predict branch
+	}
+
+	key[keyLength++] = 1 + getPrecedence(type); //Less than any letter, so shorter titles come first
+
+	return keyLength;
+}
+
+void MediaEntry::computeKeyPrefix()
+{
+	keyPrefix = 0;
+
+	int index = 0;
+	int alphLength = 0;
+	int numChars = 0;
+	while (numChars < 8 && index < titleLength) //Pack the letters in the order compareTitles
+	{					    //compares them, the first one most significant
+		char nextChar = getNextChar(title, titleLength, index, alphLength);
+		if (nextChar != '\0')
+		{
+			keyPrefix = (keyPrefix << 8) | toupper(nextChar);
+			numChars++;
+		}
+	}
+
+	if (numChars > 0) //Shifting by the full 64 bits is undefined; a title with no letters is 0 already
+		keyPrefix <<= 8*(8 - numChars); //Missing letters are zeros, so shorter titles are less
+}
+
+long MediaEntry::getNumTitleAllocations()
+{
+	return numTitleAllocations;
+}
+
+long MediaEntry::getNumTitleBytesCopied()
+{
+	return numTitleBytesCopied;
+}
+
+void MediaEntry::resetCopyCounters()
+{
+	numTitleAllocations = 0;
+	numTitleBytesCopied = 0;
+}
+
 void MediaEntry::setTitle(const char* mediaTitle)
 {
 	if (title != NULL) //Deallocate and remove the existing title, if any
@@ -76,6 +141,11 @@ void MediaEntry::setTitle(const char* mediaTitle)
 	title = new char[titleLength+1];
 	for (int i = 0; i < titleLength; i++) //Copy the contents of mediaTitle into title
 		title[i] = mediaTitle[i];
+
+	numTitleAllocations++;
+	numTitleBytesCopied += titleLength;
+
+	computeKeyPrefix();
 }
 
 void MediaEntry::setMediaType(char mediaType)
@@ -128,6 +198,11 @@ int MediaEntry::compareTitles(const MediaEntry& otherEntry) const
 		value = -1;			       //in the set
 	else if (title != NULL && otherEntry.title == NULL) //This checks if any of the titles are empty
 		value = 1;				    //Prior to comparison
+	else if (keyPrefix != otherEntry.keyPrefix) //The first letters already differ
+		value = (keyPrefix < otherEntry.keyPrefix) ? -1 : 1;
+	else if (titleLength == otherEntry.titleLength && //Same characters, as when both entries are
+		 memcmp(title, otherEntry.title, titleLength) == 0) //copies of one: equal without a scan
+		value = 0;
 	else //Both titles are nonempty or they are empty.
 	{    //Regardless, function returns correct value for both
 
@@ -173,19 +248,20 @@ int MediaEntry::compareTitles(const MediaEntry& otherEntry) const
 
 char MediaEntry::getNextChar(char* phrase, int phraseLength, int& index, int& alphLength) const
 {
-	char nextChar = phrase[index];
+	char nextChar = '\0'; //Null character is returned if no alphabetical character is left
 
-	//Note the ASCII value of A = 65 and Z = 90
-	for (; (index < phraseLength) && ((toupper(nextChar) < 65) || (toupper(nextChar) > 90)); index++)
+	//Skip the characters that aren't a part of the alphabet. Note the ASCII value of A = 65 and Z = 90
+	while ((index < phraseLength) && ((toupper(phrase[index]) < 65) || (toupper(phrase[index]) > 90)))
+		index++;
+
+	if (index < phraseLength) //Found the next alphabetical character
+	{
 		nextChar = phrase[index];
+		alphLength++;
+	}
 
 	index++; //Increment the index to avoid repeats next time the function is called
 
-	if ((65 <= toupper(nextChar)) && (toupper(nextChar) <= 90)) //Ensure that the character is a part
-		alphLength++;					    //of the alphabet
-	else //No alphabetical character was found, so return the null character
-		nextChar = '\0';
-
 	return nextChar;
 }
 
@@ -194,10 +270,7 @@ bool MediaEntry::operator==(const MediaEntry& otherEntry) const
 	//Two media entries are equal if they have the same type, and if they have
 	//the same title (i.e. name).
 	if (type == otherEntry.type)
-	{
-		if (compareTitles(otherEntry) == 0)
-			return true;
-	}
+		return (compareTitles(otherEntry) == 0);
 	else
 		return false;
 }
@@ -271,6 +344,52 @@ bool MediaEntry::operator!=(const MediaEntry& otherEntry) const
 
 void MediaEntry::writeToFile(std::ostream& outFile) const
 {
-	outFile << (*this) << std::endl; //Write the title and type of the media entry to the file
-	outFile << type << std::endl; //The extra line is to facilitate input for the media library
+	outFile << (*this) << '\n'; //Write the title and type of the media entry to the file
+	outFile << type << '\n'; //The extra line is to facilitate input for the media library
+}
+
+void MediaEntry::writeToFile(BufferedWriter& writer) const
+{
+	writer.write(title, titleLength);
+	writer.put('\n');
+	writer.put(type);
+	writer.put('\n');
+}
+
+void MediaEntry::display(BufferedWriter& writer) const
+{
+	writer.write(title, titleLength);
+	writer.put('\n');
+}
+
+bool MediaEntry::getPrefixBound(MediaEntry& bound) const
+{
+	char* prefix = new char[titleLength+1];
+	int prefixLength = 0;
+	int index = 0;
+	int alphLength = 0;
+
+	while (index < titleLength) //Collect the alphabetical characters of the title in upper case
+	{
+		char nextChar = getNextChar(title, titleLength, index, alphLength);
+		if (nextChar != '\0')
+			prefix[prefixLength++] = toupper(nextChar);
+	}
+
+	while (prefixLength > 0 && prefix[prefixLength-1] == 'Z') //A trailing Z can't be incremented,
+		prefixLength--;					   //so drop it and carry over
+
+	bool hasBound = (prefixLength > 0);
+	if (hasBound) //Incrementing the last letter gives the first title past the prefix
+	{
+		prefix[prefixLength-1]++;
+		prefix[prefixLength] = '\0';
+
+		bound.setTitle(prefix);
+		bound.setMediaType('M'); //Movies have the lowest precedence
+	}
+
+	delete [] prefix;
+
+	return hasBound;
 }
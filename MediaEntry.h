@@ -3,6 +3,8 @@
 #define _MEDIA_ENTRY_H
 
 #include <iostream>
+#include <atomic>
+#include "BufferedWriter.h"
 
 class MediaEntry
 {
@@ -12,6 +14,10 @@ private:
 	char* title; //Name of the media entry
 	char type; //Type of the media entry (either Movie, TV Show, or Music/Song)
 	int titleLength; //Length of the media entry's name
+	unsigned long long keyPrefix; //First letters of the title, see getKeyPrefix
+
+	static std::atomic<long> numTitleAllocations; //Number of titles allocated by all media entries (entries may be copied on several threads)
+	static std::atomic<long> numTitleBytesCopied; //Number of title characters copied by all media entries
 
 
 	void copyEntry(const MediaEntry& otherEntry); //Copies the contents of another media entry
@@ -44,6 +50,12 @@ private:
 	*/
 	int getPrecedence(char type) const;
 
+	/*
+	Computes keyPrefix from the title
+	@post keyPrefix is up to date with the title
+	*/
+	void computeKeyPrefix();
+
 public:
 	MediaEntry();
 	MediaEntry(const char* mediaTitle, char mediaType = 'S');
@@ -62,6 +74,41 @@ public:
 	*/
 	char getMediaType() const;
 
+	/*
+	Returns the first 8 alphabetical characters of the title in upper case, packed big-endian
+	into an integer and padded with zeros. Titles whose prefixes differ compare the same way as
+	their prefixes, so the prefix decides most comparisons without looking at the titles.
+	@return The key prefix of the title, 0 if it has no alphabetical characters
+	*/
+	unsigned long long getKeyPrefix() const;
+
+	/*
+	Computes the sort key of the entry: the alphabetical characters of the title in upper case,
+	followed by a byte from 1 to 3 for the precedence of the type. Comparing two sort keys byte by
+	byte orders them the same way as the comparison operators, and no sort key is the beginning
+	of another one, since the last byte is the only one that isn't a letter.
+	@pre key has room for length()+1 characters
+	@post key holds the sort key, which isn't null-terminated
+	@param key Array receiving the sort key
+	@return The length of the sort key
+	*/
+	int getSortKey(unsigned char key[]) const;
+
+	/*
+	Returns the number of titles allocated, or the number of title characters copied, by
+	every media entry since the program started or since the counters were last reset.
+	Used to measure how often the data structures copy their entries.
+	@return The number of title allocations or title characters copied
+	*/
+	static long getNumTitleAllocations();
+	static long getNumTitleBytesCopied();
+
+	/*
+	Resets the title allocation and title character counters to 0
+	@post Both counters are 0
+	*/
+	static void resetCopyCounters();
+
 	/*
 	Sets the title of the media entry to mediaTitle.
 	@post title has the same phrase as mediaTitle
@@ -77,6 +124,16 @@ public:
 	void setMediaType(char mediaType);
 
 
+	/*
+	Computes the smallest entry that is greater than every entry whose title starts with
+	this entry's title, ignoring case and non-alphabetical characters as compareTitles does.
+	Together with this entry as a movie, it bounds the range of entries having this prefix.
+	@post If it exists, bound holds the computed entry
+	@param bound The entry that receives the bound
+	@return True if the bound exists, false if every title past the prefix has it (e.g. "ZZ")
+	*/
+	bool getPrefixBound(MediaEntry& bound) const;
+
 	/*
 	Writes the contents of the media entry, specifically its title and genre,
 	to the file opened by outFile.
@@ -85,13 +142,23 @@ public:
 	*/
 	void writeToFile(std::ostream& outFile) const;
 
+	/*
+	Same as writeToFile, or writes the title on a line of its own to display the entry,
+	adding them to the block of writer
+	@post The entry is written to writer
+	@param writer The writer collecting the output
+	*/
+	void writeToFile(BufferedWriter& writer) const;
+	void display(BufferedWriter& writer) const;
+
 	/*
 	Override the assignment operator
 	*/
 	const MediaEntry& operator=(const MediaEntry&);
 
 	/*
-	Override the array index operator
+	Override the array index operator. Changing the title through it leaves the key prefix
+	out of date, so use setTitle instead.
 	*/
 	char& operator[](int index);
 	const char& operator[](int index) const;
@@ -3,104 +3,856 @@
 
 #include "MediaLibrary.h"
 #include <iostream>
+#include <cstring>
+#include <algorithm>
+#include <sstream>
+#include <mutex>
+#include "NotFoundException.h"
 
 template <template <class MediaEntry> class DataStructure>
-MediaLibrary<DataStructure>::MediaLibrary()
+MediaLibrary<DataStructure>::MediaLibrary(int aNumThreads)
 {
+	numThreads = aNumThreads;
+	if (numThreads < 1) //As in ThreadPool, which is only started once needed
+		numThreads = std::thread::hardware_concurrency();
+	if (numThreads < 1)
+		numThreads = 1;
+	poolPtr = NULL;
+
+	wordIndexPtr = NULL;
+	fuzzyIndexPtr = NULL;
+	lookupCachePtr = NULL;
+}
+
+template <template <class MediaEntry> class DataStructure>
+MediaLibrary<DataStructure>::~MediaLibrary()
+{
+	delete wordIndexPtr;
+	delete fuzzyIndexPtr;
+	delete lookupCachePtr;
+	delete poolPtr;
+}
+
+template <template <class MediaEntry> class DataStructure>
+ThreadPool& MediaLibrary<DataStructure>::getPool() const
+{
+	std::lock_guard<std::mutex> lock(poolMutex);
+	if (poolPtr == NULL)
+		poolPtr = new ThreadPool(numThreads);
+
+	return *poolPtr;
 }
 
 template <template <class MediaEntry> class DataStructure>
 bool MediaLibrary<DataStructure>::addEntry(const MediaEntry& newMedia)
 {
-	return library.add(newMedia);
+	if (!partitions[getTypeIndex(newMedia.getMediaType())].add(newMedia))
+		return false;
+
+	addToTextIndexes(newMedia);
+	invalidateCached(newMedia); //It may have been cached as missing
+	return true;
+}
+
+template <template <class MediaEntry> class DataStructure>
+bool MediaLibrary<DataStructure>::addEntries(const MediaEntry newMedia[], int numEntries)
+{
+	bool* results = new bool[numEntries > 0 ? numEntries : 1];
+	int numAdded = runOnPartitions(newMedia, numEntries, results, [this](int t,
+					const MediaEntry typeEntries[], int numTypeEntries, bool typeResults[])
+	{
+		bool isAdded = partitions[t].addAll(typeEntries, numTypeEntries); //In the same order, so a
+		for (int j = 0; j < numTypeEntries; j++)			    //sorted array still
+			typeResults[j] = isAdded;				    //builds the trees
+		return isAdded ? numTypeEntries : 0;				    //bottom-up
+	});
+	delete [] results;
+
+	for (int i = 0; i < numEntries; i++)
+		addToTextIndexes(newMedia[i]);
+	clearCached();
+
+	return (numAdded == numEntries);
 }
 
 template <template <class MediaEntry> class DataStructure>
 bool MediaLibrary<DataStructure>::removeEntry(const MediaEntry& newMedia)
 {
-	return library.remove(newMedia);
+	if (!partitions[getTypeIndex(newMedia.getMediaType())].remove(newMedia))
+		return false;
+
+	removeFromTextIndexes(newMedia);
+	invalidateCached(newMedia);
+	return true;
 }
 
 template <template <class MediaEntry> class DataStructure>
 MediaEntry MediaLibrary<DataStructure>::getEntry(const MediaEntry& media) const
 {
-	return library.getEntry(media);
+	if (lookupCachePtr == NULL)
+		return partitions[getTypeIndex(media.getMediaType())].getEntry(media);
+
+	MediaEntry entry;
+	if (!findCached(media, &entry)) //Same as the data structures
+		throw(NotFoundException("getEntry() called with a nonexistant entry"));
+	return entry;
 }
 
 template <template <class MediaEntry> class DataStructure>
 bool MediaLibrary<DataStructure>::contains(const MediaEntry& media) const
 {
-	return library.contains(media);
+	if (lookupCachePtr == NULL)
+		return partitions[getTypeIndex(media.getMediaType())].contains(media);
+
+	return findCached(media, NULL);
+}
+
+template <template <class MediaEntry> class DataStructure>
+bool MediaLibrary<DataStructure>::findCached(const MediaEntry& media, MediaEntry* entryPtr) const
+{
+	std::lock_guard<std::mutex> lock(lookupCacheMutex); //Held until the result is cached, as
+							    //insert goes on from find
+	const MediaEntry* foundPtr;
+	if (lookupCachePtr->find(media, foundPtr))
+	{
+		if (foundPtr != NULL && entryPtr != NULL)
+			*entryPtr = *foundPtr;
+		return (foundPtr != NULL);
+	}
+
+	MediaEntry entry; //The spelling stored, not the one asked for, as a later getEntry returns it
+	bool isFound = partitions[getTypeIndex(media.getMediaType())].findEntry(media, entry);
+	lookupCachePtr->insert(media, isFound ? &entry : NULL); //Missing entries are cached too
+	if (isFound && entryPtr != NULL)
+		*entryPtr = entry;
+	return isFound;
+}
+
+template <template <class MediaEntry> class DataStructure>
+void MediaLibrary<DataStructure>::invalidateCached(const MediaEntry& media)
+{
+	if (lookupCachePtr != NULL)
+	{
+		std::lock_guard<std::mutex> lock(lookupCacheMutex);
+		lookupCachePtr->invalidate(media);
+	}
+}
+
+template <template <class MediaEntry> class DataStructure>
+void MediaLibrary<DataStructure>::clearCached()
+{
+	if (lookupCachePtr != NULL)
+	{
+		std::lock_guard<std::mutex> lock(lookupCacheMutex);
+		lookupCachePtr->clear();
+	}
+}
+
+template <template <class MediaEntry> class DataStructure>
+int MediaLibrary<DataStructure>::containsMany(const MediaEntry media[], int numEntries, bool results[]) const
+{
+	return runOnPartitions(media, numEntries, results, [this](int t,
+				const MediaEntry typeEntries[], int numTypeEntries, bool typeResults[])
+	{
+		return partitions[t].containsMany(typeEntries, numTypeEntries, typeResults);
+	});
+}
+
+template <template <class MediaEntry> class DataStructure>
+int MediaLibrary<DataStructure>::addMany(const MediaEntry media[], int numEntries, bool results[])
+{
+	int numAdded = runOnPartitions(media, numEntries, results, [this](int t,
+				const MediaEntry typeEntries[], int numTypeEntries, bool typeResults[])
+	{
+		return partitions[t].addMany(typeEntries, numTypeEntries, typeResults);
+	});
+	for (int i = 0; i < numEntries; i++)
+	{
+		if (results[i])
+		{
+			addToTextIndexes(media[i]);
+			invalidateCached(media[i]);
+		}
+	}
+
+	return numAdded;
+}
+
+template <template <class MediaEntry> class DataStructure>
+int MediaLibrary<DataStructure>::removeMany(const MediaEntry media[], int numEntries, bool results[])
+{
+	int numRemoved = runOnPartitions(media, numEntries, results, [this](int t,
+				const MediaEntry typeEntries[], int numTypeEntries, bool typeResults[])
+	{
+		return partitions[t].removeMany(typeEntries, numTypeEntries, typeResults);
+	});
+	for (int i = 0; i < numEntries; i++)
+	{
+		if (results[i])
+		{
+			removeFromTextIndexes(media[i]);
+			invalidateCached(media[i]);
+		}
+	}
+
+	return numRemoved;
+}
+
+template <template <class MediaEntry> class DataStructure>
+bool MediaLibrary<DataStructure>::hasConcurrentLookups() const
+{
+	return true; //The batch lookups go to the data structure, and the lookup cache has its own lock
 }
 
 template <template <class MediaEntry> class DataStructure>
 void MediaLibrary<DataStructure>::displayAllMovies() const
 {
-	library.traverse(displayMovie);
+	displayType('M');
 }
 
 template <template <class MediaEntry> class DataStructure>
 void MediaLibrary<DataStructure>::displayAllMusic() const
 {
-	library.traverse(displayMusic);
+	displayType('S');
 }
 
 template <template <class MediaEntry> class DataStructure>
 void MediaLibrary<DataStructure>::displayAllTv() const
 {
-	library.traverse(displayTv);
+	displayType('T');
 }
 
 template <template <class MediaEntry> class DataStructure>
 void MediaLibrary<DataStructure>::displayAll() const
 {
-	library.traverse(displayEntry);
+	BufferedWriter writer(std::cout); //Entries are written out a block at a time
+	forEachInRange(NULL, NULL, [&writer](const MediaEntry& media)
+	{
+		media.display(writer);
+		return true;
+	});
+	writer.flush();
+}
+
+template <template <class MediaEntry> class DataStructure>
+void MediaLibrary<DataStructure>::displayType(char mediaType) const
+{
+	BufferedWriter writer(std::cout);
+	partitions[getTypeIndex(mediaType)].forEach([&writer](const MediaEntry& media)
+	{
+		media.display(writer);
+		return true;
+	});
+	writer.flush();
+}
+
+template <template <class MediaEntry> class DataStructure>
+int MediaLibrary<DataStructure>::getTypeIndex(char mediaType)
+{
+	switch (mediaType)
+	{
+	case 'M':
+		return 0;
+	case 'T':
+		return 1;
+	default: //Anything else is stored as a song
+		return 2;
+	}
+}
+
+template <template <class MediaEntry> class DataStructure>
+void MediaLibrary<DataStructure>::gatherEntries(const MediaEntry* lowPtr, const MediaEntry* highPtr,
+						int maxEntries, std::vector<const MediaEntry*>& entryPtrs) const
+{
+	entryPtrs.clear();
+	if (maxEntries == 0)
+		return;
+
+	forEachInRange(lowPtr, highPtr, [&entryPtrs, maxEntries](const MediaEntry& media)
+	{
+		entryPtrs.push_back(&media);
+		return (maxEntries < 0 || (int)entryPtrs.size() < maxEntries);
+	});
+}
+
+template <template <class MediaEntry> class DataStructure>
+void MediaLibrary<DataStructure>::writeEntries(const std::vector<const MediaEntry*>& entryPtrs,
+						std::ostream& outFile) const
+{
+	int numEntries = entryPtrs.size();
+	if (numThreads == 1 || numEntries < MIN_PARALLEL_ITEMS) //Not worth splitting
+	{
+		BufferedWriter writer(outFile);
+		for (int i = 0; i < numEntries; i++)
+			entryPtrs[i]->writeToFile(writer);
+		return;
+	}
+
+	ThreadPool& pool = getPool();
+	int numParts = 4*numThreads; //As for the subtrees of a tree, so uneven parts even out
+	std::ostringstream* buffers = new std::ostringstream[numParts];
+	for (int i = 0; i < numParts; i++) //Each worker writes its part to its own buffer
+	{
+		int first = (long)numEntries*i/numParts;
+		int last = (long)numEntries*(i+1)/numParts;
+		std::ostringstream* bufferPtr = &buffers[i];
+		pool.submit([&entryPtrs, first, last, bufferPtr]()
+		{
+			BufferedWriter writer(*bufferPtr);
+			for (int j = first; j < last; j++)
+				entryPtrs[j]->writeToFile(writer);
+		});
+	}
+	pool.wait();
+
+	for (int i = 0; i < numParts; i++) //Write the buffers in order
+		outFile << buffers[i].str();
+
+	delete [] buffers;
+}
+
+template <template <class MediaEntry> class DataStructure>
+template <class Operation>
+int MediaLibrary<DataStructure>::runOnPartitions(const MediaEntry media[], int numEntries, bool results[],
+							Operation&& operation)
+{
+	int firstType = (numEntries > 0) ? getTypeIndex(media[0].getMediaType()) : 0;
+	int i = 1;
+	while (i < numEntries && getTypeIndex(media[i].getMediaType()) == firstType)
+		i++;
+
+	if (i >= numEntries) //A single type, e.g. a whole file of songs, isn't copied
+		return operation(firstType, media, numEntries, results);
+
+	MediaEntry* typeEntries = new MediaEntry[numEntries];
+	bool* typeResults = new bool[numEntries];
+	int* positions = new int[numEntries]; //Position in media of each entry of typeEntries
+
+	int totalFound = 0;
+	for (int t = 0; t < NUM_MEDIA_TYPES; t++) //The entries keep their order within each type
+	{
+		int numTypeEntries = 0;
+		for (i = 0; i < numEntries; i++)
+		{
+			if (getTypeIndex(media[i].getMediaType()) == t)
+			{
+				positions[numTypeEntries] = i;
+				typeEntries[numTypeEntries++] = media[i];
+			}
+		}
+
+		if (numTypeEntries == 0)
+			continue;
+
+		totalFound += operation(t, typeEntries, numTypeEntries, typeResults);
+		for (i = 0; i < numTypeEntries; i++)
+			results[positions[i]] = typeResults[i];
+	}
+
+	delete [] typeEntries;
+	delete [] typeResults;
+	delete [] positions;
+
+	return totalFound;
+}
+
+template <template <class MediaEntry> class DataStructure>
+void MediaLibrary<DataStructure>::display(int offset, int limit) const
+{
+	if (offset < 0)
+		offset = 0;
+
+	if (!isOrdered()) //Pages of a table go type after type, so whole partitions are skipped
+	{
+		for (int t = 0; t < NUM_MEDIA_TYPES && limit > 0; t++)
+		{
+			int numTypeEntries = partitions[t].getNumberOfItems();
+			if (offset < numTypeEntries)
+			{
+				int numShown = std::min(limit, numTypeEntries - offset);
+				partitions[t].pageTraverse(offset, numShown, displayEntry);
+				limit -= numShown;
+			}
+			offset = std::max(offset - numTypeEntries, 0);
+		}
+		std::cout.flush();
+		return;
+	}
+
+	const MediaEntry* firstPtr = select(offset);
+	if (firstPtr == NULL || limit <= 0)
+		return;
+
+	int numSkipped = offset - rank(*firstPtr); //Entries equal to the first one but before the page
+	int numDisplayed = 0;
+	forEachInRange(firstPtr, NULL, [&numSkipped, limit, &numDisplayed](const MediaEntry& media)
+	{
+		if (numSkipped > 0)
+		{
+			numSkipped--;
+			return true;
+		}
+
+		std::cout << media << '\n';
+		return (++numDisplayed < limit);
+	});
+	std::cout.flush();
+}
+
+template <template <class MediaEntry> class DataStructure>
+void MediaLibrary<DataStructure>::displayRange(const MediaEntry& low, const MediaEntry& high) const
+{
+	forEachInRange(&low, &high, [](const MediaEntry& media)
+	{
+		std::cout << media << '\n'; //Flushed once the range is done
+		return true;
+	});
+	std::cout.flush();
+}
+
+template <template <class MediaEntry> class DataStructure>
+void MediaLibrary<DataStructure>::displayPrefix(const MediaEntry& prefix) const
+{
+	MediaEntry low(prefix); //Movies come first among equal titles, so the prefix as a
+	low.setMediaType('M');	//movie is the smallest entry having it
+
+	MediaEntry high; //Without a bound, every title past low has the prefix
+	bool hasBound = prefix.getPrefixBound(high);
+	forEachInRange(&low, hasBound ? &high : NULL, [](const MediaEntry& media)
+	{
+		std::cout << media << '\n';
+		return true;
+	});
+	std::cout.flush();
+}
+
+template <template <class MediaEntry> class DataStructure>
+int MediaLibrary<DataStructure>::planQuery(const MediaQuery& query) const
+{
+	if (query.isEmpty())
+		return QUERY_NO_ENTRIES;
+
+	bool isBounded = (query.getLowPtr() != NULL || query.getHighPtr() != NULL);
+	if (isBounded && isOrdered()) //A range of several types is kept in sorted order
+		return (query.getNumTypes() == 1) ? QUERY_TYPE_RANGE : QUERY_RANGE;
+	else if (query.getNumTypes() < NUM_MEDIA_TYPES)
+		return QUERY_TYPE_SCAN;
+	else
+		return QUERY_FULL_SCAN;
+}
+
+template <template <class MediaEntry> class DataStructure>
+int MediaLibrary<DataStructure>::runQuery(const MediaQuery& query, void visit(const MediaEntry&),
+						QueryStatistics& stats) const
+{
+	stats.accessPath = planQuery(query);
+	stats.numExamined = 0;
+	stats.numMatched = 0;
+	stats.numReturned = 0;
+
+	int numSkipped = 0;
+	auto visitEntry = [&query, visit, &stats, &numSkipped](const MediaEntry& media)
+	{
+		stats.numExamined++; //The access path narrows the entries, query.matches does the rest
+		if (!query.matches(media))
+			return true;
+
+		stats.numMatched++;
+		if (numSkipped < query.getOffset())
+		{
+			numSkipped++;
+			return true;
+		}
+
+		visit(media);
+		stats.numReturned++;
+		return (query.getLimit() < 0 || stats.numReturned < query.getLimit());
+	};
+
+	const char mediaTypes[] = "MTS"; //In the order of partitions
+	switch (stats.accessPath)
+	{
+	case QUERY_RANGE:
+		forEachInRange(query.getLowPtr(), query.getHighPtr(), visitEntry);
+		break;
+	case QUERY_TYPE_RANGE:
+	case QUERY_TYPE_SCAN:
+		for (int t = 0; t < NUM_MEDIA_TYPES; t++) //Types come one after the other
+		{
+			if (!query.hasType(mediaTypes[t]))
+				continue;
+
+			bool isDone = (stats.accessPath == QUERY_TYPE_RANGE) ?
+				!partitions[t].forEachInRange(query.getLowPtr(), query.getHighPtr(), visitEntry) :
+				!partitions[t].forEach(visitEntry);
+			if (isDone) //The limit was reached
+				break;
+		}
+		break;
+	case QUERY_FULL_SCAN:
+		forEachInRange(NULL, NULL, visitEntry);
+		break;
+	}
+
+	return stats.numReturned;
+}
+
+template <template <class MediaEntry> class DataStructure>
+void MediaLibrary<DataStructure>::setWordIndex(bool isEnabled)
+{
+	if (isEnabled && wordIndexPtr == NULL)
+	{
+		WordIndex* indexPtr = new WordIndex;
+		for (int t = 0; t < NUM_MEDIA_TYPES; t++)
+		{
+			partitions[t].forEach([indexPtr](const MediaEntry& media)
+			{
+				indexPtr->add(media);
+				return true;
+			});
+		}
+		wordIndexPtr = indexPtr;
+	}
+	else if (!isEnabled && wordIndexPtr != NULL)
+	{
+		delete wordIndexPtr;
+		wordIndexPtr = NULL;
+	}
 }
 
 template <template <class MediaEntry> class DataStructure>
-void MediaLibrary<DataStructure>::displayMovie(MediaEntry& media)
+void MediaLibrary<DataStructure>::setFuzzyIndex(bool isEnabled)
 {
-	if (media.getMediaType() == 'M')
-		std::cout << media << std::endl;
+	if (isEnabled && fuzzyIndexPtr == NULL)
+	{
+		FuzzyIndex* indexPtr = new FuzzyIndex;
+		for (int t = 0; t < NUM_MEDIA_TYPES; t++)
+		{
+			partitions[t].forEach([indexPtr](const MediaEntry& media)
+			{
+				indexPtr->add(media);
+				return true;
+			});
+		}
+		fuzzyIndexPtr = indexPtr;
+	}
+	else if (!isEnabled && fuzzyIndexPtr != NULL)
+	{
+		delete fuzzyIndexPtr;
+		fuzzyIndexPtr = NULL;
+	}
 }
 
 template <template <class MediaEntry> class DataStructure>
-void MediaLibrary<DataStructure>::displayMusic(MediaEntry& media)
+void MediaLibrary<DataStructure>::setLookupCache(int maxEntries)
 {
-	if (media.getMediaType() == 'S')
-		std::cout << media << std::endl;
+	delete lookupCachePtr;
+	lookupCachePtr = (maxEntries > 0) ? new LookupCache(maxEntries) : NULL;
 }
 
 template <template <class MediaEntry> class DataStructure>
-void MediaLibrary<DataStructure>::displayTv(MediaEntry& media)
+void MediaLibrary<DataStructure>::addToTextIndexes(const MediaEntry& newMedia)
 {
-	if (media.getMediaType() == 'T')
-		std::cout << media << std::endl;
+	if (wordIndexPtr != NULL)
+		wordIndexPtr->add(newMedia);
+	if (fuzzyIndexPtr != NULL)
+		fuzzyIndexPtr->add(newMedia);
+}
+
+template <template <class MediaEntry> class DataStructure>
+void MediaLibrary<DataStructure>::removeFromTextIndexes(const MediaEntry& media)
+{
+	if (wordIndexPtr != NULL)
+		wordIndexPtr->remove(media);
+	if (fuzzyIndexPtr != NULL)
+		fuzzyIndexPtr->remove(media);
+}
+
+template <template <class MediaEntry> class DataStructure>
+void MediaLibrary<DataStructure>::rebuildTextIndexes()
+{
+	bool hasWordIndex = (wordIndexPtr != NULL);
+	bool hasFuzzyIndex = (fuzzyIndexPtr != NULL);
+
+	setWordIndex(false); //Turning them back on builds them from the library
+	setFuzzyIndex(false);
+	setWordIndex(hasWordIndex);
+	setFuzzyIndex(hasFuzzyIndex);
+}
+
+template <template <class MediaEntry> class DataStructure>
+int MediaLibrary<DataStructure>::findWords(const char* text, void visit(const MediaEntry&)) const
+{
+	if (wordIndexPtr != NULL)
+		return wordIndexPtr->find(text, visit);
+
+	std::vector<std::string> words;
+	WordIndex::getWords(text, std::strlen(text), words);
+	if (words.empty())
+		return 0;
+
+	int numFound = 0; //Without the index, every title is split into its words
+	forEachInRange(NULL, NULL, [&words, visit, &numFound](const MediaEntry& media)
+	{
+		if (WordIndex::hasWords(media, words))
+		{
+			visit(media);
+			numFound++;
+		}
+		return true;
+	});
+
+	return numFound;
+}
+
+template <template <class MediaEntry> class DataStructure>
+int MediaLibrary<DataStructure>::findClosest(const char* title, int maxDistance, int maxResults,
+						void visit(const MediaEntry&, int)) const
+{
+	int numCandidates;
+	if (fuzzyIndexPtr != NULL)
+		return fuzzyIndexPtr->find(title, maxDistance, maxResults, visit, numCandidates);
+
+	std::string key;
+	FuzzyIndex::getKey(title, key);
+	if (key.empty() || maxResults <= 0)
+		return 0;
+
+	std::vector<std::pair<int, MediaEntry> > found; //Without the index, the distance of every
+	auto visitEntry = [&key, maxDistance, &found](const MediaEntry& media) //title is computed
+	{
+		std::string mediaKey;
+		FuzzyIndex::getKey(media, mediaKey);
+		int distance = FuzzyIndex::getEditDistance(key, mediaKey, maxDistance);
+		if (distance <= maxDistance)
+			found.push_back(std::make_pair(distance, media));
+		return true;
+	};
+	for (int t = 0; t < NUM_MEDIA_TYPES; t++) //The results are sorted below
+		partitions[t].forEach(visitEntry);
+
+	int numFound = std::min((int)found.size(), maxResults);
+	std::partial_sort(found.begin(), found.begin() + numFound, found.end()); //Closest first, then
+	for (int i = 0; i < numFound; i++)					 //in sorted order
+		visit(found[i].second, found[i].first);
+
+	return numFound;
 }
 
 template <template <class MediaEntry> class DataStructure>
 void MediaLibrary<DataStructure>::displayEntry(MediaEntry& media)
 {
-	std::cout << media << std::endl;
+	std::cout << media << '\n'; //Flushed once the traversal is done
 }
 
 template <template <class MediaEntry> class DataStructure>
 void MediaLibrary<DataStructure>::writeToFile(std::ostream& outFile) const
 {
-	library.writeToFile(outFile);
-	outFile << std::endl << std::endl;
+	if (isOrdered()) //Sorted order for a tree, so the file can be reloaded with a bottom-up build
+	{
+		std::vector<const MediaEntry*> entryPtrs;
+		gatherEntries(NULL, NULL, -1, entryPtrs);
+		writeEntries(entryPtrs, outFile);
+	}
+	else //Type after type, each one written by the workers
+	{
+		for (int t = 0; t < NUM_MEDIA_TYPES; t++)
+		{
+			if (numThreads > 1)
+				partitions[t].writeToFile(outFile, getPool());
+			else
+				partitions[t].writeToFile(outFile);
+		}
+	}
+	outFile << "\n\n" << std::flush;
+}
+
+template <template <class MediaEntry> class DataStructure>
+MediaLibraryInterface* MediaLibrary<DataStructure>::snapshot() const
+{
+	MediaLibrary<DataStructure>* snapshotPtr = new MediaLibrary<DataStructure>(numThreads);
+	for (int t = 0; t < NUM_MEDIA_TYPES; t++)
+		snapshotPtr->partitions[t].takeSnapshot(partitions[t]);
+	if (wordIndexPtr != NULL) //Unlike a tree, the indexes of the titles are copied
+		snapshotPtr->wordIndexPtr = new WordIndex(*wordIndexPtr);
+	if (fuzzyIndexPtr != NULL)
+		snapshotPtr->fuzzyIndexPtr = new FuzzyIndex(*fuzzyIndexPtr);
+	if (lookupCachePtr != NULL) //The cache starts out empty
+		snapshotPtr->setLookupCache(lookupCachePtr->getCapacity());
+
+	return snapshotPtr;
+}
+
+template <template <class MediaEntry> class DataStructure>
+MediaLibraryInterface* MediaLibrary<DataStructure>::freeze() const
+{
+	return convert<FrozenIndex>();
+}
+
+template <template <class MediaEntry> class DataStructure>
+template <template <class MediaEntry> class OtherStructure>
+MediaLibrary<OtherStructure>* MediaLibrary<DataStructure>::convert() const
+{
+	std::vector<const MediaEntry*> entryPtrs;
+	gatherEntries(NULL, NULL, -1, entryPtrs);
+	int numEntries = entryPtrs.size();
+	MediaEntry* entries = new MediaEntry[numEntries > 0 ? numEntries : 1];
+
+	if (!isOrdered()) //Sorted either way, so a tree is built bottom-up, and a frozen index
+	{		  //doesn't have to sort them. Only the pointers are moved.
+		std::sort(entryPtrs.begin(), entryPtrs.end(), [](const MediaEntry* onePtr, const MediaEntry* otherPtr)
+		{
+			return (*onePtr < *otherPtr);
+		});
+	}
+
+	for (int i = 0; i < numEntries; i++)
+		entries[i] = *entryPtrs[i];
+
+	MediaLibrary<OtherStructure>* otherPtr = new MediaLibrary<OtherStructure>(numThreads);
+	otherPtr->addEntries(entries, numEntries);
+	otherPtr->setWordIndex(wordIndexPtr != NULL);
+	otherPtr->setFuzzyIndex(fuzzyIndexPtr != NULL);
+	otherPtr->setLookupCache((lookupCachePtr != NULL) ? lookupCachePtr->getCapacity() : 0);
+
+	delete [] entries;
+
+	return otherPtr;
+}
+
+template <template <class MediaEntry> class DataStructure>
+template <class Visitor>
+bool MediaLibrary<DataStructure>::forEachInRange(const MediaEntry* lowPtr, const MediaEntry* highPtr,
+							Visitor&& visit) const
+{
+	if (!isOrdered()) //Nothing to merge, so the partitions are visited directly
+	{
+		for (int t = 0; t < NUM_MEDIA_TYPES; t++)
+		{
+			if (!partitions[t].forEachInRange(lowPtr, highPtr, visit))
+				return false;
+		}
+		return true;
+	}
+
+	return RangeCursor<MediaEntry>::merge(NUM_MEDIA_TYPES, lowPtr, [this, highPtr](int t,
+					const MediaEntry* chunkLowPtr, RangeCursor<MediaEntry>& cursor)
+	{
+		return partitions[t].forEachInRange(chunkLowPtr, highPtr, [&cursor](const MediaEntry& media)
+		{
+			return cursor.take(media);
+		});
+	}, visit);
+}
+
+template <template <class MediaEntry> class DataStructure>
+template <class Visitor>
+bool MediaLibrary<DataStructure>::forEachOfTypeInRange(char mediaType, const MediaEntry* lowPtr,
+							const MediaEntry* highPtr, Visitor&& visit) const
+{
+	return partitions[getTypeIndex(mediaType)].forEachInRange(lowPtr, highPtr, visit);
+}
+
+template <template <class MediaEntry> class DataStructure>
+bool MediaLibrary<DataStructure>::isOrdered() const
+{
+	return partitions[0].isOrdered(); //The same for every partition
+}
+
+template <template <class MediaEntry> class DataStructure>
+const MediaEntry* MediaLibrary<DataStructure>::select(int index) const
+{
+	if (index < 0 || index >= getNumberOfItems())
+		return NULL;
+
+	if (!isOrdered())
+	{
+		int t = 0;
+		while (index >= partitions[t].getNumberOfItems())
+			index -= partitions[t++].getNumberOfItems();
+
+		return partitions[t].select(index);
+	}
+
+	return RangeCursor<MediaEntry>::selectMerged(NUM_MEDIA_TYPES, index, [this](int t, int i)
+	{
+		return partitions[t].select(i);
+	}, [this](int t, const MediaEntry& media)
+	{
+		return partitions[t].rank(media);
+	});
+}
+
+template <template <class MediaEntry> class DataStructure>
+int MediaLibrary<DataStructure>::rank(const MediaEntry& media) const
+{
+	int numSmaller = 0;
+	for (int t = 0; t < NUM_MEDIA_TYPES; t++)
+		numSmaller += partitions[t].rank(media);
+
+	return numSmaller;
 }
 
 template <template <class MediaEntry> class DataStructure>
 int MediaLibrary<DataStructure>::getNumberOfItems() const
 {
-	return library.getNumberOfItems();
+	int numItems = 0;
+	for (int t = 0; t < NUM_MEDIA_TYPES; t++)
+		numItems += partitions[t].getNumberOfItems();
+
+	return numItems;
+}
+
+template <template <class MediaEntry> class DataStructure>
+int MediaLibrary<DataStructure>::getNumberOfType(char mediaType) const
+{
+	return partitions[getTypeIndex(mediaType)].getNumberOfItems();
 }
 
 template <template <class MediaEntry> class DataStructure>
 void MediaLibrary<DataStructure>::displayStatistics(std::ostream& os) const
 {
-	library.displayStatistics(os);
+	const char* typeNames[NUM_MEDIA_TYPES] = {"Movies", "TV shows", "Songs"}; //In the order of
+	for (int t = 0; t < NUM_MEDIA_TYPES; t++)				      //partitions
+	{
+		os << typeNames[t] << ":" << std::endl;
+		if (numThreads > 1)
+			partitions[t].displayStatistics(os, getPool());
+		else
+			partitions[t].displayStatistics(os);
+	}
+	if (lookupCachePtr != NULL)
+	{
+		std::lock_guard<std::mutex> lock(lookupCacheMutex);
+		lookupCachePtr->displayStatistics(os);
+	}
+}
+
+template <template <class MediaEntry> class DataStructure>
+void MediaLibrary<DataStructure>::mergeFrom(const MediaLibrary<DataStructure>& otherLibrary)
+{
+	for (int t = 0; t < NUM_MEDIA_TYPES; t++) //Entries of different types never match
+		partitions[t].mergeFrom(otherLibrary.partitions[t]);
+	rebuildTextIndexes();
+	clearCached();
+}
+
+template <template <class MediaEntry> class DataStructure>
+void MediaLibrary<DataStructure>::intersectWith(const MediaLibrary<DataStructure>& otherLibrary)
+{
+	for (int t = 0; t < NUM_MEDIA_TYPES; t++) //Entries of different types never match
+		partitions[t].intersectWith(otherLibrary.partitions[t]);
+	rebuildTextIndexes();
+	clearCached();
+}
+
+template <template <class MediaEntry> class DataStructure>
+void MediaLibrary<DataStructure>::difference(const MediaLibrary<DataStructure>& otherLibrary)
+{
+	for (int t = 0; t < NUM_MEDIA_TYPES; t++) //Entries of different types never match
+		partitions[t].difference(otherLibrary.partitions[t]);
+	rebuildTextIndexes();
+	clearCached();
 }
 
 #endif
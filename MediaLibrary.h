@@ -3,39 +3,248 @@
 #define _MEDIA_LIBRARY_H
 
 #include "MediaLibraryInterface.h"
+#include "FrozenIndex.h"
+#include "ThreadPool.h"
+#include "WordIndex.h"
+#include "FuzzyIndex.h"
+#include "LookupCache.h"
+#include "RangeCursor.h"
+#include <vector>
+#include <mutex>
 
+const int NUM_MEDIA_TYPES = 3; //Movies, TV shows and songs
 
 template <template <class MediaEntry> class DataStructure>
 class MediaLibrary : public MediaLibraryInterface
 {
 private:
-	DataStructure<MediaEntry> library;
+	DataStructure<MediaEntry> partitions[NUM_MEDIA_TYPES]; //The entries of each type, which together
+							       //are the library, so listing one type
+							       //doesn't go through the others
+	int numThreads; //Number of workers of the thread pool
+	mutable ThreadPool* poolPtr; //Workers for the full scans of the library (export and statistics),
+				     //NULL until a scan needs them, so a library that is never exported,
+				     //e.g. a snapshot, a shard or a converted copy, starts no threads
+	mutable std::mutex poolMutex; //Held while the pool is started
+	WordIndex* wordIndexPtr; //Index of the words of the titles, NULL if it is off
+	FuzzyIndex* fuzzyIndexPtr; //Trigram index of the titles, NULL if it is off
+	LookupCache* lookupCachePtr; //Results of contains and getEntry, NULL if there is no cache
+	mutable std::mutex lookupCacheMutex; //Held while the cache is used, as lookups change it too
 
 	/*
-	Displays the media entry if it is a movie, music/song, or TV Show for the first three functions,
-	or the entry itself for the last one.
-	@post All entries satisfying the criteria in the function title are displayed
+	Returns the thread pool, starting its workers the first time
+	@pre numThreads > 1
+	@return The pool
+	*/
+	ThreadPool& getPool() const;
+
+	/*
+	Looks an entry up through the lookup cache. On a miss, the partition is searched once, and
+	what it found is cached.
+	@pre lookupCachePtr != NULL
+	@post If the entry is found and entryPtr isn't NULL, *entryPtr is the entry stored
+	@param media The entry looked up
+	entryPtr Pointer to the entry receiving the one found, NULL if it isn't needed
+	@return True if the library has media, false otherwise
+	*/
+	bool findCached(const MediaEntry& media, MediaEntry* entryPtr) const;
+
+	/*
+	Drops an entry, or every entry, from the lookup cache if there is one, after a change to
+	the library
+	@post The entry, or every entry, isn't cached
+	@param media The entry added or removed
+	*/
+	void invalidateCached(const MediaEntry& media);
+	void clearCached();
+
+	/*
+	Adds an entry to, or removes it from, the indexes of the titles that are on
+	@post The word and trigram indexes that are on have the entry, or no longer have it
+	@param newMedia The entry added to the library
+	media The entry removed from the library
+	*/
+	void addToTextIndexes(const MediaEntry& newMedia);
+	void removeFromTextIndexes(const MediaEntry& media);
+
+	/*
+	Builds the indexes of the titles that are on again from the entries of the library,
+	after changes made to the library as a whole
+	@post The indexes that are on hold every entry of the library
+	*/
+	void rebuildTextIndexes();
+
+	/*
+	Returns the position of the partition of a media type in partitions
+	@param mediaType The type, which is either 'M', 'T', or 'S'
+	@return 0 for movies, 1 for TV shows and 2 for songs
+	*/
+	static int getTypeIndex(char mediaType);
+
+	/*
+	Gathers the entries of the library in a range, in the order of forEachInRange, for the
+	operations that need all of them at once (the parallel export and convert)
+	@post entryPtrs points to the entries in the order of the library, at most maxEntries of them
+	@param lowPtr Pointer to the inclusive lower bound, NULL if there is no lower bound
+	highPtr Pointer to the exclusive upper bound, NULL if there is no upper bound
+	maxEntries The number of entries needed from the start of the range, -1 for all of them
+	entryPtrs Receives pointers to the entries, valid until the library is changed
+	*/
+	void gatherEntries(const MediaEntry* lowPtr, const MediaEntry* highPtr, int maxEntries,
+				std::vector<const MediaEntry*>& entryPtrs) const;
+
+	/*
+	Writes entries in the order given, the way the data structures write their items, splitting
+	them between the workers of the pool if there are enough of them
+	@post The entries are written to outFile
+	@param entryPtrs Pointers to the entries to be written
+	outFile Ostream variable for the output
+	*/
+	void writeEntries(const std::vector<const MediaEntry*>& entryPtrs, std::ostream& outFile) const;
+
+	/*
+	Runs a batch operation on an array of entries: the entries are split by type, the part of
+	each type is given to its partition, and the results are put back in the order of the array.
+	A batch of a single type is given to its partition as it is.
+	@post results[i] is the result of the operation for media[i]
+	@param media The array of entries
+	numEntries The number of entries in the array
+	results Array of numEntries flags receiving the result for each entry
+	operation Callable taking the position of a partition, an array of entries, its size and an
+	array of results, and returning the number of entries for which the result is true
+	@return The number of entries for which the result is true
+	*/
+	template <class Operation>
+	static int runOnPartitions(const MediaEntry media[], int numEntries, bool results[],
+					Operation&& operation);
+
+	/*
+	Displays every entry of the library whose type is mediaType
+	@post All entries of the given type are displayed
+	@param mediaType The type of the entries to be displayed
+	*/
+	void displayType(char mediaType) const;
+
+	/*
+	Displays the media entry, used as the visit function of the ordered traversals
+	@post The entry is displayed
 	*/
-	static void displayMovie(MediaEntry& media);
-	static void displayMusic(MediaEntry& media);
-	static void displayTv(MediaEntry& media);
 	static void displayEntry(MediaEntry& media);
 
+	/*
+	Chooses how runQuery reaches the entries: the range of titles of the partition of the only
+	type asked for or of the library, if the data structure is sorted and the query bounds the
+	titles; the partitions of the types asked for, if not every type is; and the whole library
+	otherwise
+	@param query The query to be planned
+	@return One of the access paths of MediaQuery.h
+	*/
+	int planQuery(const MediaQuery& query) const;
+
 public:
-	MediaLibrary();
+	/*
+	Creates an empty library
+	@param aNumThreads The number of workers of its thread pool, one per hardware thread if it is
+	less than 1. The shards of a sharded library, which are already processed concurrently, use 1.
+	The workers are started by the first export or statistics split between them.
+	*/
+	MediaLibrary(int aNumThreads = 0);
+	~MediaLibrary();
 
 	//Refer to MediaLibraryInterface.h for details on these functions
 	bool addEntry(const MediaEntry& newMedia);
+	bool addEntries(const MediaEntry newMedia[], int numEntries);
 	bool removeEntry(const MediaEntry& newMedia);
 	MediaEntry getEntry(const MediaEntry& media) const;
 	bool contains(const MediaEntry& media) const;
+	int containsMany(const MediaEntry media[], int numEntries, bool results[]) const;
+	int addMany(const MediaEntry media[], int numEntries, bool results[]);
+	int removeMany(const MediaEntry media[], int numEntries, bool results[]);
+	bool hasConcurrentLookups() const;
 	void displayAllMovies() const;
 	void displayAllMusic() const;
 	void displayAllTv() const;
 	void displayAll() const;
+	void display(int offset, int limit) const;
+	void displayRange(const MediaEntry& low, const MediaEntry& high) const;
+	void displayPrefix(const MediaEntry& prefix) const;
+	int runQuery(const MediaQuery& query, void visit(const MediaEntry&), QueryStatistics& stats) const;
+	void setWordIndex(bool isEnabled);
+	int findWords(const char* text, void visit(const MediaEntry&)) const;
+	void setFuzzyIndex(bool isEnabled);
+	void setLookupCache(int maxEntries);
+	int findClosest(const char* title, int maxDistance, int maxResults,
+			void visit(const MediaEntry&, int)) const;
 	void writeToFile(std::ostream& outFile) const;
+	MediaLibraryInterface* snapshot() const;
+	MediaLibraryInterface* freeze() const;
 	int getNumberOfItems() const;
+	int getNumberOfType(char mediaType) const;
 	void displayStatistics(std::ostream& os) const;
+
+	/*
+	Builds a library backed by another data structure, holding the same entries, e.g. to move
+	the library to the data structure that suits how it is used. The entries are added all at
+	once in sorted order (sorted first if this library is hash-backed), so a tree is built
+	bottom-up. The new library has the same indexes of the titles on, and an empty cache of the
+	same capacity. freeze does the same for a FrozenIndex.
+	@return Pointer to the new library, which the caller has to delete
+	*/
+	template <template <class MediaEntry> class OtherStructure>
+	MediaLibrary<OtherStructure>* convert() const;
+
+	/*
+	Same as forEachInRange of the data structure, over every entry of the library, or over the
+	entries of a single type using its partition, e.g. for a library made of several ones to
+	merge their entries. If the data structure is sorted, the partitions are merged lazily with a
+	RangeCursor in each, so a traversal stopped early only goes through the entries it needed.
+	The entries can't be changed through the traversal.
+	@post visit is executed for every entry in the range, up to the first call returning false
+	@param mediaType The type, which is either 'M', 'T', or 'S'
+	lowPtr Pointer to the inclusive lower bound, NULL if there is no lower bound
+	highPtr Pointer to the exclusive upper bound, NULL if there is no upper bound
+	visit Callable taking a const MediaEntry& and returning true to continue, false to stop
+	@return False if visit stopped the traversal, true otherwise
+	*/
+	template <class Visitor>
+	bool forEachInRange(const MediaEntry* lowPtr, const MediaEntry* highPtr, Visitor&& visit) const;
+	template <class Visitor>
+	bool forEachOfTypeInRange(char mediaType, const MediaEntry* lowPtr, const MediaEntry* highPtr,
+					Visitor&& visit) const;
+
+	/*
+	Tells if the entries are traversed in sorted order, as in the data structure
+	@return True if the data structure is sorted, false otherwise
+	*/
+	bool isOrdered() const;
+
+	/*
+	Finds the entry at a position in the order of forEachInRange, and the position of an entry,
+	e.g. for a library made of several ones to find where a page starts. If the data structure
+	is sorted, the entry is found with RangeCursor::selectMerged from the select and rank of the
+	partitions; otherwise, the positions go through the partitions one after the other.
+	@param index The position of the entry
+	media The entry to be ranked
+	@return Pointer to the entry, NULL if index is not between 0 and the number of entries - 1,
+	and the number of entries < media, respectively
+	*/
+	const MediaEntry* select(int index) const;
+	int rank(const MediaEntry& media) const;
+
+
+	/*
+	Set operations with another library of the same kind, e.g. to merge an imported library
+	into this one, or to find what is new in a library compared to an older one. Tree-backed
+	libraries merge the two sorted sequences and rebuild, and hash-backed ones make a single pass
+	over the chains, so each runs in linear time.
+	@post mergeFrom adds the entries of otherLibrary missing from this library, intersectWith
+	removes the entries not in otherLibrary, and difference removes the entries in otherLibrary.
+	Each partition is combined with the one of the same type.
+	@param otherLibrary The other library, which is unchanged
+	*/
+	void mergeFrom(const MediaLibrary<DataStructure>& otherLibrary);
+	void intersectWith(const MediaLibrary<DataStructure>& otherLibrary);
+	void difference(const MediaLibrary<DataStructure>& otherLibrary);
 };
 
 #include "MediaLibrary.cpp"
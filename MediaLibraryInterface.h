@@ -4,10 +4,13 @@
 
 #include <iostream>
 #include "MediaEntry.h"
+#include "MediaQuery.h"
 
 class MediaLibraryInterface
 {
 public:
+	virtual ~MediaLibraryInterface() {} //Libraries are deleted through this interface
+
 	/*
 	Adds a new media entry into the library
 	@post If successful, newMedia is stored in the library
@@ -16,6 +19,17 @@ public:
 	*/
 	virtual bool addEntry(const MediaEntry& newMedia) = 0;
 
+	/*
+	Adds an array of media entries into the library. Tree-backed libraries build
+	themselves in linear time if the entries are already sorted, as they are in a
+	file written by a tree-backed library.
+	@post If successful, every entry of newMedia is stored in the library
+	@param newMedia The array of media items to be added
+	numEntries The number of items in the array
+	@return True if addition was successful, otherwise false
+	*/
+	virtual bool addEntries(const MediaEntry newMedia[], int numEntries) = 0;
+
 	/*
 	Removes a media entry from the library.
 	@post If it exists, newMedia is removed in the library. Otherwise, nothing happens.
@@ -40,7 +54,29 @@ public:
 	virtual bool contains(const MediaEntry& media) const = 0;
 
 	/*
-	Display either all of the movies, music, TV or everything in the library.
+	Same as contains, addEntry and removeEntry for every entry of an array, e.g. to check or
+	update millions of entries at once. The lookups of a group of entries are overlapped, so
+	their cache misses are paid together instead of one after the other.
+	@post results[i] is what contains, addEntry or removeEntry returned for media[i]
+	@param media The array of entries
+	numEntries The number of entries in the array
+	results Array of numEntries flags receiving the result for each entry
+	@return The number of entries found, added or removed
+	*/
+	virtual int containsMany(const MediaEntry media[], int numEntries, bool results[]) const = 0;
+	virtual int addMany(const MediaEntry media[], int numEntries, bool results[]) = 0;
+	virtual int removeMany(const MediaEntry media[], int numEntries, bool results[]) = 0;
+
+	/*
+	Tells if containsMany can run on several threads at once while nothing changes the library,
+	e.g. to serve the lookups of many clients in parallel (see AsyncLibrary.h)
+	@return True if concurrent batch lookups are safe, false if lookups change the library
+	*/
+	virtual bool hasConcurrentLookups() const = 0;
+
+	/*
+	Display either all of the movies, music, TV or everything in the library. The entries of
+	each type are stored apart, so listing a single type only goes through that type.
 	@post Either all of the movies, music, TV or the contents of the entire library
 	are outputted
 	*/
@@ -49,6 +85,108 @@ public:
 	virtual void displayAllTv() const = 0;
 	virtual void displayAll() const = 0;
 
+	/*
+	Displays a page of the library: up to limit entries, starting with the entry at
+	position offset. Pages go through the entries in the order of displayAll: sorted by
+	title for libraries backed by a sorted data structure, which find where the page starts
+	by ranking the entries, and the movies, then the TV shows, then the songs, each in table
+	order, for hash-backed libraries.
+	@post The entries at positions offset through offset+limit-1 are outputted
+	@param offset The position of the first entry to be displayed
+	limit The maximum number of entries to be displayed
+	*/
+	virtual void display(int offset, int limit) const = 0;
+
+	/*
+	Displays every entry in the range [low, high), in sorted order if the library is
+	tree-backed. Titles are compared as in MediaEntry, so the range ["A", "C") holds
+	every title starting with an A or a B.
+	@post All entries within the range are outputted
+	@param low The inclusive lower bound of the range
+	high The exclusive upper bound of the range
+	*/
+	virtual void displayRange(const MediaEntry& low, const MediaEntry& high) const = 0;
+
+	/*
+	Displays every entry whose title starts with the title of prefix, ignoring case and
+	non-alphabetical characters. The type of prefix is ignored.
+	@post All entries with the prefix are outputted
+	@param prefix The entry whose title is the prefix
+	*/
+	virtual void displayPrefix(const MediaEntry& prefix) const = 0;
+
+	/*
+	Runs a query combining a type, prefix, range and substring with an offset and a limit (see
+	MediaQuery.h), and hands the entries it returns to visit. The query is planned against the
+	ways the library can reach its entries: the range of titles of a tree-backed library if the
+	query has a prefix or a range, the entries of each type asked for if only the type is
+	constrained, and every entry otherwise. Entries come in the order of that access path, e.g.
+	sorted for the range of a tree-backed library, and the offset and limit apply to that order.
+	@post visit is executed for every entry returned, and stats tells what the query took
+	@param query The query to be run
+	visit Function executed for every entry returned
+	stats Receives the access path chosen and the number of entries examined, matched and returned
+	@return The number of entries returned
+	*/
+	virtual int runQuery(const MediaQuery& query, void visit(const MediaEntry&),
+				QueryStatistics& stats) const = 0;
+
+	/*
+	Turns the index of the words of the titles (see WordIndex.h) on or off. Turning it on builds
+	it from the entries of the library, and it is then kept up to date as entries are added and
+	removed. It holds a copy of every entry, so it takes about as much memory as the library.
+	@post findWords uses the index if isEnabled, and goes through every entry otherwise
+	@param isEnabled True to turn the index on, false to turn it off and free it
+	*/
+	virtual void setWordIndex(bool isEnabled) = 0;
+
+	/*
+	Finds every entry whose title has all of the words of text, e.g. "dark" finds "The Dark
+	Knight" and "Thor: Dark World". Words are runs of letters and digits, compared ignoring case.
+	With the word index on, only the entries having the rarest of the words are looked at.
+	@post visit is executed for every entry found
+	@param text The words looked for
+	visit Function executed for every entry found
+	@return The number of entries found, 0 if text has no word
+	*/
+	virtual int findWords(const char* text, void visit(const MediaEntry&)) const = 0;
+
+	/*
+	Turns the trigram index of the titles (see FuzzyIndex.h) on or off, the same way as
+	setWordIndex. It also holds a copy of every entry.
+	@post findClosest uses the index if isEnabled, and goes through every entry otherwise
+	@param isEnabled True to turn the index on, false to turn it off and free it
+	*/
+	virtual void setFuzzyIndex(bool isEnabled) = 0;
+
+	/*
+	Puts a cache of a fixed number of entries (see LookupCache.h) in front of contains and
+	getEntry, for libraries where a few popular titles get most of the lookups, or removes it.
+	Entries added or removed are dropped from the cache, and changes to the library as a whole
+	empty it. Its hits, misses, evictions and invalidations are part of displayStatistics.
+	The batch lookups go to the data structure directly. Lookups update the cache, so it has a
+	lock of its own, which the lookups of several threads take in turn while it is on.
+	@post contains and getEntry go through a new, empty cache if maxEntries > 0
+	@param maxEntries The number of entries the cache holds at most, 0 to remove the cache
+	*/
+	virtual void setLookupCache(int maxEntries) = 0;
+
+	/*
+	Finds the entries whose titles are closest to a title that may have typos in it, e.g.
+	"Spongebob Squarpants". Titles are compared on their letters, ignoring case, and their
+	distance is the number of letters inserted, deleted or replaced to turn one into the other.
+	With the trigram index on, only the titles sharing enough trigrams with title are compared.
+	@post visit is executed for up to maxResults entries within maxDistance of title, closest
+	first, with their distance
+	@param title The title looked for
+	maxDistance The largest distance of the entries found
+	maxResults The maximum number of entries found
+	visit Function executed for every entry found, with its distance
+	@return The number of entries found
+	*/
+	virtual int findClosest(const char* title, int maxDistance, int maxResults,
+				void visit(const MediaEntry&, int)) const = 0;
+
 
 	/*
 	Writes the contents of the library to an external file opened by outFile.
@@ -56,12 +194,37 @@ public:
 	*/
 	virtual void writeToFile(std::ostream& outFile) const = 0;
 
+	/*
+	Takes a snapshot of the library: a separate library holding the current entries, unaffected
+	by any later change to this one (and vice versa). Tree-backed libraries share their nodes with
+	the snapshot, so it is taken in constant time and the two only diverge as they are modified.
+	The snapshot may be read from another thread while this library keeps changing.
+	@return Pointer to the snapshot, which the caller has to delete
+	*/
+	virtual MediaLibraryInterface* snapshot() const = 0;
+
+	/*
+	Builds a read-only copy of the library, for libraries that are only queried once loaded. The
+	entries are stored in a sorted array searched in Eytzinger order (see FrozenIndex.h), which
+	takes less memory and fewer cache misses than the tree or table. The copy can't be modified:
+	adding or removing entries fails. This library can be deleted afterwards.
+	@return Pointer to the read-only library, which the caller has to delete
+	*/
+	virtual MediaLibraryInterface* freeze() const = 0;
+
 	/*
 	Returns the number of entries in the media library
 	@return The number of entries in the library
 	*/
 	virtual int getNumberOfItems() const = 0;
 
+	/*
+	Returns the number of entries of a media type in the library
+	@param mediaType The type, which is either 'M', 'T', or 'S'
+	@return The number of entries of that type
+	*/
+	virtual int getNumberOfType(char mediaType) const = 0;
+
 	/*
 	Displays the relevant statistics of the data structure used to implement the library
 	using the ostream variable os to output them.
@@ -0,0 +1,272 @@
+#include "MediaQuery.h"
+#include <cstring>
+#include <cctype>
+
+MediaQuery::MediaQuery()
+{
+	typeMask = 0; //No type added, so every type matches
+	hasLow = false;
+	hasHigh = false;
+	substring = NULL;
+	substringLength = 0;
+	offset = 0;
+	limit = -1;
+}
+
+MediaQuery::MediaQuery(const MediaQuery& otherQuery)
+{
+	copyQuery(otherQuery);
+}
+
+MediaQuery::~MediaQuery()
+{
+	if (substring != NULL)
+	{
+		delete [] substring;
+		substring = NULL;
+	}
+}
+
+void MediaQuery::copyQuery(const MediaQuery& otherQuery)
+{
+	typeMask = otherQuery.typeMask;
+	low = otherQuery.low;
+	high = otherQuery.high;
+	hasLow = otherQuery.hasLow;
+	hasHigh = otherQuery.hasHigh;
+
+	substringLength = otherQuery.substringLength;
+	if (otherQuery.substring != NULL)
+	{
+		substring = new char[substringLength+1];
+		std::strcpy(substring, otherQuery.substring);
+	}
+	else
+		substring = NULL;
+
+	offset = otherQuery.offset;
+	limit = otherQuery.limit;
+}
+
+int MediaQuery::getTypeBit(char mediaType)
+{
+	switch (mediaType)
+	{
+	case 'M':
+		return 1;
+	case 'T':
+		return 2;
+	default: //Anything else is stored as a song
+		return 4;
+	}
+}
+
+void MediaQuery::addType(char mediaType)
+{
+	typeMask |= getTypeBit(mediaType);
+}
+
+void MediaQuery::narrowRange(const MediaEntry* lowPtr, const MediaEntry* highPtr)
+{
+	if (lowPtr != NULL && (!hasLow || low < *lowPtr))
+	{
+		low = *lowPtr;
+		hasLow = true;
+	}
+
+	if (highPtr != NULL && (!hasHigh || *highPtr < high))
+	{
+		high = *highPtr;
+		hasHigh = true;
+	}
+}
+
+void MediaQuery::setPrefix(const char* prefix)
+{
+	MediaEntry prefixLow(prefix, 'M'); //Movies come first among equal titles, so the prefix as a
+					   //movie is the smallest entry having it
+	MediaEntry prefixHigh;
+	if (prefixLow.getPrefixBound(prefixHigh))
+		narrowRange(&prefixLow, &prefixHigh);
+	else //Every title past prefixLow has the prefix
+		narrowRange(&prefixLow, NULL);
+}
+
+void MediaQuery::setRange(const MediaEntry* lowPtr, const MediaEntry* highPtr)
+{
+	narrowRange(lowPtr, highPtr);
+}
+
+void MediaQuery::setSubstring(const char* text)
+{
+	if (substring != NULL)
+		delete [] substring;
+
+	if (text != NULL && text[0] != '\0')
+	{
+		substringLength = std::strlen(text);
+		substring = new char[substringLength+1];
+		for (int i = 0; i <= substringLength; i++) //Stored in upper case, like the titles are compared
+			substring[i] = toupper(text[i]);
+	}
+	else //Every title contains the empty text
+	{
+		substring = NULL;
+		substringLength = 0;
+	}
+}
+
+void MediaQuery::setOffset(int numSkipped)
+{
+	offset = (numSkipped > 0) ? numSkipped : 0;
+}
+
+void MediaQuery::setLimit(int maxReturned)
+{
+	limit = maxReturned;
+}
+
+int MediaQuery::getOffset() const
+{
+	return offset;
+}
+
+int MediaQuery::getLimit() const
+{
+	return limit;
+}
+
+bool MediaQuery::hasType(char mediaType) const
+{
+	return (typeMask == 0 || (typeMask & getTypeBit(mediaType)) != 0);
+}
+
+int MediaQuery::getNumTypes() const
+{
+	if (typeMask == 0)
+		return 3;
+
+	int numTypes = 0;
+	for (int mask = typeMask; mask != 0; mask >>= 1)
+		numTypes += (mask & 1);
+
+	return numTypes;
+}
+
+const MediaEntry* MediaQuery::getLowPtr() const
+{
+	return hasLow ? &low : NULL;
+}
+
+const MediaEntry* MediaQuery::getHighPtr() const
+{
+	return hasHigh ? &high : NULL;
+}
+
+bool MediaQuery::isEmpty() const
+{
+	return (limit == 0 || (hasLow && hasHigh && !(low < high)));
+}
+
+bool MediaQuery::hasSubstring(const MediaEntry& media) const
+{
+	int lastStart = media.length() - substringLength;
+	for (int start = 0; start <= lastStart; start++) //Titles are short, so a plain search is enough
+	{
+		int i = 0;
+		while (i < substringLength && toupper(media[start + i]) == substring[i])
+			i++;
+
+		if (i == substringLength)
+			return true;
+	}
+
+	return false;
+}
+
+bool MediaQuery::matches(const MediaEntry& media) const
+{
+	if (!hasType(media.getMediaType()))
+		return false;
+
+	if ((hasLow && media < low) || (hasHigh && !(media < high)))
+		return false;
+
+	return (substring == NULL || hasSubstring(media));
+}
+
+void MediaQuery::explain(const QueryStatistics& stats, std::ostream& os) const
+{
+	os << "Query:";
+	if (typeMask != 0)
+	{
+		os << " types";
+		const char types[] = "MTS";
+		for (int i = 0; types[i] != '\0'; i++)
+		{
+			if (hasType(types[i]))
+				os << ' ' << types[i];
+		}
+		os << ',';
+	}
+
+	if (hasLow || hasHigh)
+	{
+		os << " titles in [";
+		if (hasLow)
+			os << '"' << low << '"';
+		os << ", ";
+		if (hasHigh)
+			os << '"' << high << '"';
+		os << "),";
+	}
+
+	if (substring != NULL)
+		os << " containing \"" << substring << "\",";
+
+	os << " offset " << offset << ", limit ";
+	if (limit < 0)
+		os << "none";
+	else
+		os << limit;
+	os << '\n';
+
+	os << "Access path: ";
+	switch (stats.accessPath)
+	{
+	case QUERY_NO_ENTRIES:
+		os << "none, no entry can match";
+		break;
+	case QUERY_TYPE_RANGE:
+		os << "range of titles of the type";
+		break;
+	case QUERY_RANGE:
+		os << "range of titles in the library";
+		break;
+	case QUERY_TYPE_SCAN:
+		os << "scan of the types asked for";
+		break;
+	default:
+		os << "scan of the whole library";
+		break;
+	}
+	os << '\n';
+
+	os << "Entries examined: " << stats.numExamined << ", matched: " << stats.numMatched
+	   << ", returned: " << stats.numReturned << '\n';
+}
+
+const MediaQuery& MediaQuery::operator=(const MediaQuery& otherQuery)
+{
+	if (this != &otherQuery)
+	{
+		if (substring != NULL) //Delete the existing substring
+		{
+			delete [] substring;
+			substring = NULL;
+		}
+		copyQuery(otherQuery);
+	}
+
+	return *this;
+}
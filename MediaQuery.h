@@ -0,0 +1,165 @@
+/*@file MediaQuery.h*/
+#ifndef _MEDIA_QUERY_H
+#define _MEDIA_QUERY_H
+
+#include <iostream>
+#include "MediaEntry.h"
+
+const int QUERY_NO_ENTRIES = 0; //Access paths a library can answer a query with. No entries can match,
+const int QUERY_TYPE_RANGE = 1; //the range of titles of a single type, the range of titles in the
+const int QUERY_RANGE = 2;	//whole library, every entry of the types asked for, or every
+const int QUERY_TYPE_SCAN = 3;	//entry of the library.
+const int QUERY_FULL_SCAN = 4;
+
+struct QueryStatistics //What running a query took, see MediaQuery::explain
+{
+	int accessPath; //One of the access paths above
+	int numExamined; //Entries the access path went through, up to where the limit stopped it. Merges
+			 //read ahead at most CURSOR_CHUNK_SIZE more per partition or shard
+	int numMatched; //Entries matching every predicate, including those skipped by the offset
+	int numReturned; //Entries handed to the visit function
+};
+
+/*
+A query over a media library: predicates every entry returned has to match (its type, the
+beginning of its title, a range of titles, and text within its title), combined with an offset
+and a limit. The prefix and the range both narrow a single range of titles, which tree-backed
+libraries can go through without looking at the rest of the entries. See MediaLibraryInterface::query.
+*/
+class MediaQuery
+{
+private:
+	int typeMask; //Bit of each type asked for, see getTypeBit
+	MediaEntry low; //Inclusive lower bound of the titles, if hasLow
+	MediaEntry high; //Exclusive upper bound of the titles, if hasHigh
+	bool hasLow;
+	bool hasHigh;
+	char* substring; //Text the titles have to contain, ignoring case, NULL if there is none
+	int substringLength;
+	int offset; //Number of matching entries skipped before the first one returned
+	int limit; //Maximum number of entries returned, negative if there is no limit
+
+	/*
+	Returns the bit of a media type in typeMask
+	@param mediaType The type, which is either 'M', 'T', or 'S'
+	@return 1 for movies, 2 for TV shows and 4 for songs
+	*/
+	static int getTypeBit(char mediaType);
+
+	/*
+	Narrows the range of titles to its intersection with [*lowPtr, *highPtr)
+	@post The bounds are the larger of the lower bounds and the smaller of the upper bounds
+	@param lowPtr Pointer to the inclusive lower bound, NULL if there is no lower bound
+	highPtr Pointer to the exclusive upper bound, NULL if there is no upper bound
+	*/
+	void narrowRange(const MediaEntry* lowPtr, const MediaEntry* highPtr);
+
+	/*
+	Checks if the title of media contains substring, ignoring case
+	@param media The entry to be checked
+	@return True if the title contains substring, false otherwise
+	*/
+	bool hasSubstring(const MediaEntry& media) const;
+
+	void copyQuery(const MediaQuery& otherQuery); //Copies the contents of another query
+
+public:
+	/*
+	Creates a query matching every entry, with no offset and no limit
+	*/
+	MediaQuery();
+	MediaQuery(const MediaQuery& otherQuery); //Copy constructor
+	~MediaQuery();
+
+	/*
+	Adds a media type to the types asked for. A query with no type added matches every type.
+	@post Entries of mediaType match the type predicate
+	@param mediaType The type, which is either 'M', 'T', or 'S'
+	*/
+	void addType(char mediaType);
+
+	/*
+	Asks for the titles starting with the title of prefix, ignoring case and non-alphabetical
+	characters as displayPrefix does
+	@post The range of titles is narrowed to the titles having the prefix
+	@param prefix The beginning of the titles
+	*/
+	void setPrefix(const char* prefix);
+
+	/*
+	Asks for the titles in the range [*lowPtr, *highPtr), compared as in MediaEntry
+	@post The range of titles is narrowed to [*lowPtr, *highPtr)
+	@param lowPtr Pointer to the inclusive lower bound, NULL if there is no lower bound
+	highPtr Pointer to the exclusive upper bound, NULL if there is no upper bound
+	*/
+	void setRange(const MediaEntry* lowPtr, const MediaEntry* highPtr);
+
+	/*
+	Asks for the titles containing text, ignoring case
+	@post Only titles containing text match the query
+	@param text The text, or NULL to remove the predicate
+	*/
+	void setSubstring(const char* text);
+
+	/*
+	Sets the number of matching entries skipped, and the maximum number of entries returned
+	@param numSkipped The offset, 0 to return the entries from the first match on
+	maxReturned The limit, negative if there is no limit
+	*/
+	void setOffset(int numSkipped);
+	void setLimit(int maxReturned);
+
+	int getOffset() const;
+	int getLimit() const;
+
+	/*
+	Checks if entries of a media type can match the query
+	@param mediaType The type, which is either 'M', 'T', or 'S'
+	@return True if the type was added, or if no type was added
+	*/
+	bool hasType(char mediaType) const;
+
+	/*
+	Returns the number of types the entries can have
+	@return The number of types added, 3 if no type was added
+	*/
+	int getNumTypes() const;
+
+	/*
+	Returns the bounds of the range of titles
+	@return Pointer to the bound, NULL if the range has no such bound
+	*/
+	const MediaEntry* getLowPtr() const;
+	const MediaEntry* getHighPtr() const;
+
+	/*
+	Checks if no entry can be returned, either because the range of titles is empty or
+	because the limit is 0
+	@return True if the query can't return any entry, false otherwise
+	*/
+	bool isEmpty() const;
+
+	/*
+	Checks if media matches every predicate of the query. The offset and the limit are
+	left to the library running the query.
+	@param media The entry to be checked
+	@return True if media matches, false otherwise
+	*/
+	bool matches(const MediaEntry& media) const;
+
+	/*
+	Writes out the predicates of the query, the access path chosen for it, and how many
+	entries were examined, matched and returned when it ran
+	@post The query and stats are written to os
+	@param stats What running the query took
+	os Ostream variable for the output
+	*/
+	void explain(const QueryStatistics& stats, std::ostream& os) const;
+
+	/*
+	Override the assignment operator
+	*/
+	const MediaQuery& operator=(const MediaQuery& otherQuery);
+};
+
+#endif
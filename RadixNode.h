@@ -0,0 +1,147 @@
+/*@file RadixNode.h*/
+#ifndef _RADIX_NODE_H
+#define _RADIX_NODE_H
+
+#include <cstddef>
+
+const int RADIX_LEAF = 0; //Types of the nodes of an adaptive radix tree. Inner nodes are named
+const int RADIX_NODE_4 = 4; //after the most children they can have.
+const int RADIX_NODE_16 = 16;
+const int RADIX_NODE_48 = 48;
+const int RADIX_NODE_256 = 256;
+
+template <class ItemType> //Fields shared by every node of the adaptive radix tree
+struct RadixNode
+{
+	int nodeType; //One of the types above, telling which struct the node really is
+	int numChildren; //Number of children of an inner node
+	int prefixLength; //Length of the compressed path of an inner node: the key bytes shared by
+	unsigned char* prefix; //every item below it, between its parent's byte and its own
+};
+
+template <class ItemType> //A leaf holds a single item and its whole sort key
+struct RadixLeaf : public RadixNode<ItemType>
+{
+	ItemType item;
+	int keyLength;
+	unsigned char* key;
+};
+
+template <class ItemType> //Up to 4 or 16 children, with their key bytes kept sorted
+struct RadixNode4 : public RadixNode<ItemType>
+{
+	unsigned char keys[4];
+	RadixNode<ItemType>* children[4];
+};
+
+template <class ItemType>
+struct RadixNode16 : public RadixNode<ItemType>
+{
+	unsigned char keys[16];
+	RadixNode<ItemType>* children[16];
+};
+
+template <class ItemType> //childIndex maps a key byte to 1 + the position of its child, 0 if none
+struct RadixNode48 : public RadixNode<ItemType>
+{
+	unsigned char childIndex[256];
+	RadixNode<ItemType>* children[48];
+};
+
+template <class ItemType> //Children indexed directly by their key byte
+struct RadixNode256 : public RadixNode<ItemType>
+{
+	RadixNode<ItemType>* children[256];
+};
+
+
+/*
+Returns the first child of the inner node nodePtr at or after position, in key byte order.
+Positions are indexes into the arrays of a RadixNode4 or RadixNode16, and key bytes for a
+RadixNode48 or RadixNode256.
+@post position is the position of the child found
+@param nodePtr Pointer to the inner node
+position The position the search starts at
+@return Pointer to the child, NULL if there are no more children
+*/
+template <class ItemType>
+RadixNode<ItemType>* getNextChild(const RadixNode<ItemType>* nodePtr, int& position)
+{
+	switch (nodePtr->nodeType)
+	{
+	case RADIX_NODE_4:
+		if (position < nodePtr->numChildren)
+			return static_cast<const RadixNode4<ItemType>*>(nodePtr)->children[position];
+		break;
+	case RADIX_NODE_16:
+		if (position < nodePtr->numChildren)
+			return static_cast<const RadixNode16<ItemType>*>(nodePtr)->children[position];
+		break;
+	case RADIX_NODE_48:
+	{
+		const RadixNode48<ItemType>* node48Ptr = static_cast<const RadixNode48<ItemType>*>(nodePtr);
+		for (; position < 256; position++)
+		{
+			if (node48Ptr->childIndex[position] != 0)
+				return node48Ptr->children[node48Ptr->childIndex[position]-1];
+		}
+		break;
+	}
+	case RADIX_NODE_256:
+	{
+		const RadixNode256<ItemType>* node256Ptr = static_cast<const RadixNode256<ItemType>*>(nodePtr);
+		for (; position < 256; position++)
+		{
+			if (node256Ptr->children[position] != NULL)
+				return node256Ptr->children[position];
+		}
+		break;
+	}
+	}
+
+	return NULL;
+}
+
+/*
+Returns the position from which getNextChild finds the children whose key byte is >= keyByte
+@param nodePtr Pointer to the inner node
+keyByte The smallest key byte of interest
+@return The position to start from
+*/
+template <class ItemType>
+int getChildPosition(const RadixNode<ItemType>* nodePtr, unsigned char keyByte)
+{
+	const unsigned char* keys = NULL;
+	if (nodePtr->nodeType == RADIX_NODE_4)
+		keys = static_cast<const RadixNode4<ItemType>*>(nodePtr)->keys;
+	else if (nodePtr->nodeType == RADIX_NODE_16)
+		keys = static_cast<const RadixNode16<ItemType>*>(nodePtr)->keys;
+	else //Positions are the key bytes themselves
+		return keyByte;
+
+	int position = 0;
+	while (position < nodePtr->numChildren && keys[position] < keyByte)
+		position++;
+
+	return position;
+}
+
+/*
+Returns the key byte of the child of nodePtr at position
+@pre There is a child at position
+@param nodePtr Pointer to the inner node
+position The position of the child, as set by getNextChild
+@return The key byte leading to the child
+*/
+template <class ItemType>
+unsigned char getChildByte(const RadixNode<ItemType>* nodePtr, int position)
+{
+	if (nodePtr->nodeType == RADIX_NODE_4)
+		return static_cast<const RadixNode4<ItemType>*>(nodePtr)->keys[position];
+	else if (nodePtr->nodeType == RADIX_NODE_16)
+		return static_cast<const RadixNode16<ItemType>*>(nodePtr)->keys[position];
+	else
+		return position;
+}
+
+#endif
@@ -0,0 +1,1098 @@
+#ifndef _RADIX_TREE_CPP
+#define _RADIX_TREE_CPP
+
+#include <cstring>
+#include <sstream>
+#include "RadixTree.h"
+#include "NotFoundException.h"
+
+template <class ItemType>
+RadixTree<ItemType>::RadixTree() //Default state of the tree is empty
+{
+	rootPtr = NULL;
+	numItems = 0;
+}
+
+template <class ItemType>
+RadixTree<ItemType>::RadixTree(const RadixTree<ItemType>& aTree)
+{
+	rootPtr = copyTree(aTree.rootPtr);
+	numItems = aTree.numItems;
+}
+
+template <class ItemType>
+RadixTree<ItemType>::~RadixTree()
+{
+	clear();
+}
+
+template <class ItemType>
+unsigned char* RadixTree<ItemType>::getKeyArray(const ItemType& anEntry, unsigned char buffer[]) const
+{
+	if (anEntry.length() + 1 <= KEY_BUFFER_SIZE)
+		return buffer;
+	else //Rare long title
+		return new unsigned char[anEntry.length() + 1];
+}
+
+template <class ItemType>
+template <class NodeType>
+NodeType* RadixTree<ItemType>::createNode(int nodeType) const
+{
+	NodeType* newNodePtr = new NodeType(); //Value initialization sets every child to NULL
+	newNodePtr->nodeType = nodeType;
+	newNodePtr->numChildren = 0;
+	newNodePtr->prefixLength = 0;
+	newNodePtr->prefix = NULL;
+
+	return newNodePtr;
+}
+
+template <class ItemType>
+RadixLeaf<ItemType>* RadixTree<ItemType>::createLeaf(const ItemType& anItem, const unsigned char key[],
+								int keyLength) const
+{
+	RadixLeaf<ItemType>* newLeafPtr = createNode<RadixLeaf<ItemType> >(RADIX_LEAF);
+	newLeafPtr->item = anItem;
+	newLeafPtr->keyLength = keyLength;
+	newLeafPtr->key = new unsigned char[keyLength];
+	std::memcpy(newLeafPtr->key, key, keyLength);
+
+	return newLeafPtr;
+}
+
+template <class ItemType>
+void RadixTree<ItemType>::deleteNode(RadixNode<ItemType>* nodePtr)
+{
+	delete [] nodePtr->prefix;
+
+	switch (nodePtr->nodeType) //The structs have no virtual destructor, so delete the real type
+	{
+	case RADIX_LEAF:
+		delete [] static_cast<RadixLeaf<ItemType>*>(nodePtr)->key;
+		delete static_cast<RadixLeaf<ItemType>*>(nodePtr);
+		break;
+	case RADIX_NODE_4:
+		delete static_cast<RadixNode4<ItemType>*>(nodePtr);
+		break;
+	case RADIX_NODE_16:
+		delete static_cast<RadixNode16<ItemType>*>(nodePtr);
+		break;
+	case RADIX_NODE_48:
+		delete static_cast<RadixNode48<ItemType>*>(nodePtr);
+		break;
+	case RADIX_NODE_256:
+		delete static_cast<RadixNode256<ItemType>*>(nodePtr);
+		break;
+	}
+}
+
+template <class ItemType>
+void RadixTree<ItemType>::setPrefix(RadixNode<ItemType>* nodePtr, const unsigned char bytes[], int length) const
+{
+	unsigned char* newPrefix = NULL;
+	if (length > 0)
+	{
+		newPrefix = new unsigned char[length];
+		std::memcpy(newPrefix, bytes, length); //Copied before the old prefix is deleted
+	}
+
+	delete [] nodePtr->prefix;
+	nodePtr->prefix = newPrefix;
+	nodePtr->prefixLength = length;
+}
+
+template <class ItemType>
+void RadixTree<ItemType>::moveHeader(RadixNode<ItemType>* fromPtr, RadixNode<ItemType>* toPtr)
+{
+	toPtr->numChildren = fromPtr->numChildren;
+	toPtr->prefixLength = fromPtr->prefixLength;
+	toPtr->prefix = fromPtr->prefix;
+
+	fromPtr->prefixLength = 0;
+	fromPtr->prefix = NULL;
+}
+
+template <class ItemType>
+RadixNode<ItemType>** RadixTree<ItemType>::findChild(RadixNode<ItemType>* nodePtr, unsigned char keyByte) const
+{
+	switch (nodePtr->nodeType)
+	{
+	case RADIX_NODE_4:
+	{
+		RadixNode4<ItemType>* node4Ptr = static_cast<RadixNode4<ItemType>*>(nodePtr);
+		for (int i = 0; i < node4Ptr->numChildren; i++)
+		{
+			if (node4Ptr->keys[i] == keyByte)
+				return &node4Ptr->children[i];
+		}
+		break;
+	}
+	case RADIX_NODE_16:
+	{
+		RadixNode16<ItemType>* node16Ptr = static_cast<RadixNode16<ItemType>*>(nodePtr);
+		for (int i = 0; i < node16Ptr->numChildren; i++)
+		{
+			if (node16Ptr->keys[i] == keyByte)
+				return &node16Ptr->children[i];
+		}
+		break;
+	}
+	case RADIX_NODE_48:
+	{
+		RadixNode48<ItemType>* node48Ptr = static_cast<RadixNode48<ItemType>*>(nodePtr);
+		if (node48Ptr->childIndex[keyByte] != 0)
+			return &node48Ptr->children[node48Ptr->childIndex[keyByte]-1];
+		break;
+	}
+	case RADIX_NODE_256:
+	{
+		RadixNode256<ItemType>* node256Ptr = static_cast<RadixNode256<ItemType>*>(nodePtr);
+		if (node256Ptr->children[keyByte] != NULL)
+			return &node256Ptr->children[keyByte];
+		break;
+	}
+	}
+
+	return NULL;
+}
+
+/*
+Inserts childPtr into the sorted arrays of a RadixNode4 or RadixNode16
+@pre The arrays have room for one more child
+@post keys and children are still sorted by key byte
+@param keys The key bytes of the children
+children The children
+numChildren The number of children before the insertion
+keyByte The key byte of the new child
+childPtr Pointer to the new child
+*/
+template <class ItemType>
+void insertSortedChild(unsigned char keys[], RadixNode<ItemType>* children[], int numChildren,
+				unsigned char keyByte, RadixNode<ItemType>* childPtr)
+{
+	int position = numChildren;
+	while (position > 0 && keys[position-1] > keyByte) //Shift the larger ones to the right
+	{
+		keys[position] = keys[position-1];
+		children[position] = children[position-1];
+		position--;
+	}
+
+	keys[position] = keyByte;
+	children[position] = childPtr;
+}
+
+/*
+Removes the child with keyByte from the sorted arrays of a RadixNode4 or RadixNode16
+@pre There is a child with keyByte
+@post keys and children are still sorted by key byte, without the child
+@param keys The key bytes of the children
+children The children
+numChildren The number of children before the removal
+keyByte The key byte of the child to be removed
+*/
+template <class ItemType>
+void removeSortedChild(unsigned char keys[], RadixNode<ItemType>* children[], int numChildren,
+				unsigned char keyByte)
+{
+	int position = 0;
+	while (keys[position] != keyByte)
+		position++;
+
+	for (; position < numChildren - 1; position++) //Shift the larger ones to the left
+	{
+		keys[position] = keys[position+1];
+		children[position] = children[position+1];
+	}
+}
+
+template <class ItemType>
+void RadixTree<ItemType>::addChild(RadixNode<ItemType>*& nodeRef, unsigned char keyByte,
+						RadixNode<ItemType>* childPtr)
+{
+	switch (nodeRef->nodeType)
+	{
+	case RADIX_NODE_4:
+	{
+		RadixNode4<ItemType>* node4Ptr = static_cast<RadixNode4<ItemType>*>(nodeRef);
+		if (node4Ptr->numChildren < 4)
+		{
+			insertSortedChild(node4Ptr->keys, node4Ptr->children, node4Ptr->numChildren, keyByte, childPtr);
+			node4Ptr->numChildren++;
+			return;
+		}
+
+		RadixNode16<ItemType>* node16Ptr = createNode<RadixNode16<ItemType> >(RADIX_NODE_16); //Full, so grow
+		moveHeader(node4Ptr, node16Ptr);
+		for (int i = 0; i < 4; i++)
+		{
+			node16Ptr->keys[i] = node4Ptr->keys[i];
+			node16Ptr->children[i] = node4Ptr->children[i];
+		}
+
+		deleteNode(node4Ptr);
+		nodeRef = node16Ptr;
+		addChild(nodeRef, keyByte, childPtr);
+		break;
+	}
+	case RADIX_NODE_16:
+	{
+		RadixNode16<ItemType>* node16Ptr = static_cast<RadixNode16<ItemType>*>(nodeRef);
+		if (node16Ptr->numChildren < 16)
+		{
+			insertSortedChild(node16Ptr->keys, node16Ptr->children, node16Ptr->numChildren, keyByte, childPtr);
+			node16Ptr->numChildren++;
+			return;
+		}
+
+		RadixNode48<ItemType>* node48Ptr = createNode<RadixNode48<ItemType> >(RADIX_NODE_48);
+		moveHeader(node16Ptr, node48Ptr);
+		for (int i = 0; i < 16; i++)
+		{
+			node48Ptr->childIndex[node16Ptr->keys[i]] = i + 1;
+			node48Ptr->children[i] = node16Ptr->children[i];
+		}
+
+		deleteNode(node16Ptr);
+		nodeRef = node48Ptr;
+		addChild(nodeRef, keyByte, childPtr);
+		break;
+	}
+	case RADIX_NODE_48:
+	{
+		RadixNode48<ItemType>* node48Ptr = static_cast<RadixNode48<ItemType>*>(nodeRef);
+		if (node48Ptr->numChildren < 48)
+		{
+			int slot = 0; //Removals may have left holes anywhere
+			while (node48Ptr->children[slot] != NULL)
+				slot++;
+
+			node48Ptr->children[slot] = childPtr;
+			node48Ptr->childIndex[keyByte] = slot + 1;
+			node48Ptr->numChildren++;
+			return;
+		}
+
+		RadixNode256<ItemType>* node256Ptr = createNode<RadixNode256<ItemType> >(RADIX_NODE_256);
+		moveHeader(node48Ptr, node256Ptr);
+		for (int b = 0; b < 256; b++)
+		{
+			if (node48Ptr->childIndex[b] != 0)
+				node256Ptr->children[b] = node48Ptr->children[node48Ptr->childIndex[b]-1];
+		}
+
+		deleteNode(node48Ptr);
+		nodeRef = node256Ptr;
+		addChild(nodeRef, keyByte, childPtr);
+		break;
+	}
+	case RADIX_NODE_256:
+	{
+		RadixNode256<ItemType>* node256Ptr = static_cast<RadixNode256<ItemType>*>(nodeRef);
+		node256Ptr->children[keyByte] = childPtr;
+		node256Ptr->numChildren++;
+		break;
+	}
+	}
+}
+
+template <class ItemType>
+void RadixTree<ItemType>::removeChild(RadixNode<ItemType>*& nodeRef, unsigned char keyByte)
+{
+	switch (nodeRef->nodeType)
+	{
+	case RADIX_NODE_4:
+	{
+		RadixNode4<ItemType>* node4Ptr = static_cast<RadixNode4<ItemType>*>(nodeRef);
+		removeSortedChild(node4Ptr->keys, node4Ptr->children, node4Ptr->numChildren, keyByte);
+		node4Ptr->numChildren--;
+
+		if (node4Ptr->numChildren == 1) //The node no longer branches, so merge it into its child
+		{
+			RadixNode<ItemType>* childPtr = node4Ptr->children[0];
+			if (childPtr->nodeType != RADIX_LEAF) //Leaves hold their whole key, so need no prefix
+			{
+				int newLength = node4Ptr->prefixLength + 1 + childPtr->prefixLength;
+				unsigned char* newPrefix = new unsigned char[newLength];
+
+				if (node4Ptr->prefixLength > 0)
+					std::memcpy(newPrefix, node4Ptr->prefix, node4Ptr->prefixLength);
+				newPrefix[node4Ptr->prefixLength] = node4Ptr->keys[0];
+				if (childPtr->prefixLength > 0)
+					std::memcpy(newPrefix + node4Ptr->prefixLength + 1, childPtr->prefix, childPtr->prefixLength);
+
+				delete [] childPtr->prefix;
+				childPtr->prefix = newPrefix;
+				childPtr->prefixLength = newLength;
+			}
+
+			deleteNode(node4Ptr);
+			nodeRef = childPtr;
+		}
+		break;
+	}
+	case RADIX_NODE_16:
+	{
+		RadixNode16<ItemType>* node16Ptr = static_cast<RadixNode16<ItemType>*>(nodeRef);
+		removeSortedChild(node16Ptr->keys, node16Ptr->children, node16Ptr->numChildren, keyByte);
+		node16Ptr->numChildren--;
+
+		if (node16Ptr->numChildren == 3) //Shrink a little below the size it grew at, so
+		{				 //alternating adds and removes don't keep resizing it
+			RadixNode4<ItemType>* node4Ptr = createNode<RadixNode4<ItemType> >(RADIX_NODE_4);
+			moveHeader(node16Ptr, node4Ptr);
+			for (int i = 0; i < 3; i++)
+			{
+				node4Ptr->keys[i] = node16Ptr->keys[i];
+				node4Ptr->children[i] = node16Ptr->children[i];
+			}
+
+			deleteNode(node16Ptr);
+			nodeRef = node4Ptr;
+		}
+		break;
+	}
+	case RADIX_NODE_48:
+	{
+		RadixNode48<ItemType>* node48Ptr = static_cast<RadixNode48<ItemType>*>(nodeRef);
+		node48Ptr->children[node48Ptr->childIndex[keyByte]-1] = NULL;
+		node48Ptr->childIndex[keyByte] = 0;
+		node48Ptr->numChildren--;
+
+		if (node48Ptr->numChildren == 12)
+		{
+			RadixNode16<ItemType>* node16Ptr = createNode<RadixNode16<ItemType> >(RADIX_NODE_16);
+			moveHeader(node48Ptr, node16Ptr);
+
+			int i = 0;
+			for (int b = 0; b < 256; b++) //In key byte order, so the arrays come out sorted
+			{
+				if (node48Ptr->childIndex[b] != 0)
+				{
+					node16Ptr->keys[i] = b;
+					node16Ptr->children[i++] = node48Ptr->children[node48Ptr->childIndex[b]-1];
+				}
+			}
+
+			deleteNode(node48Ptr);
+			nodeRef = node16Ptr;
+		}
+		break;
+	}
+	case RADIX_NODE_256:
+	{
+		RadixNode256<ItemType>* node256Ptr = static_cast<RadixNode256<ItemType>*>(nodeRef);
+		node256Ptr->children[keyByte] = NULL;
+		node256Ptr->numChildren--;
+
+		if (node256Ptr->numChildren == 37)
+		{
+			RadixNode48<ItemType>* node48Ptr = createNode<RadixNode48<ItemType> >(RADIX_NODE_48);
+			moveHeader(node256Ptr, node48Ptr);
+
+			int slot = 0;
+			for (int b = 0; b < 256; b++)
+			{
+				if (node256Ptr->children[b] != NULL)
+				{
+					node48Ptr->children[slot++] = node256Ptr->children[b];
+					node48Ptr->childIndex[b] = slot;
+				}
+			}
+
+			deleteNode(node256Ptr);
+			nodeRef = node48Ptr;
+		}
+		break;
+	}
+	}
+}
+
+template <class ItemType>
+bool RadixTree<ItemType>::insertLeaf(RadixNode<ItemType>*& nodeRef, RadixLeaf<ItemType>* newLeafPtr, int depth)
+{
+	if (nodeRef == NULL) //Only for the root of an empty tree
+	{
+		nodeRef = newLeafPtr;
+		return true;
+	}
+
+	const unsigned char* key = newLeafPtr->key;
+	int keyLength = newLeafPtr->keyLength;
+
+	if (nodeRef->nodeType == RADIX_LEAF) //Replace the leaf by a node branching where the keys differ
+	{
+		RadixLeaf<ItemType>* leafPtr = static_cast<RadixLeaf<ItemType>*>(nodeRef);
+
+		int i = depth;
+		while (i < keyLength && i < leafPtr->keyLength && key[i] == leafPtr->key[i])
+			i++;
+		if (i == keyLength || i == leafPtr->keyLength) //No sort key is a beginning of another,
+			return false;				       //so the keys are the same
+
+		RadixNode<ItemType>* newNodePtr = createNode<RadixNode4<ItemType> >(RADIX_NODE_4);
+		setPrefix(newNodePtr, key + depth, i - depth);
+		addChild(newNodePtr, leafPtr->key[i], leafPtr);
+		addChild(newNodePtr, key[i], newLeafPtr);
+
+		nodeRef = newNodePtr;
+		return true;
+	}
+
+	int i = 0; //Match the compressed path against the key
+	while (i < nodeRef->prefixLength && nodeRef->prefix[i] == key[depth + i])
+		i++;
+
+	if (i < nodeRef->prefixLength) //The key leaves the path, so split it with a new node
+	{
+		RadixNode<ItemType>* newNodePtr = createNode<RadixNode4<ItemType> >(RADIX_NODE_4);
+		setPrefix(newNodePtr, nodeRef->prefix, i);
+
+		unsigned char oldByte = nodeRef->prefix[i]; //The rest of the path is below that byte
+		setPrefix(nodeRef, nodeRef->prefix + i + 1, nodeRef->prefixLength - i - 1);
+
+		addChild(newNodePtr, oldByte, nodeRef);
+		addChild(newNodePtr, key[depth + i], newLeafPtr);
+
+		nodeRef = newNodePtr;
+		return true;
+	}
+
+	depth += nodeRef->prefixLength;
+	RadixNode<ItemType>** childRef = findChild(nodeRef, key[depth]);
+	if (childRef != NULL)
+		return insertLeaf(*childRef, newLeafPtr, depth + 1);
+
+	addChild(nodeRef, key[depth], newLeafPtr);
+	return true;
+}
+
+template <class ItemType>
+bool RadixTree<ItemType>::removeLeaf(RadixNode<ItemType>*& nodeRef, const unsigned char key[],
+							int keyLength, int depth)
+{
+	if (nodeRef == NULL)
+		return false;
+
+	if (nodeRef->nodeType == RADIX_LEAF) //Only for a root leaf, inner nodes check their children
+	{
+		RadixLeaf<ItemType>* leafPtr = static_cast<RadixLeaf<ItemType>*>(nodeRef);
+		if (leafPtr->keyLength != keyLength || std::memcmp(leafPtr->key, key, keyLength) != 0)
+			return false;
+
+		deleteNode(leafPtr);
+		nodeRef = NULL;
+		return true;
+	}
+
+	if (depth + nodeRef->prefixLength >= keyLength ||
+		(nodeRef->prefixLength > 0 && std::memcmp(nodeRef->prefix, key + depth, nodeRef->prefixLength) != 0))
+		return false;
+
+	depth += nodeRef->prefixLength;
+	RadixNode<ItemType>** childRef = findChild(nodeRef, key[depth]);
+	if (childRef == NULL)
+		return false;
+
+	RadixNode<ItemType>* childPtr = *childRef;
+	if (childPtr->nodeType != RADIX_LEAF)
+		return removeLeaf(*childRef, key, keyLength, depth + 1);
+
+	RadixLeaf<ItemType>* leafPtr = static_cast<RadixLeaf<ItemType>*>(childPtr);
+	if (leafPtr->keyLength != keyLength || std::memcmp(leafPtr->key, key, keyLength) != 0)
+		return false;
+
+	deleteNode(leafPtr);
+	removeChild(nodeRef, key[depth]);
+	return true;
+}
+
+template <class ItemType>
+RadixLeaf<ItemType>* RadixTree<ItemType>::findLeaf(const unsigned char key[], int keyLength) const
+{
+	RadixNode<ItemType>* nodePtr = rootPtr;
+	int depth = 0;
+
+	while (nodePtr != NULL)
+	{
+		if (nodePtr->nodeType == RADIX_LEAF)
+		{
+			RadixLeaf<ItemType>* leafPtr = static_cast<RadixLeaf<ItemType>*>(nodePtr);
+			if (leafPtr->keyLength == keyLength && std::memcmp(leafPtr->key, key, keyLength) == 0)
+				return leafPtr;
+			else
+				return NULL;
+		}
+
+		if (depth + nodePtr->prefixLength >= keyLength ||
+			(nodePtr->prefixLength > 0 && std::memcmp(nodePtr->prefix, key + depth, nodePtr->prefixLength) != 0))
+			return NULL;
+
+		depth += nodePtr->prefixLength;
+		RadixNode<ItemType>** childRef = findChild(nodePtr, key[depth]);
+		if (childRef == NULL)
+			return NULL;
+
+		nodePtr = *childRef;
+		depth++;
+	}
+
+	return NULL;
+}
+
+template <class ItemType>
+RadixNode<ItemType>* RadixTree<ItemType>::copyTree(const RadixNode<ItemType>* subTreePtr) const
+{
+	if (subTreePtr == NULL)
+		return NULL;
+
+	RadixNode<ItemType>* newNodePtr = NULL;
+	switch (subTreePtr->nodeType)
+	{
+	case RADIX_LEAF:
+	{
+		const RadixLeaf<ItemType>* leafPtr = static_cast<const RadixLeaf<ItemType>*>(subTreePtr);
+		return createLeaf(leafPtr->item, leafPtr->key, leafPtr->keyLength);
+	}
+	case RADIX_NODE_4:
+		newNodePtr = new RadixNode4<ItemType>(*static_cast<const RadixNode4<ItemType>*>(subTreePtr));
+		break;
+	case RADIX_NODE_16:
+		newNodePtr = new RadixNode16<ItemType>(*static_cast<const RadixNode16<ItemType>*>(subTreePtr));
+		break;
+	case RADIX_NODE_48:
+		newNodePtr = new RadixNode48<ItemType>(*static_cast<const RadixNode48<ItemType>*>(subTreePtr));
+		break;
+	case RADIX_NODE_256:
+		newNodePtr = new RadixNode256<ItemType>(*static_cast<const RadixNode256<ItemType>*>(subTreePtr));
+		break;
+	}
+
+	newNodePtr->prefix = NULL; //The copy still shares the prefix and children of the original
+	setPrefix(newNodePtr, subTreePtr->prefix, subTreePtr->prefixLength);
+
+	int position = 0;
+	RadixNode<ItemType>* childPtr = getNextChild(newNodePtr, position);
+	while (childPtr != NULL)
+	{
+		*findChild(newNodePtr, getChildByte(newNodePtr, position)) = copyTree(childPtr);
+
+		position++;
+		childPtr = getNextChild(newNodePtr, position);
+	}
+
+	return newNodePtr;
+}
+
+template <class ItemType>
+void RadixTree<ItemType>::postorderDelete(RadixNode<ItemType>* subTreePtr)
+{
+	if (subTreePtr != NULL)
+	{
+		if (subTreePtr->nodeType != RADIX_LEAF)
+		{
+			int position = 0;
+			RadixNode<ItemType>* childPtr = getNextChild(subTreePtr, position);
+			while (childPtr != NULL)
+			{
+				postorderDelete(childPtr);
+
+				position++;
+				childPtr = getNextChild(subTreePtr, position);
+			}
+		}
+
+		deleteNode(subTreePtr);
+	}
+}
+
+template <class ItemType>
+int RadixTree<ItemType>::getHeightHelper(const RadixNode<ItemType>* subTreePtr) const
+{
+	if (subTreePtr == NULL)
+		return 0;
+	else if (subTreePtr->nodeType == RADIX_LEAF)
+		return 1;
+
+	int maxHeight = 0; //Unlike in a 2-3 tree, the leaves can be at any depth
+	int position = 0;
+	const RadixNode<ItemType>* childPtr = getNextChild(subTreePtr, position);
+	while (childPtr != NULL)
+	{
+		int childHeight = getHeightHelper(childPtr);
+		if (childHeight > maxHeight)
+			maxHeight = childHeight;
+
+		position++;
+		childPtr = getNextChild(subTreePtr, position);
+	}
+
+	return 1 + maxHeight;
+}
+
+template <class ItemType>
+void RadixTree<ItemType>::getNumNodes(const RadixNode<ItemType>* subTreePtr, int nodeCounts[]) const
+{
+	if (subTreePtr == NULL)
+		return;
+
+	switch (subTreePtr->nodeType)
+	{
+	case RADIX_LEAF:
+		nodeCounts[0]++;
+		return;
+	case RADIX_NODE_4:
+		nodeCounts[1]++;
+		break;
+	case RADIX_NODE_16:
+		nodeCounts[2]++;
+		break;
+	case RADIX_NODE_48:
+		nodeCounts[3]++;
+		break;
+	case RADIX_NODE_256:
+		nodeCounts[4]++;
+		break;
+	}
+
+	int position = 0;
+	const RadixNode<ItemType>* childPtr = getNextChild(subTreePtr, position);
+	while (childPtr != NULL)
+	{
+		getNumNodes(childPtr, nodeCounts);
+
+		position++;
+		childPtr = getNextChild(subTreePtr, position);
+	}
+}
+
+template <class ItemType>
+void RadixTree<ItemType>::writeSubtree(RadixNode<ItemType>* subTreePtr, BufferedWriter& writer) const
+{
+	auto writeItem = [&writer](const ItemType& item)
+	{
+		item.writeToFile(writer);
+		return true;
+	};
+	forEachHelper(subTreePtr, writeItem);
+}
+
+template <class ItemType>
+bool RadixTree<ItemType>::isEmpty() const
+{
+	return rootPtr == NULL;
+}
+
+template <class ItemType>
+int RadixTree<ItemType>::getHeight() const
+{
+	return getHeightHelper(rootPtr);
+}
+
+template <class ItemType>
+int RadixTree<ItemType>::getNumberOfItems() const
+{
+	return numItems;
+}
+
+template <class ItemType>
+bool RadixTree<ItemType>::add(const ItemType& newData)
+{
+	unsigned char buffer[KEY_BUFFER_SIZE];
+	unsigned char* key = getKeyArray(newData, buffer);
+	int keyLength = newData.getSortKey(key);
+
+	RadixLeaf<ItemType>* newLeafPtr = createLeaf(newData, key, keyLength);
+	bool isAdded = insertLeaf(rootPtr, newLeafPtr, 0);
+	if (isAdded)
+		numItems++;
+	else //Already in the tree
+		deleteNode(newLeafPtr);
+
+	if (key != buffer)
+		delete [] key;
+
+	return isAdded;
+}
+
+template <class ItemType>
+bool RadixTree<ItemType>::addAll(const ItemType items[], int numItems)
+{
+	for (int i = 0; i < numItems; i++)
+		add(items[i]);
+
+	return true;
+}
+
+template <class ItemType>
+int RadixTree<ItemType>::containsMany(const ItemType items[], int numItems, bool results[]) const
+{
+	int numFound = 0;
+	for (int i = 0; i < numItems; i++)
+	{
+		results[i] = contains(items[i]);
+		if (results[i])
+			numFound++;
+	}
+
+	return numFound;
+}
+
+template <class ItemType>
+int RadixTree<ItemType>::addMany(const ItemType items[], int numItems, bool results[])
+{
+	int numAdded = 0;
+	for (int i = 0; i < numItems; i++)
+	{
+		results[i] = add(items[i]);
+		if (results[i])
+			numAdded++;
+	}
+
+	return numAdded;
+}
+
+template <class ItemType>
+int RadixTree<ItemType>::removeMany(const ItemType items[], int numItems, bool results[])
+{
+	int numRemoved = 0;
+	for (int i = 0; i < numItems; i++)
+	{
+		results[i] = remove(items[i]);
+		if (results[i])
+			numRemoved++;
+	}
+
+	return numRemoved;
+}
+
+template <class ItemType>
+bool RadixTree<ItemType>::remove(const ItemType& anEntry)
+{
+	unsigned char buffer[KEY_BUFFER_SIZE];
+	unsigned char* key = getKeyArray(anEntry, buffer);
+	int keyLength = anEntry.getSortKey(key);
+
+	bool isRemoved = removeLeaf(rootPtr, key, keyLength, 0);
+	if (isRemoved)
+		numItems--;
+
+	if (key != buffer)
+		delete [] key;
+
+	return isRemoved;
+}
+
+template <class ItemType>
+void RadixTree<ItemType>::clear()
+{
+	postorderDelete(rootPtr);
+	rootPtr = NULL;
+	numItems = 0;
+}
+
+template <class ItemType>
+ItemType RadixTree<ItemType>::getEntry(const ItemType& anEntry) const
+{
+	unsigned char buffer[KEY_BUFFER_SIZE];
+	unsigned char* key = getKeyArray(anEntry, buffer);
+	int keyLength = anEntry.getSortKey(key);
+
+	RadixLeaf<ItemType>* leafPtr = findLeaf(key, keyLength);
+
+	if (key != buffer)
+		delete [] key;
+
+	if (leafPtr != NULL) //The item stored, whose title can differ in case and punctuation
+		return leafPtr->item;
+	else //Throw exception if the entry does not exist
+		throw(NotFoundException("getEntry() called with a nonexistant item."));
+}
+
+template <class ItemType>
+bool RadixTree<ItemType>::findEntry(const ItemType& anEntry, ItemType& foundEntry) const
+{
+	unsigned char buffer[KEY_BUFFER_SIZE];
+	unsigned char* key = getKeyArray(anEntry, buffer);
+	int keyLength = anEntry.getSortKey(key);
+
+	RadixLeaf<ItemType>* leafPtr = findLeaf(key, keyLength);
+	if (leafPtr != NULL)
+		foundEntry = leafPtr->item;
+
+	if (key != buffer)
+		delete [] key;
+
+	return (leafPtr != NULL);
+}
+
+template <class ItemType>
+bool RadixTree<ItemType>::contains(const ItemType& anEntry) const
+{
+	unsigned char buffer[KEY_BUFFER_SIZE];
+	unsigned char* key = getKeyArray(anEntry, buffer);
+	int keyLength = anEntry.getSortKey(key);
+
+	bool isFound = (findLeaf(key, keyLength) != NULL);
+
+	if (key != buffer)
+		delete [] key;
+
+	return isFound;
+}
+
+template <class ItemType>
+void RadixTree<ItemType>::traverse(void visit(ItemType&)) const
+{
+	for (iterator iter = begin(); iter != end(); ++iter)
+		visit(iter.leafPtr->item);
+}
+
+template <class ItemType>
+template <class Visitor>
+bool RadixTree<ItemType>::forEach(Visitor&& visit) const
+{
+	return forEachHelper(rootPtr, visit); //Recursion needs no path to be kept, unlike the iterator
+}
+
+template <class ItemType>
+template <class Visitor>
+bool RadixTree<ItemType>::forEachHelper(const RadixNode<ItemType>* subTreePtr, Visitor& visit) const
+{
+	if (subTreePtr == NULL)
+		return true;
+	else if (subTreePtr->nodeType == RADIX_LEAF)
+		return visit(static_cast<const RadixLeaf<ItemType>*>(subTreePtr)->item);
+
+	int position = 0;
+	const RadixNode<ItemType>* childPtr = getNextChild(subTreePtr, position);
+	while (childPtr != NULL)
+	{
+		if (!forEachHelper(childPtr, visit))
+			return false;
+
+		position++;
+		childPtr = getNextChild(subTreePtr, position);
+	}
+
+	return true;
+}
+
+template <class ItemType>
+typename RadixTree<ItemType>::iterator RadixTree<ItemType>::begin() const
+{
+	return iterator(rootPtr);
+}
+
+template <class ItemType>
+typename RadixTree<ItemType>::iterator RadixTree<ItemType>::end() const
+{
+	return iterator();
+}
+
+template <class ItemType>
+void RadixTree<ItemType>::rangeTraverse(const ItemType* lowPtr, const ItemType* highPtr,
+						void visit(ItemType&)) const
+{
+	forEachInRange(lowPtr, highPtr, [visit](ItemType& item)
+	{
+		visit(item);
+		return true;
+	});
+}
+
+template <class ItemType>
+template <class Visitor>
+bool RadixTree<ItemType>::forEachInRange(const ItemType* lowPtr, const ItemType* highPtr,
+						Visitor&& visit) const
+{
+	iterator iter = begin();
+	if (lowPtr != NULL)
+	{
+		unsigned char buffer[KEY_BUFFER_SIZE];
+		unsigned char* lowKey = getKeyArray(*lowPtr, buffer);
+		int lowKeyLength = lowPtr->getSortKey(lowKey);
+
+		iter = iterator(rootPtr, lowKey, lowKeyLength);
+
+		if (lowKey != buffer)
+			delete [] lowKey;
+	}
+
+	unsigned char buffer[KEY_BUFFER_SIZE];
+	unsigned char* highKey = NULL;
+	int highKeyLength = 0;
+	if (highPtr != NULL)
+	{
+		highKey = getKeyArray(*highPtr, buffer);
+		highKeyLength = highPtr->getSortKey(highKey);
+	}
+
+	bool isStopped = false; //Whether visit stopped the traversal
+	for (; iter != end(); ++iter)
+	{
+		if (highKey != NULL) //Stop at the first key >= the high key
+		{
+			int minLength = (iter.getKeyLength() < highKeyLength) ? iter.getKeyLength() : highKeyLength;
+			int comparison = std::memcmp(iter.getKey(), highKey, minLength);
+			if (comparison > 0 || (comparison == 0 && iter.getKeyLength() >= highKeyLength))
+				break;
+		}
+
+		if (!visit(iter.leafPtr->item))
+		{
+			isStopped = true;
+			break;
+		}
+	}
+
+	if (highKey != buffer)
+		delete [] highKey;
+
+	return !isStopped;
+}
+
+template <class ItemType>
+bool RadixTree<ItemType>::isOrdered() const
+{
+	return true;
+}
+
+template <class ItemType>
+void RadixTree<ItemType>::pageTraverse(int offset, int limit, void visit(ItemType&)) const
+{
+	iterator iter = begin();
+	for (int i = 0; i < offset && iter != end(); i++) //Leaves don't know their rank, so skip them
+		++iter;
+
+	for (int i = 0; i < limit && iter != end(); i++, ++iter)
+		visit(iter.leafPtr->item);
+}
+
+template <class ItemType>
+const ItemType* RadixTree<ItemType>::select(int index) const
+{
+	if (index < 0)
+		return NULL;
+
+	iterator iter = begin();
+	for (int i = 0; i < index && iter != end(); i++)
+		++iter;
+
+	return (iter != end()) ? &(iter.leafPtr->item) : NULL;
+}
+
+template <class ItemType>
+int RadixTree<ItemType>::rank(const ItemType& anEntry) const
+{
+	int numSmaller = 0;
+	for (iterator iter = begin(); iter != end() && iter.leafPtr->item < anEntry; ++iter)
+		numSmaller++;
+
+	return numSmaller;
+}
+
+template <class ItemType>
+void RadixTree<ItemType>::prefixTraverse(const ItemType& prefix, int limit, void visit(ItemType&)) const
+{
+	unsigned char buffer[KEY_BUFFER_SIZE];
+	unsigned char* key = getKeyArray(prefix, buffer);
+	int prefixLength = prefix.getSortKey(key) - 1; //Without the type byte at the end
+
+	//Every key starting with the prefix is >= it, and they are all together right after it
+	iterator iter(rootPtr, key, prefixLength);
+	for (int i = 0; (limit < 0 || i < limit) && iter != end(); i++, ++iter)
+	{
+		if (iter.getKeyLength() < prefixLength || std::memcmp(iter.getKey(), key, prefixLength) != 0)
+			break;
+
+		visit(iter.leafPtr->item);
+	}
+
+	if (key != buffer)
+		delete [] key;
+}
+
+template <class ItemType>
+void RadixTree<ItemType>::writeToFile(std::ostream& outFile) const
+{
+	BufferedWriter writer(outFile);
+	writeSubtree(rootPtr, writer);
+}
+
+template <class ItemType>
+void RadixTree<ItemType>::writeToFile(std::ostream& outFile, ThreadPool& pool) const
+{
+	if (pool.getNumThreads() <= 1 || numItems < MIN_PARALLEL_ITEMS || rootPtr->nodeType == RADIX_LEAF)
+	{
+		writeToFile(outFile); //Not worth splitting
+		return;
+	}
+
+	//The children of the root split the items by their first letter, and there are at most 256 of them
+	RadixNode<ItemType>* subtreePtrs[256];
+	int numSubtrees = 0;
+	int position = 0;
+	RadixNode<ItemType>* childPtr = getNextChild(rootPtr, position);
+	while (childPtr != NULL)
+	{
+		subtreePtrs[numSubtrees++] = childPtr;
+
+		position++;
+		childPtr = getNextChild(rootPtr, position);
+	}
+
+	std::ostringstream* buffers = new std::ostringstream[numSubtrees];
+	for (int i = 0; i < numSubtrees; i++) //Each subtree is written to its own buffer
+	{
+		RadixNode<ItemType>* subTreePtr = subtreePtrs[i];
+		std::ostringstream* bufferPtr = &buffers[i];
+		pool.submit([this, subTreePtr, bufferPtr]()
+		{
+			BufferedWriter writer(*bufferPtr);
+			writeSubtree(subTreePtr, writer);
+		});
+	}
+	pool.wait();
+
+	for (int i = 0; i < numSubtrees; i++) //Write the buffers in sorted order
+		outFile << buffers[i].str();
+
+	delete [] buffers;
+}
+
+template <class ItemType>
+void RadixTree<ItemType>::displayStatistics(std::ostream& os) const
+{
+	int nodeCounts[5] = {0, 0, 0, 0, 0};
+	getNumNodes(rootPtr, nodeCounts);
+
+	os << "Tree height: " << getHeight() << std::endl;
+	os << "Number of leaves: " << nodeCounts[0] << std::endl;
+	os << "Number of 4-nodes: " << nodeCounts[1] << std::endl;
+	os << "Number of 16-nodes: " << nodeCounts[2] << std::endl;
+	os << "Number of 48-nodes: " << nodeCounts[3] << std::endl;
+	os << "Number of 256-nodes: " << nodeCounts[4] << std::endl;
+	os << "Number of items: " << numItems << std::endl;
+	os << std::endl << std::endl;
+}
+
+template <class ItemType>
+void RadixTree<ItemType>::displayStatistics(std::ostream& os, ThreadPool&) const
+{
+	displayStatistics(os);
+}
+
+template <class ItemType>
+void RadixTree<ItemType>::takeSnapshot(const RadixTree<ItemType>& aTree)
+{
+	if (this != &aTree)
+	{
+		clear();
+		rootPtr = copyTree(aTree.rootPtr);
+		numItems = aTree.numItems;
+	}
+}
+
+#endif
@@ -0,0 +1,294 @@
+/*@file RadixTree.h*/
+#ifndef _RADIX_TREE_H
+#define _RADIX_TREE_H
+
+#include "BalancedSearchTreeInterface.h"
+#include "RadixNode.h"
+#include "RadixTreeIterator.h"
+#include "ThreadPool.h"
+#include "BufferedWriter.h"
+#include <iostream>
+
+const int KEY_BUFFER_SIZE = 64; //Sort keys up to this length are built on the stack
+
+/*
+Adaptive radix tree: a trie over the sort keys of the items (see MediaEntry::getSortKey), whose
+inner nodes grow from 4 to 16, 48 and 256 children as needed, and whose chains of single-child
+nodes are compressed into a prefix stored in the node below. A search looks at each byte of the
+key once instead of comparing whole titles at every level, so its cost depends on the length of
+the key rather than on the number of items. Items with the same sort key are the same entry, so
+the tree holds at most one of them.
+*/
+template <class ItemType>
+class RadixTree : public BalancedSearchTreeInterface<ItemType>
+{
+private:
+	RadixNode<ItemType>* rootPtr; //Pointer to the root of the tree
+	int numItems; //Number of items in the tree
+
+	/*
+	Returns an array big enough for the sort key of anEntry: buffer if the key fits in it,
+	otherwise a new array which the caller has to delete
+	@param anEntry The item whose sort key is needed
+	buffer Array of KEY_BUFFER_SIZE characters
+	@return The array to hold the sort key
+	*/
+	unsigned char* getKeyArray(const ItemType& anEntry, unsigned char buffer[]) const;
+
+	/*
+	Creates a node of type NodeType with no children and no prefix
+	@param nodeType The type of the node, one of the types in RadixNode.h
+	@return Pointer to the new node
+	*/
+	template <class NodeType>
+	NodeType* createNode(int nodeType) const;
+
+	/*
+	Creates a leaf holding a copy of anItem and of its sort key
+	@param anItem The item of the leaf
+	key The sort key of anItem
+	keyLength The length of key
+	@return Pointer to the new leaf
+	*/
+	RadixLeaf<ItemType>* createLeaf(const ItemType& anItem, const unsigned char key[], int keyLength) const;
+
+	/*
+	Deletes the node along with its prefix, or the key of a leaf, but not its children
+	@post The node is deleted
+	@param nodePtr Pointer to the node
+	*/
+	void deleteNode(RadixNode<ItemType>* nodePtr);
+
+	/*
+	Replaces the prefix of the node with a copy of length bytes starting at bytes, which may
+	be part of the current prefix
+	@post The node has the new prefix
+	@param nodePtr Pointer to the inner node
+	bytes The bytes of the new prefix
+	length The length of the new prefix
+	*/
+	void setPrefix(RadixNode<ItemType>* nodePtr, const unsigned char bytes[], int length) const;
+
+	/*
+	Moves the number of children and the prefix of fromPtr to toPtr, used when a node is
+	replaced by a larger or smaller one
+	@post toPtr has the header of fromPtr, and fromPtr no longer has a prefix
+	@param fromPtr Pointer to the node being replaced
+	toPtr Pointer to the replacing node
+	*/
+	void moveHeader(RadixNode<ItemType>* fromPtr, RadixNode<ItemType>* toPtr);
+
+	/*
+	Returns the link from the inner node to its child for keyByte
+	@param nodePtr Pointer to the inner node
+	keyByte The key byte of the child
+	@return Pointer to the node's pointer to the child, NULL if there is no such child
+	*/
+	RadixNode<ItemType>** findChild(RadixNode<ItemType>* nodePtr, unsigned char keyByte) const;
+
+	/*
+	Adds childPtr as the child of the inner node for keyByte. A full node is replaced by one of
+	the next larger type.
+	@pre The node has no child for keyByte
+	@post nodeRef points to the node, or its replacement, which has the new child
+	@param nodeRef Reference to the pointer to the inner node
+	keyByte The key byte of the child
+	childPtr Pointer to the new child
+	*/
+	void addChild(RadixNode<ItemType>*& nodeRef, unsigned char keyByte, RadixNode<ItemType>* childPtr);
+
+	/*
+	Removes the child of the inner node for keyByte, without deleting it. A node left with few
+	children is replaced by one of the next smaller type, and a RadixNode4 left with a single
+	child is replaced by that child, with its own prefix and key byte added to the child's prefix.
+	@pre The node has a child for keyByte
+	@post nodeRef points to the node, or its replacement, which no longer has the child
+	@param nodeRef Reference to the pointer to the inner node
+	keyByte The key byte of the child
+	*/
+	void removeChild(RadixNode<ItemType>*& nodeRef, unsigned char keyByte);
+
+	/*
+	Inserts the leaf into the subtree, splitting a leaf or a compressed path where the new key
+	leaves them
+	@post The leaf is in the subtree, unless an item with the same key already was
+	@param nodeRef Reference to the pointer to the root of the subtree
+	newLeafPtr Pointer to the new leaf
+	depth The number of key bytes matched above the subtree
+	@return True if the leaf was inserted, false if its key was already there
+	*/
+	bool insertLeaf(RadixNode<ItemType>*& nodeRef, RadixLeaf<ItemType>* newLeafPtr, int depth);
+
+	/*
+	Removes the leaf with the given sort key from the subtree, if there is one
+	@post The leaf is removed and deleted, and the nodes above it shrunk if necessary
+	@param nodeRef Reference to the pointer to the root of the subtree
+	key The sort key of the item to be removed
+	keyLength The length of key
+	depth The number of key bytes matched above the subtree
+	@return True if the leaf was found and removed, false otherwise
+	*/
+	bool removeLeaf(RadixNode<ItemType>*& nodeRef, const unsigned char key[], int keyLength, int depth);
+
+	/*
+	Returns the leaf with the given sort key
+	@param key The sort key to be looked for
+	keyLength The length of key
+	@return Pointer to the leaf, NULL if there is none
+	*/
+	RadixLeaf<ItemType>* findLeaf(const unsigned char key[], int keyLength) const;
+
+	/*
+	Recursively copies or deletes the subtree
+	@param subTreePtr Pointer to the root of the subtree
+	@return Pointer to the copy of the subtree
+	*/
+	RadixNode<ItemType>* copyTree(const RadixNode<ItemType>* subTreePtr) const;
+	void postorderDelete(RadixNode<ItemType>* subTreePtr);
+
+	/*
+	Computes the height of the subtree, counting the leaves
+	@param subTreePtr Pointer to the root of the subtree
+	@return The height of the subtree. Empty tree has 0 height.
+	*/
+	int getHeightHelper(const RadixNode<ItemType>* subTreePtr) const;
+
+	/*
+	Counts the nodes of each type in the subtree
+	@post nodeCounts[i] is incremented for every node of the i-th type: leaves, then the
+	RadixNode4, RadixNode16, RadixNode48 and RadixNode256 nodes
+	@param subTreePtr Pointer to the root of the subtree
+	nodeCounts Array of 5 counters
+	*/
+	void getNumNodes(const RadixNode<ItemType>* subTreePtr, int nodeCounts[]) const;
+
+	/*
+	Writes out the items of the subtree in order to writer
+	@post The items of the subtree are written to writer
+	@param subTreePtr Pointer to the root of the subtree
+	writer The writer collecting the output for the file
+	*/
+	void writeSubtree(RadixNode<ItemType>* subTreePtr, BufferedWriter& writer) const;
+
+	/*
+	Visits the items of the subtree in order, as forEach does
+	@param subTreePtr Pointer to the root of the subtree
+	visit Callable taking a const ItemType& and returning whether to continue
+	@return False if visit stopped the traversal, true otherwise
+	*/
+	template <class Visitor>
+	bool forEachHelper(const RadixNode<ItemType>* subTreePtr, Visitor& visit) const;
+
+public:
+	typedef RadixTreeIterator<ItemType> iterator; //Iterators only give read access to the items
+	typedef RadixTreeIterator<ItemType> const_iterator;
+
+	RadixTree();
+	RadixTree(const RadixTree<ItemType>& aTree);
+	virtual ~RadixTree();
+
+	//These are all specified in BalancedSearchTreeInterface.h
+	bool isEmpty() const;
+	int getHeight() const;
+	int getNumberOfItems() const;
+	bool add(const ItemType& newData);
+	bool remove(const ItemType& anEntry);
+	void clear();
+	ItemType getEntry(const ItemType& anEntry) const;
+	bool findEntry(const ItemType& anEntry, ItemType& foundEntry) const; //See TwoThreeTree
+	bool contains(const ItemType& anEntry) const;
+	void traverse(void visit(ItemType&)) const;
+
+	/*
+	Same as forEach in TwoThreeTree
+	*/
+	template <class Visitor>
+	bool forEach(Visitor&& visit) const;
+
+	/*
+	Adds every item of the array items into the tree. The shape of a radix tree doesn't
+	depend on the insertion order, so they are simply added one at a time.
+	@post Every item of items is stored in the tree
+	@param items The array of items to be added
+	numItems The number of items in the array
+	@return True if addition was successful, false if not
+	*/
+	bool addAll(const ItemType items[], int numItems);
+
+	/*
+	Same as contains, add and remove for every item of an array. Each step of a search depends
+	on the key byte compared at the previous one, so the items are simply handled in turn.
+	@post results[i] is what contains, add or remove returned for items[i]
+	@param items The array of items
+	numItems The number of items in the array
+	results Array of numItems flags receiving the result for each item
+	@return The number of items found, added or removed
+	*/
+	int containsMany(const ItemType items[], int numItems, bool results[]) const;
+	int addMany(const ItemType items[], int numItems, bool results[]);
+	int removeMany(const ItemType items[], int numItems, bool results[]);
+
+	/*
+	Returns an iterator at the smallest item of the tree, or the end iterator, so the tree
+	can be used in a range-based for loop
+	@return The iterator at the smallest item or at the end, respectively
+	*/
+	iterator begin() const;
+	iterator end() const;
+
+	/*
+	Same as in TwoThreeTree. The first item of the range is found in time proportional to the
+	length of its key, and the next ones in constant amortized time each. Pages are found by
+	skipping the first offset items, and select and rank go through the items before theirs.
+	*/
+	void rangeTraverse(const ItemType* lowPtr, const ItemType* highPtr, void visit(ItemType&)) const;
+	void pageTraverse(int offset, int limit, void visit(ItemType&)) const;
+	template <class Visitor>
+	bool forEachInRange(const ItemType* lowPtr, const ItemType* highPtr, Visitor&& visit) const;
+	bool isOrdered() const;
+	const ItemType* select(int index) const;
+	int rank(const ItemType& anEntry) const;
+
+	/*
+	Traverses in order up to limit items whose title starts with the title of prefix, ignoring
+	case and non-alphabetical characters as compareTitles does, e.g. to autocomplete a title.
+	It takes time proportional to the length of the prefix plus the number of items visited.
+	@post Visit is executed for the first limit items having the prefix, or all of them if
+	limit < 0
+	@param prefix Item whose title is the prefix. Its type is ignored.
+	limit The maximum number of items to be visited, or -1 for no limit
+	visit(ItemType&) A client defined function that performs an action on an item of the tree
+	*/
+	void prefixTraverse(const ItemType& prefix, int limit, void visit(ItemType&)) const;
+
+	/*
+	Writes out the contents of the tree in order to outFile. With a pool, the subtrees below
+	the root are written concurrently to their own buffers, which are then written out in order.
+	@post The contents of the tree are written to outFile
+	@param outFile Ostream variable storing the file
+	pool The thread pool processing the subtrees
+	*/
+	void writeToFile(std::ostream& outFile) const;
+	void writeToFile(std::ostream& outFile, ThreadPool& pool) const;
+
+	/*
+	Writes out the number of items, the height of the tree and the number of nodes of each
+	type to os. The statistics are gathered by this thread even if a pool is given.
+	@post The statistics of the tree are written to os
+	@param os Ostream variable for the output
+	pool Unused
+	*/
+	void displayStatistics(std::ostream& os) const;
+	void displayStatistics(std::ostream& os, ThreadPool& pool) const;
+
+	/*
+	Replaces the contents of the tree with a copy of aTree
+	@post The tree is identical to aTree
+	@param aTree The tree to be copied
+	*/
+	void takeSnapshot(const RadixTree<ItemType>& aTree);
+};
+
+#include "RadixTree.cpp"
+
+#endif
@@ -0,0 +1,171 @@
+#ifndef _RADIX_TREE_ITERATOR_CPP
+#define _RADIX_TREE_ITERATOR_CPP
+
+#include <cstring>
+#include "RadixTreeIterator.h"
+
+template <class ItemType>
+RadixTreeIterator<ItemType>::RadixTreeIterator(RadixNode<ItemType>* rootPtr)
+{
+	leafPtr = NULL;
+	if (rootPtr != NULL) //Smallest item is at the end of the leftmost path
+		pushLeftPath(rootPtr);
+}
+
+template <class ItemType>
+RadixTreeIterator<ItemType>::RadixTreeIterator(RadixNode<ItemType>* rootPtr, const unsigned char key[],
+						int keyLength)
+{
+	leafPtr = NULL;
+	RadixNode<ItemType>* nodePtr = rootPtr;
+	int depth = 0; //Number of key bytes matched so far
+
+	while (nodePtr != NULL)
+	{
+		if (nodePtr->nodeType == RADIX_LEAF) //Either the bound, or the leaf right before it
+		{
+			RadixLeaf<ItemType>* currentPtr = static_cast<RadixLeaf<ItemType>*>(nodePtr);
+			int minLength = (currentPtr->keyLength < keyLength) ? currentPtr->keyLength : keyLength;
+			int comparison = std::memcmp(currentPtr->key, key, minLength);
+
+			if (comparison > 0 || (comparison == 0 && currentPtr->keyLength >= keyLength))
+				leafPtr = currentPtr;
+			else
+				moveToNextSubtree();
+			return;
+		}
+
+		int i = 0; //Match the compressed path against the key
+		while (i < nodePtr->prefixLength && depth + i < keyLength && nodePtr->prefix[i] == key[depth + i])
+			i++;
+
+		if (i < nodePtr->prefixLength) //Every key of the subtree differs from key at the same byte
+		{
+			if (depth + i >= keyLength || nodePtr->prefix[i] > key[depth + i])
+				pushLeftPath(nodePtr); //So they are all greater,
+			else
+				moveToNextSubtree(); //or all smaller
+			return;
+		}
+
+		depth += nodePtr->prefixLength;
+		if (depth >= keyLength) //key is a beginning of every key in the subtree, so it is smaller
+		{
+			pushLeftPath(nodePtr);
+			return;
+		}
+
+		int position = getChildPosition(nodePtr, key[depth]);
+		RadixNode<ItemType>* childPtr = getNextChild(nodePtr, position);
+		if (childPtr == NULL) //Every child is smaller
+		{
+			moveToNextSubtree();
+			return;
+		}
+
+		pathPtr.push_back(nodePtr);
+		childPosition.push_back(position);
+
+		if (getChildByte(nodePtr, position) > key[depth]) //First child past the key
+		{
+			pushLeftPath(childPtr);
+			return;
+		}
+
+		nodePtr = childPtr; //Same byte, so keep matching below
+		depth++;
+	}
+}
+
+template <class ItemType>
+void RadixTreeIterator<ItemType>::pushLeftPath(RadixNode<ItemType>* subTreePtr)
+{
+	while (subTreePtr->nodeType != RADIX_LEAF)
+	{
+		int position = 0;
+		RadixNode<ItemType>* childPtr = getNextChild(subTreePtr, position);
+
+		pathPtr.push_back(subTreePtr);
+		childPosition.push_back(position);
+
+		subTreePtr = childPtr;
+	}
+
+	leafPtr = static_cast<RadixLeaf<ItemType>*>(subTreePtr);
+}
+
+template <class ItemType>
+void RadixTreeIterator<ItemType>::moveToNextSubtree()
+{
+	while (!pathPtr.empty())
+	{
+		int position = childPosition.back() + 1;
+		RadixNode<ItemType>* childPtr = getNextChild(pathPtr.back(), position);
+		if (childPtr != NULL) //The next child's subtree holds the next items
+		{
+			childPosition.back() = position;
+			pushLeftPath(childPtr);
+			return;
+		}
+
+		pathPtr.pop_back(); //No children left, so go back up
+		childPosition.pop_back();
+	}
+
+	leafPtr = NULL; //Went past the last item
+}
+
+template <class ItemType>
+const ItemType& RadixTreeIterator<ItemType>::operator*() const
+{
+	return leafPtr->item;
+}
+
+template <class ItemType>
+const ItemType* RadixTreeIterator<ItemType>::operator->() const
+{
+	return &(leafPtr->item);
+}
+
+template <class ItemType>
+const unsigned char* RadixTreeIterator<ItemType>::getKey() const
+{
+	return leafPtr->key;
+}
+
+template <class ItemType>
+int RadixTreeIterator<ItemType>::getKeyLength() const
+{
+	return leafPtr->keyLength;
+}
+
+template <class ItemType>
+RadixTreeIterator<ItemType>& RadixTreeIterator<ItemType>::operator++()
+{
+	moveToNextSubtree(); //The current leaf is a subtree of its own
+
+	return *this;
+}
+
+template <class ItemType>
+RadixTreeIterator<ItemType> RadixTreeIterator<ItemType>::operator++(int)
+{
+	RadixTreeIterator<ItemType> previous = *this;
+	++(*this);
+
+	return previous;
+}
+
+template <class ItemType>
+bool RadixTreeIterator<ItemType>::operator==(const RadixTreeIterator<ItemType>& otherIterator) const
+{
+	return leafPtr == otherIterator.leafPtr;
+}
+
+template <class ItemType>
+bool RadixTreeIterator<ItemType>::operator!=(const RadixTreeIterator<ItemType>& otherIterator) const
+{
+	return !(*this == otherIterator);
+}
+
+#endif
@@ -0,0 +1,94 @@
+/*@file RadixTreeIterator.h*/
+#ifndef _RADIX_TREE_ITERATOR_H
+#define _RADIX_TREE_ITERATOR_H
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+#include "RadixNode.h"
+
+template <class ItemType>
+class RadixTree;
+
+/*
+Forward iterator visiting the items of an adaptive radix tree in the order of their sort keys.
+Like TwoThreeTreeIterator, it keeps the path from the root to the current leaf. The path is as
+long as the number of inner nodes above the leaf, so it grows as needed.
+*/
+template <class ItemType>
+class RadixTreeIterator
+{
+public:
+	typedef std::forward_iterator_tag iterator_category;
+	typedef ItemType value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef const ItemType* pointer;
+	typedef const ItemType& reference;
+
+private:
+	//Inner nodes on the path from the root to the current leaf, and the position (see getNextChild)
+	//of the child the path goes through in each of them. leafPtr is NULL at the end.
+	std::vector<RadixNode<ItemType>*> pathPtr;
+	std::vector<int> childPosition;
+	RadixLeaf<ItemType>* leafPtr;
+
+	friend class RadixTree<ItemType>; //The tree visits the items of its leaves directly
+
+	/*
+	Extends the path from subTreePtr down to the leaf with the smallest key in its subtree
+	@post The current leaf is the smallest leaf of the subtree
+	@param subTreePtr Pointer to the root of the subtree
+	*/
+	void pushLeftPath(RadixNode<ItemType>* subTreePtr);
+
+	/*
+	Moves past the subtree the last node of the path is going through, to the smallest leaf of
+	the next subtree, going up the path as long as there is none
+	@post The current leaf is the first leaf after that subtree, or the iterator is at the end
+	*/
+	void moveToNextSubtree();
+
+public:
+	/*
+	Creates an iterator at the smallest item of the tree rooted at rootPtr, or at the end
+	if rootPtr is NULL
+	*/
+	RadixTreeIterator(RadixNode<ItemType>* rootPtr = NULL);
+
+	/*
+	Creates an iterator at the first item of the tree rooted at rootPtr whose sort key is
+	>= key, or at the end if there is none. It takes time proportional to the key length.
+	@param rootPtr Pointer to the root of the tree
+	key The sort key to be looked for
+	keyLength The length of key
+	*/
+	RadixTreeIterator(RadixNode<ItemType>* rootPtr, const unsigned char key[], int keyLength);
+
+	/*
+	Returns the current item, or the sort key of the current item
+	@pre The iterator is not at the end
+	@return A reference to the current item, or a pointer to its sort key
+	*/
+	const ItemType& operator*() const;
+	const ItemType* operator->() const;
+	const unsigned char* getKey() const;
+	int getKeyLength() const;
+
+	/*
+	Moves the iterator to the next item in order, or to the end if there is none
+	@pre The iterator is not at the end
+	@return The iterator after (prefix) or before (postfix) the move
+	*/
+	RadixTreeIterator<ItemType>& operator++();
+	RadixTreeIterator<ItemType> operator++(int);
+
+	/*
+	Two iterators are equal if they are both at the end, or at the same leaf
+	*/
+	bool operator==(const RadixTreeIterator<ItemType>& otherIterator) const;
+	bool operator!=(const RadixTreeIterator<ItemType>& otherIterator) const;
+};
+
+#include "RadixTreeIterator.cpp"
+
+#endif
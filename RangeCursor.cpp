@@ -0,0 +1,166 @@
+#ifndef _RANGE_CURSOR_CPP
+#define _RANGE_CURSOR_CPP
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include "RangeCursor.h"
+
+template <class ItemType>
+RangeCursor<ItemType>::RangeCursor() : numItems(0), position(0), startPtr(NULL), numEqualFetched(0),
+					numSkipped(0), hasMore(false)
+{
+}
+
+template <class ItemType>
+template <class Source>
+void RangeCursor<ItemType>::fetch(Source&& source)
+{
+	numItems = 0;
+	position = 0;
+	numSkipped = 0;
+	hasMore = !source(startPtr, *this); //forEachInRange was stopped by a full chunk
+	if (numItems == 0)
+	{
+		hasMore = false;
+		return;
+	}
+
+	//The next chunk starts at the last item, so it skips the items equal to it fetched so far,
+	//which come first in it
+	const ItemType* lastPtr = itemPtrs[numItems-1];
+	int numEqual = 1;
+	while (numEqual < numItems && !(*itemPtrs[numItems-1-numEqual] < *lastPtr))
+		numEqual++;
+	if (numEqual == numItems && startPtr != NULL && !(*startPtr < *lastPtr)) //The whole chunk
+		numEqual += numEqualFetched;					   //equals the last one
+
+	startPtr = lastPtr;
+	numEqualFetched = numEqual;
+}
+
+template <class ItemType>
+template <class Source>
+void RangeCursor<ItemType>::start(const ItemType* lowPtr, Source&& source)
+{
+	startPtr = lowPtr;
+	numEqualFetched = 0;
+	fetch(source);
+}
+
+template <class ItemType>
+template <class Source>
+void RangeCursor<ItemType>::next(Source&& source)
+{
+	position++;
+	if (position == numItems && hasMore)
+		fetch(source);
+}
+
+template <class ItemType>
+bool RangeCursor<ItemType>::isAtEnd() const
+{
+	return position >= numItems;
+}
+
+template <class ItemType>
+const ItemType& RangeCursor<ItemType>::getItem() const
+{
+	return *itemPtrs[position];
+}
+
+template <class ItemType>
+bool RangeCursor<ItemType>::take(const ItemType& anItem)
+{
+	if (numSkipped < numEqualFetched) //Already in the previous chunk
+	{
+		numSkipped++;
+		return true;
+	}
+
+	itemPtrs[numItems++] = &anItem;
+	return (numItems < CURSOR_CHUNK_SIZE);
+}
+
+template <class ItemType>
+template <class Source, class Visitor>
+bool RangeCursor<ItemType>::merge(int numSources, const ItemType* lowPtr, Source&& source, Visitor&& visit)
+{
+	std::vector<RangeCursor<ItemType> > cursors(numSources);
+	std::vector<int> heap; //Positions of the cursors not at the end
+	for (int i = 0; i < numSources; i++)
+	{
+		cursors[i].start(lowPtr, [&source, i](const ItemType* chunkLowPtr, RangeCursor<ItemType>& cursor)
+		{
+			return source(i, chunkLowPtr, cursor);
+		});
+		if (!cursors[i].isAtEnd())
+			heap.push_back(i);
+	}
+
+	auto isAfter = [&cursors](int one, int other)
+	{
+		return (cursors[other].getItem() < cursors[one].getItem());
+	};
+
+	std::make_heap(heap.begin(), heap.end(), isAfter);
+	while (!heap.empty())
+	{
+		std::pop_heap(heap.begin(), heap.end(), isAfter);
+		int i = heap.back();
+		if (!visit(cursors[i].getItem()))
+			return false;
+
+		cursors[i].next([&source, i](const ItemType* chunkLowPtr, RangeCursor<ItemType>& cursor)
+		{
+			return source(i, chunkLowPtr, cursor);
+		});
+		if (cursors[i].isAtEnd())
+			heap.pop_back();
+		else //The cursor goes back in the heap with its next item
+			std::push_heap(heap.begin(), heap.end(), isAfter);
+	}
+
+	return true;
+}
+
+template <class ItemType>
+template <class Selector, class Ranker>
+const ItemType* RangeCursor<ItemType>::selectMerged(int numSources, int index, Selector&& select,
+							Ranker&& rank)
+{
+	auto countSmaller = [numSources, &rank](const ItemType& anItem)
+	{
+		int numSmaller = 0;
+		for (int i = 0; i < numSources; i++)
+			numSmaller += rank(i, anItem);
+		return numSmaller;
+	};
+
+	const ItemType* resultPtr = NULL;
+	for (int i = 0; i < numSources; i++)
+	{
+		const ItemType* candidatePtr = NULL;
+		int low = 0; //At most index items are smaller than the item at position index in any of
+		int high = index; //them, and equal items past it are the same item as far as the merge goes
+		while (low <= high)
+		{
+			int mid = low + (high - low)/2;
+			const ItemType* itemPtr = select(i, mid);
+			if (itemPtr != NULL && countSmaller(*itemPtr) <= index)
+			{
+				candidatePtr = itemPtr;
+				low = mid + 1;
+			}
+			else
+				high = mid - 1;
+		}
+
+		if (candidatePtr != NULL && (resultPtr == NULL || *resultPtr < *candidatePtr))
+			resultPtr = candidatePtr;
+	}
+
+	return resultPtr;
+}
+
+#endif
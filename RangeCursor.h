@@ -0,0 +1,109 @@
+/*@file RangeCursor.h*/
+#ifndef _RANGE_CURSOR_H
+#define _RANGE_CURSOR_H
+
+const int CURSOR_CHUNK_SIZE = 64; //Items a cursor fetches from its data structure at a time
+
+/*
+Position in the items of a sorted data structure lying in a range, used to merge several of
+them lazily, e.g. the partitions of a library or the shards of a sharded one. The items are
+fetched a chunk at a time with forEachInRange, each chunk starting from the last item of the
+previous one, so a merge that is stopped early has only gone through the chunks it used: a
+search of the data structure per chunk, plus the items visited.
+*/
+template <class ItemType>
+class RangeCursor
+{
+private:
+	const ItemType* itemPtrs[CURSOR_CHUNK_SIZE]; //The chunk fetched last
+	int numItems; //Number of items in the chunk
+	int position; //Position of the current item in the chunk
+	const ItemType* startPtr; //Where the next chunk starts: the lower bound, then the last item fetched
+	int numEqualFetched; //Items equal to *startPtr fetched so far, which the next chunk skips
+	int numSkipped; //Items skipped by the chunk being fetched
+	bool hasMore; //False once the range ended within a chunk
+
+	/*
+	Fetches the next chunk of items
+	@post The current item is the first item of the chunk, or the cursor is at the end
+	@param source Callable taking the lower bound of the chunk and the cursor, which calls
+	forEachInRange of the data structure with take as the visit, and returns its result
+	*/
+	template <class Source>
+	void fetch(Source&& source);
+
+public:
+	RangeCursor();
+
+	/*
+	Starts the cursor at the first item >= *lowPtr
+	@post The cursor is at the first item in the range, or at the end if there is none
+	@param lowPtr Pointer to the inclusive lower bound, NULL if there is no lower bound
+	source See fetch
+	*/
+	template <class Source>
+	void start(const ItemType* lowPtr, Source&& source);
+
+	/*
+	Moves the cursor to the next item, fetching the next chunk if the current one is done
+	@pre The cursor is not at the end
+	@param source See fetch
+	*/
+	template <class Source>
+	void next(Source&& source);
+
+	/*
+	Tells if every item of the range has been gone through
+	@return True if there is no current item
+	*/
+	bool isAtEnd() const;
+
+	/*
+	Returns the current item
+	@pre The cursor is not at the end
+	@return A reference to the current item
+	*/
+	const ItemType& getItem() const;
+
+	/*
+	Adds an item to the chunk being fetched, used as the visit of forEachInRange by the source
+	@param anItem The item visited by forEachInRange
+	@return False once the chunk is full, to stop forEachInRange
+	*/
+	bool take(const ItemType& anItem);
+
+	/*
+	Visits the items of several sorted data structures lying in a range, merged in sorted
+	order, with a cursor in each one and a heap of the cursors, smallest item on top
+	@post visit is executed for the items in the range, up to the first call returning false
+	@param numSources The number of data structures
+	lowPtr Pointer to the inclusive lower bound, NULL if there is no lower bound
+	source Callable taking the position of a data structure, the lower bound of a chunk and a
+	cursor, which calls forEachInRange of that data structure as in fetch
+	visit Callable taking a const ItemType& and returning true to continue, false to stop
+	@return False if visit stopped the traversal, true otherwise
+	*/
+	template <class Source, class Visitor>
+	static bool merge(int numSources, const ItemType* lowPtr, Source&& source, Visitor&& visit);
+
+	/*
+	Finds the item at a position in the merged order of several sorted data structures, e.g.
+	to start a page there. Each data structure is binary searched for its last item with at most
+	index items smaller than it in all of them together, and the largest of those is the item.
+	Equal items come one after the other in the merge, so the item is followed there by the
+	items equal to it, the first index - (number of items smaller) of which are before index.
+	@param numSources The number of data structures
+	index The position of the item in the merged order
+	select Callable taking the position of a data structure and a position in it, and returning
+	a pointer to the item there, NULL if it is past the end
+	rank Callable taking the position of a data structure and an item, and returning the number
+	of items smaller than it in that data structure
+	@return Pointer to the item, NULL if there are no items
+	*/
+	template <class Selector, class Ranker>
+	static const ItemType* selectMerged(int numSources, int index, Selector&& select, Ranker&& rank);
+};
+
+#include "RangeCursor.cpp"
+
+#endif
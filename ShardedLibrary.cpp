@@ -0,0 +1,658 @@
+#ifndef _SHARDED_LIBRARY_CPP
+#define _SHARDED_LIBRARY_CPP
+
+#include "ShardedLibrary.h"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+#include "BufferedWriter.h"
+
+template <template <class MediaEntry> class DataStructure>
+ShardedLibrary<DataStructure>::ShardedLibrary(int aNumShards) : pool(aNumShards)
+{
+	numShards = pool.getNumThreads(); //The pool has one worker per shard
+	shards = new MediaLibrary<DataStructure>*[numShards];
+	for (int s = 0; s < numShards; s++)
+		shards[s] = new MediaLibrary<DataStructure>(1);
+
+	wordIndexPtr = NULL;
+	fuzzyIndexPtr = NULL;
+	lookupCacheCapacity = 0;
+}
+
+template <template <class MediaEntry> class DataStructure>
+ShardedLibrary<DataStructure>::~ShardedLibrary()
+{
+	for (int s = 0; s < numShards; s++)
+		delete shards[s];
+	delete [] shards;
+	delete wordIndexPtr;
+	delete fuzzyIndexPtr;
+}
+
+template <template <class MediaEntry> class DataStructure>
+int ShardedLibrary<DataStructure>::getShard(const MediaEntry& media) const
+{
+	unsigned char shortKey[MAX_SHORT_SORT_KEY];
+	unsigned char* key = (media.length() < MAX_SHORT_SORT_KEY) ? shortKey : new unsigned char[media.length() + 1];
+	int keyLength = media.getSortKey(key);
+
+	unsigned int hash = 2166136261u; //FNV-1a
+	for (int i = 0; i < keyLength; i++)
+	{
+		hash ^= key[i];
+		hash *= 16777619u;
+	}
+
+	if (key != shortKey)
+		delete [] key;
+
+	return hash % numShards;
+}
+
+template <template <class MediaEntry> class DataStructure>
+template <class Visitor>
+bool ShardedLibrary<DataStructure>::forEachMerged(char mediaType, const MediaEntry* lowPtr,
+							const MediaEntry* highPtr, Visitor&& visit) const
+{
+	if (!shards[0]->isOrdered()) //Nothing to merge, so the shards are visited directly
+	{
+		for (int s = 0; s < numShards; s++)
+		{
+			bool isDone = (mediaType == '\0') ?
+				!shards[s]->forEachInRange(lowPtr, highPtr, visit) :
+				!shards[s]->forEachOfTypeInRange(mediaType, lowPtr, highPtr, visit);
+			if (isDone)
+				return false;
+		}
+
+		return true;
+	}
+
+	return RangeCursor<MediaEntry>::merge(numShards, lowPtr, [this, mediaType, highPtr](int s,
+					const MediaEntry* chunkLowPtr, RangeCursor<MediaEntry>& cursor)
+	{
+		auto takeEntry = [&cursor](const MediaEntry& media)
+		{
+			return cursor.take(media);
+		};
+
+		if (mediaType == '\0')
+			return shards[s]->forEachInRange(chunkLowPtr, highPtr, takeEntry);
+		else
+			return shards[s]->forEachOfTypeInRange(mediaType, chunkLowPtr, highPtr, takeEntry);
+	}, visit);
+}
+
+template <template <class MediaEntry> class DataStructure>
+template <class Operation>
+int ShardedLibrary<DataStructure>::runOnShards(const MediaEntry media[], int numEntries, bool results[],
+						Operation&& operation) const
+{
+	int* shardOf = new int[numEntries > 0 ? numEntries : 1];
+	int* shardStarts = new int[numShards + 1]; //Part of each shard in the entries sorted by shard
+	int* order = new int[numEntries > 0 ? numEntries : 1]; //Positions of the entries sorted by shard
+	int* numFound = new int[numShards];
+
+	for (int s = 0; s <= numShards; s++)
+		shardStarts[s] = 0;
+	for (int i = 0; i < numEntries; i++)
+	{
+		shardOf[i] = getShard(media[i]);
+		shardStarts[shardOf[i] + 1]++;
+	}
+	for (int s = 0; s < numShards; s++)
+		shardStarts[s + 1] += shardStarts[s];
+
+	int* nextPos = new int[numShards]; //The entries keep their order within each shard
+	for (int s = 0; s < numShards; s++)
+		nextPos[s] = shardStarts[s];
+	for (int i = 0; i < numEntries; i++)
+		order[nextPos[shardOf[i]]++] = i;
+	delete [] nextPos;
+
+	for (int s = 0; s < numShards; s++)
+	{
+		numFound[s] = 0;
+		if (shardStarts[s] == shardStarts[s + 1])
+			continue;
+
+		pool.submit([this, s, media, results, shardStarts, order, numFound, &operation]()
+		{
+			int numShardEntries = shardStarts[s + 1] - shardStarts[s];
+			MediaEntry* shardEntries = new MediaEntry[numShardEntries];
+			bool* shardResults = new bool[numShardEntries];
+			for (int j = 0; j < numShardEntries; j++)
+				shardEntries[j] = media[order[shardStarts[s] + j]];
+
+			numFound[s] = operation(shards[s], shardEntries, numShardEntries, shardResults);
+			for (int j = 0; j < numShardEntries; j++)
+				results[order[shardStarts[s] + j]] = shardResults[j];
+
+			delete [] shardEntries;
+			delete [] shardResults;
+		});
+	}
+	pool.wait();
+
+	int totalFound = 0;
+	for (int s = 0; s < numShards; s++)
+		totalFound += numFound[s];
+
+	delete [] shardOf;
+	delete [] shardStarts;
+	delete [] order;
+	delete [] numFound;
+
+	return totalFound;
+}
+
+template <template <class MediaEntry> class DataStructure>
+bool ShardedLibrary<DataStructure>::addEntry(const MediaEntry& newMedia)
+{
+	if (!shards[getShard(newMedia)]->addEntry(newMedia))
+		return false;
+
+	addToTextIndexes(newMedia);
+	return true;
+}
+
+template <template <class MediaEntry> class DataStructure>
+bool ShardedLibrary<DataStructure>::addEntries(const MediaEntry newMedia[], int numEntries)
+{
+	bool* results = new bool[numEntries > 0 ? numEntries : 1];
+	int numAdded = runOnShards(newMedia, numEntries, results, [](MediaLibrary<DataStructure>* shardPtr,
+					const MediaEntry shardEntries[], int numShardEntries, bool shardResults[])
+	{
+		bool isAdded = shardPtr->addEntries(shardEntries, numShardEntries); //Still sorted if the
+		for (int j = 0; j < numShardEntries; j++)			   //file was
+			shardResults[j] = isAdded;
+		return isAdded ? numShardEntries : 0;
+	});
+	delete [] results;
+
+	for (int i = 0; i < numEntries; i++)
+		addToTextIndexes(newMedia[i]);
+
+	return (numAdded == numEntries);
+}
+
+template <template <class MediaEntry> class DataStructure>
+bool ShardedLibrary<DataStructure>::removeEntry(const MediaEntry& newMedia)
+{
+	if (!shards[getShard(newMedia)]->removeEntry(newMedia))
+		return false;
+
+	removeFromTextIndexes(newMedia);
+	return true;
+}
+
+template <template <class MediaEntry> class DataStructure>
+MediaEntry ShardedLibrary<DataStructure>::getEntry(const MediaEntry& media) const
+{
+	return shards[getShard(media)]->getEntry(media);
+}
+
+template <template <class MediaEntry> class DataStructure>
+bool ShardedLibrary<DataStructure>::contains(const MediaEntry& media) const
+{
+	return shards[getShard(media)]->contains(media);
+}
+
+template <template <class MediaEntry> class DataStructure>
+int ShardedLibrary<DataStructure>::containsMany(const MediaEntry media[], int numEntries, bool results[]) const
+{
+	return runOnShards(media, numEntries, results, [](MediaLibrary<DataStructure>* shardPtr,
+				const MediaEntry shardEntries[], int numShardEntries, bool shardResults[])
+	{
+		return shardPtr->containsMany(shardEntries, numShardEntries, shardResults);
+	});
+}
+
+template <template <class MediaEntry> class DataStructure>
+int ShardedLibrary<DataStructure>::addMany(const MediaEntry media[], int numEntries, bool results[])
+{
+	int numAdded = runOnShards(media, numEntries, results, [](MediaLibrary<DataStructure>* shardPtr,
+					const MediaEntry shardEntries[], int numShardEntries, bool shardResults[])
+	{
+		return shardPtr->addMany(shardEntries, numShardEntries, shardResults);
+	});
+
+	for (int i = 0; i < numEntries; i++)
+	{
+		if (results[i])
+			addToTextIndexes(media[i]);
+	}
+
+	return numAdded;
+}
+
+template <template <class MediaEntry> class DataStructure>
+int ShardedLibrary<DataStructure>::removeMany(const MediaEntry media[], int numEntries, bool results[])
+{
+	int numRemoved = runOnShards(media, numEntries, results, [](MediaLibrary<DataStructure>* shardPtr,
+					const MediaEntry shardEntries[], int numShardEntries, bool shardResults[])
+	{
+		return shardPtr->removeMany(shardEntries, numShardEntries, shardResults);
+	});
+
+	for (int i = 0; i < numEntries; i++)
+	{
+		if (results[i])
+			removeFromTextIndexes(media[i]);
+	}
+
+	return numRemoved;
+}
+
+template <template <class MediaEntry> class DataStructure>
+bool ShardedLibrary<DataStructure>::hasConcurrentLookups() const
+{
+	return true; //Same as the shards, whose tasks can share the pool
+}
+
+template <template <class MediaEntry> class DataStructure>
+void ShardedLibrary<DataStructure>::displayAllMovies() const
+{
+	displayType('M');
+}
+
+template <template <class MediaEntry> class DataStructure>
+void ShardedLibrary<DataStructure>::displayAllMusic() const
+{
+	displayType('S');
+}
+
+template <template <class MediaEntry> class DataStructure>
+void ShardedLibrary<DataStructure>::displayAllTv() const
+{
+	displayType('T');
+}
+
+template <template <class MediaEntry> class DataStructure>
+void ShardedLibrary<DataStructure>::displayAll() const
+{
+	displayType('\0');
+}
+
+template <template <class MediaEntry> class DataStructure>
+void ShardedLibrary<DataStructure>::displayType(char mediaType) const
+{
+	BufferedWriter writer(std::cout);
+	forEachMerged(mediaType, NULL, NULL, [&writer](const MediaEntry& media)
+	{
+		media.display(writer);
+		return true;
+	});
+	writer.flush();
+}
+
+template <template <class MediaEntry> class DataStructure>
+void ShardedLibrary<DataStructure>::display(int offset, int limit) const
+{
+	if (!shards[0]->isOrdered() || numShards == 1) //Pages are in table order, so whole shards
+	{						//are skipped
+		for (int s = 0; s < numShards && limit > 0; s++)
+		{
+			int numShardEntries = shards[s]->getNumberOfItems();
+			if (offset < numShardEntries)
+			{
+				shards[s]->display(offset, limit);
+				limit -= numShardEntries - offset;
+			}
+			offset = std::max(offset - numShardEntries, 0);
+		}
+		return;
+	}
+
+	if (offset < 0)
+		offset = 0;
+	if (offset >= getNumberOfItems() || limit <= 0)
+		return;
+
+	//The page starts as in MediaLibrary, with the shards in place of the partitions
+	const MediaEntry* firstPtr = RangeCursor<MediaEntry>::selectMerged(numShards, offset, [this](int s, int i)
+	{
+		return shards[s]->select(i);
+	}, [this](int s, const MediaEntry& media)
+	{
+		return shards[s]->rank(media);
+	});
+
+	int numSkipped = offset; //Entries equal to the first one but before the page
+	for (int s = 0; s < numShards; s++)
+		numSkipped -= shards[s]->rank(*firstPtr);
+
+	int numDisplayed = 0;
+	forEachMerged('\0', firstPtr, NULL, [&numSkipped, limit, &numDisplayed](const MediaEntry& media)
+	{
+		if (numSkipped > 0)
+		{
+			numSkipped--;
+			return true;
+		}
+
+		std::cout << media << '\n'; //Flushed once the page is done
+		return (++numDisplayed < limit);
+	});
+	std::cout.flush();
+}
+
+template <template <class MediaEntry> class DataStructure>
+void ShardedLibrary<DataStructure>::displayRange(const MediaEntry& low, const MediaEntry& high) const
+{
+	forEachMerged('\0', &low, &high, [](const MediaEntry& media)
+	{
+		std::cout << media << '\n';
+		return true;
+	});
+	std::cout.flush();
+}
+
+template <template <class MediaEntry> class DataStructure>
+void ShardedLibrary<DataStructure>::displayPrefix(const MediaEntry& prefix) const
+{
+	MediaEntry low(prefix); //Same as in MediaLibrary
+	low.setMediaType('M');
+
+	MediaEntry high;
+	bool hasBound = prefix.getPrefixBound(high);
+	forEachMerged('\0', &low, hasBound ? &high : NULL, [](const MediaEntry& media)
+	{
+		std::cout << media << '\n';
+		return true;
+	});
+	std::cout.flush();
+}
+
+template <template <class MediaEntry> class DataStructure>
+int ShardedLibrary<DataStructure>::planQuery(const MediaQuery& query) const
+{
+	if (query.isEmpty())
+		return QUERY_NO_ENTRIES;
+
+	bool isBounded = (query.getLowPtr() != NULL || query.getHighPtr() != NULL);
+	if (isBounded && shards[0]->isOrdered())
+		return (query.getNumTypes() == 1) ? QUERY_TYPE_RANGE : QUERY_RANGE;
+	else if (query.getNumTypes() < NUM_MEDIA_TYPES)
+		return QUERY_TYPE_SCAN;
+	else
+		return QUERY_FULL_SCAN;
+}
+
+template <template <class MediaEntry> class DataStructure>
+int ShardedLibrary<DataStructure>::runQuery(const MediaQuery& query, void visit(const MediaEntry&),
+						QueryStatistics& stats) const
+{
+	stats.accessPath = planQuery(query);
+	stats.numExamined = 0;
+	stats.numMatched = 0;
+	stats.numReturned = 0;
+
+	int numSkipped = 0;
+	auto visitEntry = [&query, visit, &stats, &numSkipped](const MediaEntry& media)
+	{
+		stats.numExamined++; //Counted on the merged entries, as in a single library
+		if (!query.matches(media))
+			return true;
+
+		stats.numMatched++;
+		if (numSkipped < query.getOffset())
+		{
+			numSkipped++;
+			return true;
+		}
+
+		visit(media);
+		stats.numReturned++;
+		return (query.getLimit() < 0 || stats.numReturned < query.getLimit());
+	};
+
+	const char mediaTypes[] = "MTS"; //Same order as in MediaLibrary
+	switch (stats.accessPath)
+	{
+	case QUERY_RANGE:
+		forEachMerged('\0', query.getLowPtr(), query.getHighPtr(), visitEntry);
+		break;
+	case QUERY_TYPE_RANGE:
+	case QUERY_TYPE_SCAN:
+		for (int t = 0; t < NUM_MEDIA_TYPES; t++)
+		{
+			if (!query.hasType(mediaTypes[t]))
+				continue;
+
+			bool isDone = (stats.accessPath == QUERY_TYPE_RANGE) ?
+				!forEachMerged(mediaTypes[t], query.getLowPtr(), query.getHighPtr(), visitEntry) :
+				!forEachMerged(mediaTypes[t], NULL, NULL, visitEntry);
+			if (isDone)
+				break;
+		}
+		break;
+	case QUERY_FULL_SCAN:
+		forEachMerged('\0', NULL, NULL, visitEntry);
+		break;
+	}
+
+	return stats.numReturned;
+}
+
+template <template <class MediaEntry> class DataStructure>
+void ShardedLibrary<DataStructure>::setWordIndex(bool isEnabled)
+{
+	if (isEnabled && wordIndexPtr == NULL)
+	{
+		WordIndex* indexPtr = new WordIndex;
+		forEachMerged('\0', NULL, NULL, [indexPtr](const MediaEntry& media)
+		{
+			indexPtr->add(media);
+			return true;
+		});
+		wordIndexPtr = indexPtr;
+	}
+	else if (!isEnabled && wordIndexPtr != NULL)
+	{
+		delete wordIndexPtr;
+		wordIndexPtr = NULL;
+	}
+}
+
+template <template <class MediaEntry> class DataStructure>
+void ShardedLibrary<DataStructure>::setFuzzyIndex(bool isEnabled)
+{
+	if (isEnabled && fuzzyIndexPtr == NULL)
+	{
+		FuzzyIndex* indexPtr = new FuzzyIndex;
+		forEachMerged('\0', NULL, NULL, [indexPtr](const MediaEntry& media)
+		{
+			indexPtr->add(media);
+			return true;
+		});
+		fuzzyIndexPtr = indexPtr;
+	}
+	else if (!isEnabled && fuzzyIndexPtr != NULL)
+	{
+		delete fuzzyIndexPtr;
+		fuzzyIndexPtr = NULL;
+	}
+}
+
+template <template <class MediaEntry> class DataStructure>
+void ShardedLibrary<DataStructure>::setLookupCache(int maxEntries)
+{
+	lookupCacheCapacity = std::max(maxEntries, 0);
+	int shardCapacity = (lookupCacheCapacity + numShards - 1) / numShards; //Popular titles are
+	for (int s = 0; s < numShards; s++)				       //spread over the shards
+		shards[s]->setLookupCache(shardCapacity);
+}
+
+template <template <class MediaEntry> class DataStructure>
+void ShardedLibrary<DataStructure>::addToTextIndexes(const MediaEntry& newMedia)
+{
+	if (wordIndexPtr != NULL)
+		wordIndexPtr->add(newMedia);
+	if (fuzzyIndexPtr != NULL)
+		fuzzyIndexPtr->add(newMedia);
+}
+
+template <template <class MediaEntry> class DataStructure>
+void ShardedLibrary<DataStructure>::removeFromTextIndexes(const MediaEntry& media)
+{
+	if (wordIndexPtr != NULL)
+		wordIndexPtr->remove(media);
+	if (fuzzyIndexPtr != NULL)
+		fuzzyIndexPtr->remove(media);
+}
+
+template <template <class MediaEntry> class DataStructure>
+int ShardedLibrary<DataStructure>::findWords(const char* text, void visit(const MediaEntry&)) const
+{
+	if (wordIndexPtr != NULL)
+		return wordIndexPtr->find(text, visit);
+
+	int numFound = 0; //Without the index, each shard goes through its own entries
+	for (int s = 0; s < numShards; s++)
+		numFound += shards[s]->findWords(text, visit);
+
+	return numFound;
+}
+
+template <template <class MediaEntry> class DataStructure>
+int ShardedLibrary<DataStructure>::findClosest(const char* title, int maxDistance, int maxResults,
+						void visit(const MediaEntry&, int)) const
+{
+	int numCandidates;
+	if (fuzzyIndexPtr != NULL)
+		return fuzzyIndexPtr->find(title, maxDistance, maxResults, visit, numCandidates);
+
+	std::string key; //Same as in MediaLibrary, with the entries of every shard
+	FuzzyIndex::getKey(title, key);
+	if (key.empty() || maxResults <= 0)
+		return 0;
+
+	std::vector<std::pair<int, MediaEntry> > found;
+	forEachMerged('\0', NULL, NULL, [&key, maxDistance, &found](const MediaEntry& media)
+	{
+		std::string mediaKey;
+		FuzzyIndex::getKey(media, mediaKey);
+		int distance = FuzzyIndex::getEditDistance(key, mediaKey, maxDistance);
+		if (distance <= maxDistance)
+			found.push_back(std::make_pair(distance, media));
+		return true;
+	});
+
+	int numFound = std::min((int)found.size(), maxResults);
+	std::partial_sort(found.begin(), found.begin() + numFound, found.end());
+	for (int i = 0; i < numFound; i++)
+		visit(found[i].second, found[i].first);
+
+	return numFound;
+}
+
+template <template <class MediaEntry> class DataStructure>
+void ShardedLibrary<DataStructure>::writeToFile(std::ostream& outFile) const
+{
+	BufferedWriter writer(outFile); //Merged in sorted order, so the file can be reloaded
+	forEachMerged('\0', NULL, NULL, [&writer](const MediaEntry& media) //with a bottom-up build as well
+	{
+		media.writeToFile(writer);
+		return true;
+	});
+	writer.flush();
+	outFile << "\n\n" << std::flush;
+}
+
+template <template <class MediaEntry> class DataStructure>
+MediaLibraryInterface* ShardedLibrary<DataStructure>::snapshot() const
+{
+	ShardedLibrary<DataStructure>* snapshotPtr = new ShardedLibrary<DataStructure>(numShards);
+	for (int s = 0; s < numShards; s++) //Each shard takes its own snapshot, e.g. in constant time
+	{				    //for a tree
+		delete snapshotPtr->shards[s];
+		snapshotPtr->shards[s] = static_cast<MediaLibrary<DataStructure>*>(shards[s]->snapshot());
+	}
+	if (wordIndexPtr != NULL)
+		snapshotPtr->wordIndexPtr = new WordIndex(*wordIndexPtr);
+	if (fuzzyIndexPtr != NULL)
+		snapshotPtr->fuzzyIndexPtr = new FuzzyIndex(*fuzzyIndexPtr);
+	snapshotPtr->lookupCacheCapacity = lookupCacheCapacity;
+
+	return snapshotPtr;
+}
+
+template <template <class MediaEntry> class DataStructure>
+MediaLibraryInterface* ShardedLibrary<DataStructure>::freeze() const
+{
+	int numEntries = getNumberOfItems();
+	MediaEntry* entries = new MediaEntry[numEntries > 0 ? numEntries : 1];
+
+	int i = 0;
+	forEachMerged('\0', NULL, NULL, [entries, &i](const MediaEntry& media)
+	{
+		entries[i++] = media;
+		return true;
+	});
+
+	MediaLibrary<FrozenIndex>* frozenPtr = new MediaLibrary<FrozenIndex>; //A single index, as
+	frozenPtr->addEntries(entries, numEntries);			     //nothing is added to it
+	frozenPtr->setWordIndex(wordIndexPtr != NULL);
+	frozenPtr->setFuzzyIndex(fuzzyIndexPtr != NULL);
+	frozenPtr->setLookupCache(lookupCacheCapacity);
+
+	delete [] entries;
+
+	return frozenPtr;
+}
+
+template <template <class MediaEntry> class DataStructure>
+int ShardedLibrary<DataStructure>::getNumberOfItems() const
+{
+	int numItems = 0;
+	for (int s = 0; s < numShards; s++)
+		numItems += shards[s]->getNumberOfItems();
+
+	return numItems;
+}
+
+template <template <class MediaEntry> class DataStructure>
+int ShardedLibrary<DataStructure>::getNumberOfType(char mediaType) const
+{
+	int numItems = 0;
+	for (int s = 0; s < numShards; s++)
+		numItems += shards[s]->getNumberOfType(mediaType);
+
+	return numItems;
+}
+
+template <template <class MediaEntry> class DataStructure>
+void ShardedLibrary<DataStructure>::displayStatistics(std::ostream& os) const
+{
+	int minItems = shards[0]->getNumberOfItems();
+	int maxItems = minItems;
+	for (int s = 1; s < numShards; s++)
+	{
+		minItems = std::min(minItems, shards[s]->getNumberOfItems());
+		maxItems = std::max(maxItems, shards[s]->getNumberOfItems());
+	}
+
+	os << "Number of shards: " << numShards << std::endl;
+	os << "Entries per shard: " << minItems << " to " << maxItems << std::endl;
+	if (getNumberOfItems() > 0)
+		os << "Largest shard over the average: "
+		   << 100.0*maxItems*numShards/getNumberOfItems() - 100 << "%" << std::endl;
+	os << std::endl << std::endl;
+
+	for (int s = 0; s < numShards; s++)
+	{
+		os << "Shard " << s << ":" << std::endl;
+		shards[s]->displayStatistics(os);
+	}
+}
+
+template <template <class MediaEntry> class DataStructure>
+int ShardedLibrary<DataStructure>::getNumberOfShards() const
+{
+	return numShards;
+}
+
+#endif
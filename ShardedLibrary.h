@@ -0,0 +1,152 @@
+/*@file ShardedLibrary.h*/
+#ifndef _SHARDED_LIBRARY_H
+#define _SHARDED_LIBRARY_H
+
+#include <iostream>
+#include "MediaLibraryInterface.h"
+#include "MediaLibrary.h"
+#include "ThreadPool.h"
+#include "WordIndex.h"
+#include "FuzzyIndex.h"
+
+const int MAX_SHORT_SORT_KEY = 128; //Sort keys up to this length are computed on the stack
+
+/*
+Media library split into independent libraries, its shards, each holding the entries whose
+sort keys (see MediaEntry::getSortKey) hash to it. Equal entries have the same sort key, so an
+entry is only ever looked up, added or removed in its own shard. Loading a file partitions the
+entries by shard, and then builds every shard at once on the workers of a thread pool, instead
+of building a single data structure on one thread. The batch operations run on the shards
+concurrently too. Listings go through every shard: if the data structure is ordered, the sorted
+entries of the shards are merged (see forEachMerged), so they come out in the same order as from
+a single library, and otherwise the shards are listed one after the other. A page of sorted
+titles starts at the entry found by ranking the entries of the shards (see
+RangeCursor::selectMerged), so only the page itself is merged. The indexes of the words and
+trigrams of the titles are kept for the whole library, and each shard has a part of the lookup
+cache.
+*/
+template <template <class MediaEntry> class DataStructure>
+class ShardedLibrary : public MediaLibraryInterface
+{
+private:
+	mutable ThreadPool pool; //Workers building and searching the shards
+	MediaLibrary<DataStructure>** shards; //The libraries the entries are split into
+	int numShards; //Number of shards
+	WordIndex* wordIndexPtr; //Index of the words of the titles, NULL if it is off
+	FuzzyIndex* fuzzyIndexPtr; //Trigram index of the titles, NULL if it is off
+	int lookupCacheCapacity; //Number of entries cached by all the shards together
+
+	/*
+	Returns the shard of an entry
+	@param media The entry
+	@return The position of its shard in shards
+	*/
+	int getShard(const MediaEntry& media) const;
+
+	/*
+	Visits the entries of the shards lying in [*lowPtr, *highPtr), of every type or of a single
+	type. If the data structure is ordered, the entries come in sorted order: the shards are
+	merged lazily with a RangeCursor in each (see RangeCursor::merge), so a page or a query with
+	a limit stops once it has what it needs. Otherwise, the shards are visited one after the other.
+	@post visit is executed for the entries in the range, up to the first call returning false
+	@param mediaType The type, either 'M', 'T', or 'S', or '\0' for every type
+	lowPtr Pointer to the inclusive lower bound, NULL if there is no lower bound
+	highPtr Pointer to the exclusive upper bound, NULL if there is no upper bound
+	visit Callable taking a const MediaEntry& and returning true to continue, false to stop
+	@return False if visit stopped the traversal, true otherwise
+	*/
+	template <class Visitor>
+	bool forEachMerged(char mediaType, const MediaEntry* lowPtr, const MediaEntry* highPtr,
+				Visitor&& visit) const;
+
+	/*
+	Runs a batch operation on an array of entries: the entries are split by shard, the part of
+	each shard is given to it in a task of the pool, and the results are put back in the order
+	of the array. Each shard is only used by its own task.
+	@post results[i] is the result of the operation for media[i]
+	@param media The array of entries
+	numEntries The number of entries in the array
+	results Array of numEntries flags receiving the result for each entry
+	operation Callable taking a shard, an array of entries, its size and an array of results,
+	and returning the number of entries for which the result is true
+	@return The number of entries for which the result is true
+	*/
+	template <class Operation>
+	int runOnShards(const MediaEntry media[], int numEntries, bool results[], Operation&& operation) const;
+
+	/*
+	Adds an entry to, or removes it from, the indexes of the titles that are on
+	@post The word and trigram indexes that are on have the entry, or no longer have it
+	@param newMedia The entry added to the library
+	media The entry removed from the library
+	*/
+	void addToTextIndexes(const MediaEntry& newMedia);
+	void removeFromTextIndexes(const MediaEntry& media);
+
+	/*
+	Same as in MediaLibrary, with the shards
+	*/
+	int planQuery(const MediaQuery& query) const;
+	void displayType(char mediaType) const;
+
+	//A copy would share the shards
+	ShardedLibrary(const ShardedLibrary<DataStructure>&);
+	ShardedLibrary<DataStructure>& operator=(const ShardedLibrary<DataStructure>&);
+
+public:
+	/*
+	Creates an empty library
+	@param aNumShards The number of shards, one per hardware thread if it is less than 1
+	*/
+	ShardedLibrary(int aNumShards = 0);
+	~ShardedLibrary();
+
+	//Refer to MediaLibraryInterface.h for details on these functions. The entries found by
+	//findWords come one shard after the other.
+	bool addEntry(const MediaEntry& newMedia);
+	bool addEntries(const MediaEntry newMedia[], int numEntries);
+	bool removeEntry(const MediaEntry& newMedia);
+	MediaEntry getEntry(const MediaEntry& media) const;
+	bool contains(const MediaEntry& media) const;
+	int containsMany(const MediaEntry media[], int numEntries, bool results[]) const;
+	int addMany(const MediaEntry media[], int numEntries, bool results[]);
+	int removeMany(const MediaEntry media[], int numEntries, bool results[]);
+	bool hasConcurrentLookups() const;
+	void displayAllMovies() const;
+	void displayAllMusic() const;
+	void displayAllTv() const;
+	void displayAll() const;
+	void display(int offset, int limit) const;
+	void displayRange(const MediaEntry& low, const MediaEntry& high) const;
+	void displayPrefix(const MediaEntry& prefix) const;
+	int runQuery(const MediaQuery& query, void visit(const MediaEntry&), QueryStatistics& stats) const;
+	void setWordIndex(bool isEnabled);
+	int findWords(const char* text, void visit(const MediaEntry&)) const;
+	void setFuzzyIndex(bool isEnabled);
+	void setLookupCache(int maxEntries);
+	int findClosest(const char* title, int maxDistance, int maxResults,
+			void visit(const MediaEntry&, int)) const;
+	void writeToFile(std::ostream& outFile) const;
+	MediaLibraryInterface* snapshot() const;
+	MediaLibraryInterface* freeze() const;
+	int getNumberOfItems() const;
+	int getNumberOfType(char mediaType) const;
+
+	/*
+	Writes out the number of shards and how evenly the entries are spread over them, followed
+	by the statistics of each shard, to os
+	@post The statistics are written to os
+	@param os Ostream variable for the output
+	*/
+	void displayStatistics(std::ostream& os) const;
+
+	/*
+	Returns the number of shards
+	@return The number of shards
+	*/
+	int getNumberOfShards() const;
+};
+
+#include "ShardedLibrary.cpp"
+
+#endif
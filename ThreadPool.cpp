@@ -0,0 +1,75 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(int numThreads)
+{
+	numPending = 0;
+	isStopping = false;
+
+	if (numThreads < 1) //Default to the number of hardware threads, or 1 if it is unknown
+		numThreads = std::thread::hardware_concurrency();
+	if (numThreads < 1)
+		numThreads = 1;
+
+	for (int i = 0; i < numThreads; i++)
+		workers.push_back(std::thread(&ThreadPool::workerLoop, this));
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(poolMutex);
+		isStopping = true;
+	}
+	taskAdded.notify_all(); //Wake every worker so it can finish the queue and exit
+
+	for (size_t i = 0; i < workers.size(); i++)
+		workers[i].join();
+}
+
+int ThreadPool::getNumThreads() const
+{
+	return workers.size();
+}
+
+void ThreadPool::workerLoop()
+{
+	while (true)
+	{
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(poolMutex);
+			while (tasks.empty() && !isStopping) //Sleep until there is a task to run
+				taskAdded.wait(lock);
+
+			if (tasks.empty()) //Pool is stopping and nothing is left
+				return;
+
+			task = tasks.front();
+			tasks.pop();
+		}
+
+		task();
+
+		std::lock_guard<std::mutex> lock(poolMutex);
+		numPending--;
+		if (numPending == 0) //Last task finished, so wake anyone waiting on the pool
+			tasksDone.notify_all();
+	}
+}
+
+void ThreadPool::submit(const std::function<void()>& task)
+{
+	{
+		std::lock_guard<std::mutex> lock(poolMutex);
+		tasks.push(task);
+		numPending++;
+	}
+	taskAdded.notify_one();
+}
+
+void ThreadPool::wait()
+{
+	std::unique_lock<std::mutex> lock(poolMutex);
+	while (numPending > 0)
+		tasksDone.wait(lock);
+}
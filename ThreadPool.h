@@ -0,0 +1,69 @@
+/*@file ThreadPool.h*/
+#ifndef _THREAD_POOL_H
+#define _THREAD_POOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+const int MIN_PARALLEL_ITEMS = 10000; //Data structures with fewer items are processed by a single thread
+
+/*
+Fixed set of worker threads that run submitted tasks. Used by the data structures to
+process independent parts of themselves (e.g. subtrees or ranges of the table) concurrently.
+*/
+class ThreadPool
+{
+private:
+	std::vector<std::thread> workers; //The worker threads
+	std::queue<std::function<void()> > tasks; //Tasks waiting for a worker
+	std::mutex poolMutex; //Guards tasks, numPending and isStopping
+	std::condition_variable taskAdded; //Signalled when a task is submitted or the pool stops
+	std::condition_variable tasksDone; //Signalled when the last pending task finishes
+	int numPending; //Number of tasks submitted that haven't finished yet
+	bool isStopping; //True once the destructor asks the workers to exit
+
+	/*
+	Loop run by every worker: waits for a task, runs it, and repeats until the pool stops
+	*/
+	void workerLoop();
+
+	//The workers refer to the pool, so it can't be copied
+	ThreadPool(const ThreadPool&);
+	ThreadPool& operator=(const ThreadPool&);
+
+public:
+	/*
+	Starts numThreads workers. If numThreads < 1, one worker per hardware thread is started.
+	*/
+	ThreadPool(int numThreads = 0);
+
+	/*
+	Finishes the submitted tasks and then stops the workers
+	*/
+	~ThreadPool();
+
+	/*
+	Returns the number of workers in the pool
+	@return The number of workers
+	*/
+	int getNumThreads() const;
+
+	/*
+	Queues a task to be run by the next free worker
+	@post task will be run exactly once by one of the workers
+	@param task The task to be run
+	*/
+	void submit(const std::function<void()>& task);
+
+	/*
+	Blocks until every task submitted so far has finished
+	@post No tasks are pending
+	*/
+	void wait();
+};
+
+#endif
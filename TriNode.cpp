@@ -10,9 +10,13 @@ TriNode<ItemType>::TriNode() //Set the default state of the node to an empty lea
 {
 	smallItem = NULL;
 	largeItem = NULL;
+	smallKeyPrefix = 0;
+	largeKeyPrefix = 0;
 	leftChildPtr = NULL;
 	midChildPtr = NULL;
 	rightChildPtr = NULL;
+	subtreeSize = 0;
+	refCount = 1; //Referenced by whoever created it
 }
 
 template <class ItemType>
@@ -76,6 +80,7 @@ void TriNode<ItemType>::setSmallItem(const ItemType& anItem)
 		smallItem = new ItemType;
 
 	*smallItem = anItem;
+	smallKeyPrefix = anItem.getKeyPrefix();
 }
 
 template <class ItemType>
@@ -85,6 +90,45 @@ void TriNode<ItemType>::setLargeItem(const ItemType& anItem)
 		largeItem = new ItemType;
 
 	*largeItem = anItem;
+	largeKeyPrefix = anItem.getKeyPrefix();
+}
+
+template <class ItemType>
+void TriNode<ItemType>::setSmallItemPtr(ItemType* itemPtr)
+{
+	if (smallItem != NULL && smallItem != itemPtr) //Delete the item being replaced
+		delete smallItem;
+
+	smallItem = itemPtr;
+	smallKeyPrefix = (itemPtr != NULL) ? itemPtr->getKeyPrefix() : 0;
+}
+
+template <class ItemType>
+void TriNode<ItemType>::setLargeItemPtr(ItemType* itemPtr)
+{
+	if (largeItem != NULL && largeItem != itemPtr)
+		delete largeItem;
+
+	largeItem = itemPtr;
+	largeKeyPrefix = (itemPtr != NULL) ? itemPtr->getKeyPrefix() : 0;
+}
+
+template <class ItemType>
+ItemType* TriNode<ItemType>::releaseSmallItem()
+{
+	ItemType* itemPtr = smallItem; //Node no longer points to the item, so it won't delete it
+	smallItem = NULL;
+
+	return itemPtr;
+}
+
+template <class ItemType>
+ItemType* TriNode<ItemType>::releaseLargeItem()
+{
+	ItemType* itemPtr = largeItem;
+	largeItem = NULL;
+
+	return itemPtr;
 }
 
 template <class ItemType>
@@ -107,6 +151,32 @@ void TriNode<ItemType>::removeLargeItem()
 	}
 }
 
+template <class ItemType>
+int TriNode<ItemType>::compareSmallItem(const ItemType& anItem, unsigned long long keyPrefix) const
+{
+	if (keyPrefix != smallKeyPrefix) //Decided without loading the item
+		return (keyPrefix < smallKeyPrefix) ? -1 : 1;
+	else if (anItem < *smallItem)
+		return -1;
+	else if (anItem == *smallItem)
+		return 0;
+	else
+		return 1;
+}
+
+template <class ItemType>
+int TriNode<ItemType>::compareLargeItem(const ItemType& anItem, unsigned long long keyPrefix) const
+{
+	if (keyPrefix != largeKeyPrefix)
+		return (keyPrefix < largeKeyPrefix) ? -1 : 1;
+	else if (anItem < *largeItem)
+		return -1;
+	else if (anItem == *largeItem)
+		return 0;
+	else
+		return 1;
+}
+
 template <class ItemType>
 TriNode<ItemType>* TriNode<ItemType>::getLeftChildPtr() const
 {
@@ -143,6 +213,53 @@ void TriNode<ItemType>::setRightChildPtr(TriNode<ItemType>* newNode)
 	rightChildPtr = newNode;
 }
 
+template <class ItemType>
+int TriNode<ItemType>::getSubtreeSize() const
+{
+	return subtreeSize;
+}
+
+template <class ItemType>
+void TriNode<ItemType>::setSubtreeSize(int size)
+{
+	subtreeSize = size;
+}
+
+template <class ItemType>
+void TriNode<ItemType>::updateSubtreeSize()
+{
+	subtreeSize = 0;
+	if (smallItem != NULL) //Count the node's own items
+		subtreeSize++;
+	if (largeItem != NULL)
+		subtreeSize++;
+
+	if (leftChildPtr != NULL) //Followed by the items in each subtree
+		subtreeSize += leftChildPtr->subtreeSize;
+	if (midChildPtr != NULL)
+		subtreeSize += midChildPtr->subtreeSize;
+	if (rightChildPtr != NULL)
+		subtreeSize += rightChildPtr->subtreeSize;
+}
+
+template <class ItemType>
+void TriNode<ItemType>::addReference()
+{
+	refCount++;
+}
+
+template <class ItemType>
+int TriNode<ItemType>::removeReference()
+{
+	return --refCount; //Atomic, so a snapshot can be released by another thread
+}
+
+template <class ItemType>
+bool TriNode<ItemType>::isShared() const
+{
+	return refCount > 1;
+}
+
 #endif
 
 
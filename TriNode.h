@@ -2,15 +2,21 @@
 #ifndef _TRI_NODE_H
 #define _TRI_NODE_H
 
+#include <atomic>
+
 template <class ItemType>
 class TriNode
 {
 private:
 	ItemType* smallItem; //Small item of the node
 	ItemType* largeItem; //Large item, if it is a 3-Node
+	unsigned long long smallKeyPrefix; //Key prefixes of the small and large items, kept in the
+	unsigned long long largeKeyPrefix; //node so most comparisons don't have to load the items
 	TriNode<ItemType>* leftChildPtr; //Pointer to the node's left child
 	TriNode<ItemType>* midChildPtr; //Pointer to the node's middle child (for a 3-Node)
 	TriNode<ItemType>* rightChildPtr; //Pointer to the node's right child
+	int subtreeSize; //Number of items in the subtree rooted at the node
+	std::atomic<int> refCount; //Number of parent nodes and trees pointing to the node
 
 public:
 	TriNode();
@@ -36,7 +42,8 @@ public:
 	bool isThreeNode() const;
 
 	/*
-	Returns a pointer to the node's small or large item.
+	Returns a pointer to the node's small or large item. The key of the item must not be
+	changed through the pointer, as the node keeps its key prefix.
 	@return The pointer to the item, NULL if the item does not exist.
 	*/
 	ItemType* getSmallItem() const;
@@ -52,6 +59,24 @@ public:
 	void setLargeItem(const ItemType& anItem);
 
 
+	/*
+	Hands the node the ownership of the item pointed to by itemPtr as its small or large item,
+	without copying it. Any item already stored there is deleted.
+	@post The small or large item of the node is the item pointed to by itemPtr
+	@param itemPtr Pointer to a dynamically allocated item
+	*/
+	void setSmallItemPtr(ItemType* itemPtr);
+	void setLargeItemPtr(ItemType* itemPtr);
+
+	/*
+	Takes the small or large item out of the node without deleting it, so it can be moved to
+	another node
+	@post The node no longer has the small or large item, and the caller owns it
+	@return Pointer to the item, NULL if the item does not exist
+	*/
+	ItemType* releaseSmallItem();
+	ItemType* releaseLargeItem();
+
 	/*
 	Removes the small or large item of the node
 	@post The small or large item of the node is removed if it exists, otherwise nothing happens
@@ -59,6 +84,17 @@ public:
 	void removeSmallItem();
 	void removeLargeItem();
 
+	/*
+	Compares anItem with the small or large item of the node. The key prefixes are compared
+	first, and the items themselves only if the prefixes are equal.
+	@pre The small or large item exists
+	@param anItem The item to be compared
+	keyPrefix The key prefix of anItem
+	@return -1 if anItem is less than the node's item, 0 if they are equal, 1 if it is greater
+	*/
+	int compareSmallItem(const ItemType& anItem, unsigned long long keyPrefix) const;
+	int compareLargeItem(const ItemType& anItem, unsigned long long keyPrefix) const;
+
 	/*
 	Retrieves the left, mid, or right child pointers of the node
 	@return The pointer to the left, mid, or right child of the node
@@ -76,6 +112,47 @@ public:
 	void setLeftChildPtr(TriNode<ItemType>* newNode);
 	void setMidChildPtr(TriNode<ItemType>* midNode);
 	void setRightChildPtr(TriNode<ItemType>* rightNode);
+
+
+	/*
+	Returns the number of items in the subtree rooted at the node
+	@return The number of items in the subtree. A NULL child's subtree has no items.
+	*/
+	int getSubtreeSize() const;
+
+	/*
+	Sets the number of items in the subtree rooted at the node to size
+	@post The subtree size of the node is equal to size
+	@param size The new subtree size
+	*/
+	void setSubtreeSize(int size);
+
+	/*
+	Recomputes the subtree size of the node from its own items and its children's subtree sizes
+	@post The subtree size of the node is correct, provided that those of its children are
+	*/
+	void updateSubtreeSize();
+
+
+	/*
+	Records that one more parent node or tree points to the node. A new node has one reference.
+	@post The reference count of the node is incremented
+	*/
+	void addReference();
+
+	/*
+	Records that a parent node or tree no longer points to the node
+	@post The reference count of the node is decremented
+	@return The remaining number of references. The node should be deleted once it reaches 0.
+	*/
+	int removeReference();
+
+	/*
+	Checks if the node is shared, i.e. reachable from more than one parent or tree. Shared
+	nodes may be read by a snapshot, so they have to be copied before they are modified.
+	@return True if the node has more than one reference, false otherwise
+	*/
+	bool isShared() const;
 };
 
 #include "TriNode.cpp"
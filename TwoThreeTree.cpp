@@ -2,6 +2,7 @@
 #define _TWO_THREE_CPP
 
 #include <algorithm>
+#include <sstream>
 #include "TwoThreeTree.h"
 #include "NotFoundException.h"
 
@@ -28,6 +29,7 @@ TriNode<ItemType>* TwoThreeTree<ItemType>::copyTree(const TriNode<ItemType>* oth
 		newNode->setLeftChildPtr(copyTree(otherTreePtr->getLeftChildPtr()));
 		newNode->setMidChildPtr(copyTree(otherTreePtr->getMidChildPtr()));
 		newNode->setRightChildPtr(copyTree(otherTreePtr->getRightChildPtr()));
+		newNode->setSubtreeSize(otherTreePtr->getSubtreeSize());
 
 		return newNode;
 	}
@@ -54,19 +56,15 @@ bool TwoThreeTree<ItemType>::isEmpty() const
 template <class ItemType>
 int TwoThreeTree<ItemType>::getHeightHelper(TriNode<ItemType>* subTreePtr) const
 {
-	if (subTreePtr == NULL) //Empty tree height is 0
-		return 0;
-	else if (subTreePtr->isTwoNode()) //2-Node case, computes the height of the left and right subtrees
-	{
-		return 1 + std::max(getHeightHelper(subTreePtr->getLeftChildPtr()),
-					getHeightHelper(subTreePtr->getRightChildPtr()));
-	}
-	else //3-Node case, computes height of the left, middle and right subtrees
-	{
-		return 1 + std::max(std::max(getHeightHelper(subTreePtr->getLeftChildPtr()),
-					getHeightHelper(subTreePtr->getMidChildPtr())),
-						getHeightHelper(subTreePtr->getRightChildPtr()));
+	int height = 0; //Empty tree height is 0
+
+	while (subTreePtr != NULL) //Every leaf of a 2-3 tree is at the same depth, so following
+	{			   //the left children is enough
+		height++;
+		subTreePtr = subTreePtr->getLeftChildPtr();
 	}
+
+	return height;
 }
 
 template <class ItemType>
@@ -77,25 +75,18 @@ int TwoThreeTree<ItemType>::getHeight() const
 
 
 template <class ItemType>
-int TwoThreeTree<ItemType>::getNumberOfItemsHelper(TriNode<ItemType>* subTreePtr) const
+int TwoThreeTree<ItemType>::getSubtreeSize(TriNode<ItemType>* subTreePtr) const
 {
-	if (subTreePtr == NULL)
+	if (subTreePtr == NULL) //Empty tree has 0 items
 		return 0;
-	else if (subTreePtr->isTwoNode()) //2-node case, adds 1 to the # of items in the left and right
-		return 1 + getNumberOfItemsHelper(subTreePtr->getLeftChildPtr()) //subtrees
-				+ getNumberOfItemsHelper(subTreePtr->getRightChildPtr());
-	else //3-node case, adds 2 to the # of items in the left, middle, and right subtrees.
-		return 2 + getNumberOfItemsHelper(subTreePtr->getLeftChildPtr())
-				+ getNumberOfItemsHelper(subTreePtr->getRightChildPtr())
-					+ getNumberOfItemsHelper(subTreePtr->getMidChildPtr());
+	else
+		return subTreePtr->getSubtreeSize();
 }
 
-
-
 template <class ItemType>
 int TwoThreeTree<ItemType>::getNumberOfItems() const
 {
-	return getNumberOfItemsHelper(rootPtr);
+	return getSubtreeSize(rootPtr);
 }
 
 
@@ -103,18 +94,23 @@ template <class ItemType>
 void TwoThreeTree<ItemType>::findInsertLoc(TriNode<ItemType>* subTreePtr, ItemType* itemPtr)
 {
 	Stack<TriNode<ItemType>*> ptrStack; //Used to store the pointers of the nodes traversed
+	subTreePtr = unshareChild(NULL, subTreePtr); //Any node on the path may be modified
+	unsigned long long keyPrefix = itemPtr->getKeyPrefix();
+
 	while (!subTreePtr->isLeaf()) //during the search. Search stops when a leaf is found.
 	{
 		TriNode<ItemType>* nextPtr = NULL;
-		if (*itemPtr < *(subTreePtr->getSmallItem()))
+		if (subTreePtr->compareSmallItem(*itemPtr, keyPrefix) < 0)
 			nextPtr = subTreePtr->getLeftChildPtr();
-		else if (subTreePtr->isThreeNode() && *itemPtr < *(subTreePtr->getLargeItem()))
+		else if (subTreePtr->isThreeNode() && subTreePtr->compareLargeItem(*itemPtr, keyPrefix) < 0)
 			nextPtr = subTreePtr->getMidChildPtr();
 		else
 			nextPtr = subTreePtr->getRightChildPtr();
+		nextPtr = unshareChild(subTreePtr, nextPtr);
 
 		ptrStack.push(subTreePtr);
-		subTreePtr = nextPtr;
+		subTreePtr->setSubtreeSize(subTreePtr->getSubtreeSize() + 1); //The item always ends up
+		subTreePtr = nextPtr;						//below this node
 	}
 
 	insertInLoc(subTreePtr, itemPtr, ptrStack); //Inserts the contents of itemPtr into the leaf pointed to
@@ -128,12 +124,13 @@ void TwoThreeTree<ItemType>::insertInLoc(TriNode<ItemType>* nodePtr, ItemType* i
 	if (nodePtr->isTwoNode()) //2-node leaf becomes a 3-node
 	{
 		if (*itemPtr > *(nodePtr->getSmallItem()))
-			nodePtr->setLargeItem(*itemPtr);
+			nodePtr->setLargeItemPtr(itemPtr);
 		else //It is smaller than the current item in the 2-Node
 		{
-			nodePtr->setLargeItem(*(nodePtr->getSmallItem()));
-			nodePtr->setSmallItem(*itemPtr);
+			nodePtr->setLargeItemPtr(nodePtr->releaseSmallItem());
+			nodePtr->setSmallItemPtr(itemPtr);
 		}
+		nodePtr->updateSubtreeSize();
 	}
 	else //We have a three node
 	{
@@ -146,11 +143,11 @@ void TwoThreeTree<ItemType>::insertInLoc(TriNode<ItemType>* nodePtr, ItemType* i
 			if (nodePtr->isTwoNode()) //If it is a 2-node, insert contents
 			{			 //of itemPtr and make it a 3-node
 				if (*itemPtr > *(nodePtr->getSmallItem()))
-					nodePtr->setLargeItem(*itemPtr);
+					nodePtr->setLargeItemPtr(itemPtr);
 				else //It is smaller than the current item in the 2-Node
 				{
-					nodePtr->setLargeItem(*(nodePtr->getSmallItem()));
-					nodePtr->setSmallItem(*itemPtr);
+					nodePtr->setLargeItemPtr(nodePtr->releaseSmallItem());
+					nodePtr->setSmallItemPtr(itemPtr);
 				}
 				itemPtr = NULL; //Tree is now rebuilt, so there is no passed item.
 				reconnect(nodePtr, connectingPtr); //Reconnect n1 and n2 from any previous
@@ -164,7 +161,8 @@ void TwoThreeTree<ItemType>::insertInLoc(TriNode<ItemType>* nodePtr, ItemType* i
 		}
 		if (ptrStack.empty() && itemPtr != NULL) //We've reached the root, so the empty node
 		{					 //pointed to by connetingPtr becomes the new root
-			connectingPtr->setSmallItem(*itemPtr); //containing the passed item.
+			connectingPtr->setSmallItemPtr(itemPtr); //containing the passed item.
+			connectingPtr->updateSubtreeSize();
 			rootPtr = connectingPtr;
 		}
 	}
@@ -200,10 +198,8 @@ TriNode<ItemType>* TwoThreeTree<ItemType>::split(TriNode<ItemType>* nodePtr, Tri
 	TriNode<ItemType>* n2 = new TriNode<ItemType>;
 
 
-	n1->setSmallItem(*(nodePtr->getSmallItem())); //n1 gets nodePtr's small item
-	nodePtr->removeSmallItem();
-	n2->setSmallItem(*(nodePtr->getLargeItem())); //n2 gets nodePtr's large item
-	nodePtr->removeLargeItem();
+	n1->setSmallItemPtr(nodePtr->releaseSmallItem()); //n1 gets nodePtr's small item
+	n2->setSmallItemPtr(nodePtr->releaseLargeItem()); //n2 gets nodePtr's large item
 
 	if (connectingPtr != NULL) //Check if there are n1 and n2 from an earlier split and reconnect
 	{				//accordingly
@@ -232,6 +228,9 @@ TriNode<ItemType>* TwoThreeTree<ItemType>::split(TriNode<ItemType>* nodePtr, Tri
 	}
 
 
+	n1->updateSubtreeSize(); //Children of n1 and n2 are unchanged subtrees, so their sizes
+	n2->updateSubtreeSize(); //can be computed directly
+
 	nodePtr->setMidChildPtr(NULL);
 	nodePtr->setLeftChildPtr(n1);
 	nodePtr->setRightChildPtr(n2);
@@ -243,20 +242,20 @@ template <class ItemType>
 ItemType* TwoThreeTree<ItemType>::getMiddleItem(TriNode<ItemType>* nodePtr, ItemType* passedItem)
 {
 
-	if (*passedItem < *(nodePtr->getSmallItem())) //The small item is in the middle
-	{
-		ItemType temp = *passedItem;
-		*passedItem = *(nodePtr->getSmallItem());
-		nodePtr->setSmallItem(temp);
+	ItemType* middleItem = passedItem; //Passed item is in the middle by default
+
+	if (*passedItem < *(nodePtr->getSmallItem())) //The small item is in the middle, so
+	{					      //the passed item takes its place
+		middleItem = nodePtr->releaseSmallItem();
+		nodePtr->setSmallItemPtr(passedItem);
 	}
 	else if (*passedItem > *(nodePtr->getLargeItem())) //The large item is the middle
 	{
-		ItemType temp = *passedItem;
-		*passedItem = *(nodePtr->getLargeItem());
-		nodePtr->setLargeItem(temp);
+		middleItem = nodePtr->releaseLargeItem();
+		nodePtr->setLargeItemPtr(passedItem);
 	}
 
-	return passedItem;
+	return middleItem;
 }
 
 template <class ItemType>
@@ -266,18 +265,353 @@ bool TwoThreeTree<ItemType>::add(const ItemType& newData)
 	{
 		rootPtr = new TriNode<ItemType>;
 		rootPtr->setSmallItem(newData);
+		rootPtr->updateSubtreeSize();
 	}
 	else //Nonempty tree
 	{
-		ItemType* itemPtr = new ItemType; //Create pointer that stores the new item,
-		*itemPtr = newData;		 //used to facilitate passing items during
-		findInsertLoc(rootPtr, itemPtr); //rebuilding of the tree
+		ItemType* itemPtr = new ItemType(newData); //The only copy of the new item. It is passed
+		findInsertLoc(rootPtr, itemPtr);	   //between the nodes by pointer until a node
+	}						   //takes ownership of it
+
+	return true;
+}
+
+template <class ItemType>
+int TwoThreeTree<ItemType>::containsMany(const ItemType items[], int numItems, bool results[]) const
+{
+	int numFound = 0;
+	TriNode<ItemType>* foundPtrs[TREE_PROBE_GROUP_SIZE];
+	for (int first = 0; first < numItems; first += TREE_PROBE_GROUP_SIZE)
+	{
+		int groupSize = std::min(TREE_PROBE_GROUP_SIZE, numItems - first);
+		findGroup(items + first, groupSize, foundPtrs);
+
+		for (int i = 0; i < groupSize; i++)
+		{
+			results[first + i] = (foundPtrs[i] != NULL);
+			if (results[first + i])
+				numFound++;
+		}
+	}
+
+	return numFound;
+}
+
+template <class ItemType>
+int TwoThreeTree<ItemType>::addMany(const ItemType items[], int numItems, bool results[])
+{
+	TriNode<ItemType>* foundPtrs[TREE_PROBE_GROUP_SIZE];
+	for (int first = 0; first < numItems; first += TREE_PROBE_GROUP_SIZE)
+	{
+		int groupSize = std::min(TREE_PROBE_GROUP_SIZE, numItems - first);
+		findGroup(items + first, groupSize, foundPtrs); //Only to load the paths
+
+		for (int i = first; i < first + groupSize; i++)
+			results[i] = add(items[i]);
+	}
+
+	return numItems; //Same as add, which always succeeds
+}
+
+template <class ItemType>
+int TwoThreeTree<ItemType>::removeMany(const ItemType items[], int numItems, bool results[])
+{
+	int numRemoved = 0;
+	TriNode<ItemType>* foundPtrs[TREE_PROBE_GROUP_SIZE];
+	for (int first = 0; first < numItems; first += TREE_PROBE_GROUP_SIZE)
+	{
+		int groupSize = std::min(TREE_PROBE_GROUP_SIZE, numItems - first);
+		findGroup(items + first, groupSize, foundPtrs);
+
+		for (int i = 0; i < groupSize; i++)
+		{
+			results[first + i] = false; //Items not found need no removal. A removal can move the
+			if (foundPtrs[i] != NULL)   //other items of the group, so each is searched again.
+			{
+				results[first + i] = remove(items[first + i]);
+				if (results[first + i])
+					numRemoved++;
+			}
+		}
+	}
+
+	return numRemoved;
+}
+
+template <class ItemType>
+bool TwoThreeTree<ItemType>::isSorted(const ItemType items[], int numItems) const
+{
+	bool sorted = true;
+	for (int i = 1; sorted && i < numItems; i++) //Stop at the first item smaller than its predecessor
+		sorted = !(items[i] < items[i-1]);
+
+	return sorted;
+}
+
+template <class ItemType>
+TriNode<ItemType>* TwoThreeTree<ItemType>::buildNode(const ItemType* levelItems[], int& itemIndex,
+						bool isThreeNode, TriNode<ItemType>* childPtrs[],
+							int& childIndex, bool isLeafLevel, bool isTaken[])
+{
+	TriNode<ItemType>* nodePtr = new TriNode<ItemType>;
+	for (int i = 0; i < (isThreeNode ? 2 : 1); i++)
+	{
+		ItemType* itemPtr = const_cast<ItemType*>(levelItems[itemIndex]); //Owned by the caller,
+		if (isTaken == NULL || !isTaken[itemIndex])			   //see buildFromSorted
+			itemPtr = new ItemType(*itemPtr);
+		itemIndex++;
+
+		if (i == 0)
+			nodePtr->setSmallItemPtr(itemPtr);
+		else
+			nodePtr->setLargeItemPtr(itemPtr);
+	}
+
+	if (!isLeafLevel) //Internal nodes take the next nodes of the level below as children
+	{
+		nodePtr->setLeftChildPtr(childPtrs[childIndex++]);
+		if (isThreeNode)
+			nodePtr->setMidChildPtr(childPtrs[childIndex++]);
+		nodePtr->setRightChildPtr(childPtrs[childIndex++]);
+	}
+
+	nodePtr->updateSubtreeSize();
+
+	return nodePtr;
+}
+
+template <class ItemType>
+void TwoThreeTree<ItemType>::buildFromSorted(const ItemType items[], int numItems)
+{
+	if (numItems <= 0)
+		return;
+
+	const ItemType** levelItems = new const ItemType*[numItems];
+	for (int i = 0; i < numItems; i++)
+		levelItems[i] = &items[i];
+
+	rootPtr = buildFromSorted(levelItems, numItems);
+
+	delete [] levelItems;
+}
+
+template <class ItemType>
+TriNode<ItemType>* TwoThreeTree<ItemType>::buildFromSorted(const ItemType* levelItems[], int numItems,
+								bool isTaken[])
+{
+	if (numItems <= 0)
+		return NULL;
+
+	//The items and nodes of every level are stored in these two arrays. Each level is
+	//rewritten in place since a node never ends up ahead of the items and children it was built from
+	TriNode<ItemType>** childPtrs = new TriNode<ItemType>*[numItems+1];
+
+	int numLevelItems = numItems;
+	bool isLeafLevel = true;
+	while (numLevelItems > 2) //Too many items for the root, so build another level
+	{
+		//A level of k nodes holds between k and 2k items, plus the k-1 items passed up
+		//between them. Use the fewest nodes possible, filling the first ones as 3-nodes.
+		int numNodes = (numLevelItems + 3)/3;
+		int numThreeNodes = (numLevelItems - numNodes + 1) - numNodes;
+
+		int itemIndex = 0;
+		int childIndex = 0;
+		for (int i = 0; i < numNodes; i++)
+		{
+			childPtrs[i] = buildNode(levelItems, itemIndex, i < numThreeNodes, childPtrs,
+							childIndex, isLeafLevel, isTaken);
+
+			if (i < numNodes-1) //The item after the node separates it from the next
+			{		    //one, so it goes up a level
+				if (isTaken != NULL)
+					isTaken[i] = isTaken[itemIndex];
+				levelItems[i] = levelItems[itemIndex++];
+			}
+		}
+
+		numLevelItems = numNodes-1;
+		isLeafLevel = false;
+	}
+
+	int itemIndex = 0;
+	int childIndex = 0;
+	TriNode<ItemType>* newRootPtr = buildNode(levelItems, itemIndex, numLevelItems == 2, childPtrs,
+							childIndex, isLeafLevel, isTaken);
+
+	delete [] childPtrs;
+
+	return newRootPtr;
+}
+
+template <class ItemType>
+bool TwoThreeTree<ItemType>::addAll(const ItemType items[], int numItems)
+{
+	if (isEmpty() && isSorted(items, numItems)) //Only a sorted sequence can be built bottom-up
+		buildFromSorted(items, numItems);
+	else //Fall back to inserting each item individually
+	{
+		for (int i = 0; i < numItems; i++)
+			add(items[i]);
 	}
 
 	return true;
 }
 
 
+template <class ItemType>
+void TwoThreeTree<ItemType>::takeItems(TriNode<ItemType>* subTreePtr, bool isShared,
+					const ItemType* items[], bool isTaken[], int& numItems)
+{
+	if (subTreePtr != NULL)
+	{
+		isShared = isShared || subTreePtr->isShared(); //A snapshot reaches everything below
+		bool isThreeNode = subTreePtr->isThreeNode();
+		ItemType* smallItemPtr = isShared ? subTreePtr->getSmallItem() : subTreePtr->releaseSmallItem();
+		ItemType* largeItemPtr = isShared ? subTreePtr->getLargeItem() : subTreePtr->releaseLargeItem();
+
+		takeItems(subTreePtr->getLeftChildPtr(), isShared, items, isTaken, numItems);
+		isTaken[numItems] = !isShared;
+		items[numItems++] = smallItemPtr;
+		if (isThreeNode)
+		{
+			takeItems(subTreePtr->getMidChildPtr(), isShared, items, isTaken, numItems);
+			isTaken[numItems] = !isShared;
+			items[numItems++] = largeItemPtr;
+		}
+		takeItems(subTreePtr->getRightChildPtr(), isShared, items, isTaken, numItems);
+	}
+}
+
+template <class ItemType>
+void TwoThreeTree<ItemType>::combine(const TwoThreeTree<ItemType>& aTree, bool keepOnlyThis,
+					bool keepCommon, bool keepOnlyOther)
+{
+	int numThisItems = getNumberOfItems();
+	int maxItems = numThisItems + aTree.getNumberOfItems();
+	const ItemType** thisItems = new const ItemType*[numThisItems > 0 ? numThisItems : 1];
+	bool* isThisTaken = new bool[numThisItems > 0 ? numThisItems : 1];
+	const ItemType** mergedItems = new const ItemType*[maxItems > 0 ? maxItems : 1];
+	bool* isTaken = new bool[maxItems > 0 ? maxItems : 1];
+	int numMerged = 0;
+
+	numThisItems = 0;
+	takeItems(rootPtr, false, thisItems, isThisTaken, numThisItems);
+
+	int thisIndex = 0; //Merge the two in-order sequences, keeping pointers to the
+	iterator otherIter = aTree.begin(); //items that are part of the result
+	while (thisIndex < numThisItems || otherIter != aTree.end())
+	{
+		if (thisIndex == numThisItems || (otherIter != aTree.end() && *otherIter < *thisItems[thisIndex]))
+		{
+			if (keepOnlyOther) //aTree is unchanged, so its items are copied
+			{
+				isTaken[numMerged] = false;
+				mergedItems[numMerged++] = &(*otherIter);
+			}
+			++otherIter;
+		}
+		else
+		{
+			bool isKept = keepOnlyThis;
+			if (otherIter != aTree.end() && !(*thisItems[thisIndex] < *otherIter)) //In both trees
+			{
+				isKept = keepCommon;
+				++otherIter;
+			}
+
+			if (isKept)
+			{
+				isTaken[numMerged] = isThisTaken[thisIndex];
+				mergedItems[numMerged++] = thisItems[thisIndex];
+			}
+			else if (isThisTaken[thisIndex]) //No node holds it any more
+				delete thisItems[thisIndex];
+			thisIndex++;
+		}
+	}
+
+	TriNode<ItemType>* newRootPtr = buildFromSorted(mergedItems, numMerged, isTaken); //Copies the
+	postorderDelete(rootPtr);	//items still held by the old tree, so it goes afterwards
+	rootPtr = newRootPtr;
+
+	delete [] thisItems;
+	delete [] isThisTaken;
+	delete [] mergedItems;
+	delete [] isTaken;
+}
+
+template <class ItemType>
+bool TwoThreeTree<ItemType>::isSmallOperand(const TwoThreeTree<ItemType>& aTree) const
+{
+	return (long)aTree.getNumberOfItems() * (getHeight() + 1) < getNumberOfItems();
+}
+
+template <class ItemType>
+void TwoThreeTree<ItemType>::mergeFrom(const TwoThreeTree<ItemType>& aTree)
+{
+	if (this == &aTree) //Every item is already in the tree
+		return;
+
+	if (isSmallOperand(aTree))
+	{
+		aTree.forEach([this](const ItemType& item)
+		{
+			if (!contains(item)) //add doesn't skip duplicates
+				add(item);
+			return true;
+		});
+	}
+	else
+		combine(aTree, true, true, true);
+}
+
+template <class ItemType>
+void TwoThreeTree<ItemType>::intersectWith(const TwoThreeTree<ItemType>& aTree)
+{
+	if (this == &aTree) //The intersection with itself is the tree itself
+		return;
+
+	if (isSmallOperand(aTree)) //Only the items found in the tree are gone through
+	{
+		const ItemType** commonItems = new const ItemType*[aTree.getNumberOfItems() + 1];
+		int numCommon = 0;
+		aTree.forEach([&](const ItemType& item)
+		{
+			TriNode<ItemType>* nodePtr = findItem(rootPtr, item);
+			if (nodePtr != NULL) //Keeps the tree's own item, as combine does
+				commonItems[numCommon++] = (nodePtr->compareSmallItem(item, item.getKeyPrefix()) == 0)
+								? nodePtr->getSmallItem() : nodePtr->getLargeItem();
+			return true;
+		});
+
+		TriNode<ItemType>* newRootPtr = buildFromSorted(commonItems, numCommon);
+		postorderDelete(rootPtr);
+		rootPtr = newRootPtr;
+
+		delete [] commonItems;
+	}
+	else
+		combine(aTree, false, true, false);
+}
+
+template <class ItemType>
+void TwoThreeTree<ItemType>::difference(const TwoThreeTree<ItemType>& aTree)
+{
+	if (this == &aTree)
+		clear();
+	else if (isSmallOperand(aTree))
+	{
+		aTree.forEach([this](const ItemType& item)
+		{
+			if (contains(item)) //remove copies the shared nodes on its path, even if the
+				remove(item); //item isn't found
+			return true;
+		});
+	}
+	else
+		combine(aTree, true, false, false);
+}
 
 
 template <class ItemType>
@@ -286,8 +620,8 @@ void TwoThreeTree<ItemType>::mergeTwoParent(TriNode<ItemType>* emptyNodePtr, Tri
 {
 	if (emptyNodePtr == parentPtr->getLeftChildPtr()) //Case A of "Merging Nodes: Two Node Parent Cases"
 	{
-		siblingPtr->setLargeItem(*(siblingPtr->getSmallItem()));
-		siblingPtr->setSmallItem(*(parentPtr->getSmallItem()));
+		siblingPtr->setLargeItemPtr(siblingPtr->releaseSmallItem());
+		siblingPtr->setSmallItemPtr(parentPtr->releaseSmallItem());
 
 
 		siblingPtr->setMidChildPtr(siblingPtr->getLeftChildPtr());
@@ -295,7 +629,7 @@ void TwoThreeTree<ItemType>::mergeTwoParent(TriNode<ItemType>* emptyNodePtr, Tri
 	}
 	else //Case B of "Merging Nodes: Two Node Parent Cases"
 	{
-		siblingPtr->setLargeItem(*(parentPtr->getSmallItem()));
+		siblingPtr->setLargeItemPtr(parentPtr->releaseSmallItem());
 
 		siblingPtr->setMidChildPtr(siblingPtr->getRightChildPtr());
 		siblingPtr->setRightChildPtr(emptyNodePtr->getMidChildPtr());
@@ -308,6 +642,9 @@ void TwoThreeTree<ItemType>::mergeTwoParent(TriNode<ItemType>* emptyNodePtr, Tri
 	parentPtr->setRightChildPtr(NULL);
 	parentPtr->setMidChildPtr(siblingPtr);
 
+	siblingPtr->updateSubtreeSize(); //Sibling holds everything below the parent now
+	parentPtr->updateSubtreeSize();
+
 
 	delete emptyNodePtr; //Removing the original empty node
 }
@@ -320,28 +657,28 @@ void TwoThreeTree<ItemType>::mergeThreeParent(TriNode<ItemType>* emptyNodePtr, T
 	{
 		if (emptyNodePtr == parentPtr->getLeftChildPtr()) //Case A of "Merging Nodes: 3-Node Parent Cases"
 		{
-			siblingPtr->setLargeItem(*(siblingPtr->getSmallItem()));
-			siblingPtr->setSmallItem(*(parentPtr->getSmallItem()));
+			siblingPtr->setLargeItemPtr(siblingPtr->releaseSmallItem());
+			siblingPtr->setSmallItemPtr(parentPtr->releaseSmallItem());
 
 			siblingPtr->setMidChildPtr(siblingPtr->getLeftChildPtr());
 			siblingPtr->setLeftChildPtr(emptyNodePtr->getMidChildPtr());
 		}
 		else //Case B of "Merging Nodes: 3-Node Parent Cases"
 		{
-			siblingPtr->setLargeItem(*(parentPtr->getSmallItem()));
+			siblingPtr->setLargeItemPtr(parentPtr->releaseSmallItem());
 
 			siblingPtr->setMidChildPtr(siblingPtr->getRightChildPtr());
 			siblingPtr->setRightChildPtr(emptyNodePtr->getMidChildPtr());
 		}
 
-		parentPtr->setSmallItem(*(parentPtr->getLargeItem()));
+		parentPtr->setSmallItemPtr(parentPtr->releaseLargeItem());
 
 		parentPtr->setLeftChildPtr(siblingPtr);
 
 	}
 	else //Case C of "Merging Nodes: 3-Node Parent Cases"
 	{
-		siblingPtr->setLargeItem(*(parentPtr->getLargeItem()));
+		siblingPtr->setLargeItemPtr(parentPtr->releaseLargeItem());
 
 		siblingPtr->setMidChildPtr(siblingPtr->getRightChildPtr());
 		siblingPtr->setRightChildPtr(emptyNodePtr->getMidChildPtr());
@@ -354,6 +691,9 @@ void TwoThreeTree<ItemType>::mergeThreeParent(TriNode<ItemType>* emptyNodePtr, T
 	parentPtr->setMidChildPtr(NULL);
 	parentPtr->removeLargeItem();
 
+	siblingPtr->updateSubtreeSize();
+	parentPtr->updateSubtreeSize();
+
 
 	delete emptyNodePtr; //Removing the original, empty node
 }
@@ -363,13 +703,13 @@ void TwoThreeTree<ItemType>::redistributeTwoParent(TriNode<ItemType>* emptyNodeP
 							TriNode<ItemType>* siblingPtr)
 {
 	//Turning empty node back into a 2-Node
-	emptyNodePtr->setSmallItem(*(parentPtr->getSmallItem()));
+	emptyNodePtr->setSmallItemPtr(parentPtr->releaseSmallItem());
 
 	if (emptyNodePtr == parentPtr->getLeftChildPtr()) //Case A of "Redistribute: 2-Node Parent Cases"
 	{
-		parentPtr->setSmallItem(*(siblingPtr->getSmallItem()));
+		parentPtr->setSmallItemPtr(siblingPtr->releaseSmallItem());
 
-		siblingPtr->setSmallItem(*(siblingPtr->getLargeItem()));
+		siblingPtr->setSmallItemPtr(siblingPtr->releaseLargeItem());
 
 		emptyNodePtr->setLeftChildPtr(emptyNodePtr->getMidChildPtr());
 		emptyNodePtr->setRightChildPtr(siblingPtr->getLeftChildPtr());
@@ -378,7 +718,7 @@ void TwoThreeTree<ItemType>::redistributeTwoParent(TriNode<ItemType>* emptyNodeP
 	}
 	else //Case B of "Redistribute: 2-Node Parent Cases"
 	{
-		parentPtr->setSmallItem(*(siblingPtr->getLargeItem()));
+		parentPtr->setSmallItemPtr(siblingPtr->releaseLargeItem());
 
 		emptyNodePtr->setRightChildPtr(emptyNodePtr->getMidChildPtr());
 		emptyNodePtr->setLeftChildPtr(siblingPtr->getRightChildPtr());
@@ -394,6 +734,10 @@ void TwoThreeTree<ItemType>::redistributeTwoParent(TriNode<ItemType>* emptyNodeP
 
 	//Resetting empty node's middle child
 	emptyNodePtr->setMidChildPtr(NULL);
+
+	emptyNodePtr->updateSubtreeSize(); //Parent keeps the same items below it, but its
+	siblingPtr->updateSubtreeSize();   //children need to be recounted
+	parentPtr->updateSubtreeSize();
 }
 
 
@@ -403,13 +747,13 @@ void TwoThreeTree<ItemType>::redistributeThreeParent(TriNode<ItemType>* emptyNod
 {
 	if (emptyNodePtr == parentPtr->getLeftChildPtr() || siblingPtr == parentPtr->getLeftChildPtr())
 	{
-		emptyNodePtr->setSmallItem(*(parentPtr->getSmallItem()));
+		emptyNodePtr->setSmallItemPtr(parentPtr->releaseSmallItem());
 
 		if (emptyNodePtr == parentPtr->getLeftChildPtr()) //Case A of "Redistribute: 3-Node Parent Cases"
 		{
-			parentPtr->setSmallItem(*(siblingPtr->getSmallItem()));
+			parentPtr->setSmallItemPtr(siblingPtr->releaseSmallItem());
 
-			siblingPtr->setSmallItem(*(siblingPtr->getLargeItem()));
+			siblingPtr->setSmallItemPtr(siblingPtr->releaseLargeItem());
 
 			emptyNodePtr->setLeftChildPtr(emptyNodePtr->getMidChildPtr());
 			emptyNodePtr->setRightChildPtr(siblingPtr->getLeftChildPtr());
@@ -418,7 +762,7 @@ void TwoThreeTree<ItemType>::redistributeThreeParent(TriNode<ItemType>* emptyNod
 		}
 		else //Case B of "Redistribute: 3-Node Parent Cases"
 		{
-			parentPtr->setSmallItem(*(siblingPtr->getLargeItem()));
+			parentPtr->setSmallItemPtr(siblingPtr->releaseLargeItem());
 
 
 			emptyNodePtr->setRightChildPtr(emptyNodePtr->getMidChildPtr());
@@ -429,11 +773,11 @@ void TwoThreeTree<ItemType>::redistributeThreeParent(TriNode<ItemType>* emptyNod
 	}
 	else if (emptyNodePtr == parentPtr->getRightChildPtr() || siblingPtr == parentPtr->getRightChildPtr())
 	{
-		emptyNodePtr->setSmallItem(*(parentPtr->getLargeItem()));
+		emptyNodePtr->setSmallItemPtr(parentPtr->releaseLargeItem());
 
 		if (emptyNodePtr == parentPtr->getRightChildPtr()) //Case C of "Redistribute: 3-Node Parent Cases"
 		{
-			parentPtr->setLargeItem(*(siblingPtr->getLargeItem()));
+			parentPtr->setLargeItemPtr(siblingPtr->releaseLargeItem());
 
 
 			emptyNodePtr->setRightChildPtr(emptyNodePtr->getMidChildPtr());
@@ -444,9 +788,9 @@ void TwoThreeTree<ItemType>::redistributeThreeParent(TriNode<ItemType>* emptyNod
 		else //Case D of "Redistribute: 3-Node Parent Cases"
 		{
 
-			parentPtr->setLargeItem(*(siblingPtr->getSmallItem()));
+			parentPtr->setLargeItemPtr(siblingPtr->releaseSmallItem());
 
-			siblingPtr->setSmallItem(*(siblingPtr->getLargeItem()));
+			siblingPtr->setSmallItemPtr(siblingPtr->releaseLargeItem());
 
 			emptyNodePtr->setLeftChildPtr(emptyNodePtr->getMidChildPtr());
 			emptyNodePtr->setRightChildPtr(siblingPtr->getLeftChildPtr());
@@ -462,6 +806,10 @@ void TwoThreeTree<ItemType>::redistributeThreeParent(TriNode<ItemType>* emptyNod
 
 	//Reset empty node into a 2-Node
 	emptyNodePtr->setMidChildPtr(NULL);
+
+	emptyNodePtr->updateSubtreeSize();
+	siblingPtr->updateSubtreeSize();
+	parentPtr->updateSubtreeSize();
 }
 
 
@@ -500,44 +848,63 @@ bool TwoThreeTree<ItemType>::removeValue(TriNode<ItemType>* subTreePtr, const It
 {
 	bool canRemove = false;
 	Stack<TriNode<ItemType>*> ptrStack; //Stack to store the pointers of the nodes traversed.
+	unsigned long long keyPrefix = value.getKeyPrefix();
+
+	if (subTreePtr != NULL) //Nodes on the path are modified, so none of them can be shared
+		subTreePtr = unshareChild(NULL, subTreePtr);
 
 	while (!canRemove && subTreePtr != NULL) //While the node containing the item hasn't been found,
 	{					 //Or the end of the tree hasn't been reached
 		TriNode<ItemType>* nextPtr = NULL;
+		int comparison = subTreePtr->compareSmallItem(value, keyPrefix);
 
-		if (value < *(subTreePtr->getSmallItem())) //Move to the left subtree
+		if (comparison < 0) //Move to the left subtree
 			nextPtr = subTreePtr->getLeftChildPtr();
-		else if (value == *(subTreePtr->getSmallItem())) //Found the value
+		else if (comparison == 0) //Found the value
 			canRemove = true;
 		else if (!subTreePtr->isThreeNode()) //Move to the right child if root of subtree isn't a 3-node
 			nextPtr = subTreePtr->getRightChildPtr();
-		else //Root of the subtree is a 3-node
+		else //Root of the subtree is a 3-node, and value > small item
 		{
-			if (*(subTreePtr->getSmallItem()) < value && value < *(subTreePtr->getLargeItem()))
+			comparison = subTreePtr->compareLargeItem(value, keyPrefix);
+			if (comparison < 0)
 				nextPtr = subTreePtr->getMidChildPtr(); //Move to the middle child
-			else if (value == *(subTreePtr->getLargeItem())) //Found the item
+			else if (comparison == 0) //Found the item
 				canRemove = true;
 			else //Move to the right child
 				nextPtr = subTreePtr->getRightChildPtr();
 		}
 
+		//Every node along the way loses an item if the value is found
+		subTreePtr->setSubtreeSize(subTreePtr->getSubtreeSize() - 1);
+
 		if (!canRemove) //Store subTreePtr in the stack if the node has not been found
 		{
 			ptrStack.push(subTreePtr);
+			if (nextPtr != NULL)
+				nextPtr = unshareChild(subTreePtr, nextPtr);
 			subTreePtr = nextPtr;
 		}
 	}
 
-	if (canRemove) //If the item was found, we need to remove it accordingly
+	if (!canRemove) //Value isn't in the tree, so give back the items taken from the traversed nodes
+	{
+		while (!ptrStack.empty())
+		{
+			ptrStack.top()->setSubtreeSize(ptrStack.top()->getSubtreeSize() + 1);
+			ptrStack.pop();
+		}
+	}
+	else //If the item was found, we need to remove it accordingly
 	{
 		if (subTreePtr->isLeaf()) //Item is at a leaf
 		{
 			if (subTreePtr->isThreeNode()) //3-node leaf, simply remove the corresponding
 			{			       //small or large item
-				if (value == *(subTreePtr->getSmallItem()))
-					subTreePtr->setSmallItem(*(subTreePtr->getLargeItem()));
-
-				subTreePtr->removeLargeItem(); //3-node becomes a 2-node
+				if (value == *(subTreePtr->getSmallItem())) //Large item replaces the small one
+					subTreePtr->setSmallItemPtr(subTreePtr->releaseLargeItem());
+				else
+					subTreePtr->removeLargeItem(); //3-node becomes a 2-node
 			}
 			else //We have a 2-Node leaf
 				removeTwoNode(subTreePtr, ptrStack);
@@ -545,46 +912,43 @@ bool TwoThreeTree<ItemType>::removeValue(TriNode<ItemType>* subTreePtr, const It
 		else //We have an internal node, so find the inorder successor
 		{
 			ptrStack.push(subTreePtr);
-			ItemType* itemPtr = NULL; //Pointer to the item that's going to be swapped
+			TriNode<ItemType>* foundPtr = subTreePtr; //Node of the item that's going to be replaced
+			bool isLargeItem = false;
 
 			if (subTreePtr->isThreeNode()) //3-node case
 			{
 				if (value == *(subTreePtr->getSmallItem()))
-				{
-					itemPtr = subTreePtr->getSmallItem();
-					subTreePtr = subTreePtr->getMidChildPtr(); //Successor is in the
-				}						   //middle child.
+					subTreePtr = subTreePtr->getMidChildPtr(); //Successor is in the middle child.
 				else //It is the large item of the 3-Node
 				{
-					itemPtr = subTreePtr->getLargeItem();
+					isLargeItem = true;
 					subTreePtr = subTreePtr->getRightChildPtr(); //Successor is
 				}						     //in the right child.
 			}
 			else //2-Node case
-			{
-				itemPtr = subTreePtr->getSmallItem();
 				subTreePtr = subTreePtr->getRightChildPtr(); //Successor is in the right child
-			}
+			subTreePtr = unshareChild(foundPtr, subTreePtr);
 
 
+			subTreePtr->setSubtreeSize(subTreePtr->getSubtreeSize() - 1);
 			while (subTreePtr->getLeftChildPtr() != NULL) //Search for the inorder successor
 			{
 				ptrStack.push(subTreePtr); //Place the traversed nodes into the stack
-				subTreePtr = subTreePtr->getLeftChildPtr();
+				subTreePtr = unshareChild(subTreePtr, subTreePtr->getLeftChildPtr());
+				subTreePtr->setSubtreeSize(subTreePtr->getSubtreeSize() - 1);
 			}
 
-			if (subTreePtr->isThreeNode()) //Smaller item of the 3-node is the successor
-			{
-				*itemPtr = *(subTreePtr->getSmallItem());
+			//Move the successor, the small item of the leaf, into the place of the removed item
+			bool isThreeNodeLeaf = subTreePtr->isThreeNode();
+			if (isLargeItem)
+				foundPtr->setLargeItemPtr(subTreePtr->releaseSmallItem());
+			else
+				foundPtr->setSmallItemPtr(subTreePtr->releaseSmallItem());
 
-				subTreePtr->setSmallItem(*(subTreePtr->getLargeItem())); //Convert to 2-Node
-				subTreePtr->removeLargeItem();
-			}
-			else //Successor is in a 2-node
-			{
-				*itemPtr = *(subTreePtr->getSmallItem());
+			if (isThreeNodeLeaf) //Convert the 3-node to a 2-Node
+				subTreePtr->setSmallItemPtr(subTreePtr->releaseLargeItem());
+			else //Successor was in a 2-node
 				removeTwoNode(subTreePtr, ptrStack); //Rebuild the tree by removing empty 2-Node
-			}
 
 		}
 	}
@@ -611,7 +975,8 @@ void TwoThreeTree<ItemType>::removeTwoNode(TriNode<ItemType>* subTreePtr, Stack<
 			TriNode<ItemType>* parentPtr = ptrStack.top(); //Get the parent pointer from stack
 			ptrStack.pop();
 
-			TriNode<ItemType>* siblingPtr = getSiblingPtr(subTreePtr, parentPtr); //Get the sibling
+			//Get the sibling, which is modified as well
+			TriNode<ItemType>* siblingPtr = unshareChild(parentPtr, getSiblingPtr(subTreePtr, parentPtr));
 
 			if (parentPtr->isTwoNode())
 			{
@@ -660,8 +1025,8 @@ bool TwoThreeTree<ItemType>::remove(const ItemType& anEntry)
 template <class ItemType>
 void TwoThreeTree<ItemType>::postorderDelete(TriNode<ItemType>* subTreePtr)
 {
-	if (subTreePtr != NULL)
-	{
+	if (subTreePtr != NULL && subTreePtr->removeReference() == 0) //Skip the nodes still in use
+	{								   //by a snapshot
 		if (subTreePtr->isTwoNode()) //If it's a 2-node, postorder is the same as a normal binary tree
 		{
 			postorderDelete(subTreePtr->getLeftChildPtr());
@@ -678,6 +1043,65 @@ void TwoThreeTree<ItemType>::postorderDelete(TriNode<ItemType>* subTreePtr)
 	}
 }
 
+template <class ItemType>
+TriNode<ItemType>* TwoThreeTree<ItemType>::copyNode(const TriNode<ItemType>* nodePtr)
+{
+	TriNode<ItemType>* newNode = new TriNode<ItemType>; //Same as copyTree, except the children
+	newNode->setSmallItem(*(nodePtr->getSmallItem())); //are shared instead of copied
+	if (nodePtr->isThreeNode())
+		newNode->setLargeItem(*(nodePtr->getLargeItem()));
+
+	newNode->setLeftChildPtr(nodePtr->getLeftChildPtr());
+	newNode->setMidChildPtr(nodePtr->getMidChildPtr());
+	newNode->setRightChildPtr(nodePtr->getRightChildPtr());
+	newNode->setSubtreeSize(nodePtr->getSubtreeSize());
+
+	if (newNode->getLeftChildPtr() != NULL)
+		newNode->getLeftChildPtr()->addReference();
+	if (newNode->getMidChildPtr() != NULL)
+		newNode->getMidChildPtr()->addReference();
+	if (newNode->getRightChildPtr() != NULL)
+		newNode->getRightChildPtr()->addReference();
+
+	return newNode;
+}
+
+template <class ItemType>
+TriNode<ItemType>* TwoThreeTree<ItemType>::unshareChild(TriNode<ItemType>* parentPtr,
+							TriNode<ItemType>* childPtr)
+{
+	if (!childPtr->isShared()) //Only this tree refers to the node, so it can be modified in place
+		return childPtr;
+
+	TriNode<ItemType>* copyPtr = copyNode(childPtr);
+
+	if (parentPtr == NULL) //Point the parent, or the tree, to the copy instead
+		rootPtr = copyPtr;
+	else if (parentPtr->getLeftChildPtr() == childPtr)
+		parentPtr->setLeftChildPtr(copyPtr);
+	else if (parentPtr->getMidChildPtr() == childPtr)
+		parentPtr->setMidChildPtr(copyPtr);
+	else
+		parentPtr->setRightChildPtr(copyPtr);
+
+	postorderDelete(childPtr); //Original loses the reference. If the snapshot let go of it in
+				   //the meantime, this deletes it.
+	return copyPtr;
+}
+
+template <class ItemType>
+void TwoThreeTree<ItemType>::takeSnapshot(const TwoThreeTree<ItemType>& aTree)
+{
+	if (this != &aTree)
+	{
+		clear();
+
+		rootPtr = aTree.rootPtr; //Share the whole tree through its root
+		if (rootPtr != NULL)
+			rootPtr->addReference();
+	}
+}
+
 template <class ItemType>
 void TwoThreeTree<ItemType>::clear()
 {
@@ -689,27 +1113,81 @@ void TwoThreeTree<ItemType>::clear()
 template <class ItemType>
 TriNode<ItemType>* TwoThreeTree<ItemType>::findItem(TriNode<ItemType>* subTreePtr, const ItemType& anEntry) const
 {
-	if (subTreePtr == NULL) //Item does not exist in the tree
+	unsigned long long keyPrefix = anEntry.getKeyPrefix(); //Compared with the prefixes cached in
+								//the nodes along the way
+	bool isFound = false;
+	while (subTreePtr != NULL && !isFound) //Stop when the item is found, or does not exist in the tree
+		subTreePtr = findStep(subTreePtr, anEntry, keyPrefix, isFound);
+
+	return subTreePtr;
+}
+
+template <class ItemType>
+TriNode<ItemType>* TwoThreeTree<ItemType>::findStep(TriNode<ItemType>* nodePtr, const ItemType& anEntry,
+							unsigned long long keyPrefix, bool& isFound) const
+{
+	isFound = false;
+
+	int comparison = nodePtr->compareSmallItem(anEntry, keyPrefix);
+	if (comparison == 0) //Found the item
 	{
-		return NULL;
+		isFound = true;
+		return nodePtr;
 	}
-	else
+	else if (comparison < 0) //Move to left child if item < small item of node
+		return nodePtr->getLeftChildPtr();
+	else if (nodePtr->isThreeNode()) //Check 3-node case
 	{
-		if (anEntry < *(subTreePtr->getSmallItem())) //Move to left child if item < small item of node
-			return findItem(subTreePtr->getLeftChildPtr(), anEntry);
-		else if (anEntry == *(subTreePtr->getSmallItem())) //Found the item
-			return subTreePtr;
-		else if (subTreePtr->isThreeNode()) //Check 3-node case
+		comparison = nodePtr->compareLargeItem(anEntry, keyPrefix);
+		if (comparison == 0) //Found the item
 		{
-			if (anEntry < *(subTreePtr->getLargeItem())) //Move to the middle child if item
-				return findItem(subTreePtr->getMidChildPtr(), anEntry); //< large item
-			else if (anEntry == *(subTreePtr->getLargeItem())) //Found the item
-				return subTreePtr;
-			else //Move to the right child
-				return findItem(subTreePtr->getRightChildPtr(), anEntry);
+			isFound = true;
+			return nodePtr;
 		}
+		else if (comparison < 0) //Move to the middle child if item < large item
+			return nodePtr->getMidChildPtr();
 		else //Move to the right child
-			return findItem(subTreePtr->getRightChildPtr(), anEntry);
+			return nodePtr->getRightChildPtr();
+	}
+	else //Move to the right child
+		return nodePtr->getRightChildPtr();
+}
+
+template <class ItemType>
+void TwoThreeTree<ItemType>::findGroup(const ItemType items[], int numItems, TriNode<ItemType>* foundPtrs[]) const
+{
+	TriNode<ItemType>* currentPtrs[TREE_PROBE_GROUP_SIZE]; //Next node of each search, NULL once done
+	unsigned long long keyPrefixes[TREE_PROBE_GROUP_SIZE];
+	for (int i = 0; i < numItems; i++)
+	{
+		currentPtrs[i] = rootPtr;
+		keyPrefixes[i] = items[i].getKeyPrefix();
+		foundPtrs[i] = NULL;
+	}
+
+	int numActive = (rootPtr != NULL) ? numItems : 0;
+	while (numActive > 0) //Every leaf is at the same depth, so the searches take turns level by level
+	{
+		for (int i = 0; i < numItems; i++)
+		{
+			if (currentPtrs[i] != NULL)
+			{
+				bool isFound = false;
+				TriNode<ItemType>* nextPtr = findStep(currentPtrs[i], items[i], keyPrefixes[i], isFound);
+				if (isFound)
+				{
+					foundPtrs[i] = nextPtr;
+					nextPtr = NULL;
+				}
+
+				if (nextPtr != NULL) //Loaded while the other searches take their turn
+					__builtin_prefetch(nextPtr);
+				else
+					numActive--;
+
+				currentPtrs[i] = nextPtr;
+			}
+		}
 	}
 }
 
@@ -717,13 +1195,35 @@ TriNode<ItemType>* TwoThreeTree<ItemType>::findItem(TriNode<ItemType>* subTreePt
 template <class ItemType>
 ItemType TwoThreeTree<ItemType>::getEntry(const ItemType& anEntry) const
 {
-	TriNode<ItemType>* nodePtr = findItem(rootPtr, anEntry);
-	if (nodePtr != NULL)
-		return anEntry;
+	ItemType* itemPtr = findStoredItem(rootPtr, anEntry);
+	if (itemPtr != NULL)
+		return *itemPtr;
 	else //Throw exception if the entry does not exist
 		throw(NotFoundException("getEntry() called with a nonexistant item."));
 }
 
+template <class ItemType>
+bool TwoThreeTree<ItemType>::findEntry(const ItemType& anEntry, ItemType& foundEntry) const
+{
+	ItemType* itemPtr = findStoredItem(rootPtr, anEntry);
+	if (itemPtr != NULL)
+		foundEntry = *itemPtr;
+
+	return (itemPtr != NULL);
+}
+
+template <class ItemType>
+ItemType* TwoThreeTree<ItemType>::findStoredItem(TriNode<ItemType>* subTreePtr, const ItemType& anEntry) const
+{
+	TriNode<ItemType>* nodePtr = findItem(subTreePtr, anEntry);
+	if (nodePtr == NULL)
+		return NULL;
+	else if (*(nodePtr->getSmallItem()) == anEntry)
+		return nodePtr->getSmallItem();
+	else
+		return nodePtr->getLargeItem();
+}
+
 template <class ItemType>
 bool TwoThreeTree<ItemType>::contains(const ItemType& anEntry) const
 {
@@ -758,6 +1258,108 @@ void TwoThreeTree<ItemType>::inorderHelper(TriNode<ItemType>* subTreePtr, void v
 	}
 }
 
+template <class ItemType>
+template <class Visitor>
+bool TwoThreeTree<ItemType>::forEachHelper(TriNode<ItemType>* subTreePtr, Visitor& visit) const
+{
+	if (subTreePtr == NULL)
+		return true;
+
+	if (!forEachHelper(subTreePtr->getLeftChildPtr(), visit) || !visit(*(subTreePtr->getSmallItem())))
+		return false;
+
+	if (subTreePtr->isThreeNode()) //Extra item and middle child of a 3-node
+	{
+		if (!forEachHelper(subTreePtr->getMidChildPtr(), visit) || !visit(*(subTreePtr->getLargeItem())))
+			return false;
+	}
+
+	return forEachHelper(subTreePtr->getRightChildPtr(), visit);
+}
+
+template <class ItemType>
+template <class Visitor>
+bool TwoThreeTree<ItemType>::forEach(Visitor&& visit) const
+{
+	return forEachHelper(rootPtr, visit);
+}
+
+template <class ItemType>
+template <class Visitor>
+bool TwoThreeTree<ItemType>::rangeHelper(TriNode<ItemType>* subTreePtr, const ItemType* lowPtr,
+						const ItemType* highPtr, Visitor& visit) const
+{
+	if (subTreePtr == NULL)
+		return true;
+
+	ItemType* smallPtr = subTreePtr->getSmallItem();
+	ItemType* largePtr = subTreePtr->getLargeItem();
+
+	//Items of the left subtree are <= small item, so it is skipped if small item < low
+	if (lowPtr == NULL || !(*smallPtr < *lowPtr))
+	{
+		if (!rangeHelper(subTreePtr->getLeftChildPtr(), lowPtr, highPtr, visit))
+			return false;
+	}
+
+	if ((lowPtr == NULL || !(*smallPtr < *lowPtr)) && (highPtr == NULL || *smallPtr < *highPtr))
+	{
+		if (!visit(*smallPtr))
+			return false;
+	}
+
+	if (subTreePtr->isThreeNode()) //Middle subtree lies between the small and large items
+	{
+		if ((highPtr == NULL || *smallPtr < *highPtr) && (lowPtr == NULL || !(*largePtr < *lowPtr)))
+		{
+			if (!rangeHelper(subTreePtr->getMidChildPtr(), lowPtr, highPtr, visit))
+				return false;
+		}
+
+		if ((lowPtr == NULL || !(*largePtr < *lowPtr)) && (highPtr == NULL || *largePtr < *highPtr))
+		{
+			if (!visit(*largePtr))
+				return false;
+		}
+	}
+	else
+		largePtr = smallPtr; //Right subtree of a 2-node is bounded by its only item
+
+	//Items of the right subtree are >= large item, so it is skipped if large item >= high
+	if (highPtr == NULL || *largePtr < *highPtr)
+		return rangeHelper(subTreePtr->getRightChildPtr(), lowPtr, highPtr, visit);
+
+	return true;
+}
+
+template <class ItemType>
+void TwoThreeTree<ItemType>::positionHelper(TriNode<ItemType>* subTreePtr, int first, int last,
+						void visit(ItemType&)) const
+{
+	//Skip the subtree if none of its positions are in [first, last)
+	if (subTreePtr != NULL && first < subTreePtr->getSubtreeSize() && last > 0)
+	{
+		int position = getSubtreeSize(subTreePtr->getLeftChildPtr()); //Position of the small item
+
+		positionHelper(subTreePtr->getLeftChildPtr(), first, last, visit);
+		if (first <= position && position < last)
+			visit(*(subTreePtr->getSmallItem()));
+		position++;
+
+		if (subTreePtr->isThreeNode()) //Positions in the middle subtree are shifted by the items
+		{			       //before it
+			positionHelper(subTreePtr->getMidChildPtr(), first - position, last - position, visit);
+			position += getSubtreeSize(subTreePtr->getMidChildPtr());
+
+			if (first <= position && position < last)
+				visit(*(subTreePtr->getLargeItem()));
+			position++;
+		}
+
+		positionHelper(subTreePtr->getRightChildPtr(), first - position, last - position, visit);
+	}
+}
+
 /* IGNORE
 template <class ItemType>
 void TwoThreeTree<ItemType>::printNode(TriNode<ItemType>* subTreePtr) const
@@ -810,7 +1412,177 @@ void TwoThreeTree<ItemType>::traverse(void visit(ItemType&)) const
 }
 
 template <class ItemType>
-void TwoThreeTree<ItemType>::inorderFileWrite(TriNode<ItemType>* subTreePtr, std::ostream& outFile) const
+const ItemType* TwoThreeTree<ItemType>::lowerBound(const ItemType& anEntry) const
+{
+	const ItemType* boundPtr = NULL;
+	TriNode<ItemType>* subTreePtr = rootPtr;
+	unsigned long long keyPrefix = anEntry.getKeyPrefix();
+
+	while (subTreePtr != NULL) //Every item >= anEntry is a candidate, so keep the latest one and
+	{			   //look for a smaller candidate in the subtree to its left
+		if (subTreePtr->compareSmallItem(anEntry, keyPrefix) <= 0)
+		{
+			boundPtr = subTreePtr->getSmallItem();
+			subTreePtr = subTreePtr->getLeftChildPtr();
+		}
+		else if (subTreePtr->isThreeNode() && subTreePtr->compareLargeItem(anEntry, keyPrefix) <= 0)
+		{
+			boundPtr = subTreePtr->getLargeItem();
+			subTreePtr = subTreePtr->getMidChildPtr();
+		}
+		else
+			subTreePtr = subTreePtr->getRightChildPtr();
+	}
+
+	return boundPtr;
+}
+
+template <class ItemType>
+const ItemType* TwoThreeTree<ItemType>::upperBound(const ItemType& anEntry) const
+{
+	const ItemType* boundPtr = NULL;
+	TriNode<ItemType>* subTreePtr = rootPtr;
+	unsigned long long keyPrefix = anEntry.getKeyPrefix();
+
+	while (subTreePtr != NULL) //Same as lowerBound, except only items > anEntry are candidates
+	{
+		if (subTreePtr->compareSmallItem(anEntry, keyPrefix) < 0)
+		{
+			boundPtr = subTreePtr->getSmallItem();
+			subTreePtr = subTreePtr->getLeftChildPtr();
+		}
+		else if (subTreePtr->isThreeNode() && subTreePtr->compareLargeItem(anEntry, keyPrefix) < 0)
+		{
+			boundPtr = subTreePtr->getLargeItem();
+			subTreePtr = subTreePtr->getMidChildPtr();
+		}
+		else
+			subTreePtr = subTreePtr->getRightChildPtr();
+	}
+
+	return boundPtr;
+}
+
+template <class ItemType>
+const ItemType* TwoThreeTree<ItemType>::select(int index) const
+{
+	const ItemType* itemPtr = NULL;
+	TriNode<ItemType>* subTreePtr = rootPtr;
+
+	if (index < 0 || index >= getNumberOfItems()) //Position doesn't exist
+		subTreePtr = NULL;
+
+	while (subTreePtr != NULL && itemPtr == NULL) //Use the subtree sizes to find which subtree
+	{					      //holds the position, adjusting index to match it
+		int leftSize = getSubtreeSize(subTreePtr->getLeftChildPtr());
+
+		if (index < leftSize)
+			subTreePtr = subTreePtr->getLeftChildPtr();
+		else if (index == leftSize) //Found the small item
+			itemPtr = subTreePtr->getSmallItem();
+		else if (subTreePtr->isThreeNode())
+		{
+			index -= leftSize + 1;
+			int midSize = getSubtreeSize(subTreePtr->getMidChildPtr());
+
+			if (index < midSize)
+				subTreePtr = subTreePtr->getMidChildPtr();
+			else if (index == midSize) //Found the large item
+				itemPtr = subTreePtr->getLargeItem();
+			else
+			{
+				index -= midSize + 1;
+				subTreePtr = subTreePtr->getRightChildPtr();
+			}
+		}
+		else
+		{
+			index -= leftSize + 1;
+			subTreePtr = subTreePtr->getRightChildPtr();
+		}
+	}
+
+	return itemPtr;
+}
+
+template <class ItemType>
+int TwoThreeTree<ItemType>::rank(const ItemType& anEntry) const
+{
+	int numSmaller = 0;
+	TriNode<ItemType>* subTreePtr = rootPtr;
+
+	while (subTreePtr != NULL) //Each time we move right of an item, that item and the subtree to its
+	{			   //left are smaller than anEntry
+		if (!(*(subTreePtr->getSmallItem()) < anEntry))
+			subTreePtr = subTreePtr->getLeftChildPtr();
+		else
+		{
+			numSmaller += getSubtreeSize(subTreePtr->getLeftChildPtr()) + 1;
+
+			if (subTreePtr->isThreeNode() && !(*(subTreePtr->getLargeItem()) < anEntry))
+				subTreePtr = subTreePtr->getMidChildPtr();
+			else
+			{
+				if (subTreePtr->isThreeNode())
+					numSmaller += getSubtreeSize(subTreePtr->getMidChildPtr()) + 1;
+				subTreePtr = subTreePtr->getRightChildPtr();
+			}
+		}
+	}
+
+	return numSmaller;
+}
+
+template <class ItemType>
+void TwoThreeTree<ItemType>::pageTraverse(int offset, int limit, void visit(ItemType&)) const
+{
+	if (offset < 0)
+		offset = 0;
+
+	if (limit > 0)
+		positionHelper(rootPtr, offset, offset + limit, visit);
+}
+
+template <class ItemType>
+void TwoThreeTree<ItemType>::rangeTraverse(const ItemType* lowPtr, const ItemType* highPtr,
+						void visit(ItemType&)) const
+{
+	auto visitItem = [visit](ItemType& item)
+	{
+		visit(item);
+		return true;
+	};
+	rangeHelper(rootPtr, lowPtr, highPtr, visitItem);
+}
+
+template <class ItemType>
+template <class Visitor>
+bool TwoThreeTree<ItemType>::forEachInRange(const ItemType* lowPtr, const ItemType* highPtr,
+						Visitor&& visit) const
+{
+	return rangeHelper(rootPtr, lowPtr, highPtr, visit);
+}
+
+template <class ItemType>
+bool TwoThreeTree<ItemType>::isOrdered() const
+{
+	return true;
+}
+
+template <class ItemType>
+typename TwoThreeTree<ItemType>::iterator TwoThreeTree<ItemType>::begin() const
+{
+	return iterator(rootPtr);
+}
+
+template <class ItemType>
+typename TwoThreeTree<ItemType>::iterator TwoThreeTree<ItemType>::end() const
+{
+	return iterator(NULL);
+}
+
+template <class ItemType>
+void TwoThreeTree<ItemType>::inorderFileWrite(TriNode<ItemType>* subTreePtr, BufferedWriter& writer) const
 {
 	//Same as inorderhelper, except every item in the node has a function writeToFile
 	//(see the class MediaEntry for more details)
@@ -818,17 +1590,17 @@ void TwoThreeTree<ItemType>::inorderFileWrite(TriNode<ItemType>* subTreePtr, std
 	{
 		if (subTreePtr->isTwoNode()) //If it's a 2-node, inorder is the same as a normal binary tree
 		{
-			inorderFileWrite(subTreePtr->getLeftChildPtr(), outFile);
-			(*(subTreePtr->getSmallItem())).writeToFile(outFile);
-			inorderFileWrite(subTreePtr->getRightChildPtr(), outFile);
+			inorderFileWrite(subTreePtr->getLeftChildPtr(), writer);
+			(*(subTreePtr->getSmallItem())).writeToFile(writer);
+			inorderFileWrite(subTreePtr->getRightChildPtr(), writer);
 		}
 		else //Modify for 3-node
 		{
-			inorderFileWrite(subTreePtr->getLeftChildPtr(), outFile);
-			(*(subTreePtr->getSmallItem())).writeToFile(outFile);
-			inorderFileWrite(subTreePtr->getMidChildPtr(), outFile);
-			(*(subTreePtr->getLargeItem())).writeToFile(outFile);
-			inorderFileWrite(subTreePtr->getRightChildPtr(), outFile);
+			inorderFileWrite(subTreePtr->getLeftChildPtr(), writer);
+			(*(subTreePtr->getSmallItem())).writeToFile(writer);
+			inorderFileWrite(subTreePtr->getMidChildPtr(), writer);
+			(*(subTreePtr->getLargeItem())).writeToFile(writer);
+			inorderFileWrite(subTreePtr->getRightChildPtr(), writer);
 		}
 	}
 }
@@ -836,7 +1608,8 @@ void TwoThreeTree<ItemType>::inorderFileWrite(TriNode<ItemType>* subTreePtr, std
 template <class ItemType>
 void TwoThreeTree<ItemType>::writeToFile(std::ostream& outFile) const
 {
-	inorderFileWrite(rootPtr, outFile);
+	BufferedWriter writer(outFile);
+	inorderFileWrite(rootPtr, writer);
 }
 
 template <class ItemType>
@@ -877,6 +1650,186 @@ void TwoThreeTree<ItemType>::displayStatistics(std::ostream& os) const
 	os << std::endl << std::endl;
 }
 
+template <class ItemType>
+int TwoThreeTree<ItemType>::getSplitLevel(const ThreadPool& pool) const
+{
+	int levels = 0;
+
+	if (pool.getNumThreads() > 1 && getNumberOfItems() >= MIN_PARALLEL_ITEMS)
+	{
+		int maxLevels = getHeight() - 1; //Subtrees must not go below the leaves
+
+		//Aim for at least 4 subtrees per worker so that uneven subtrees even out
+		while (levels < maxLevels && (1 << levels) < 4*pool.getNumThreads())
+			levels++;
+	}
+
+	return levels;
+}
+
+template <class ItemType>
+void TwoThreeTree<ItemType>::splitSubtrees(TriNode<ItemType>* subTreePtr, int levelsDown,
+						TriNode<ItemType>* subtreePtrs[], ItemType* separatorPtrs[],
+							int& numSubtrees, int& numTwoNodes, int& numThreeNodes) const
+{
+	if (levelsDown == 0) //Reached the level of the split, so this is one of the subtrees
+		subtreePtrs[numSubtrees++] = subTreePtr;
+	else //Same as inorderHelper, except the items separate the subtrees found below them
+	{
+		splitSubtrees(subTreePtr->getLeftChildPtr(), levelsDown-1, subtreePtrs, separatorPtrs,
+					numSubtrees, numTwoNodes, numThreeNodes);
+		separatorPtrs[numSubtrees-1] = subTreePtr->getSmallItem();
+
+		if (subTreePtr->isThreeNode())
+		{
+			numThreeNodes++;
+			splitSubtrees(subTreePtr->getMidChildPtr(), levelsDown-1, subtreePtrs, separatorPtrs,
+						numSubtrees, numTwoNodes, numThreeNodes);
+			separatorPtrs[numSubtrees-1] = subTreePtr->getLargeItem();
+		}
+		else
+			numTwoNodes++;
+
+		splitSubtrees(subTreePtr->getRightChildPtr(), levelsDown-1, subtreePtrs, separatorPtrs,
+					numSubtrees, numTwoNodes, numThreeNodes);
+	}
+}
+
+template <class ItemType>
+void TwoThreeTree<ItemType>::parallelTraverse(void visit(ItemType&), ThreadPool& pool) const
+{
+	int levels = getSplitLevel(pool);
+	if (levels == 0) //Not worth splitting
+	{
+		inorderHelper(rootPtr, visit);
+		return;
+	}
+
+	int maxSubtrees = 1;
+	for (int i = 0; i < levels; i++) //A level can have at most 3 times as many nodes as the last
+		maxSubtrees *= 3;
+
+	TriNode<ItemType>** subtreePtrs = new TriNode<ItemType>*[maxSubtrees];
+	ItemType** separatorPtrs = new ItemType*[maxSubtrees];
+	int numSubtrees = 0;
+	int numTwoNodes = 0;
+	int numThreeNodes = 0;
+	splitSubtrees(rootPtr, levels, subtreePtrs, separatorPtrs, numSubtrees, numTwoNodes, numThreeNodes);
+
+	for (int i = 0; i < numSubtrees; i++) //Each worker traverses its own subtree
+	{
+		TriNode<ItemType>* subTreePtr = subtreePtrs[i];
+		pool.submit([this, subTreePtr, visit]() { inorderHelper(subTreePtr, visit); });
+	}
+	for (int i = 0; i < numSubtrees-1; i++) //Meanwhile, visit the items above the subtrees
+		visit(*(separatorPtrs[i]));
+	pool.wait();
+
+	delete [] subtreePtrs;
+	delete [] separatorPtrs;
+}
+
+template <class ItemType>
+void TwoThreeTree<ItemType>::writeToFile(std::ostream& outFile, ThreadPool& pool) const
+{
+	int levels = getSplitLevel(pool);
+	if (levels == 0) //Not worth splitting
+	{
+		writeToFile(outFile);
+		return;
+	}
+
+	int maxSubtrees = 1;
+	for (int i = 0; i < levels; i++)
+		maxSubtrees *= 3;
+
+	TriNode<ItemType>** subtreePtrs = new TriNode<ItemType>*[maxSubtrees];
+	ItemType** separatorPtrs = new ItemType*[maxSubtrees];
+	int numSubtrees = 0;
+	int numTwoNodes = 0;
+	int numThreeNodes = 0;
+	splitSubtrees(rootPtr, levels, subtreePtrs, separatorPtrs, numSubtrees, numTwoNodes, numThreeNodes);
+
+	std::ostringstream* buffers = new std::ostringstream[numSubtrees];
+	for (int i = 0; i < numSubtrees; i++) //Each worker writes its subtree to its own buffer
+	{
+		TriNode<ItemType>* subTreePtr = subtreePtrs[i];
+		std::ostringstream* bufferPtr = &buffers[i];
+		pool.submit([this, subTreePtr, bufferPtr]()
+		{
+			BufferedWriter writer(*bufferPtr);
+			inorderFileWrite(subTreePtr, writer);
+		});
+	}
+	pool.wait();
+
+	for (int i = 0; i < numSubtrees; i++) //Write the buffers in order, each followed by the
+	{				      //item separating it from the next subtree
+		outFile << buffers[i].str();
+		if (i < numSubtrees-1)
+			separatorPtrs[i]->writeToFile(outFile);
+	}
+
+	delete [] buffers;
+	delete [] subtreePtrs;
+	delete [] separatorPtrs;
+}
+
+template <class ItemType>
+void TwoThreeTree<ItemType>::displayStatistics(std::ostream& os, ThreadPool& pool) const
+{
+	int levels = getSplitLevel(pool);
+	if (levels == 0) //Not worth splitting
+	{
+		displayStatistics(os);
+		return;
+	}
+
+	int maxSubtrees = 1;
+	for (int i = 0; i < levels; i++)
+		maxSubtrees *= 3;
+
+	TriNode<ItemType>** subtreePtrs = new TriNode<ItemType>*[maxSubtrees];
+	ItemType** separatorPtrs = new ItemType*[maxSubtrees];
+	int numSubtrees = 0;
+	int numTwoNodes = 0; //Nodes above the subtrees are counted by the split
+	int numThreeNodes = 0;
+	splitSubtrees(rootPtr, levels, subtreePtrs, separatorPtrs, numSubtrees, numTwoNodes, numThreeNodes);
+
+	int* twoNodeCounts = new int[numSubtrees];
+	int* threeNodeCounts = new int[numSubtrees];
+	for (int i = 0; i < numSubtrees; i++) //Each worker counts the nodes of its own subtree
+	{
+		TriNode<ItemType>* subTreePtr = subtreePtrs[i];
+		int* twoPtr = &twoNodeCounts[i];
+		int* threePtr = &threeNodeCounts[i];
+		pool.submit([this, subTreePtr, twoPtr, threePtr]()
+		{
+			*twoPtr = 0;
+			*threePtr = 0;
+			getNumNodes(subTreePtr, *twoPtr, *threePtr);
+		});
+	}
+	pool.wait();
+
+	for (int i = 0; i < numSubtrees; i++)
+	{
+		numTwoNodes += twoNodeCounts[i];
+		numThreeNodes += threeNodeCounts[i];
+	}
+
+	os << "Tree height: " << getHeight() << std::endl;
+	os << "Number of two nodes: " << numTwoNodes << std::endl;
+	os << "Number of three nodes: " << numThreeNodes << std::endl;
+	os << "Number of items: " << getNumberOfItems() << std::endl;
+	os << std::endl << std::endl;
+
+	delete [] twoNodeCounts;
+	delete [] threeNodeCounts;
+	delete [] subtreePtrs;
+	delete [] separatorPtrs;
+}
+
 
 #endif
 
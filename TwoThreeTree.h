@@ -4,12 +4,21 @@
 
 #include "BalancedSearchTreeInterface.h"
 #include "TriNode.h"
+#include "TwoThreeTreeIterator.h"
 #include "Stack.h"
+#include "ThreadPool.h"
+#include "BufferedWriter.h"
 #include <iostream>
 
+const int TREE_PROBE_GROUP_SIZE = 16; //Number of searches a batch operation interleaves
+
+template <class ItemType>
+class ConcurrentTwoThreeTree;
+
 template <class ItemType>
 class TwoThreeTree : public BalancedSearchTreeInterface<ItemType>
 {
+	friend class ConcurrentTwoThreeTree<ItemType>; //Publishes the root of its working copy
 private:
 	TriNode<ItemType>* rootPtr; //Pointer to the root of the tree
 
@@ -31,11 +40,11 @@ private:
 
 
 	/*
-	Computes the number of items in the tree
+	Returns the number of items in the subtree, as recorded in its root
 	@param subTreePtr Pointer to the root of the subtree
-	@return The number of items in the tree. Empty tree has 0 items.
+	@return The number of items in the subtree. Empty tree has 0 items.
 	*/
-	int getNumberOfItemsHelper(TriNode<ItemType>* subTreePtr) const;
+	int getSubtreeSize(TriNode<ItemType>* subTreePtr) const;
 
 
 
@@ -60,9 +69,10 @@ private:
 
 	/*
 	Readjusts the contents of the 3-Node, and then returns a pointer to the passed, middle item.
-	@post The 3-node pointed to by nodePtr is sorted, and its middle item is returned.
+	Items are moved by pointer, so none of them are copied.
+	@post The 3-node pointed to by nodePtr is sorted, and the caller owns the returned middle item.
 	@param nodePtr Pointer to the 3-Node
-	passedItem Pointer to the passed item
+	passedItem Pointer to the passed item, owned by the caller
 	@return Returns a pointer to the middle item
 	*/
 	ItemType* getMiddleItem(TriNode<ItemType>* nodePtr, ItemType* passedItem);
@@ -187,12 +197,119 @@ private:
 
 
 	/*
-	Deletes the contents of the tree in a postorder fashion
+	Checks if the items are in ascending order, allowing for duplicates
+	@param items The array of items to be checked
+	numItems The number of items in the array
+	@return True if every item is no smaller than the one before it, false otherwise
+	*/
+	bool isSorted(const ItemType items[], int numItems) const;
+
+	/*
+	Builds the tree bottom-up from the sorted array items, one level at a time. Each level is
+	split into nodes holding one or two items, and the single item between two adjacent
+	nodes is passed up to form the level above. This stops once a level fits in the root.
+	@pre The tree is empty and items is sorted in ascending order
+	@post The tree is a 2-3 tree storing every item of items. Each item is copied exactly once.
+	@param items The sorted array of items
+	numItems The number of items in the array
+	*/
+	void buildFromSorted(const ItemType items[], int numItems);
+
+	/*
+	Same as buildFromSorted, except the items are given as an array of pointers to them, which is
+	used as the working array, and the new tree is returned instead of becoming this tree.
+	@post levelItems (and isTaken) are overwritten
+	@param levelItems Pointers to the items in sorted order
+	numItems The number of items
+	isTaken Which items the caller owns; these are moved into the new tree instead of copied.
+	NULL if every item is copied.
+	@return Pointer to the root of the new tree, NULL if numItems is 0
+	*/
+	TriNode<ItemType>* buildFromSorted(const ItemType* levelItems[], int numItems, bool isTaken[] = NULL);
+
+	/*
+	Lists the items of a subtree in order. The items of the nodes that no snapshot shares are
+	taken out of them, so combine can move them instead of copying them.
+	@post Both items of every unshared node are released and owned by the caller, so
+	postorderDelete still deletes all of the node's children
+	@param subTreePtr The root of the subtree
+	isShared True if an ancestor of the subtree is shared, which makes the whole subtree shared
+	items Receives pointers to the items of the subtree
+	isTaken Receives, for each item, true if it was taken out of its node
+	numItems The number of items listed so far, increased by the size of the subtree
+	*/
+	void takeItems(TriNode<ItemType>* subTreePtr, bool isShared, const ItemType* items[],
+			bool isTaken[], int& numItems);
+
+	/*
+	Rebuilds the tree out of a sorted merge of its in-order sequence with that of aTree, which
+	takes linear time. Which items make it into the new tree depends on where they appear. The
+	items of this tree are moved into the new one unless a snapshot shares them.
+	@post The tree holds the items selected from the two trees
+	@param aTree The other tree, which is unchanged
+	keepOnlyThis True to keep the items that are only in this tree
+	keepCommon True to keep the items that are in both trees
+	keepOnlyOther True to keep the items that are only in aTree
+	*/
+	void combine(const TwoThreeTree<ItemType>& aTree, bool keepOnlyThis, bool keepCommon,
+			bool keepOnlyOther);
+
+	/*
+	Checks if a set operation with aTree is cheaper done by searching the tree once for each
+	item of aTree than by rebuilding the whole tree with combine
+	@param aTree The other operand
+	@return True if the searches go through fewer nodes than the tree has items
+	*/
+	bool isSmallOperand(const TwoThreeTree<ItemType>& aTree) const;
+
+	/*
+	Creates a node for buildFromSorted out of the next one or two items of the current level
+	and, above the leaves, the next two or three nodes of the level below.
+	@post itemIndex and childIndex are moved past the items and children that were used
+	@param levelItems Pointers to the items of the current level
+	itemIndex Index of the node's small item in levelItems
+	isThreeNode True if the node gets two items, false if it gets one
+	childPtrs Pointers to the nodes of the level below, ignored for leaves
+	childIndex Index of the node's left child in childPtrs
+	isLeafLevel True if the node is a leaf
+	isTaken Which items of levelItems are moved instead of copied, NULL if none
+	@return A pointer to the new node
+	*/
+	TriNode<ItemType>* buildNode(const ItemType* levelItems[], int& itemIndex, bool isThreeNode,
+				TriNode<ItemType>* childPtrs[], int& childIndex, bool isLeafLevel,
+					bool isTaken[]);
+
+
+
+
+	/*
+	Deletes the contents of the tree in a postorder fashion. Nodes still shared with a snapshot
+	only lose a reference, and are left for the snapshot to delete.
 	@post The tree is empty
 	@param subTreePtr Pointer to the root of the subtree
 	*/
 	void postorderDelete(TriNode<ItemType>* subTreePtr);
 
+	/*
+	Copies the node pointed to by nodePtr, including its items. The copy points to the same
+	children, which gain a reference.
+	@param nodePtr Pointer to the node to be copied
+	@return Pointer to the new node
+	*/
+	TriNode<ItemType>* copyNode(const TriNode<ItemType>* nodePtr);
+
+	/*
+	Makes sure that childPtr, a child of parentPtr, can be modified without affecting a snapshot.
+	If it is shared, it is replaced by a copy in parentPtr, and the original loses a reference.
+	Called on every node of a path from the root, this copies only the shared nodes on the path.
+	@pre parentPtr is not shared
+	@post The returned node is referenced by parentPtr only
+	@param parentPtr Pointer to the parent of childPtr, or NULL if childPtr is the root
+	childPtr Pointer to the node to be modified
+	@return Pointer to childPtr, or to its copy if it was shared
+	*/
+	TriNode<ItemType>* unshareChild(TriNode<ItemType>* parentPtr, TriNode<ItemType>* childPtr);
+
 
 
 
@@ -205,6 +322,37 @@ private:
 	*/
 	TriNode<ItemType>* findItem(TriNode<ItemType>* subTreePtr, const ItemType& anEntry) const;
 
+	/*
+	Same as findItem, for the item itself, e.g. for getEntry to return the item stored rather than
+	the one looked for, whose title may only be equal to it ignoring case and punctuation
+	@param subTreePtr Pointer to the root of the subtree
+	anEntry The item to be located
+	@return Pointer to the item equal to anEntry, NULL if anEntry does not exist
+	*/
+	ItemType* findStoredItem(TriNode<ItemType>* subTreePtr, const ItemType& anEntry) const;
+
+	/*
+	Makes one step of findItem: compares anEntry with the items of the node
+	@param nodePtr Pointer to the current node of the search
+	anEntry The item to be located
+	keyPrefix The key prefix of anEntry
+	isFound Set to true if the node contains anEntry, false otherwise
+	@return The node if it contains anEntry, otherwise the child the search continues in
+	*/
+	TriNode<ItemType>* findStep(TriNode<ItemType>* nodePtr, const ItemType& anEntry,
+					unsigned long long keyPrefix, bool& isFound) const;
+
+	/*
+	Searches for up to TREE_PROBE_GROUP_SIZE items at once. The searches advance in turns, one
+	node each, and the next node of every search is prefetched when it is reached, so the cache
+	misses of the different searches overlap instead of following one another.
+	@post foundPtrs[i] points to the node containing items[i], or is NULL if it isn't in the tree
+	@param items The items to be located
+	numItems The number of items, at most TREE_PROBE_GROUP_SIZE
+	foundPtrs Array receiving the nodes found
+	*/
+	void findGroup(const ItemType items[], int numItems, TriNode<ItemType>* foundPtrs[]) const;
+
 
 
 	/*
@@ -216,6 +364,47 @@ private:
 	*/
 	void inorderHelper(TriNode<ItemType>* subTreePtr, void visit(ItemType&)) const;
 
+	/*
+	Same as inorderHelper, except visit is any callable, and the traversal stops as soon as
+	it returns false
+	@param subTreePtr Pointer to the root of the subtree
+	visit Callable taking a const ItemType& and returning whether to continue
+	@return False if visit stopped the traversal, true otherwise
+	*/
+	template <class Visitor>
+	bool forEachHelper(TriNode<ItemType>* subTreePtr, Visitor& visit) const;
+
+
+	/*
+	Traverses the items of the subtree lying in the range [*lowPtr, *highPtr) in an inorder fashion,
+	and executes visit on each of them. Subtrees lying entirely outside of the range are skipped,
+	and the traversal stops as soon as visit returns false.
+	@post Visit is executed for every entry of the subtree within the range, up to the first
+	call returning false
+	@param subTreePtr Pointer to the root of the subtree
+	lowPtr Pointer to the inclusive lower bound, NULL if there is no lower bound
+	highPtr Pointer to the exclusive upper bound, NULL if there is no upper bound
+	visit Callable taking an ItemType& and returning whether to continue
+	@return False if visit stopped the traversal, true otherwise
+	*/
+	template <class Visitor>
+	bool rangeHelper(TriNode<ItemType>* subTreePtr, const ItemType* lowPtr, const ItemType* highPtr,
+				Visitor& visit) const;
+
+
+	/*
+	Traverses the items of the subtree whose positions in sorted order fall in [first, last)
+	and executes visit on each of them. Positions are relative to the subtree, and subtrees
+	lying entirely outside of them are skipped using the subtree sizes.
+	@post Visit is executed for every entry at the positions first through last-1
+	@param subTreePtr Pointer to the root of the subtree
+	first Position of the first item to be visited
+	last Position one past the last item to be visited
+	visit Client defined function
+	*/
+	void positionHelper(TriNode<ItemType>* subTreePtr, int first, int last,
+				void visit(ItemType&)) const;
+
 
 /*
 	//IGNORE printNode and levelOrderTraverseHelper, these were used for debugging.
@@ -227,12 +416,12 @@ private:
 
 
 	/*
-	Writes the contents of the tree to the file outFile in an inorder fashion
-	@post The entries of the tree are contained in outFile
+	Writes the contents of the tree to writer in an inorder fashion
+	@post The entries of the tree are written to writer
 	@param subTreePtr Pointer to the root of the tree
-	outFile ostream variable containing the file opened
+	writer The writer collecting the output for the file
 	*/
-	void inorderFileWrite(TriNode<ItemType>* subTreePtr, std::ostream& outFile) const;
+	void inorderFileWrite(TriNode<ItemType>* subTreePtr, BufferedWriter& writer) const;
 
 
 	/*
@@ -244,7 +433,36 @@ private:
 	void getNumNodes(TriNode<ItemType>* subTreePtr, int& numTwoNodes, int& numThreeNodes) const;
 
 
+	/*
+	Chooses how many levels below the root the tree should be split so that every worker of
+	pool gets several independent subtrees to process
+	@param pool The pool that will process the subtrees
+	@return The number of levels, or 0 if the tree is too small to be worth splitting
+	*/
+	int getSplitLevel(const ThreadPool& pool) const;
+
+	/*
+	Splits the subtree into the independent subtrees rooted levelsDown levels below it, in order.
+	Every item above those subtrees separates two of them.
+	@post subtreePtrs holds the subtrees from left to right, and separatorPtrs[i] points to the item
+	between subtreePtrs[i] and subtreePtrs[i+1]. The nodes above the subtrees are added to
+	numTwoNodes and numThreeNodes.
+	@param subTreePtr Pointer to the root of the subtree
+	levelsDown The number of levels to go down, less than the height of the subtree
+	subtreePtrs Array receiving the subtrees, with room for 3^levelsDown of them
+	separatorPtrs Array receiving the separating items
+	numSubtrees The number of subtrees found so far
+	numTwoNodes, numThreeNodes Counters of the 2-nodes and 3-nodes above the subtrees
+	*/
+	void splitSubtrees(TriNode<ItemType>* subTreePtr, int levelsDown, TriNode<ItemType>* subtreePtrs[],
+				ItemType* separatorPtrs[], int& numSubtrees, int& numTwoNodes,
+					int& numThreeNodes) const;
+
+
 public:
+	typedef TwoThreeTreeIterator<ItemType> iterator; //Iterators only give read access to the items
+	typedef TwoThreeTreeIterator<ItemType> const_iterator;
+
 	TwoThreeTree();
 	TwoThreeTree(const TwoThreeTree<ItemType>& aTree);
 	virtual ~TwoThreeTree();
@@ -261,12 +479,137 @@ public:
 	bool contains(const ItemType& anEntry) const;
 	void traverse(void visit(ItemType&)) const;
 
+	/*
+	Same as getEntry, telling whether the entry was found instead of throwing an exception, e.g.
+	for a lookup cache to search the tree once whether the entry is there or not
+	@post If anEntry is in the tree, foundEntry is the item stored
+	@param anEntry The item to be retrieved
+	foundEntry Receives the item found
+	@return True if anEntry is in the tree, false otherwise
+	*/
+	bool findEntry(const ItemType& anEntry, ItemType& foundEntry) const;
+
+	/*
+	Conducts an inorder traversal of the tree with any callable, e.g. a lambda. Unlike traverse,
+	the call can be inlined and the callable can hold state, and it can stop the traversal early
+	by returning false.
+	@post visit is executed in order for every item, up to the first call returning false
+	@param visit Callable taking a const ItemType& and returning true to continue, false to stop
+	@return False if visit stopped the traversal, true otherwise
+	*/
+	template <class Visitor>
+	bool forEach(Visitor&& visit) const;
+
+
+	/*
+	Returns an iterator at the smallest item of the tree, or the end iterator, so the tree
+	can be used in a range-based for loop. Adding or removing items invalidates the iterators.
+	@return The iterator at the smallest item or at the end, respectively
+	*/
+	iterator begin() const;
+	iterator end() const;
+
 
 
 
 /*IGNORE	void levelOrderTraverse() const;*/
 
 
+	/*
+	Adds every item of the array items into the tree. If the tree is empty and items is
+	in ascending order (e.g. a library saved by writeToFile), the tree is built bottom-up
+	in linear time. Otherwise, each item is inserted individually with add.
+	@post Every item of items is stored in the tree
+	@param items The array of items to be added
+	numItems The number of items in the array
+	@return True if addition was successful, false if not
+	*/
+	bool addAll(const ItemType items[], int numItems);
+
+	/*
+	Same as contains, add and remove for every item of an array, e.g. to check millions of
+	entries. The items are searched in groups whose searches overlap (see findGroup). Adding
+	and removing still change the tree one item at a time, after a search of the group has
+	brought the nodes on their paths into the cache.
+	@post results[i] is what contains, add or remove returned for items[i]
+	@param items The array of items
+	numItems The number of items in the array
+	results Array of numItems flags receiving the result for each item
+	@return The number of items found, added or removed
+	*/
+	int containsMany(const ItemType items[], int numItems, bool results[]) const;
+	int addMany(const ItemType items[], int numItems, bool results[]);
+	int removeMany(const ItemType items[], int numItems, bool results[]);
+
+
+	/*
+	Returns a pointer to the smallest item in the tree that is greater than or equal to anEntry
+	@param anEntry The item to be bounded
+	@return Pointer to the smallest item >= anEntry, NULL if there is no such item
+	*/
+	const ItemType* lowerBound(const ItemType& anEntry) const;
+
+	/*
+	Returns a pointer to the smallest item in the tree that is greater than anEntry
+	@param anEntry The item to be bounded
+	@return Pointer to the smallest item > anEntry, NULL if there is no such item
+	*/
+	const ItemType* upperBound(const ItemType& anEntry) const;
+
+	/*
+	Returns a pointer to the item at position index in sorted order, where the smallest
+	item is at position 0
+	@param index The position of the item
+	@return Pointer to the item, NULL if index is not between 0 and the number of items - 1
+	*/
+	const ItemType* select(int index) const;
+
+	/*
+	Returns the number of items in the tree that are smaller than anEntry, which is the
+	position of anEntry in sorted order if it is in the tree
+	@param anEntry The item to be ranked
+	@return The number of items < anEntry
+	*/
+	int rank(const ItemType& anEntry) const;
+
+	/*
+	Traverses up to limit items in order, starting at the item at position offset
+	@post Visit is executed for the items at the positions offset through offset+limit-1
+	@param offset Position of the first item to be visited
+	limit The maximum number of items to be visited
+	visit Client defined function
+	*/
+	void pageTraverse(int offset, int limit, void visit(ItemType&)) const;
+
+	/*
+	Traverses the items in the range [*lowPtr, *highPtr) in order. Only the nodes along
+	the two bounds and those holding items in the range are visited.
+	@post Visit is executed for every entry in the range
+	@param lowPtr Pointer to the inclusive lower bound, NULL if there is no lower bound
+	highPtr Pointer to the exclusive upper bound, NULL if there is no upper bound
+	visit Client defined function
+	*/
+	void rangeTraverse(const ItemType* lowPtr, const ItemType* highPtr, void visit(ItemType&)) const;
+
+	/*
+	Same as rangeTraverse, with any callable as in forEach
+	@post visit is executed in order for every item in the range, up to the first call returning false
+	@param lowPtr Pointer to the inclusive lower bound, NULL if there is no lower bound
+	highPtr Pointer to the exclusive upper bound, NULL if there is no upper bound
+	visit Callable taking a const ItemType& and returning true to continue, false to stop
+	@return False if visit stopped the traversal, true otherwise
+	*/
+	template <class Visitor>
+	bool forEachInRange(const ItemType* lowPtr, const ItemType* highPtr, Visitor&& visit) const;
+
+	/*
+	Tells if the items are kept in sorted order, so that the traversals of a range only go
+	through the items in the range. True for the trees and the frozen index, false for the table.
+	@return True if the items are sorted, false otherwise
+	*/
+	bool isOrdered() const;
+
+
 	/*
 	Writes the contents of the tree to the file opened by outFile
 	@post The contents of the tree are written to outFile
@@ -281,6 +624,48 @@ public:
 	@param os The ostream variable for the output
 	*/
 	void displayStatistics(std::ostream& os) const;
+
+
+	/*
+	Replaces the contents of the tree with a snapshot of aTree in constant time. Both trees share
+	all of their nodes, and a node is only copied once either tree modifies it: adding or removing
+	an item copies the shared nodes on its root-to-leaf path (and the siblings it rebalances with),
+	so neither tree sees the other's changes. Nodes are deleted once no tree refers to them, so the
+	snapshot may be read, and deleted, by another thread while aTree keeps changing.
+	@post The tree holds the same items as aTree
+	@param aTree The tree to be snapshotted
+	*/
+	void takeSnapshot(const TwoThreeTree<ItemType>& aTree);
+
+	/*
+	Set operations with aTree, done as a linear merge of the two in-order sequences followed
+	by a bottom-up rebuild of the tree. mergeFrom adds the items of aTree that aren't in the tree
+	yet, intersectWith keeps only the items also in aTree, and difference removes the items in aTree.
+	When aTree is small (see isSmallOperand), its items are searched for one at a time instead:
+	mergeFrom and difference add or remove them, and intersectWith builds the tree from those found.
+	@post The tree holds the union, intersection, or difference of the two trees
+	@param aTree The other operand, which is unchanged
+	*/
+	void mergeFrom(const TwoThreeTree<ItemType>& aTree);
+	void intersectWith(const TwoThreeTree<ItemType>& aTree);
+	void difference(const TwoThreeTree<ItemType>& aTree);
+
+
+	/*
+	Same as traverse, writeToFile and displayStatistics, except the tree is split into independent
+	subtrees near the root which are processed concurrently by the workers of pool. The file is
+	still written in order: each subtree is written to its own buffer, and the buffers are written
+	out one after the other. Trees too small to be worth splitting are processed by this thread.
+	For parallelTraverse, the items are not visited in order, and visit may be called concurrently.
+	@post Same as traverse, writeToFile and displayStatistics, respectively
+	@param visit Client defined function, safe to call from several threads at once
+	outFile Ostream variable storing the file
+	os The ostream variable for the output
+	pool The thread pool processing the subtrees
+	*/
+	void parallelTraverse(void visit(ItemType&), ThreadPool& pool) const;
+	void writeToFile(std::ostream& outFile, ThreadPool& pool) const;
+	void displayStatistics(std::ostream& os, ThreadPool& pool) const;
 };
 
 #include "TwoThreeTree.cpp"
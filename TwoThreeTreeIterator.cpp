@@ -0,0 +1,104 @@
+#ifndef _TWO_THREE_TREE_ITERATOR_CPP
+#define _TWO_THREE_TREE_ITERATOR_CPP
+
+#include "TwoThreeTreeIterator.h"
+
+template <class ItemType>
+TwoThreeTreeIterator<ItemType>::TwoThreeTreeIterator(TriNode<ItemType>* rootPtr)
+{
+	pathLength = 0;
+	pushLeftPath(rootPtr); //Smallest item is at the end of the leftmost path
+}
+
+template <class ItemType>
+void TwoThreeTreeIterator<ItemType>::pushLeftPath(TriNode<ItemType>* subTreePtr)
+{
+	while (subTreePtr != NULL)
+	{
+		pathPtr[pathLength] = subTreePtr;
+		itemIndex[pathLength] = 0; //Small item of every node is visited first
+		pathLength++;
+
+		subTreePtr = subTreePtr->getLeftChildPtr();
+	}
+}
+
+template <class ItemType>
+int TwoThreeTreeIterator<ItemType>::getNodeSize(TriNode<ItemType>* nodePtr) const
+{
+	if (nodePtr->isThreeNode())
+		return 2;
+	else
+		return 1;
+}
+
+template <class ItemType>
+const ItemType& TwoThreeTreeIterator<ItemType>::operator*() const
+{
+	TriNode<ItemType>* nodePtr = pathPtr[pathLength-1];
+	if (itemIndex[pathLength-1] == 0)
+		return *(nodePtr->getSmallItem());
+	else
+		return *(nodePtr->getLargeItem());
+}
+
+template <class ItemType>
+const ItemType* TwoThreeTreeIterator<ItemType>::operator->() const
+{
+	return &(operator*());
+}
+
+template <class ItemType>
+TwoThreeTreeIterator<ItemType>& TwoThreeTreeIterator<ItemType>::operator++()
+{
+	TriNode<ItemType>* nodePtr = pathPtr[pathLength-1];
+	int index = itemIndex[pathLength-1];
+
+	//The subtree right after the current item holds the next items, if the node has children
+	TriNode<ItemType>* nextPtr = NULL;
+	if (index == 0 && nodePtr->isThreeNode())
+		nextPtr = nodePtr->getMidChildPtr();
+	else
+		nextPtr = nodePtr->getRightChildPtr();
+
+	itemIndex[pathLength-1]++; //Once we come back to this node, its next item is visited
+
+	if (nextPtr != NULL) //Internal node, so the next item is the smallest one of that subtree
+		pushLeftPath(nextPtr);
+	else //Leaf, so go back up until a node with an item left to visit is found
+	{
+		while (pathLength > 0 && itemIndex[pathLength-1] >= getNodeSize(pathPtr[pathLength-1]))
+			pathLength--;
+	}
+
+	return *this;
+}
+
+template <class ItemType>
+TwoThreeTreeIterator<ItemType> TwoThreeTreeIterator<ItemType>::operator++(int)
+{
+	TwoThreeTreeIterator<ItemType> previous = *this;
+	++(*this);
+
+	return previous;
+}
+
+template <class ItemType>
+bool TwoThreeTreeIterator<ItemType>::operator==(const TwoThreeTreeIterator<ItemType>& otherIterator) const
+{
+	if (pathLength != otherIterator.pathLength)
+		return false;
+	else if (pathLength == 0) //Both are at the end
+		return true;
+	else //Same item if the last node and item index on the paths are the same
+		return (pathPtr[pathLength-1] == otherIterator.pathPtr[pathLength-1] &&
+				itemIndex[pathLength-1] == otherIterator.itemIndex[pathLength-1]);
+}
+
+template <class ItemType>
+bool TwoThreeTreeIterator<ItemType>::operator!=(const TwoThreeTreeIterator<ItemType>& otherIterator) const
+{
+	return !(*this == otherIterator);
+}
+
+#endif
@@ -0,0 +1,79 @@
+/*@file TwoThreeTreeIterator.h*/
+#ifndef _TWO_THREE_TREE_ITERATOR_H
+#define _TWO_THREE_TREE_ITERATOR_H
+
+#include <cstddef>
+#include <iterator>
+#include "TriNode.h"
+
+const int MAX_TREE_HEIGHT = 32; //A 2-3 tree of height 32 holds more items than an int can count
+
+/*
+Forward iterator visiting the items of a 2-3 tree in order. Instead of recursing, it keeps
+the path from the root to the current item, so it can be stopped and resumed at any point.
+*/
+template <class ItemType>
+class TwoThreeTreeIterator
+{
+public:
+	typedef std::forward_iterator_tag iterator_category;
+	typedef ItemType value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef const ItemType* pointer;
+	typedef const ItemType& reference;
+
+private:
+	//Nodes on the path from the root to the current item. itemIndex[i] is 0 if the next item
+	//of pathPtr[i] to be visited is its small item, 1 if it is its large item. The current item
+	//is the one pointed to by the last entry of the path, and the path is empty at the end.
+	TriNode<ItemType>* pathPtr[MAX_TREE_HEIGHT];
+	int itemIndex[MAX_TREE_HEIGHT];
+	int pathLength;
+
+	/*
+	Extends the path from subTreePtr down to the smallest item of its subtree
+	@post The current item is the smallest item of the subtree
+	@param subTreePtr Pointer to the root of the subtree
+	*/
+	void pushLeftPath(TriNode<ItemType>* subTreePtr);
+
+	/*
+	Returns the number of items in the node, i.e. 1 for a 2-node and 2 for a 3-node
+	@param nodePtr Pointer to the node
+	@return The number of items in the node
+	*/
+	int getNodeSize(TriNode<ItemType>* nodePtr) const;
+
+public:
+	/*
+	Creates an iterator at the smallest item of the tree rooted at rootPtr, or at the end
+	if rootPtr is NULL
+	*/
+	TwoThreeTreeIterator(TriNode<ItemType>* rootPtr = NULL);
+
+	/*
+	Returns the current item
+	@pre The iterator is not at the end
+	@return A reference to the current item
+	*/
+	const ItemType& operator*() const;
+	const ItemType* operator->() const;
+
+	/*
+	Moves the iterator to the next item in order, or to the end if there is none
+	@pre The iterator is not at the end
+	@return The iterator after (prefix) or before (postfix) the move
+	*/
+	TwoThreeTreeIterator<ItemType>& operator++();
+	TwoThreeTreeIterator<ItemType> operator++(int);
+
+	/*
+	Two iterators are equal if they are both at the end, or at the same item of the same tree
+	*/
+	bool operator==(const TwoThreeTreeIterator<ItemType>& otherIterator) const;
+	bool operator!=(const TwoThreeTreeIterator<ItemType>& otherIterator) const;
+};
+
+#include "TwoThreeTreeIterator.cpp"
+
+#endif
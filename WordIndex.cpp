@@ -0,0 +1,202 @@
+#include "WordIndex.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+WordIndex::WordIndex()
+{
+	numRemoved = 0;
+}
+
+void WordIndex::getWords(const char* text, int length, std::vector<std::string>& words)
+{
+	words.clear();
+
+	int index = 0;
+	while (index < length)
+	{
+		while (index < length && !isalnum(text[index])) //Skip to the start of the next word
+			index++;
+
+		std::string word;
+		while (index < length && isalnum(text[index]))
+			word += toupper(text[index++]);
+
+		if (!word.empty())
+			words.push_back(word);
+	}
+
+	std::sort(words.begin(), words.end()); //A word repeated in a title only lists it once
+	words.erase(std::unique(words.begin(), words.end()), words.end());
+}
+
+void WordIndex::getWords(const MediaEntry& media, std::vector<std::string>& words)
+{
+	std::string title;
+	for (int i = 0; i < media.length(); i++)
+		title += media[i];
+
+	getWords(title.c_str(), title.length(), words);
+}
+
+bool WordIndex::hasWords(const MediaEntry& media, const std::vector<std::string>& words)
+{
+	std::vector<std::string> titleWords;
+	getWords(media, titleWords);
+
+	return std::includes(titleWords.begin(), titleWords.end(), words.begin(), words.end());
+}
+
+void WordIndex::add(const MediaEntry& newMedia)
+{
+	std::vector<std::string> words;
+	getWords(newMedia, words);
+	if (words.empty())
+		return;
+
+	int id = entries.size(); //Ids only grow, so each list stays sorted by appending to it
+	entries.push_back(newMedia);
+	isRemoved.push_back(false);
+
+	for (unsigned int i = 0; i < words.size(); i++)
+		postings[words[i]].push_back(id);
+}
+
+bool WordIndex::remove(const MediaEntry& media)
+{
+	std::vector<std::string> words;
+	getWords(media, words);
+	if (words.empty())
+		return false;
+
+	const std::vector<int>* shortestPtr = NULL; //Every list of its words has its id, so
+	for (unsigned int i = 0; i < words.size(); i++) //look in the shortest one
+	{
+		std::unordered_map<std::string, std::vector<int> >::const_iterator listIter = postings.find(words[i]);
+		if (listIter == postings.end()) //No title has this word
+			return false;
+
+		if (shortestPtr == NULL || listIter->second.size() < shortestPtr->size())
+			shortestPtr = &(listIter->second);
+	}
+
+	int id = -1;
+	for (unsigned int i = 0; i < shortestPtr->size() && id < 0; i++)
+	{
+		if (entries[(*shortestPtr)[i]] == media)
+			id = (*shortestPtr)[i];
+	}
+
+	if (id < 0)
+		return false;
+
+	for (unsigned int i = 0; i < words.size(); i++)
+	{
+		std::vector<int>& list = postings[words[i]];
+		list.erase(std::lower_bound(list.begin(), list.end(), id));
+		if (list.empty())
+			postings.erase(words[i]);
+	}
+
+	entries[id] = MediaEntry(); //Frees the title until the ids are compacted
+	isRemoved[id] = true;
+	numRemoved++;
+
+	if (numRemoved > MIN_COMPACT_SIZE && 2*numRemoved > (int)entries.size())
+		compact();
+
+	return true;
+}
+
+void WordIndex::compact()
+{
+	std::vector<MediaEntry> oldEntries;
+	oldEntries.swap(entries);
+	std::vector<bool> oldIsRemoved;
+	oldIsRemoved.swap(isRemoved);
+
+	clear();
+	for (unsigned int id = 0; id < oldEntries.size(); id++) //Adding them in the same order keeps
+	{							  //the order of the ids
+		if (!oldIsRemoved[id])
+			add(oldEntries[id]);
+	}
+}
+
+void WordIndex::clear()
+{
+	entries.clear();
+	isRemoved.clear();
+	postings.clear();
+	numRemoved = 0;
+}
+
+int WordIndex::getNumberOfItems() const
+{
+	return entries.size() - numRemoved;
+}
+
+int WordIndex::gallop(const std::vector<int>& list, int first, int id)
+{
+	int size = list.size();
+	int step = 1;
+	int last = first; //Position of the last id checked, which is < id
+	while (first < size && list[first] < id)
+	{
+		last = first;
+		first += step;
+		step *= 2;
+	}
+
+	if (first > size)
+		first = size;
+
+	return std::lower_bound(list.begin() + last, list.begin() + first, id) - list.begin();
+}
+
+int WordIndex::find(const char* text, void visit(const MediaEntry&)) const
+{
+	std::vector<std::string> words;
+	getWords(text, std::strlen(text), words);
+	if (words.empty())
+		return 0;
+
+	std::vector<const std::vector<int>*> lists;
+	for (unsigned int i = 0; i < words.size(); i++)
+	{
+		std::unordered_map<std::string, std::vector<int> >::const_iterator listIter = postings.find(words[i]);
+		if (listIter == postings.end()) //No title has this word
+			return 0;
+
+		lists.push_back(&(listIter->second));
+	}
+
+	for (unsigned int i = 1; i < lists.size(); i++) //Shortest list first, so the candidates only
+	{						 //get fewer as the longer lists are searched
+		for (unsigned int j = i; j > 0 && lists[j]->size() < lists[j-1]->size(); j--)
+			std::swap(lists[j], lists[j-1]);
+	}
+
+	std::vector<int> candidates(*lists[0]);
+	for (unsigned int i = 1; i < lists.size() && !candidates.empty(); i++)
+	{
+		int numKept = 0;
+		int position = 0;
+		for (unsigned int c = 0; c < candidates.size(); c++)
+		{
+			position = gallop(*lists[i], position, candidates[c]);
+			if (position == (int)lists[i]->size()) //Every candidate left is past the end of the list
+				break;
+
+			if ((*lists[i])[position] == candidates[c])
+				candidates[numKept++] = candidates[c];
+		}
+
+		candidates.resize(numKept);
+	}
+
+	for (unsigned int c = 0; c < candidates.size(); c++)
+		visit(entries[candidates[c]]);
+
+	return candidates.size();
+}
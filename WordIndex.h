@@ -0,0 +1,105 @@
+/*@file WordIndex.h*/
+#ifndef _WORD_INDEX_H
+#define _WORD_INDEX_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "MediaEntry.h"
+
+const int MIN_COMPACT_SIZE = 1024; //Removed entries are only compacted away past this many
+
+/*
+Inverted index of the words of the titles, to find the titles containing some words, e.g.
+"Dark" in "The Dark Knight" and "Thor: Dark World", without going through every title. A word
+is a run of letters and digits, compared in upper case. Every entry gets an id in the order it
+was added, and each word maps to the sorted list of the ids of the titles having it, so a
+search for several words intersects their lists.
+*/
+class WordIndex
+{
+private:
+	std::vector<MediaEntry> entries; //The entries by id
+	std::vector<bool> isRemoved; //Whether the entry of each id was removed
+	std::unordered_map<std::string, std::vector<int> > postings; //The ids of the titles having each word
+	int numRemoved; //Number of ids whose entry was removed
+
+	/*
+	Renumbers the entries left, so removed entries no longer take up ids
+	@post No id is removed, and the ids keep the order of the entries
+	*/
+	void compact();
+
+	/*
+	Galloping search: finds the first id >= id in a sorted list, starting at position first
+	and doubling the step until it is passed, then searching the last step in halves. It takes
+	time logarithmic in the distance skipped, so intersecting a short list with a long one skips
+	most of the long one.
+	@param list The sorted list of ids
+	first The position the search starts from
+	id The id looked for
+	@return The position of the first id >= id from first on, or the size of the list if there is none
+	*/
+	static int gallop(const std::vector<int>& list, int first, int id);
+
+public:
+	WordIndex();
+
+	/*
+	Splits text into its words, in upper case and without repeats
+	@post words holds the words of text, sorted
+	@param text The text, e.g. a title
+	length The number of characters of text
+	words Receives the words
+	*/
+	static void getWords(const char* text, int length, std::vector<std::string>& words);
+	static void getWords(const MediaEntry& media, std::vector<std::string>& words);
+
+	/*
+	Checks if the title of media has every word of words, as the index would find it,
+	without using an index
+	@param media The entry to be checked
+	words Words from getWords
+	@return True if the title has every word, false otherwise
+	*/
+	static bool hasWords(const MediaEntry& media, const std::vector<std::string>& words);
+
+	/*
+	Adds an entry to the index. Titles without any word can't be found, so they aren't kept.
+	@post newMedia gets the next id, which is added to the list of each of its words
+	@param newMedia The entry to be added
+	*/
+	void add(const MediaEntry& newMedia);
+
+	/*
+	Removes an entry from the index. Its id is found in the shortest list of its words.
+	@post If it was in the index, media is no longer in any list
+	@param media The entry to be removed
+	@return True if the removal was successful, false otherwise
+	*/
+	bool remove(const MediaEntry& media);
+
+	/*
+	Removes every entry from the index
+	@post The index is empty
+	*/
+	void clear();
+
+	/*
+	Returns the number of entries in the index
+	@return The number of entries added and not removed
+	*/
+	int getNumberOfItems() const;
+
+	/*
+	Finds every entry whose title has all of the words of text, in the order they were added.
+	The lists of the words are intersected from the shortest one on.
+	@post visit is executed for every entry found
+	@param text The words looked for, e.g. "dark knight"
+	visit Function executed for every entry found
+	@return The number of entries found, 0 if text has no word
+	*/
+	int find(const char* text, void visit(const MediaEntry&)) const;
+};
+
+#endif
@@ -0,0 +1,328 @@
+#include "WriteAheadLog.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
+
+WriteAheadLog::WriteAheadLog(const char* aFileName, long long aGeneration, int aCommitWindow)
+	: fileName(aFileName)
+{
+	generation = aGeneration;
+	commitWindow = aCommitWindow;
+
+	numAppended = 0;
+	numDurable = 0;
+	isSyncing = false;
+	isStopping = false;
+	isFailed = false;
+
+	numSyncs = 0;
+	maxGroup = 0;
+	syncTime = 0;
+
+	createFile();
+	syncDirectory(aFileName);
+	committer = std::thread(&WriteAheadLog::commitLoop, this);
+}
+
+WriteAheadLog::~WriteAheadLog()
+{
+	{
+		std::lock_guard<std::mutex> lock(logMutex);
+		isStopping = true;
+	}
+	recordsAppended.notify_one();
+	committer.join();
+
+	if (fileDescriptor >= 0)
+		close(fileDescriptor);
+}
+
+bool WriteAheadLog::createFile()
+{
+	fileSize = LOG_HEADER_SIZE;
+	fileDescriptor = open(fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+
+	char header[LOG_HEADER_SIZE];
+	std::memcpy(header, LOG_MAGIC, 4);
+	std::memcpy(header + 4, &generation, sizeof(long long));
+	if (fileDescriptor < 0 || !writeFully(fileDescriptor, header, LOG_HEADER_SIZE) || !syncFully(fileDescriptor))
+	{
+		std::cerr << "The log file " << fileName << " could not be created." << std::endl;
+		isFailed = true;
+	}
+
+	return !isFailed;
+}
+
+bool WriteAheadLog::writeFully(int descriptor, const char* data, size_t length)
+{
+	size_t written = 0;
+	while (written < length) //Writes can be cut short
+	{
+		ssize_t numBytes = write(descriptor, data + written, length - written);
+		if (numBytes > 0)
+			written += numBytes;
+		else if (numBytes < 0 && errno != EINTR) //Interrupted before writing anything otherwise
+			return false;
+	}
+
+	return true;
+}
+
+bool WriteAheadLog::syncFully(int descriptor)
+{
+	int result;
+	do
+	{
+		result = fsync(descriptor);
+	} while (result != 0 && errno == EINTR);
+
+	return (result == 0);
+}
+
+unsigned int WriteAheadLog::getChecksum(const char* data, int length)
+{
+	unsigned int hash = 2166136261u; //FNV-1a
+	for (int i = 0; i < length; i++)
+	{
+		hash ^= (unsigned char)data[i];
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+void WriteAheadLog::commitLoop()
+{
+	std::unique_lock<std::mutex> lock(logMutex);
+	while (true)
+	{
+		recordsAppended.wait(lock, [this]() { return ((!buffer.empty() || isStopping) && !isSyncing); });
+		if (buffer.empty()) //Stopping, and every record is durable
+			return;
+
+		if (commitWindow > 0 && !isStopping) //More records can join the group in the meantime
+		{
+			int window = commitWindow;
+			lock.unlock();
+			std::this_thread::sleep_for(std::chrono::microseconds(window));
+			lock.lock();
+			if (isSyncing || buffer.empty()) //rotate synced the group already
+				continue;
+		}
+
+		syncGroup(lock);
+	}
+}
+
+void WriteAheadLog::syncGroup(std::unique_lock<std::mutex>& lock)
+{
+	isSyncing = true;
+	std::string group; //The records appended from now on form the next group
+	group.swap(buffer);
+	long lastRecord = numAppended;
+	long groupSize = lastRecord - numDurable;
+	int groupDescriptor = fileDescriptor;
+	bool isWritten = !isFailed; //Records after a failed group could never be replayed
+	lock.unlock();
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	if (isWritten)
+		isWritten = writeFully(groupDescriptor, group.data(), group.size()) && syncFully(groupDescriptor);
+	double time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	lock.lock();
+	if (isWritten)
+	{
+		numDurable = lastRecord;
+		numSyncs++;
+		maxGroup = std::max(maxGroup, groupSize);
+		syncTime += time;
+	}
+	else if (!isFailed)
+	{
+		std::cerr << "The log file " << fileName << " could not be written, the changes from now on "
+			  << "won't be recovered after a crash." << std::endl;
+		isFailed = true;
+	}
+	isSyncing = false;
+	recordsDurable.notify_all();
+	recordsAppended.notify_one(); //Records appended during the sync form the next group
+}
+
+long WriteAheadLog::append(bool isAdded, const MediaEntry& media)
+{
+	unsigned int length = 2 + media.length();
+	std::string record(LOG_RECORD_HEADER_SIZE + length, '\0');
+	char* contents = &record[LOG_RECORD_HEADER_SIZE];
+	contents[0] = isAdded ? '+' : '-';
+	contents[1] = media.getMediaType();
+	for (int i = 0; i < media.length(); i++)
+		contents[2 + i] = media[i];
+
+	unsigned int checksum = getChecksum(contents, length);
+	std::memcpy(&record[0], &length, sizeof(unsigned int));
+	std::memcpy(&record[sizeof(unsigned int)], &checksum, sizeof(unsigned int));
+
+	bool wasEmpty;
+	long recordNumber;
+	{
+		std::lock_guard<std::mutex> lock(logMutex);
+		wasEmpty = buffer.empty();
+		buffer += record;
+		fileSize += record.size();
+		recordNumber = ++numAppended;
+	}
+	if (wasEmpty) //The first record of a group wakes the committer
+		recordsAppended.notify_one();
+
+	return recordNumber;
+}
+
+bool WriteAheadLog::waitDurable(long recordNumber)
+{
+	std::unique_lock<std::mutex> lock(logMutex);
+	recordsDurable.wait(lock, [this, recordNumber]() { return (numDurable >= recordNumber || isFailed); });
+
+	return (numDurable >= recordNumber);
+}
+
+bool WriteAheadLog::hasFailed()
+{
+	std::lock_guard<std::mutex> lock(logMutex);
+	return isFailed;
+}
+
+bool WriteAheadLog::rotate(const char* oldFileName)
+{
+	std::unique_lock<std::mutex> lock(logMutex);
+	while (isSyncing || !buffer.empty()) //Every record goes to the old file
+	{
+		if (isSyncing)
+			recordsDurable.wait(lock);
+		else
+			syncGroup(lock);
+	}
+	if (isFailed) //The records of the old file may not all be there
+		return false;
+
+	close(fileDescriptor);
+	fileDescriptor = -1;
+	if (std::rename(fileName.c_str(), oldFileName) != 0)
+	{
+		std::cerr << "The log file " << fileName << " could not be renamed." << std::endl;
+		isFailed = true;
+		return false;
+	}
+	generation++;
+	if (!createFile())
+		return false;
+	syncDirectory(oldFileName);
+
+	return true;
+}
+
+void WriteAheadLog::setCommitWindow(int aCommitWindow)
+{
+	std::lock_guard<std::mutex> lock(logMutex);
+	commitWindow = aCommitWindow;
+}
+
+long long WriteAheadLog::getGeneration()
+{
+	std::lock_guard<std::mutex> lock(logMutex);
+	return generation;
+}
+
+long WriteAheadLog::getSize()
+{
+	std::lock_guard<std::mutex> lock(logMutex);
+	return fileSize;
+}
+
+void WriteAheadLog::displayStatistics(std::ostream& os)
+{
+	std::lock_guard<std::mutex> lock(logMutex);
+	os << "Log file: " << fileName << " (generation " << generation << ", " << fileSize
+	   << " bytes)" << std::endl;
+	os << "Records logged: " << numAppended << ", syncs: " << numSyncs;
+	if (numSyncs > 0)
+		os << " (" << (double)numDurable/numSyncs << " records per sync on average, "
+		   << maxGroup << " at most, " << syncTime/numSyncs << " ms per sync)";
+	os << std::endl;
+	if (isFailed)
+		os << "The log failed: the changes logged since its last sync are not durable." << std::endl;
+}
+
+long long WriteAheadLog::readGeneration(const char* aFileName)
+{
+	std::ifstream inFile(aFileName, std::ios::binary);
+	char header[LOG_HEADER_SIZE];
+	if (!inFile.read(header, LOG_HEADER_SIZE) || std::memcmp(header, LOG_MAGIC, 4) != 0)
+		return -1;
+
+	long long fileGeneration;
+	std::memcpy(&fileGeneration, header + 4, sizeof(long long));
+	return fileGeneration;
+}
+
+long WriteAheadLog::replay(const char* aFileName, MediaLibraryInterface& library)
+{
+	std::ifstream inFile(aFileName, std::ios::binary);
+	char header[LOG_HEADER_SIZE];
+	if (!inFile.read(header, LOG_HEADER_SIZE) || std::memcmp(header, LOG_MAGIC, 4) != 0)
+		return 0;
+
+	long numReplayed = 0;
+	std::string contents;
+	unsigned int recordHeader[2]; //Length and checksum
+	while (inFile.read((char*)recordHeader, LOG_RECORD_HEADER_SIZE))
+	{
+		unsigned int length = recordHeader[0];
+		if (length < 2 || length > (1u << 20)) //Cut short by the crash, or damaged
+			break;
+
+		contents.resize(length);
+		if (!inFile.read(&contents[0], length) || getChecksum(contents.data(), length) != recordHeader[1])
+			break;
+
+		MediaEntry media(contents.c_str() + 2, contents[1]); //Titles have no null character,
+		if (contents[0] == '+')				     //so the rest is the title
+			library.addEntry(media);
+		else
+			library.removeEntry(media);
+		numReplayed++;
+	}
+
+	return numReplayed;
+}
+
+bool WriteAheadLog::syncFile(const char* aFileName)
+{
+	int descriptor = open(aFileName, O_RDONLY); //Syncing a file only needs a descriptor of it
+	if (descriptor < 0)
+		return false;
+
+	bool isSynced = syncFully(descriptor);
+	close(descriptor);
+	return isSynced;
+}
+
+void WriteAheadLog::syncDirectory(const char* aFileName)
+{
+	std::string directory(aFileName);
+	size_t slash = directory.rfind('/');
+	directory = (slash == std::string::npos) ? "." : directory.substr(0, slash + 1);
+
+	int directoryDescriptor = open(directory.c_str(), O_RDONLY);
+	if (directoryDescriptor >= 0)
+	{
+		fsync(directoryDescriptor);
+		close(directoryDescriptor);
+	}
+}
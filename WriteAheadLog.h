@@ -0,0 +1,209 @@
+/*@file WriteAheadLog.h*/
+#ifndef _WRITE_AHEAD_LOG_H
+#define _WRITE_AHEAD_LOG_H
+
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "MediaEntry.h"
+#include "MediaLibraryInterface.h"
+
+const char LOG_MAGIC[] = "MLOG"; //Start of every log file, followed by its generation
+const int LOG_HEADER_SIZE = 4 + sizeof(long long);
+const int LOG_RECORD_HEADER_SIZE = 2*sizeof(unsigned int); //Length and checksum of a record
+
+/*
+Log of the entries added to and removed from a library, appended to a file so the changes made
+since the library was last written out survive a crash. The file starts with a header holding
+its generation, a number telling it apart from the logs that came before it, and then has one
+record per change: the length of the record and the checksum of its contents, in the byte order
+of the machine, followed by '+' for an entry added or '-' for an entry removed, the type, and
+the title. A record is only durable once the file is synced to the disk, which takes a few
+milliseconds. So the records are appended to a buffer, and a committer thread writes out and
+syncs everything appended since its last sync at once (group commit): the threads adding records
+while a sync is in progress all wait for the next one, and share it. The committer can also
+wait commitWindow microseconds after the first record of a group, for more records to join it,
+trading latency for fewer syncs.
+If a write or a sync fails, the records of the group may be cut short in the file, and the records
+after them could never be replayed. So the log fails for good: the records are no longer written
+out, and waitDurable tells the threads waiting for them that they aren't durable.
+*/
+class WriteAheadLog
+{
+private:
+	std::string fileName; //Name of the log file
+	int fileDescriptor; //Open log file, records are appended to it
+	long long generation; //Generation of the log file
+
+	std::mutex logMutex; //Guards every member below
+	int commitWindow; //Microseconds the committer waits for a group to fill before syncing it
+	std::condition_variable recordsAppended; //Signalled when the first record of a group is
+						 //appended, or when the log stops
+	std::condition_variable recordsDurable; //Signalled after every sync
+	std::string buffer; //Records appended since the last group was taken by the committer
+	long numAppended; //Records appended so far, numbered from 1
+	long numDurable; //Records synced so far
+	long fileSize; //Bytes in the log file, including the buffer
+	bool isSyncing; //True while the committer writes out and syncs a group
+	bool isStopping; //True once the destructor asks the committer to exit
+	bool isFailed; //True once a write or a sync failed, see the class description
+	std::thread committer; //Writes out and syncs the groups of records
+
+	long numSyncs; //Statistics of the groups synced so far
+	long maxGroup;
+	double syncTime;
+
+	/*
+	Loop run by the committer: waits for records, lets the commit window pass, then writes out
+	and syncs every record appended so far, and repeats until the log stops
+	*/
+	void commitLoop();
+
+	/*
+	Writes out the records in the buffer and syncs the file, for the committer or for rotate
+	@pre logMutex is locked through lock, and no other thread is syncing
+	@post The records appended so far are durable, and the threads waiting for them are woken
+	@param lock The lock on logMutex, released during the write and the sync
+	*/
+	void syncGroup(std::unique_lock<std::mutex>& lock);
+
+	/*
+	Writes out data to a file, retrying the writes interrupted or cut short
+	@param descriptor The file
+	data, length The data and its number of bytes
+	@return True if all of it was written, false if a write failed
+	*/
+	static bool writeFully(int descriptor, const char* data, size_t length);
+
+	/*
+	Syncs a file to the disk, retrying if the sync is interrupted
+	@param descriptor The file
+	@return True if the file was synced, false otherwise
+	*/
+	static bool syncFully(int descriptor);
+
+	/*
+	Computes the checksum of the contents of a record, telling a damaged record apart
+	@param data The contents
+	length The number of bytes
+	@return The FNV-1a hash of the contents
+	*/
+	static unsigned int getChecksum(const char* data, int length);
+
+	/*
+	Creates a new log file holding only the header
+	@post fileDescriptor is open for appending records to the file, or the log failed
+	@return True if the file was created, false otherwise
+	*/
+	bool createFile();
+
+	//The committer refers to the log, so it can't be copied
+	WriteAheadLog(const WriteAheadLog&);
+	WriteAheadLog& operator=(const WriteAheadLog&);
+
+public:
+	/*
+	Starts a new log, replacing any file with the same name
+	@param aFileName The name of the log file
+	aGeneration The generation of the log, larger than the one of every log before it
+	aCommitWindow Microseconds the committer waits for more records before each sync
+	*/
+	WriteAheadLog(const char* aFileName, long long aGeneration, int aCommitWindow = 0);
+
+	/*
+	Syncs the records still in the buffer, and closes the log file
+	*/
+	~WriteAheadLog();
+
+	/*
+	Appends a record to the buffer, without waiting for it to be durable
+	@post The record will be synced with its group
+	@param isAdded True if the entry was added, false if it was removed
+	media The entry
+	@return The number of the record, to be passed to waitDurable
+	*/
+	long append(bool isAdded, const MediaEntry& media);
+
+	/*
+	Blocks until a record and every record before it are synced to the disk, or the log fails
+	@param recordNumber The number returned by append
+	@return True if the record is durable, false if the log failed before it was synced
+	*/
+	bool waitDurable(long recordNumber);
+
+	/*
+	Returns whether a write or a sync of the log failed, so the records appended now won't be
+	durable
+	@return True if the log failed, false otherwise
+	*/
+	bool hasFailed();
+
+	/*
+	Syncs every record appended so far, renames the log file, and goes on in a new log file of
+	the next generation, e.g. before a checkpoint writes out the changes of the old one
+	@post The old records are in oldFileName, and new records go to the new log
+	@param oldFileName The new name of the current log file
+	@return True if the log was rotated, false if it failed
+	*/
+	bool rotate(const char* oldFileName);
+
+	/*
+	Changes the time the committer waits for more records before each sync
+	@param aCommitWindow The time in microseconds, 0 to sync as soon as the last sync is done
+	*/
+	void setCommitWindow(int aCommitWindow);
+
+	/*
+	Returns the generation of the current log file
+	@return The generation
+	*/
+	long long getGeneration();
+
+	/*
+	Returns the size of the current log file, including the records not synced yet
+	@return The size in bytes
+	*/
+	long getSize();
+
+	/*
+	Writes out the number of records, syncs and records per sync, and the average sync time, to os
+	@post The statistics are written to os
+	@param os Ostream variable for the output
+	*/
+	void displayStatistics(std::ostream& os);
+
+	/*
+	Reads the generation of a log file
+	@param aFileName The name of the log file
+	@return The generation, or -1 if there is no such log file
+	*/
+	static long long readGeneration(const char* aFileName);
+
+	/*
+	Makes again the changes recorded in a log file, e.g. after a crash. A record cut short or
+	damaged by the crash, and whatever follows it, is ignored.
+	@post The entries recorded are added to and removed from library, in the order of the log
+	@param aFileName The name of the log file
+	library The library the changes are made to
+	@return The number of records replayed
+	*/
+	static long replay(const char* aFileName, MediaLibraryInterface& library);
+
+	/*
+	Syncs a file to the disk, e.g. a library file before the logs of its changes are removed
+	@param aFileName The name of the file
+	@return True if the file was synced, false otherwise
+	*/
+	static bool syncFile(const char* aFileName);
+
+	/*
+	Syncs the directory holding a file, so that a file created, renamed or removed in it is
+	still there, or still gone, after a crash
+	@param aFileName The name of the file
+	*/
+	static void syncDirectory(const char* aFileName);
+};
+
+#endif
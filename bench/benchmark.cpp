@@ -0,0 +1,1714 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <cctype>
+#include <cmath>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <malloc.h>
+#include "../MediaEntry.h"
+#include "../ConcurrentTwoThreeTree.h"
+#include "../FrozenIndex.h"
+#include "../HashTable.h"
+#include "../HybridIndex.h"
+#include "../LoggedLibrary.h"
+#include "../MediaLibrary.h"
+#include "../NotFoundException.h"
+#include "../RadixTree.h"
+#include "../ShardedLibrary.h"
+#include "../ThreadPool.h"
+#include "../TwoThreeTree.h"
+
+/*
+Measures the operations of the data structures and libraries on generated entries, so the numbers
+quoted for them can be reproduced. Each section is run on its own:
+
+	./bench/benchmark lookups [number of entries]
+	./bench/benchmark concurrent [number of entries]
+	./bench/benchmark snapshots [number of entries]
+	./bench/benchmark ranges [number of entries]
+	./bench/benchmark scans [number of entries]
+	./bench/benchmark threads [number of entries]
+	./bench/benchmark setops [number of entries]
+	./bench/benchmark export [number of entries]
+	./bench/benchmark copies [number of entries]
+	./bench/benchmark cache [number of entries]
+	./bench/benchmark words [number of entries]
+	./bench/benchmark fuzzy [number of entries]
+	./bench/benchmark shards [number of entries]
+	./bench/benchmark logging [number of entries]
+	./bench/benchmark memory [number of entries]
+
+lookups: contains on the 2-3 tree, hash table and frozen index, one entry at a time and in batches
+of 1, 8, 32 and 128 entries (containsMany)
+concurrent: throughput of 1 to 16 threads making a read-mostly (95% lookups) and a write-heavy
+(50% lookups) mix of contains, add and remove, on the concurrent 2-3 tree and on a 2-3 tree
+behind a single lock
+snapshots: adds and removes made by one thread, alone and while another thread goes through every
+entry over and over, on the same two trees: the locked tree holds its lock for a whole scan, and
+the concurrent tree scans a snapshot
+ranges: range queries returning 1 to 100000 entries, and prefix queries of 1 to 4 letters, on the
+2-3 tree (forEachInRange), against going through every entry of the tree or the hash table
+scans: going through every entry of the 2-3 tree, hash table and radix tree with traverse (a
+function called through a pointer), forEach (a lambda) and an iterator (range-based for loop)
+threads: traversing, exporting (into memory) and gathering the statistics of the 2-3 tree and
+hash table by one thread, and on thread pools of 1 to 16 workers
+setops: union, intersection and difference of two 2-3 trees, and of two hash tables, sharing half
+of their entries, against a loop of contains, add and remove. Then again with a second set
+SMALL_SET_RATIO times smaller.
+export: writing the 2-3 tree and hash table to a file with writeToFile, which buffers the output in
+large blocks, against writing it entry by entry and ending each line with endl, as writeToFile did
+before
+copies: titles allocated and characters copied (see MediaEntry::getNumTitleAllocations) per entry
+by loading, adding one at a time, looking up, exporting and removing the entries of the 2-3 tree
+and hash table
+cache: contains and getEntry on a library of 2-3 trees, without a lookup cache and with caches of
+100 to 100000 entries, for lookups skewed as by popularity: the titles follow a Zipf distribution,
+and half of the popular ones aren't in the library
+words: findWords on a library of 2-3 trees whose titles have three words, for one or two words
+shared by many titles and for a word of a single title, with the word index on and off (going
+through every title)
+fuzzy: findClosest on libraries of 2-3 trees of a tenth of the entries and of all of them, with the
+titles of the words section, for titles with 1 and 2 letters replaced, with the trigram index on
+and off (computing the distance of every title), and the number of candidates the index computes
+the distance of
+shards: loading (addEntries, in sorted order as from a file) a library of 2-3 trees and of hash
+tables, and contains and containsMany on it, as a single library and split into 1 to 16 shards
+logging: entries added to a logged library of 2-3 trees by 1 to 16 threads at once, each change
+returning once it is synced, with commit windows of 0 to 5000 microseconds (see WriteAheadLog.h).
+Only NUM_LOGGED_CHANGES entries are added, whatever the number of entries given.
+memory: heap bytes per entry, titles included, of the 2-3 tree, hash table, frozen index, radix
+tree and hybrid index loaded with addAll, against an array of the entries, and ns per add (in
+random order, into an empty one), contains and remove of each. The heap is measured with
+mallinfo2, so the bytes are only shown with glibc 2.33 and later.
+
+Build it with "make bench". Extra compiler flags can be given with BENCH_FLAGS, e.g. to turn the
+prefetches off: make bench BENCH_FLAGS="-D'__builtin_prefetch(...)=((void)0)'"
+*/
+
+using namespace std;
+
+const int DEFAULT_ENTRIES = 1000000; //Entries of the data structures, unless given
+const int NUM_REPEATS = 3; //Each measurement is repeated, and the best time is kept
+const int NUM_LOOKUPS = 400000; //Lookups of the lookups section
+const int NUM_BATCH_SIZES = 4;
+const int BATCH_SIZES[NUM_BATCH_SIZES] = {1, 8, 32, 128}; //Sizes of the batches of the lookups section
+const int MAX_TITLE_LENGTH = 16; //Length of the generated titles, and room for their end
+const int NUM_THREAD_COUNTS = 5;
+const int THREAD_COUNTS[NUM_THREAD_COUNTS] = {1, 2, 4, 8, 16}; //Threads of the concurrent section
+const int NUM_MIXED_OPERATIONS = 400000; //Operations of the concurrent section, split among the threads
+const int NUM_MIXES = 2;
+const int READ_PERCENTS[NUM_MIXES] = {95, 50}; //Share of lookups of the read-mostly and write-heavy mix
+const int NUM_SNAPSHOT_CHANGES = 20000; //Adds and removes of the snapshots section
+const int NUM_RANGE_SIZES = 6;
+const int RANGE_SIZES[NUM_RANGE_SIZES] = {1, 10, 100, 1000, 10000, 100000}; //Entries in the ranges
+const int MAX_PREFIX_LETTERS = 4; //Prefix queries have 1 to this many letters
+const int NUM_RANGE_QUERIES = 1000; //Queries of each size going through the range only
+const int NUM_SCAN_QUERIES = 5; //Queries of each size going through every entry
+const int NUM_SCANS = 10; //Scans of the whole data structure by each way of the scans section
+const char EXPORT_FILE_NAME[] = "benchmark_export.txt"; //Written by the export section, then removed
+const int SMALL_SET_RATIO = 100; //The small second set of the setops section has this many times
+				  //fewer entries
+const int NUM_CACHE_LOOKUPS = 400000; //Lookups of the cache section
+const double ZIPF_EXPONENT = 0.99; //The title of rank r is looked up in proportion to 1/r^ZIPF_EXPONENT
+const int NUM_CACHE_SIZES = 5;
+const int CACHE_SIZES[NUM_CACHE_SIZES] = {0, 100, 1000, 10000, 100000}; //0 for no cache
+const int NUM_COMMON_WORDS = 1000; //Words the titles of the words section have two of
+const int NUM_WORD_QUERIES = 1000; //Queries of each kind using the word index
+const int MAX_TYPOS = 2; //Titles looked for by the fuzzy section have up to this many letters replaced
+const int NUM_FUZZY_QUERIES = 100; //Queries of each number of typos using the trigram index
+const int NUM_CLOSEST = 10; //Entries found by each query of the fuzzy section at most
+const int SHARD_BATCH_SIZE = 1024; //Entries looked up by each containsMany of the shards section
+const char LOG_FILE_NAME[] = "benchmark_log.txt"; //Library file of the logging section, whose
+						  //logs and checkpoint are removed afterwards
+const int NUM_LOGGED_CHANGES = 1000; //Changes of the logging section, split among the threads
+const int NUM_COMMIT_WINDOWS = 4;
+const int COMMIT_WINDOWS[NUM_COMMIT_WINDOWS] = {0, 200, 1000, 5000}; //In microseconds
+
+long numVisited = 0; //Entries counted by countEntry
+thread_local long numRead = 0; //Characters read by readEntry in each thread
+
+/*
+2-3 tree behind a single lock, the way a tree is shared between threads without the concurrent
+2-3 tree: every lookup waits for the changes, and for the other lookups
+*/
+class LockedTwoThreeTree
+{
+private:
+	TwoThreeTree<MediaEntry> tree;
+	mutable std::mutex treeMutex; //Held by every operation
+
+public:
+	bool addAll(const MediaEntry items[], int numItems);
+	bool add(const MediaEntry& newData);
+	bool remove(const MediaEntry& anEntry);
+	bool contains(const MediaEntry& anEntry) const;
+	template <class Visitor>
+	bool forEach(Visitor&& visit) const;
+};
+
+/*
+Writes a title made of letters only, different for every number, e.g. "Baaaaa" for 1 and "Abaaaa"
+for 26. Titles are compared by their letters, so numbers written with digits would all be equal.
+The number is written from its last digit in base 26, so the titles of consecutive numbers are
+spread over every prefix.
+@post title holds the title of number
+@param number The number, at least 0
+title Array of at least MAX_TITLE_LENGTH characters
+*/
+void makeTitle(int number, char title[]);
+
+/*
+Builds numEntries different entries of every type, in sorted order
+@post entries holds the entries
+@param numEntries The number of entries
+entries Receives the entries
+*/
+void makeEntries(int numEntries, vector<MediaEntry>& entries);
+
+/*
+Returns the time elapsed since start
+@param start The time the measurement started
+@return The number of seconds since start
+*/
+double getSeconds(chrono::steady_clock::time_point start);
+
+/*
+Times the lookups of a data structure one at a time and in batches, and displays the best time per
+lookup of each
+@post A line of times is displayed
+@param name The name of the data structure
+structure The data structure, holding the entries looked up
+lookups The entries looked up, three out of four of them in the data structure
+*/
+template <class Structure>
+void timeLookups(const char* name, const Structure& structure, const vector<MediaEntry>& lookups);
+
+/*
+Runs the lookups section
+@post The times of the lookups are displayed
+@param numEntries The number of entries of the data structures
+*/
+void benchLookups(int numEntries);
+
+/*
+Runs a mix of operations on a data structure from several threads at once. Each thread makes its
+share of the operations on random entries, half of which are in the data structure to begin with.
+A change removes the entry, or adds it if it wasn't there, so the size stays about the same.
+@post The data structure holds about as many entries as before
+@param structure The data structure, shared by the threads
+entries The entries operated on
+numThreads The number of threads
+readPercent The share of the operations that are lookups, in percent
+@return The number of seconds the operations took
+*/
+template <class Structure>
+double runMix(Structure& structure, const vector<MediaEntry>& entries, int numThreads, int readPercent);
+
+/*
+Runs the concurrent section
+@post The throughputs of the mixes are displayed
+@param numEntries The number of entries of the data structures
+*/
+void benchConcurrent(int numEntries);
+
+/*
+Makes NUM_SNAPSHOT_CHANGES adds and removes on a data structure from one thread, while another
+thread goes through every entry with forEach over and over if hasScans, and displays the changes
+per second, the longest a change took, and the number of scans completed
+@post A line of results is displayed, and the data structure holds about as many entries as before
+@param name The name of the data structure
+structure The data structure
+entries The entries changed, half of which are in the data structure to begin with
+hasScans True to scan the data structure during the changes, false to make them alone
+*/
+template <class Structure>
+void timeChangesDuringScans(const char* name, Structure& structure, const vector<MediaEntry>& entries,
+				bool hasScans);
+
+/*
+Runs the snapshots section
+@post The results of the changes are displayed
+@param numEntries The number of entries of the data structures
+*/
+void benchSnapshots(int numEntries);
+
+/*
+Times queries, and returns the best time per query
+@param numQueries The number of queries
+query Callable taking the number of a query, from 0 to numQueries - 1, making it and returning
+the number of entries it found
+numFound Receives the total number of entries found by the last round of queries
+@return The number of microseconds per query
+*/
+template <class Query>
+double timeQueries(int numQueries, Query&& query, long& numFound);
+
+/*
+Runs the ranges section
+@post The times of the range and prefix queries are displayed
+@param numEntries The number of entries of the data structures
+*/
+void benchRanges(int numEntries);
+
+/*
+Counts an entry, as the function given to traverse by the scans section
+@post numVisited is incremented
+@param media The entry visited
+*/
+void countEntry(MediaEntry& media);
+
+/*
+Times going through every entry of a data structure in each way, and displays the best time per
+entry of each
+@post A line of times is displayed
+@param name The name of the data structure
+structure The data structure
+*/
+template <class Structure>
+void timeScans(const char* name, const Structure& structure);
+
+/*
+Runs the scans section
+@post The times of the scans are displayed
+@param numEntries The number of entries of the data structures
+*/
+void benchScans(int numEntries);
+
+/*
+Reads an entry, as the function given to parallelTraverse by the threads section
+@post numRead of the calling thread is increased by the length of the title
+@param media The entry visited
+*/
+void readEntry(MediaEntry& media);
+
+/*
+Times a full pass over a data structure by one thread, then on thread pools of each size, and
+displays the best time of each
+@post A line of times is displayed
+@param name The name of the pass
+pass Callable taking a pointer to the thread pool, NULL for one thread, and making the pass
+*/
+template <class Pass>
+void timePasses(const char* name, Pass&& pass);
+
+/*
+Runs the threads section
+@post The times of the passes are displayed
+@param numEntries The number of entries of the data structures
+*/
+void benchThreads(int numEntries);
+
+/*
+Times an operation changing a data structure, which is built anew before each repetition, and
+returns the best time
+@param items The entries the data structure is built from
+operation Callable taking the data structure and changing it
+@return The number of milliseconds the operation took
+*/
+template <class Structure, class Operation>
+double timeChange(const vector<MediaEntry>& items, Operation&& operation);
+
+/*
+Times the union, intersection and difference of two data structures, each done by a loop and by
+the set operation, and displays them
+@post A line of times is displayed for each operation
+@param name The name of the data structure
+firstItems, secondItems The entries of the two data structures, in sorted order
+*/
+template <class Structure>
+void timeSetOperations(const char* name, const vector<MediaEntry>& firstItems,
+			const vector<MediaEntry>& secondItems);
+
+/*
+Runs the setops section
+@post The times of the set operations are displayed
+@param numEntries The number of entries of each data structure
+*/
+void benchSetOperations(int numEntries);
+
+/*
+Times writing a data structure to EXPORT_FILE_NAME entry by entry, flushing every line, and with
+writeToFile, and displays them
+@post A line of times is displayed
+@param name The name of the data structure
+structure The data structure to be written
+*/
+template <class Structure>
+void timeExport(const char* name, const Structure& structure);
+
+/*
+Runs the export section
+@post The export times are displayed, and EXPORT_FILE_NAME is removed
+@param numEntries The number of entries of each data structure
+*/
+void benchExport(int numEntries);
+
+/*
+Counts the titles allocated and the characters copied by an operation, and displays them per entry
+@post A line of counts is displayed
+@param name The name of the operation
+numEntries The number of entries the operation goes through
+operation Callable making the operation
+*/
+template <class Operation>
+void countCopies(const char* name, int numEntries, Operation&& operation);
+
+/*
+Counts the copies of every operation of a data structure, and displays them
+@post A line of counts is displayed for each operation
+@param name The name of the data structure
+entries The entries, in sorted order
+shuffled The same entries, in random order
+*/
+template <class Structure>
+void countStructureCopies(const char* name, const vector<MediaEntry>& entries,
+				const vector<MediaEntry>& shuffled);
+
+/*
+Runs the copies section
+@post The copies of the operations are displayed
+@param numEntries The number of entries of the data structures
+*/
+void benchCopies(int numEntries);
+
+/*
+Draws titles by popularity: the titles are ranked at random, and the title of rank r is drawn in
+proportion to 1/r^ZIPF_EXPONENT
+@post lookups holds the entries drawn
+@param numTitles The number of titles, the first half of which are in the library
+numLookups The number of entries drawn
+lookups Receives the entries
+@return The share of the lookups going to each number of most popular titles of CACHE_SIZES
+*/
+vector<double> makeZipfLookups(int numTitles, int numLookups, vector<MediaEntry>& lookups);
+
+/*
+Runs the cache section
+@post The times of the lookups are displayed
+@param numEntries The number of entries of the library
+*/
+void benchCache(int numEntries);
+
+/*
+Builds numEntries different entries whose titles have three words, e.g. "Cdaaaa Baaaaa Aaabaa":
+two drawn from NUM_COMMON_WORDS words, and one of its own
+@post entries holds the entries, in sorted order
+@param numEntries The number of entries
+entries Receives the entries
+*/
+void makeWordEntries(int numEntries, vector<MediaEntry>& entries);
+
+/*
+Counts an entry, as the function given to findWords and findClosest
+@post numVisited is incremented
+@param media The entry found
+*/
+void countFound(const MediaEntry& media);
+
+/*
+Runs the words section
+@post The times of the word queries are displayed
+@param numEntries The number of entries of the library
+*/
+void benchWords(int numEntries);
+
+/*
+Counts an entry, as the function given to findClosest
+@post numVisited is incremented
+@param media The entry found
+distance Its distance to the title looked for
+*/
+void countClosest(const MediaEntry& media, int distance);
+
+/*
+Times findClosest on a library of the first numEntries entries, and displays the best time per
+query with the trigram index on and off
+@post A line of results is displayed for each number of typos
+@param entries The entries, the first numEntries of which are in the library
+numEntries The number of entries of the library
+*/
+void timeFuzzyQueries(const vector<MediaEntry>& entries, int numEntries);
+
+/*
+Runs the fuzzy section
+@post The times of the fuzzy queries are displayed
+@param numEntries The number of entries of the larger library
+*/
+void benchFuzzy(int numEntries);
+
+/*
+Times loading a library and looking entries up in it, and displays the best times
+@post A line of times is displayed
+@param name The name of the library
+entries The entries loaded, in sorted order
+lookups The entries looked up
+makeLibrary Callable returning a new, empty library, which is deleted afterwards
+*/
+template <class MakeLibrary>
+void timeLibrary(const string& name, const vector<MediaEntry>& entries, const vector<MediaEntry>& lookups,
+			MakeLibrary&& makeLibrary);
+
+/*
+Runs the shards section
+@post The times of the loads and lookups are displayed
+@param numEntries The number of entries of the libraries
+*/
+void benchShards(int numEntries);
+
+/*
+Adds NUM_LOGGED_CHANGES entries to a new logged library from several threads at once, each
+adding its share of the entries one at a time, and returns the changes made per second
+@post The library, its logs and its checkpoint are removed
+@param entries The entries added, at least NUM_LOGGED_CHANGES of them
+numThreads The number of threads
+commitWindow The commit window of the log, in microseconds
+@return The number of changes per second
+*/
+double runLoggedChanges(const vector<MediaEntry>& entries, int numThreads, int commitWindow);
+
+/*
+Runs the logging section
+@post The throughputs of the changes are displayed
+@param numEntries Unused, the section makes NUM_LOGGED_CHANGES changes
+*/
+void benchLogging(int numEntries);
+
+/*
+Returns the number of bytes allocated on the heap and not freed
+@return The number of bytes, 0 if the C library can't tell
+*/
+size_t getHeapBytes();
+
+/*
+Loads a data structure with addAll, and displays the heap bytes it takes per entry, also beyond
+the array of the entries, and the time per add, contains and remove. A data structure that can't
+be changed shows no time for add and remove.
+@post A line of results is displayed
+@param name The name of the data structure
+entries The entries, in sorted order
+shuffled The same entries, in random order, added and removed one at a time
+lookups The entries looked up
+arrayBytes The heap bytes per entry of an array of the entries
+*/
+template <class Structure>
+void measureStructure(const char* name, const vector<MediaEntry>& entries, const vector<MediaEntry>& shuffled,
+			const vector<MediaEntry>& lookups, double arrayBytes);
+
+/*
+Runs the memory section
+@post The bytes and times of the data structures are displayed
+@param numEntries The number of entries of the data structures
+*/
+void benchMemory(int numEntries);
+
+int main(int argc, char* argv[])
+{
+	int numEntries = (argc > 2) ? atoi(argv[2]) : DEFAULT_ENTRIES;
+
+	if (argc > 1 && numEntries > 0 && strcmp(argv[1], "lookups") == 0)
+		benchLookups(numEntries);
+	else if (argc > 1 && numEntries > 0 && strcmp(argv[1], "concurrent") == 0)
+		benchConcurrent(numEntries);
+	else if (argc > 1 && numEntries > 0 && strcmp(argv[1], "snapshots") == 0)
+		benchSnapshots(numEntries);
+	else if (argc > 1 && numEntries > 0 && strcmp(argv[1], "ranges") == 0)
+		benchRanges(numEntries);
+	else if (argc > 1 && numEntries > 0 && strcmp(argv[1], "scans") == 0)
+		benchScans(numEntries);
+	else if (argc > 1 && numEntries > 0 && strcmp(argv[1], "threads") == 0)
+		benchThreads(numEntries);
+	else if (argc > 1 && numEntries > 0 && strcmp(argv[1], "setops") == 0)
+		benchSetOperations(numEntries);
+	else if (argc > 1 && numEntries > 0 && strcmp(argv[1], "export") == 0)
+		benchExport(numEntries);
+	else if (argc > 1 && numEntries > 0 && strcmp(argv[1], "copies") == 0)
+		benchCopies(numEntries);
+	else if (argc > 1 && numEntries > 0 && strcmp(argv[1], "cache") == 0)
+		benchCache(numEntries);
+	else if (argc > 1 && numEntries > 0 && strcmp(argv[1], "words") == 0)
+		benchWords(numEntries);
+	else if (argc > 1 && numEntries > 0 && strcmp(argv[1], "fuzzy") == 0)
+		benchFuzzy(numEntries);
+	else if (argc > 1 && numEntries > 0 && strcmp(argv[1], "shards") == 0)
+		benchShards(numEntries);
+	else if (argc > 1 && numEntries > 0 && strcmp(argv[1], "logging") == 0)
+		benchLogging(numEntries);
+	else if (argc > 1 && numEntries > 0 && strcmp(argv[1], "memory") == 0)
+		benchMemory(numEntries);
+	else
+	{
+		cout << "Usage: " << argv[0] << " lookups|concurrent|snapshots|ranges|scans|threads|setops|export|copies|cache|words|fuzzy|shards|logging|memory "
+			<< "[number of entries]" << endl;
+		return 1;
+	}
+
+	return 0;
+}
+
+bool LockedTwoThreeTree::addAll(const MediaEntry items[], int numItems)
+{
+	std::lock_guard<std::mutex> lock(treeMutex);
+	return tree.addAll(items, numItems);
+}
+
+bool LockedTwoThreeTree::add(const MediaEntry& newData)
+{
+	std::lock_guard<std::mutex> lock(treeMutex);
+	return tree.add(newData);
+}
+
+bool LockedTwoThreeTree::remove(const MediaEntry& anEntry)
+{
+	std::lock_guard<std::mutex> lock(treeMutex);
+	return tree.remove(anEntry);
+}
+
+bool LockedTwoThreeTree::contains(const MediaEntry& anEntry) const
+{
+	std::lock_guard<std::mutex> lock(treeMutex);
+	return tree.contains(anEntry);
+}
+
+template <class Visitor>
+bool LockedTwoThreeTree::forEach(Visitor&& visit) const
+{
+	std::lock_guard<std::mutex> lock(treeMutex); //Held for the whole traversal
+	return tree.forEach(visit);
+}
+
+void makeTitle(int number, char title[])
+{
+	const int numLetters = 6; //26^6 titles, enough for any number of entries tried
+	for (int i = 0; i < numLetters; i++)
+	{
+		title[i] = 'a' + number % 26;
+		number /= 26;
+	}
+	title[0] = toupper(title[0]);
+	title[numLetters] = '\0';
+}
+
+void makeEntries(int numEntries, vector<MediaEntry>& entries)
+{
+	const char mediaTypes[] = "MTS";
+	char title[MAX_TITLE_LENGTH];
+
+	entries.clear();
+	entries.reserve(numEntries);
+	for (int i = 0; i < numEntries; i++)
+	{
+		makeTitle(i, title);
+		entries.push_back(MediaEntry(title, mediaTypes[i % 3]));
+	}
+	sort(entries.begin(), entries.end());
+}
+
+double getSeconds(chrono::steady_clock::time_point start)
+{
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+template <class Structure>
+void timeLookups(const char* name, const Structure& structure, const vector<MediaEntry>& lookups)
+{
+	int numLookups = lookups.size();
+	bool results[128]; //Room for the largest batch
+	long numFound = 0; //Used, so the lookups aren't optimized away
+
+	cout << setw(8) << left << name << right;
+	for (int s = -1; s < NUM_BATCH_SIZES; s++) //-1 for one contains at a time
+	{
+		double bestTime = 0;
+		for (int r = 0; r < NUM_REPEATS; r++)
+		{
+			chrono::steady_clock::time_point start = chrono::steady_clock::now();
+			if (s < 0)
+			{
+				for (int i = 0; i < numLookups; i++)
+					numFound += structure.contains(lookups[i]);
+			}
+			else
+			{
+				int batchSize = BATCH_SIZES[s];
+				for (int i = 0; i + batchSize <= numLookups; i += batchSize)
+					numFound += structure.containsMany(&lookups[i], batchSize, results);
+			}
+
+			double time = getSeconds(start);
+			if (r == 0 || time < bestTime)
+				bestTime = time;
+		}
+
+		cout << setw(8) << (int)(bestTime/numLookups*1e9) << (s < 0 ? " |" : "");
+	}
+	cout << (numFound < 0 ? " " : "") << endl;
+}
+
+void benchLookups(int numEntries)
+{
+	vector<MediaEntry> entries;
+	makeEntries(numEntries, entries);
+
+	mt19937 random(1); //Three out of four lookups find their entry
+	vector<MediaEntry> lookups;
+	char title[MAX_TITLE_LENGTH];
+	for (int i = 0; i < NUM_LOOKUPS; i++)
+	{
+		if (random() % 4 != 0)
+			lookups.push_back(entries[random() % numEntries]);
+		else
+		{
+			makeTitle(numEntries + random() % numEntries, title);
+			lookups.push_back(MediaEntry(title, 'M'));
+		}
+	}
+
+	cout << "ns per lookup, " << numEntries << " entries" << endl;
+	cout << setw(8) << left << "" << right << setw(8) << "loop" << "  " << "batches of";
+	for (int s = 0; s < NUM_BATCH_SIZES; s++)
+		cout << setw(s == 0 ? 4 : 8) << BATCH_SIZES[s];
+	cout << endl;
+
+	{
+		vector<MediaEntry> shuffled(entries); //Added in random order, as a library changed over
+		shuffle(shuffled.begin(), shuffled.end(), random); //time is, instead of built bottom-up
+		TwoThreeTree<MediaEntry> tree;
+		for (int i = 0; i < numEntries; i++)
+			tree.add(shuffled[i]);
+		timeLookups("tree", tree, lookups);
+	}
+	{
+		HashTable<MediaEntry> table;
+		for (int i = 0; i < numEntries; i++)
+			table.add(entries[i]);
+		timeLookups("hash", table, lookups);
+	}
+	{
+		FrozenIndex<MediaEntry> frozen;
+		frozen.addAll(&entries[0], numEntries);
+		timeLookups("frozen", frozen, lookups);
+	}
+}
+
+template <class Structure>
+double runMix(Structure& structure, const vector<MediaEntry>& entries, int numThreads, int readPercent)
+{
+	vector<thread> threads;
+	int numEntries = entries.size();
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (int t = 0; t < numThreads; t++)
+	{
+		threads.push_back(thread([&structure, &entries, numThreads, readPercent, numEntries, t]()
+		{
+			mt19937 generator(t + 1);
+			for (int i = 0; i < NUM_MIXED_OPERATIONS / numThreads; i++)
+			{
+				int operation = generator() % 100;
+				const MediaEntry& media = entries[generator() % numEntries];
+				if (operation < readPercent)
+					structure.contains(media);
+				else if (!structure.remove(media)) //The trees take duplicates, so an entry is
+					structure.add(media);	    //only added if it isn't there
+			}
+		}));
+	}
+	for (int t = 0; t < numThreads; t++)
+		threads[t].join();
+
+	return getSeconds(start);
+}
+
+void benchConcurrent(int numEntries)
+{
+	vector<MediaEntry> entries; //Every other entry starts in the data structures
+	makeEntries(2 * numEntries, entries);
+	vector<MediaEntry> firstEntries;
+	for (int i = 0; i < 2 * numEntries; i += 2)
+		firstEntries.push_back(entries[i]);
+
+	cout << "Millions of operations per second, " << numEntries << " entries, "
+		<< thread::hardware_concurrency() << " hardware threads" << endl;
+	cout << setw(24) << left << "" << right << "threads";
+	for (int n = 0; n < NUM_THREAD_COUNTS; n++)
+		cout << setw(n == 0 ? 3 : 8) << THREAD_COUNTS[n];
+	cout << endl;
+
+	for (int m = 0; m < NUM_MIXES; m++)
+	{
+		for (int s = 0; s < 2; s++)
+		{
+			ConcurrentTwoThreeTree<MediaEntry> concurrentTree; //Only the one of the row is filled
+			LockedTwoThreeTree lockedTree;
+			if (s == 0)
+				lockedTree.addAll(&firstEntries[0], numEntries);
+			else
+				concurrentTree.addAll(&firstEntries[0], numEntries);
+
+			cout << setw(3) << READ_PERCENTS[m] << "% reads, " << setw(20) << left
+				<< (s == 0 ? "locked tree" : "concurrent tree") << right;
+			for (int n = 0; n < NUM_THREAD_COUNTS; n++)
+			{
+				double bestTime = 0;
+				for (int r = 0; r < NUM_REPEATS; r++)
+				{
+					double time = (s == 0)
+						? runMix(lockedTree, entries, THREAD_COUNTS[n], READ_PERCENTS[m])
+						: runMix(concurrentTree, entries, THREAD_COUNTS[n], READ_PERCENTS[m]);
+					if (r == 0 || time < bestTime)
+						bestTime = time;
+				}
+				cout << setw(8) << fixed << setprecision(2) << NUM_MIXED_OPERATIONS / bestTime / 1e6;
+			}
+			cout << endl;
+		}
+	}
+}
+
+template <class Structure>
+void timeChangesDuringScans(const char* name, Structure& structure, const vector<MediaEntry>& entries,
+				bool hasScans)
+{
+	atomic<bool> isDone(false);
+	long numScans = 0;
+	long numScanned = 0; //Used, so the scans aren't optimized away
+	thread scanner([&structure, &isDone, &numScans, &numScanned, hasScans]()
+	{
+		while (hasScans && !isDone)
+		{
+			structure.forEach([&numScanned](const MediaEntry&)
+			{
+				numScanned++;
+				return true;
+			});
+			numScans++;
+		}
+	});
+
+	mt19937 generator(1);
+	int numEntries = entries.size();
+	double longestChange = 0;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (int i = 0; i < NUM_SNAPSHOT_CHANGES; i++)
+	{
+		chrono::steady_clock::time_point changeStart = chrono::steady_clock::now();
+		const MediaEntry& media = entries[generator() % numEntries];
+		if (!structure.remove(media)) //Same as in runMix
+			structure.add(media);
+		longestChange = max(longestChange, getSeconds(changeStart));
+	}
+	double time = getSeconds(start);
+
+	isDone = true;
+	scanner.join();
+
+	cout << setw(20) << left << name << right << setw(10) << (hasScans ? "yes" : "no")
+		<< setw(14) << fixed << setprecision(0) << NUM_SNAPSHOT_CHANGES / time
+		<< setw(16) << setprecision(2) << longestChange * 1e3 << setw(8) << numScans
+		<< (numScanned < 0 ? " " : "") << endl;
+}
+
+void benchSnapshots(int numEntries)
+{
+	vector<MediaEntry> entries; //Every other entry starts in the data structures, as in
+	makeEntries(2 * numEntries, entries); //benchConcurrent
+	vector<MediaEntry> firstEntries;
+	for (int i = 0; i < 2 * numEntries; i += 2)
+		firstEntries.push_back(entries[i]);
+
+	cout << NUM_SNAPSHOT_CHANGES << " adds and removes, " << numEntries << " entries, "
+		<< thread::hardware_concurrency() << " hardware threads" << endl;
+	cout << setw(20) << "" << setw(10) << "scans" << setw(14) << "changes/s" << setw(16)
+		<< "longest (ms)" << setw(8) << "scans" << endl;
+	for (int s = 0; s < 2; s++)
+	{
+		bool hasScans = (s == 1);
+		{
+			LockedTwoThreeTree lockedTree;
+			lockedTree.addAll(&firstEntries[0], numEntries);
+			timeChangesDuringScans("locked tree", lockedTree, entries, hasScans);
+		}
+		{
+			ConcurrentTwoThreeTree<MediaEntry> concurrentTree;
+			concurrentTree.addAll(&firstEntries[0], numEntries);
+			timeChangesDuringScans("concurrent tree", concurrentTree, entries, hasScans);
+		}
+	}
+}
+
+template <class Query>
+double timeQueries(int numQueries, Query&& query, long& numFound)
+{
+	double bestTime = 0;
+	for (int r = 0; r < NUM_REPEATS; r++)
+	{
+		numFound = 0;
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		for (int i = 0; i < numQueries; i++)
+			numFound += query(i);
+
+		double time = getSeconds(start);
+		if (r == 0 || time < bestTime)
+			bestTime = time;
+	}
+
+	return bestTime / numQueries * 1e6;
+}
+
+void benchRanges(int numEntries)
+{
+	vector<MediaEntry> entries;
+	makeEntries(numEntries, entries);
+	TwoThreeTree<MediaEntry> tree;
+	tree.addAll(&entries[0], numEntries);
+	HashTable<MediaEntry> table;
+	for (int i = 0; i < numEntries; i++)
+		table.add(entries[i]);
+
+	mt19937 generator(1);
+	vector<MediaEntry> lows, highs;
+	long numFound = 0;
+	int countFound = 0; //Counted by the visits of the queries
+	auto count = [&countFound](const MediaEntry&) { countFound++; return true; };
+
+	cout << "Microseconds per query, " << numEntries << " entries" << endl;
+	cout << setw(10) << "in range" << setw(14) << "tree range" << setw(14) << "tree scan"
+		<< setw(14) << "hash scan" << endl;
+	for (int k = 0; k < NUM_RANGE_SIZES && RANGE_SIZES[k] < numEntries; k++)
+	{
+		lows.clear();
+		highs.clear();
+		for (int i = 0; i < NUM_RANGE_QUERIES; i++) //[low, high) holds RANGE_SIZES[k] entries
+		{
+			int first = generator() % (numEntries - RANGE_SIZES[k]);
+			lows.push_back(entries[first]);
+			highs.push_back(entries[first + RANGE_SIZES[k]]);
+		}
+
+		cout << setw(10) << RANGE_SIZES[k] << fixed << setprecision(1);
+		cout << setw(14) << timeQueries(NUM_RANGE_QUERIES, [&](int i)
+			{ countFound = 0; tree.forEachInRange(&lows[i], &highs[i], count); return countFound; },
+			numFound);
+		cout << setw(14) << timeQueries(NUM_SCAN_QUERIES, [&](int i)
+			{
+				countFound = 0;
+				tree.forEach([&](const MediaEntry& media)
+					{ countFound += (!(media < lows[i]) && media < highs[i]); return true; });
+				return countFound;
+			}, numFound);
+		cout << setw(14) << timeQueries(NUM_SCAN_QUERIES, [&](int i)
+			{ countFound = 0; table.forEachInRange(&lows[i], &highs[i], count); return countFound; },
+			numFound);
+		cout << endl;
+	}
+
+	cout << endl << setw(10) << "letters" << setw(14) << "found" << setw(14) << "tree range"
+		<< setw(14) << "hash scan" << endl;
+	for (int numLetters = 1; numLetters <= MAX_PREFIX_LETTERS; numLetters++)
+	{
+		lows.clear();
+		highs.clear();
+		char title[MAX_TITLE_LENGTH];
+		for (int i = 0; i < NUM_RANGE_QUERIES; i++) //Prefixes of random titles, from a movie (the
+		{					   //lowest type) to the first title past them
+			const MediaEntry& media = entries[generator() % numEntries];
+			for (int c = 0; c < numLetters; c++)
+				title[c] = media[c];
+			title[numLetters] = '\0';
+			lows.push_back(MediaEntry(title, 'M'));
+			highs.push_back(MediaEntry());
+			lows.back().getPrefixBound(highs.back());
+		}
+
+		double rangeTime = timeQueries(NUM_RANGE_QUERIES, [&](int i)
+			{ countFound = 0; tree.forEachInRange(&lows[i], &highs[i], count); return countFound; },
+			numFound);
+		cout << setw(10) << numLetters << setw(14) << numFound / NUM_RANGE_QUERIES << setw(14)
+			<< rangeTime;
+		cout << setw(14) << timeQueries(NUM_SCAN_QUERIES, [&](int i)
+			{ countFound = 0; table.forEachInRange(&lows[i], &highs[i], count); return countFound; },
+			numFound);
+		cout << endl;
+	}
+}
+
+void countEntry(MediaEntry& media)
+{
+	numVisited += media.length(); //Reads the entry, as a caller of traverse would
+}
+
+template <class Structure>
+void timeScans(const char* name, const Structure& structure)
+{
+	long numFound = 0;
+	double numEntries = structure.getNumberOfItems();
+
+	cout << setw(8) << left << name << right << fixed << setprecision(1);
+	cout << setw(12) << timeQueries(NUM_SCANS, [&](int)
+		{ numVisited = 0; structure.traverse(countEntry); return numVisited; }, numFound) / numEntries * 1e3;
+	cout << setw(12) << timeQueries(NUM_SCANS, [&](int)
+		{
+			long numRead = 0;
+			structure.forEach([&numRead](const MediaEntry& media) { numRead += media.length(); return true; });
+			return numRead;
+		}, numFound) / numEntries * 1e3;
+	cout << setw(12) << timeQueries(NUM_SCANS, [&](int)
+		{
+			long numRead = 0;
+			for (const MediaEntry& media : structure)
+				numRead += media.length();
+			return numRead;
+		}, numFound) / numEntries * 1e3;
+	cout << endl;
+}
+
+void benchScans(int numEntries)
+{
+	vector<MediaEntry> entries;
+	makeEntries(numEntries, entries);
+
+	cout << "ns per entry, scans of " << numEntries << " entries" << endl;
+	cout << setw(8) << "" << setw(12) << "traverse" << setw(12) << "forEach" << setw(12) << "iterator"
+		<< endl;
+	{
+		TwoThreeTree<MediaEntry> tree;
+		tree.addAll(&entries[0], numEntries);
+		timeScans("tree", tree);
+	}
+	{
+		HashTable<MediaEntry> table;
+		for (int i = 0; i < numEntries; i++)
+			table.add(entries[i]);
+		timeScans("hash", table);
+	}
+	{
+		RadixTree<MediaEntry> radixTree;
+		radixTree.addAll(&entries[0], numEntries);
+		timeScans("radix", radixTree);
+	}
+}
+
+void readEntry(MediaEntry& media)
+{
+	numRead += media.length();
+}
+
+template <class Pass>
+void timePasses(const char* name, Pass&& pass)
+{
+	long numFound = 0;
+
+	cout << setw(18) << left << name << right << fixed << setprecision(1);
+	cout << setw(8) << timeQueries(1, [&](int) { pass(NULL); return 0; }, numFound) / 1e3;
+	for (int n = 0; n < NUM_THREAD_COUNTS; n++)
+	{
+		ThreadPool pool(THREAD_COUNTS[n]);
+		cout << setw(8) << timeQueries(1, [&](int) { pass(&pool); return 0; }, numFound) / 1e3;
+	}
+	cout << endl;
+}
+
+void benchThreads(int numEntries)
+{
+	vector<MediaEntry> entries;
+	makeEntries(numEntries, entries);
+	TwoThreeTree<MediaEntry> tree;
+	tree.addAll(&entries[0], numEntries);
+	HashTable<MediaEntry> table;
+	for (int i = 0; i < numEntries; i++)
+		table.add(entries[i]);
+
+	cout << "Milliseconds per pass, " << numEntries << " entries, " << thread::hardware_concurrency()
+		<< " hardware threads" << endl;
+	cout << setw(18) << left << "workers" << right << setw(8) << "none";
+	for (int n = 0; n < NUM_THREAD_COUNTS; n++)
+		cout << setw(8) << THREAD_COUNTS[n];
+	cout << endl;
+
+	timePasses("tree traverse", [&](ThreadPool* poolPtr)
+	{
+		if (poolPtr == NULL)
+			tree.traverse(readEntry);
+		else
+			tree.parallelTraverse(readEntry, *poolPtr);
+	});
+	timePasses("tree export", [&](ThreadPool* poolPtr)
+	{
+		ostringstream outFile;
+		if (poolPtr == NULL)
+			tree.writeToFile(outFile);
+		else
+			tree.writeToFile(outFile, *poolPtr);
+	});
+	timePasses("tree statistics", [&](ThreadPool* poolPtr)
+	{
+		ostringstream os;
+		if (poolPtr == NULL)
+			tree.displayStatistics(os);
+		else
+			tree.displayStatistics(os, *poolPtr);
+	});
+	timePasses("hash export", [&](ThreadPool* poolPtr)
+	{
+		ostringstream outFile;
+		if (poolPtr == NULL)
+			table.writeToFile(outFile);
+		else
+			table.writeToFile(outFile, *poolPtr);
+	});
+	timePasses("hash statistics", [&](ThreadPool* poolPtr)
+	{
+		ostringstream os;
+		if (poolPtr == NULL)
+			table.displayStatistics(os);
+		else
+			table.displayStatistics(os, *poolPtr);
+	});
+}
+
+template <class Structure, class Operation>
+double timeChange(const vector<MediaEntry>& items, Operation&& operation)
+{
+	double bestTime = 0;
+	for (int r = 0; r < NUM_REPEATS; r++)
+	{
+		Structure structure;
+		for (int i = 0; i < (int)items.size(); i++) //The same way for every structure, so the
+			structure.add(items[i]);		    //layout in memory is alike
+
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		operation(structure);
+
+		double time = getSeconds(start);
+		if (r == 0 || time < bestTime)
+			bestTime = time;
+	}
+
+	return bestTime * 1e3;
+}
+
+template <class Structure>
+void timeSetOperations(const char* name, const vector<MediaEntry>& firstItems,
+			const vector<MediaEntry>& secondItems)
+{
+	Structure other;
+	for (int i = 0; i < (int)secondItems.size(); i++)
+		other.add(secondItems[i]);
+
+	double times[3][2]; //Loop, then set operation, for the union, intersection and difference
+	times[0][0] = timeChange<Structure>(firstItems, [&](Structure& structure)
+	{
+		for (int i = 0; i < (int)secondItems.size(); i++)
+		{
+			if (!structure.contains(secondItems[i]))
+				structure.add(secondItems[i]);
+		}
+	});
+	times[0][1] = timeChange<Structure>(firstItems, [&](Structure& structure) { structure.mergeFrom(other); });
+	times[1][0] = timeChange<Structure>(firstItems, [&](Structure& structure)
+	{
+		Structure common; //Can't be changed while it is traversed
+		structure.forEach([&](const MediaEntry& media)
+		{
+			if (other.contains(media))
+				common.add(media);
+			return true;
+		});
+		structure.takeSnapshot(common);
+	});
+	times[1][1] = timeChange<Structure>(firstItems, [&](Structure& structure) { structure.intersectWith(other); });
+	times[2][0] = timeChange<Structure>(firstItems, [&](Structure& structure)
+	{
+		for (int i = 0; i < (int)secondItems.size(); i++)
+			structure.remove(secondItems[i]);
+	});
+	times[2][1] = timeChange<Structure>(firstItems, [&](Structure& structure) { structure.difference(other); });
+
+	const char* operationNames[3] = {"union", "intersection", "difference"};
+	for (int i = 0; i < 3; i++)
+	{
+		cout << setw(6) << left << name << setw(14) << operationNames[i] << right << fixed
+			<< setprecision(1) << setw(10) << times[i][0] << setw(10) << times[i][1] << setw(9)
+			<< times[i][0] / times[i][1] << "x" << endl;
+	}
+}
+
+void benchSetOperations(int numEntries)
+{
+	vector<MediaEntry> entries; //Every third entry is in the first set, the second set,
+	makeEntries(numEntries / 2 * 3, entries); //or both
+	vector<MediaEntry> firstItems, secondItems;
+	for (int i = 0; i < (int)entries.size(); i++)
+	{
+		if (i % 3 != 2)
+			firstItems.push_back(entries[i]);
+		if (i % 3 != 0)
+			secondItems.push_back(entries[i]);
+	}
+
+	vector<MediaEntry> fewItems; //Small enough for the 2-3 tree to change one item at a time
+	for (int i = 0; i < (int)secondItems.size(); i += SMALL_SET_RATIO)
+		fewItems.push_back(secondItems[i]);
+
+	cout << "Milliseconds, two sets of " << firstItems.size() << " entries sharing half of them" << endl;
+	cout << setw(20) << "" << setw(10) << "loop" << setw(10) << "set op" << setw(10) << "speedup" << endl;
+	timeSetOperations<TwoThreeTree<MediaEntry> >("tree", firstItems, secondItems);
+	timeSetOperations<HashTable<MediaEntry> >("hash", firstItems, secondItems);
+
+	cout << endl << "Milliseconds, sets of " << firstItems.size() << " and " << fewItems.size()
+		<< " entries" << endl;
+	cout << setw(20) << "" << setw(10) << "loop" << setw(10) << "set op" << setw(10) << "speedup" << endl;
+	timeSetOperations<TwoThreeTree<MediaEntry> >("tree", firstItems, fewItems);
+	timeSetOperations<HashTable<MediaEntry> >("hash", firstItems, fewItems);
+}
+
+template <class Structure>
+void timeExport(const char* name, const Structure& structure)
+{
+	long numFound = 0;
+	double flushedTime = timeQueries(1, [&](int)
+	{
+		ofstream outFile(EXPORT_FILE_NAME);
+		structure.forEach([&](const MediaEntry& media)
+		{
+			outFile << media << endl; //Same output as writeToFile
+			outFile << media.getMediaType() << endl;
+			return true;
+		});
+		return 0;
+	}, numFound) / 1e3;
+	double bufferedTime = timeQueries(1, [&](int)
+	{
+		ofstream outFile(EXPORT_FILE_NAME);
+		structure.writeToFile(outFile);
+		return 0;
+	}, numFound) / 1e3;
+
+	cout << setw(6) << left << name << right << fixed << setprecision(1) << setw(10) << flushedTime
+		<< setw(10) << bufferedTime << setw(9) << flushedTime / bufferedTime << "x" << endl;
+}
+
+void benchExport(int numEntries)
+{
+	vector<MediaEntry> entries;
+	makeEntries(numEntries, entries);
+	TwoThreeTree<MediaEntry> tree;
+	tree.addAll(&entries[0], numEntries);
+	HashTable<MediaEntry> table;
+	for (int i = 0; i < numEntries; i++)
+		table.add(entries[i]);
+
+	cout << "Milliseconds to write " << numEntries << " entries to " << EXPORT_FILE_NAME << endl;
+	cout << setw(6) << "" << setw(10) << "flushed" << setw(10) << "buffered" << setw(10) << "speedup"
+		<< endl;
+	timeExport("tree", tree);
+	timeExport("hash", table);
+
+	remove(EXPORT_FILE_NAME);
+}
+
+template <class Operation>
+void countCopies(const char* name, int numEntries, Operation&& operation)
+{
+	MediaEntry::resetCopyCounters();
+	operation();
+
+	cout << setw(16) << left << name << right << setw(14) << fixed << setprecision(2)
+		<< (double)MediaEntry::getNumTitleAllocations() / numEntries << setw(14)
+		<< (double)MediaEntry::getNumTitleBytesCopied() / numEntries << endl;
+}
+
+template <class Structure>
+void countStructureCopies(const char* name, const vector<MediaEntry>& entries,
+				const vector<MediaEntry>& shuffled)
+{
+	int numEntries = entries.size();
+	string prefix(name);
+	long numFound = 0; //Used, so the lookups aren't optimized away
+
+	Structure loaded;
+	countCopies((prefix + " load").c_str(), numEntries, [&loaded, &entries, numEntries]()
+	{
+		loaded.addAll(&entries[0], numEntries);
+	});
+
+	Structure structure;
+	countCopies((prefix + " add").c_str(), numEntries, [&structure, &shuffled]()
+	{
+		for (const MediaEntry& media : shuffled)
+			structure.add(media);
+	});
+	countCopies((prefix + " lookup").c_str(), numEntries, [&structure, &shuffled, &numFound]()
+	{
+		for (const MediaEntry& media : shuffled)
+			numFound += structure.contains(media);
+	});
+	countCopies((prefix + " export").c_str(), numEntries, [&structure]()
+	{
+		ostringstream out;
+		structure.writeToFile(out);
+	});
+	countCopies((prefix + " remove").c_str(), numEntries, [&structure, &shuffled]()
+	{
+		for (const MediaEntry& media : shuffled)
+			structure.remove(media);
+	});
+
+	if (numFound < 0)
+		cout << endl;
+}
+
+void benchCopies(int numEntries)
+{
+	vector<MediaEntry> entries;
+	makeEntries(numEntries, entries);
+	vector<MediaEntry> shuffled(entries);
+	mt19937 random(1);
+	shuffle(shuffled.begin(), shuffled.end(), random);
+
+	cout << "Copies per entry, " << numEntries << " entries of " << entries[0].length() << " characters"
+		<< endl;
+	cout << setw(16) << "" << setw(14) << "allocations" << setw(14) << "characters" << endl;
+	countStructureCopies<TwoThreeTree<MediaEntry> >("tree", entries, shuffled);
+	countStructureCopies<HashTable<MediaEntry> >("hash", entries, shuffled);
+}
+
+vector<double> makeZipfLookups(int numTitles, int numLookups, vector<MediaEntry>& lookups)
+{
+	vector<double> weights(numTitles); //Sum of the weights of the ranks up to each one
+	double totalWeight = 0;
+	for (int r = 0; r < numTitles; r++)
+	{
+		totalWeight += 1 / pow(r + 1, ZIPF_EXPONENT);
+		weights[r] = totalWeight;
+	}
+
+	vector<int> titles(numTitles); //Title of each rank
+	for (int r = 0; r < numTitles; r++)
+		titles[r] = r;
+	mt19937 random(1);
+	shuffle(titles.begin(), titles.end(), random);
+
+	const char mediaTypes[] = "MTS"; //The same types as makeEntries gives the titles
+	uniform_real_distribution<double> draw(0, totalWeight);
+	char title[MAX_TITLE_LENGTH];
+	lookups.clear();
+	for (int i = 0; i < numLookups; i++)
+	{
+		int r = lower_bound(weights.begin(), weights.end(), draw(random)) - weights.begin();
+		int number = titles[min(r, numTitles - 1)];
+		makeTitle(number, title);
+		lookups.push_back(MediaEntry(title, mediaTypes[number % 3]));
+	}
+
+	vector<double> shares;
+	for (int c = 0; c < NUM_CACHE_SIZES; c++)
+		shares.push_back(CACHE_SIZES[c] > 0 ? weights[min(CACHE_SIZES[c], numTitles) - 1] / totalWeight : 0);
+
+	return shares;
+}
+
+void benchCache(int numEntries)
+{
+	vector<MediaEntry> entries;
+	makeEntries(numEntries, entries);
+	MediaLibrary<TwoThreeTree> library(1);
+	library.addEntries(&entries[0], numEntries);
+
+	vector<MediaEntry> lookups; //Titles numEntries and up aren't in the library
+	vector<double> shares = makeZipfLookups(2 * numEntries, NUM_CACHE_LOOKUPS, lookups);
+
+	cout << "ns per lookup, " << numEntries << " entries, Zipf exponent " << ZIPF_EXPONENT << endl;
+	cout << setw(20) << "cached entries";
+	for (int c = 0; c < NUM_CACHE_SIZES; c++)
+		cout << setw(10) << CACHE_SIZES[c];
+	cout << endl << setw(20) << "popular share (%)";
+	for (int c = 0; c < NUM_CACHE_SIZES; c++)
+		cout << setw(10) << fixed << setprecision(1) << shares[c] * 100;
+	cout << endl;
+
+	long numFound = 0; //Used, so the lookups aren't optimized away
+	for (int k = 0; k < 2; k++) //contains, then getEntry
+	{
+		cout << setw(20) << (k == 0 ? "contains" : "getEntry");
+		for (int c = 0; c < NUM_CACHE_SIZES; c++)
+		{
+			library.setLookupCache(CACHE_SIZES[c]); //Starts out empty, and fills during the first
+			double bestTime = 0;			//repetition
+			for (int r = 0; r < NUM_REPEATS; r++)
+			{
+				chrono::steady_clock::time_point start = chrono::steady_clock::now();
+				for (int i = 0; i < NUM_CACHE_LOOKUPS; i++)
+				{
+					if (k == 0)
+						numFound += library.contains(lookups[i]);
+					else
+					{
+						try
+						{
+							numFound += library.getEntry(lookups[i]).length();
+						}
+						catch (NotFoundException&)
+						{
+						}
+					}
+				}
+
+				double time = getSeconds(start);
+				if (r == 0 || time < bestTime)
+					bestTime = time;
+			}
+			cout << setw(10) << (int)(bestTime / NUM_CACHE_LOOKUPS * 1e9);
+		}
+		cout << endl;
+	}
+	cout << (numFound < 0 ? " " : "");
+}
+
+void makeWordEntries(int numEntries, vector<MediaEntry>& entries)
+{
+	const char mediaTypes[] = "MTS";
+	char words[3][MAX_TITLE_LENGTH];
+	char title[3 * MAX_TITLE_LENGTH];
+	mt19937 random(1);
+
+	entries.clear();
+	entries.reserve(numEntries);
+	for (int i = 0; i < numEntries; i++)
+	{
+		makeTitle(random() % NUM_COMMON_WORDS, words[0]);
+		makeTitle(random() % NUM_COMMON_WORDS, words[1]);
+		makeTitle(NUM_COMMON_WORDS + i, words[2]); //Past the common words, so it is only in this title
+		sprintf(title, "%s %s %s", words[0], words[1], words[2]);
+		entries.push_back(MediaEntry(title, mediaTypes[i % 3]));
+	}
+	sort(entries.begin(), entries.end());
+}
+
+void countFound(const MediaEntry& media)
+{
+	numVisited += media.length();
+}
+
+void benchWords(int numEntries)
+{
+	vector<MediaEntry> entries;
+	makeWordEntries(numEntries, entries);
+	MediaLibrary<TwoThreeTree> library(1);
+	library.addEntries(&entries[0], numEntries);
+
+	const int numKinds = 3;
+	const char* kindNames[numKinds] = {"1 common word", "2 common words", "1 rare word"};
+	vector<string> texts[numKinds];
+	mt19937 random(2);
+	char word[MAX_TITLE_LENGTH], otherWord[MAX_TITLE_LENGTH];
+	for (int i = 0; i < NUM_WORD_QUERIES; i++)
+	{
+		makeTitle(random() % NUM_COMMON_WORDS, word);
+		makeTitle(random() % NUM_COMMON_WORDS, otherWord);
+		texts[0].push_back(word);
+		texts[1].push_back(string(word) + " " + otherWord);
+		makeTitle(NUM_COMMON_WORDS + random() % numEntries, word);
+		texts[2].push_back(word);
+	}
+
+	cout << "Microseconds per query, " << numEntries << " entries of 3 words, " << NUM_COMMON_WORDS
+		<< " common words" << endl;
+	cout << setw(16) << "" << setw(10) << "found" << setw(14) << "index" << setw(14) << "scan"
+		<< endl;
+	long numFound = 0;
+	for (int k = 0; k < numKinds; k++)
+	{
+		library.setWordIndex(true);
+		double indexTime = timeQueries(NUM_WORD_QUERIES, [&](int i)
+			{ return library.findWords(texts[k][i].c_str(), countFound); }, numFound);
+		double foundPerQuery = (double)numFound / NUM_WORD_QUERIES;
+		library.setWordIndex(false);
+		double scanTime = timeQueries(NUM_SCAN_QUERIES, [&](int i)
+			{ return library.findWords(texts[k][i].c_str(), countFound); }, numFound);
+
+		cout << setw(16) << kindNames[k] << fixed << setprecision(1) << setw(10) << foundPerQuery
+			<< setw(14) << indexTime << setw(14) << scanTime << endl;
+	}
+}
+
+void countClosest(const MediaEntry& media, int distance)
+{
+	numVisited += media.length() + distance;
+}
+
+void timeFuzzyQueries(const vector<MediaEntry>& entries, int numEntries)
+{
+	vector<MediaEntry> libraryEntries(entries.begin(), entries.begin() + numEntries);
+	sort(libraryEntries.begin(), libraryEntries.end());
+	MediaLibrary<TwoThreeTree> library(1);
+	library.addEntries(&libraryEntries[0], numEntries);
+	FuzzyIndex index; //Built apart, for the number of candidates
+	for (int i = 0; i < numEntries; i++)
+		index.add(entries[i]);
+
+	mt19937 random(2);
+	for (int numTypos = 1; numTypos <= MAX_TYPOS; numTypos++)
+	{
+		vector<string> titles; //Titles of the library with numTypos letters replaced by others
+		for (int i = 0; i < NUM_FUZZY_QUERIES; i++)
+		{
+			const MediaEntry& media = entries[random() % numEntries];
+			string title;
+			for (int c = 0; c < media.length(); c++)
+				title += media[c];
+			for (int t = 0; t < numTypos; t++)
+			{
+				int position;
+				do
+					position = random() % title.length();
+				while (!isalpha(title[position]));
+				title[position] = 'a' + (tolower(title[position]) - 'a' + 1 + random() % 25) % 26;
+			}
+			titles.push_back(title);
+		}
+
+		long numCandidates = 0;
+		for (int i = 0; i < NUM_FUZZY_QUERIES; i++)
+		{
+			int queryCandidates;
+			index.find(titles[i].c_str(), MAX_TYPOS, NUM_CLOSEST, countClosest, queryCandidates);
+			numCandidates += queryCandidates;
+		}
+
+		long numFound = 0;
+		library.setFuzzyIndex(true);
+		double indexTime = timeQueries(NUM_FUZZY_QUERIES, [&](int i)
+			{ return library.findClosest(titles[i].c_str(), MAX_TYPOS, NUM_CLOSEST, countClosest); },
+			numFound);
+		double foundPerQuery = (double)numFound / NUM_FUZZY_QUERIES;
+		library.setFuzzyIndex(false);
+		double scanTime = timeQueries(NUM_SCAN_QUERIES, [&](int i)
+			{ return library.findClosest(titles[i].c_str(), MAX_TYPOS, NUM_CLOSEST, countClosest); },
+			numFound);
+
+		cout << setw(10) << numEntries << setw(8) << numTypos << fixed << setprecision(1) << setw(12)
+			<< (double)numCandidates / NUM_FUZZY_QUERIES << setw(10) << foundPerQuery << setw(14)
+			<< indexTime << setw(14) << scanTime << endl;
+	}
+}
+
+void benchFuzzy(int numEntries)
+{
+	vector<MediaEntry> entries;
+	makeWordEntries(numEntries, entries);
+	mt19937 random(1);
+	shuffle(entries.begin(), entries.end(), random); //So the smaller library has titles of every kind
+
+	cout << "Microseconds per query, titles of 3 words, at most " << MAX_TYPOS << " edits, "
+		<< NUM_CLOSEST << " results" << endl;
+	cout << setw(10) << "entries" << setw(8) << "typos" << setw(12) << "candidates" << setw(10)
+		<< "found" << setw(14) << "index" << setw(14) << "scan" << endl;
+	timeFuzzyQueries(entries, max(numEntries / 10, 1));
+	timeFuzzyQueries(entries, numEntries);
+}
+
+template <class MakeLibrary>
+void timeLibrary(const string& name, const vector<MediaEntry>& entries, const vector<MediaEntry>& lookups,
+			MakeLibrary&& makeLibrary)
+{
+	int numEntries = entries.size();
+	int numLookups = lookups.size();
+	double bestLoad = 0, bestContains = 0, bestBatches = 0;
+	long numFound = 0; //Used, so the lookups aren't optimized away
+	bool results[SHARD_BATCH_SIZE];
+	for (int r = 0; r < NUM_REPEATS; r++)
+	{
+		MediaLibraryInterface* libraryPtr = makeLibrary();
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		libraryPtr->addEntries(&entries[0], numEntries);
+		double loadTime = getSeconds(start);
+
+		start = chrono::steady_clock::now();
+		for (int i = 0; i < numLookups; i++)
+			numFound += libraryPtr->contains(lookups[i]);
+		double containsTime = getSeconds(start);
+
+		start = chrono::steady_clock::now();
+		for (int i = 0; i + SHARD_BATCH_SIZE <= numLookups; i += SHARD_BATCH_SIZE)
+			numFound += libraryPtr->containsMany(&lookups[i], SHARD_BATCH_SIZE, results);
+		double batchTime = getSeconds(start);
+		delete libraryPtr;
+
+		if (r == 0 || loadTime < bestLoad)
+			bestLoad = loadTime;
+		if (r == 0 || containsTime < bestContains)
+			bestContains = containsTime;
+		if (r == 0 || batchTime < bestBatches)
+			bestBatches = batchTime;
+	}
+
+	int numBatched = numLookups / SHARD_BATCH_SIZE * SHARD_BATCH_SIZE;
+	cout << setw(16) << name << fixed << setprecision(1) << setw(12) << bestLoad * 1e3 << setw(12)
+		<< (int)(bestContains / numLookups * 1e9) << setw(14) << (int)(bestBatches / numBatched * 1e9)
+		<< (numFound < 0 ? " " : "") << endl;
+}
+
+void benchShards(int numEntries)
+{
+	vector<MediaEntry> entries;
+	makeEntries(numEntries, entries);
+	mt19937 random(1);
+	vector<MediaEntry> lookups; //Every one in the library
+	for (int i = 0; i < NUM_LOOKUPS; i++)
+		lookups.push_back(entries[random() % numEntries]);
+
+	cout << "Load in ms and ns per lookup, " << numEntries << " entries, " << thread::hardware_concurrency()
+		<< " hardware threads" << endl;
+	cout << setw(16) << "" << setw(12) << "load" << setw(12) << "contains" << setw(14) << "containsMany"
+		<< endl;
+	timeLibrary("tree library", entries, lookups, []() { return new MediaLibrary<TwoThreeTree>(1); });
+	for (int t = 0; t < NUM_THREAD_COUNTS; t++)
+		timeLibrary("tree " + to_string(THREAD_COUNTS[t]) + " shards", entries, lookups,
+			[t]() { return new ShardedLibrary<TwoThreeTree>(THREAD_COUNTS[t]); });
+	timeLibrary("hash library", entries, lookups, []() { return new MediaLibrary<HashTable>(1); });
+	for (int t = 0; t < NUM_THREAD_COUNTS; t++)
+		timeLibrary("hash " + to_string(THREAD_COUNTS[t]) + " shards", entries, lookups,
+			[t]() { return new ShardedLibrary<HashTable>(THREAD_COUNTS[t]); });
+}
+
+double runLoggedChanges(const vector<MediaEntry>& entries, int numThreads, int commitWindow)
+{
+	LoggedLibrary::removeFiles(LOG_FILE_NAME); //Nothing left to replay from an earlier run
+	LoggedLibrary* libraryPtr = new LoggedLibrary(new MediaLibrary<TwoThreeTree>(1), LOG_FILE_NAME);
+	DurabilityPolicy policy;
+	policy.commitWindow = commitWindow;
+	policy.checkpointSize = 0;
+	libraryPtr->setDurabilityPolicy(policy);
+
+	vector<thread> threads;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (int t = 0; t < numThreads; t++)
+		threads.push_back(thread([libraryPtr, &entries, numThreads, t]()
+		{
+			for (int i = t; i < NUM_LOGGED_CHANGES; i += numThreads)
+				libraryPtr->addEntry(entries[i]);
+		}));
+	for (thread& changer : threads)
+		changer.join();
+	double time = getSeconds(start);
+
+	delete libraryPtr;
+	LoggedLibrary::removeFiles(LOG_FILE_NAME);
+	return NUM_LOGGED_CHANGES / time;
+}
+
+void benchLogging(int)
+{
+	vector<MediaEntry> entries;
+	makeEntries(NUM_LOGGED_CHANGES, entries);
+
+	cout << "Changes per second, " << NUM_LOGGED_CHANGES << " entries added, each synced" << endl;
+	cout << setw(16) << "window (us)";
+	for (int t = 0; t < NUM_THREAD_COUNTS; t++)
+		cout << setw(8) << THREAD_COUNTS[t] << (t == 0 ? " thread " : " threads");
+	cout << endl;
+	for (int w = 0; w < NUM_COMMIT_WINDOWS; w++)
+	{
+		cout << setw(16) << COMMIT_WINDOWS[w];
+		for (int t = 0; t < NUM_THREAD_COUNTS; t++)
+			cout << setw(16) << (int)runLoggedChanges(entries, THREAD_COUNTS[t], COMMIT_WINDOWS[w]);
+		cout << endl;
+	}
+}
+
+size_t getHeapBytes()
+{
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+	struct mallinfo2 heap = mallinfo2();
+	return heap.uordblks + heap.hblkhd; //Large blocks are mapped apart
+#else
+	return 0;
+#endif
+}
+
+template <class Structure>
+void measureStructure(const char* name, const vector<MediaEntry>& entries, const vector<MediaEntry>& shuffled,
+			const vector<MediaEntry>& lookups, double arrayBytes)
+{
+	int numEntries = entries.size();
+	size_t heapBytes = getHeapBytes();
+	Structure* structurePtr = new Structure;
+	structurePtr->addAll(&entries[0], numEntries);
+	double bytes = (double)(getHeapBytes() - heapBytes) / numEntries;
+
+	long numFound = 0;
+	double lookupTime = timeQueries(lookups.size(), [structurePtr, &lookups](int i)
+		{ return structurePtr->contains(lookups[i]); }, numFound);
+	delete structurePtr;
+
+	double addTime = 0, removeTime = 0; //Built anew for each repetition, as the adds change it
+	bool isChangeable = true;
+	for (int r = 0; r < NUM_REPEATS && isChangeable; r++)
+	{
+		structurePtr = new Structure;
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		for (int i = 0; i < numEntries; i++)
+			isChangeable = structurePtr->add(shuffled[i]) && isChangeable;
+		double time = getSeconds(start);
+		if (r == 0 || time < addTime)
+			addTime = time;
+
+		start = chrono::steady_clock::now();
+		for (int i = 0; i < numEntries; i++)
+			structurePtr->remove(shuffled[i]);
+		time = getSeconds(start);
+		if (r == 0 || time < removeTime)
+			removeTime = time;
+		delete structurePtr;
+	}
+
+	cout << setw(10) << name << fixed << setprecision(1) << setw(12) << bytes << setw(12)
+		<< bytes - arrayBytes;
+	if (isChangeable)
+		cout << setw(10) << (int)(addTime / numEntries * 1e9);
+	else
+		cout << setw(10) << "-";
+	cout << setw(10) << (int)(lookupTime * 1e3);
+	if (isChangeable)
+		cout << setw(10) << (int)(removeTime / numEntries * 1e9);
+	else
+		cout << setw(10) << "-";
+	cout << endl;
+}
+
+void benchMemory(int numEntries)
+{
+	size_t heapBytes = getHeapBytes();
+	vector<MediaEntry> entries;
+	makeEntries(numEntries, entries);
+	double arrayBytes = (double)(getHeapBytes() - heapBytes) / numEntries;
+
+	mt19937 random(1);
+	vector<MediaEntry> lookups; //Every one in the data structures
+	for (int i = 0; i < NUM_LOOKUPS; i++)
+		lookups.push_back(entries[random() % numEntries]);
+	vector<MediaEntry> shuffled(entries);
+	shuffle(shuffled.begin(), shuffled.end(), random);
+
+	cout << "Heap bytes per entry and ns per operation, " << numEntries << " entries of "
+		<< entries[0].length() << " characters" << endl;
+	cout << setw(10) << "" << setw(12) << "bytes" << setw(12) << "over array" << setw(10) << "add"
+		<< setw(10) << "contains" << setw(10) << "remove" << endl;
+	cout << setw(10) << "array" << fixed << setprecision(1) << setw(12) << arrayBytes << endl;
+	measureStructure<TwoThreeTree<MediaEntry> >("tree", entries, shuffled, lookups, arrayBytes);
+	measureStructure<HashTable<MediaEntry> >("hash", entries, shuffled, lookups, arrayBytes);
+	measureStructure<FrozenIndex<MediaEntry> >("frozen", entries, shuffled, lookups, arrayBytes);
+	measureStructure<RadixTree<MediaEntry> >("radix", entries, shuffled, lookups, arrayBytes);
+	measureStructure<HybridIndex<MediaEntry> >("hybrid", entries, shuffled, lookups, arrayBytes);
+}
@@ -1,8 +1,19 @@
 #include <iostream>
 #include <iomanip>
 #include <fstream>
+#include <cstdlib>
+#include <cctype>
+#include <cstring>
+#include <algorithm>
+#include "AdaptiveLibrary.h"
+#include "ConcurrentTwoThreeTree.h"
 #include "HashTable.h"
+#include "HybridIndex.h"
+#include "LoadGenerator.h"
+#include "LoggedLibrary.h"
 #include "MediaLibrary.h"
+#include "RadixTree.h"
+#include "ShardedLibrary.h"
 #include "TwoThreeTree.h"
 
 /*
@@ -24,6 +35,9 @@ they can either:
 4. Display the contents of the library
 99. Exit to the main menu
 
+Every entry added or removed is logged next to the library file, so if the program stops before the
+library is saved, the changes are recovered the next time the library is opened.
+
 They can choose to enter 99 in the main menu should they wish to exit the program.
 
 */
@@ -31,6 +45,14 @@ They can choose to enter 99 in the main menu should they wish to exit the progra
 using namespace std;
 
 const int INDENT = 10; //Indentation size for user output
+const int MAX_TEXT_LENGTH = 200; //Maximum length of the text entered by the user, e.g. a title
+const int MAX_TYPOS = 3; //Largest edit distance of the titles suggested when a search misses
+const int MAX_SUGGESTIONS = 5; //Maximum number of titles suggested
+const int LOAD_TEST_REQUESTS = 20000; //Requests submitted by each client of a load test
+const int LOAD_TEST_IN_FLIGHT = 16; //Requests a client of a load test keeps in flight
+const int LOAD_TEST_TITLES = 100000; //Titles the requests of a load test are drawn from
+const double LOAD_TEST_READ_SHARE = 0.8; //Share of lookups among the requests of a load test
+const char NEW_LIBRARY_FILE[] = "newLibrary.txt"; //File the changes to a new library are logged for
 
 //Pauses the program until the user enters a key to continue
 void pause();
@@ -39,18 +61,32 @@ void pause();
 /*
 Gives the user the choice to either open an existing library, or to build a new one from scratch
 @post If the user chooses to open an existing library, constructLibrary is called
-Regardless, the function proceeds to call libraryMenu
+Regardless, the changes to the library are logged from then on (see LoggedLibrary.h), and the
+function proceeds to call libraryMenu. The log files are only removed once the library is saved
+to the file it was opened from, or, for a new library, to any file. All new libraries are logged
+for the same file, so a new library starts empty unless the user chooses to recover the changes
+of the last one, if it wasn't saved.
 @param libraryPtr Pointer to the media library
 */
 void libraryOptions(MediaLibraryInterface* libraryPtr);
 
 
 /*
-Constructs an existing library from an external file that stores its contents
-@post libraryPtr stores the entire contents of the external file
+Constructs an existing library from an external file that stores its contents, or from its
+checkpoint if the program stopped before the library was saved
+@post libraryPtr stores the entire contents of the external file, and fileName holds its name
 @Param libraryPtr Pointer to the media library
+fileName The name of the file entered by the user
 */
-void constructLibrary(MediaLibraryInterface* libraryPtr);
+void constructLibrary(MediaLibraryInterface* libraryPtr, char fileName[]);
+
+/*
+Adds the entries stored in a library file to the library. Used in complement with constructLibrary
+@post libraryPtr stores the entries of inFile, up to the empty line ending them
+@param libraryPtr Pointer to the media library
+inFile The external file storing the library
+*/
+void importLibrary(MediaLibraryInterface* libraryPtr, ifstream& inFile);
 
 /*
 Gets the next media entry from the file storing the library.
@@ -68,14 +104,31 @@ add, search and remove functions below.
 */
 MediaEntry getUserEntry();
 
+/*
+Gets a title from the user, used by display for the prefix and range searches.
+@param prompt The message asking the user for the title
+@return An entry storing the user's title
+*/
+MediaEntry getUserTitle(const char* prompt);
+
+/*
+Gets a line of text from the user, used by runQuery for the predicates of the query.
+@post text holds the line, which is empty if the user only pressed enter
+@param prompt The message asking the user for the text
+text Array of MAX_TEXT_LENGTH characters receiving the text
+*/
+void getUserText(const char* prompt, char text[]);
+
 /*
 Displays a menu giving the user options to interact with the library.
-There are five options: add, search, remove, display and exit
+There are six options: add, search, remove, display, load test and exit
 @post Calls add if the option chosen is add, search if it's search, remove if it's remove,
-display if it's display, and exit if it's exit.
+display if it's display, loadTest if it's load test, and exit if it's exit.
 @param Pointer to the media library
+savedFileName Array of 50 characters receiving the name of the file the library is saved to
+@return True if the library was saved, false otherwise
 */
-void libraryMenu(MediaLibraryInterface* libraryPtr);
+bool libraryMenu(MediaLibraryInterface* libraryPtr, char savedFileName[]);
 
 /*
 Adds a user-defined entry into the library.
@@ -87,11 +140,19 @@ void add(MediaLibraryInterface* libraryPtr);
 /*
 Searches for an existing entry in the libary
 @post The entry is displayed/outputted if it is in the library, otherwise a message is outputted
-telling the user that the item is not found.
+telling the user that the item is not found, followed by the closest titles in the library.
 @param libraryPtr Pointer to the media library
 */
 void search(MediaLibraryInterface* libraryPtr);
 
+/*
+Displays a title suggested when a search misses, used as the visit function of findClosest
+@post The entry, its type and its distance are outputted on their own line
+@param media The entry suggested
+distance The edit distance of its title
+*/
+void displaySuggestion(const MediaEntry& media, int distance);
+
 /*
 Removes a user-defined entry from the library
 @post The user-defined item is removed from the library if it exists, otherwise nothing happens
@@ -100,11 +161,16 @@ Removes a user-defined entry from the library
 void remove(MediaLibraryInterface* libraryPtr);
 
 /*
-Gives the user four options:
+Gives the user nine options:
 1. Display all of the movies
 2. Display all TV shows
 3. Display all music
 4. Display all entries
+5. Display the entries starting with a user-defined prefix
+6. Display the entries within a user-defined range of titles
+7. Display a single page of entries
+8. Display the results of a query combining the options above
+9. Display the entries whose titles have some words
 and then accordingly displays each.
 
 @post The user-selected option is executed
@@ -112,13 +178,48 @@ and then accordingly displays each.
 */
 void display(MediaLibraryInterface* libraryPtr);
 
+/*
+Asks the user for a number of clients, and measures how fast an asynchronous front end (see
+AsyncLibrary.h) serves their random adds, removes and lookups on a snapshot of the library, so
+the library itself is left as it is
+@post The throughput, the latencies and the statistics of the front end are outputted
+@param libraryPtr Pointer to the media library
+*/
+void loadTest(MediaLibraryInterface* libraryPtr);
+
+/*
+Asks the user for the types, prefix, range, text, offset and limit of a query, each of which
+can be left out, then runs the query and displays the entries it returns followed by how it ran
+@post The results of the query and its statistics are outputted
+@param libraryPtr Pointer to the media library
+*/
+void runQuery(MediaLibraryInterface* libraryPtr);
+
+/*
+Displays a media entry returned by a query
+@post The entry is outputted on its own line
+@param media The entry to be displayed
+*/
+void displayMatch(const MediaEntry& media);
+
+/*
+Asks the user for some words and displays every entry whose title has all of them. The word
+index of the library is turned on the first time, so later searches don't go through every entry.
+@post The entries found are outputted
+@param libraryPtr Pointer to the media library
+*/
+void findWords(MediaLibraryInterface* libraryPtr);
+
 /*
 Stores the contents of the library and relevant data structure statistics
 in a user-specified external file and then takes them back to the program menu.
-@post Contents of the library and data structure statistics are stored in an external file.
+@post Contents of the library and data structure statistics are stored in an external file,
+unless the file can't be written, and the library is deleted either way.
 @param libraryPtr Pointer to the media library
+fileName Array of 50 characters receiving the name of the file entered by the user
+@return True if the library was saved, false otherwise
 */
-void exit(MediaLibraryInterface* libraryPtr);
+bool exit(MediaLibraryInterface* libraryPtr, char fileName[]);
 
 
 
@@ -134,10 +235,15 @@ int main()
 	{
 		do //Prompts user to select an option until a valid input is received
 		{
-			cout << "Please select your choice from the three options below:" << endl;
+			cout << "Please select your choice from the eight options below:" << endl;
 
 			cout << setw(INDENT) << "1. Use a 2-3 Tree to store your media library" << endl;
 			cout << setw(INDENT) << "2. Use a Hash Table to store your media library" << endl;
+			cout << setw(INDENT) << "3. Use an adaptive radix tree to store your media library" << endl;
+			cout << setw(INDENT) << "4. Use both a Hash Table and a 2-3 Tree to store your media library" << endl;
+			cout << setw(INDENT) << "5. Switch between a 2-3 Tree and a Hash Table as your media library is used" << endl;
+			cout << setw(INDENT) << "6. Use several 2-3 Trees, one per hardware thread, to store your media library" << endl;
+			cout << setw(INDENT) << "7. Use a 2-3 Tree that can be read while it is changed to store your media library" << endl;
 			cout << setw(INDENT) << "99. Exit the program" << endl << endl;
 			cout << "Choice: ";
 
@@ -146,14 +252,25 @@ int main()
 			cin.ignore(1000, '\n'); //Clean the input
 			cout << endl << endl;
 
-		} while ((choice != 99) && (choice != 1) && (choice != 2));
+		} while ((choice != 99) && (choice != 1) && (choice != 2) && (choice != 3) && (choice != 4) &&
+				(choice != 5) && (choice != 6) && (choice != 7));
 
 		if (choice != 99)
 		{
 			if (choice == 1)
 				libraryPtr = new MediaLibrary<TwoThreeTree>;
-			else
+			else if (choice == 2)
 				libraryPtr = new MediaLibrary<HashTable>;
+			else if (choice == 3)
+				libraryPtr = new MediaLibrary<RadixTree>;
+			else if (choice == 4)
+				libraryPtr = new MediaLibrary<HybridIndex>;
+			else if (choice == 5)
+				libraryPtr = new AdaptiveLibrary;
+			else if (choice == 6)
+				libraryPtr = new ShardedLibrary<TwoThreeTree>;
+			else
+				libraryPtr = new MediaLibrary<ConcurrentTwoThreeTree>;
 
 			libraryOptions(libraryPtr);
 
@@ -192,43 +309,107 @@ void libraryOptions(MediaLibraryInterface* libraryPtr)
 		cout << endl << endl;
 	} while ((choice != 1) && (choice != 2));
 
+	char fileName[50];
 	if (choice == 1)
-		constructLibrary(libraryPtr);
+		constructLibrary(libraryPtr, fileName);
+	else
+	{
+		strcpy(fileName, NEW_LIBRARY_FILE);
+		int recoverChoice = 2;
+		if (LoggedLibrary::hasFiles(fileName)) //The last new library wasn't saved
+		{
+			do
+			{
+				cout << "The last new media library wasn't saved:" << endl;
+				cout << setw(INDENT) << "1. Recover its changes" << endl;
+				cout << setw(INDENT) << "2. Discard them and start an empty library" << endl << endl;
+				cout << "Choice: ";
+
+				cin >> recoverChoice;
+				cin.clear();
+				cin.ignore(1000, '\n');
+				cout << endl << endl;
+			} while ((recoverChoice != 1) && (recoverChoice != 2));
+		}
+
+		if (recoverChoice == 1)
+		{
+			ifstream inFile(LoggedLibrary::getCheckpointName(fileName).c_str());
+			if (inFile)
+				importLibrary(libraryPtr, inFile);
+		}
+		else //Otherwise the log would replay the changes of the last new library into this one
+			LoggedLibrary::removeFiles(fileName);
+	}
 
-	libraryMenu(libraryPtr);
+	LoggedLibrary* loggedPtr = new LoggedLibrary(libraryPtr, fileName); //Replays the changes not saved
+	if (loggedPtr->getNumberRecovered() > 0)
+	{
+		cout << "Recovered " << loggedPtr->getNumberRecovered() << " changes made since the library was last saved." << endl;
+		pause();
+	}
+
+	char savedFileName[50]; //Any other file keeps the changes from fileName, unless it is new
+	if (libraryMenu(loggedPtr, savedFileName) && (choice == 2 || strcmp(savedFileName, fileName) == 0) &&
+		WriteAheadLog::syncFile(savedFileName))
+		LoggedLibrary::removeFiles(fileName); //The changes are all in the saved file now
 }
 
-void constructLibrary(MediaLibraryInterface* libraryPtr)
+void constructLibrary(MediaLibraryInterface* libraryPtr, char fileName[])
 {
 	system("clear");
 	ifstream inFile;
 
 	do //Asks user to enter the file name of the library
 	{  //Does so until a valid file name is entered
-		char fileName[50];
 		cout << "Please enter the file name with a .txt after: ";
 		cin.get(fileName, 50);
 		cin.clear();
 		cin.ignore(1000, '\n');
 		cout << endl << endl;
 
-		inFile.open(fileName);
+		inFile.open(LoggedLibrary::getCheckpointName(fileName).c_str()); //Left by a session not saved
+		if (!inFile)
+		{
+			inFile.clear();
+			inFile.open(fileName);
+		}
 	}
 	while (!inFile);
 
-	while ((inFile.peek() != '\n')) //Constructs the library until the new line character
-	{				//designating the end of the file is reached
-		MediaEntry temp;
-		getMediaEntry(temp, inFile);
-		libraryPtr->addEntry(temp);
-	}
-
+	importLibrary(libraryPtr, inFile);
 	inFile.close();
 
 	cout << "The contents of your media library were successfully imported." << endl;
 	pause();
 }
 
+void importLibrary(MediaLibraryInterface* libraryPtr, ifstream& inFile)
+{
+	int capacity = 64; //Read every entry first so the library can be built all at once
+	int numEntries = 0;
+	MediaEntry* entries = new MediaEntry[capacity];
+
+	while ((inFile.peek() != '\n')) //Reads the entries until the new line character
+	{				//designating the end of the file is reached
+		if (numEntries == capacity) //Double the array once it is full
+		{
+			MediaEntry* oldEntries = entries;
+			capacity *= 2;
+			entries = new MediaEntry[capacity];
+			for (int i = 0; i < numEntries; i++)
+				entries[i] = oldEntries[i];
+			delete [] oldEntries;
+		}
+
+		getMediaEntry(entries[numEntries], inFile);
+		numEntries++;
+	}
+
+	libraryPtr->addEntries(entries, numEntries); //Construct the library
+	delete [] entries;
+}
+
 void getMediaEntry(MediaEntry& entry, ifstream& inFile)
 {
 	char mediaTitle[200]; char mediaType; //Readsthe title of the entry and type
@@ -240,21 +421,22 @@ void getMediaEntry(MediaEntry& entry, ifstream& inFile)
 	entry.setMediaType(mediaType);
 }
 
-void libraryMenu(MediaLibraryInterface* libraryPtr)
+bool libraryMenu(MediaLibraryInterface* libraryPtr, char savedFileName[])
 {
 	int choice = 0;
 
 	do //Cycles until the user decides to exit and close their library
 	{
 		system("clear");
-		do //Prompts user to select five options until a valid input is received
+		do //Prompts user to select six options until a valid input is received
 		{
-			cout << "Please select your choice from the five options below:" << endl;
+			cout << "Please select your choice from the six options below:" << endl;
 
 			cout << setw(INDENT) << "1. Add a new entry" << endl;
 			cout << setw(INDENT) << "2. Search for an entry" << endl;
 			cout << setw(INDENT) << "3. Remove an entry" << endl;
 			cout << setw(INDENT) << "4. Display" << endl;
+			cout << setw(INDENT) << "5. Measure how fast many clients are served" << endl;
 			cout << setw(INDENT) << "99. Main Menu" << endl << endl;;
 			cout << "Choice: ";
 
@@ -264,7 +446,7 @@ void libraryMenu(MediaLibraryInterface* libraryPtr)
 			cout << endl << endl;
 
 		} while ((choice != 99) && (choice != 1) && (choice != 2) &&
-				(choice != 3) && (choice != 4));
+				(choice != 3) && (choice != 4) && (choice != 5));
 
 		switch (choice) //Calls corresponding functions depending on their choice
 		{
@@ -280,10 +462,13 @@ void libraryMenu(MediaLibraryInterface* libraryPtr)
 		case 4:
 			display(libraryPtr);
 			break;
+		case 5:
+			loadTest(libraryPtr);
+			break;
 		}
 	} while (choice != 99);
 
-	exit(libraryPtr);
+	return exit(libraryPtr, savedFileName);
 }
 
 MediaEntry getUserEntry()
@@ -329,6 +514,26 @@ MediaEntry getUserEntry()
 	return MediaEntry(mediaTitle, type);
 }
 
+MediaEntry getUserTitle(const char* prompt)
+{
+	char mediaTitle[200];
+	cout << prompt; //Prompts user to enter the title
+	cin.get(mediaTitle, 200);
+	cin.clear();
+	cin.ignore(1000, '\n');
+	cout << endl;
+
+	return MediaEntry(mediaTitle, 'M'); //Movies come first among equal titles
+}
+
+void getUserText(const char* prompt, char text[])
+{
+	cout << prompt;
+	cin.get(text, MAX_TEXT_LENGTH); //Leaves text empty, and fails, if only enter is pressed
+	cin.clear();
+	cin.ignore(1000, '\n');
+}
+
 
 void add(MediaLibraryInterface* libraryPtr)
 {
@@ -349,13 +554,32 @@ void search(MediaLibraryInterface* libraryPtr)
 		cout << "Entry: " <<  userEntry << endl;
 		cout << "Type: " << userEntry.getMediaType() << endl;
 	}
-	else //Entry is not in the library
+	else //Entry is not in the library, but a title with a typo may be close to one in it
+	{
 		cout << "Entry is not in your library." << endl;
+
+		char title[MAX_TEXT_LENGTH];
+		int titleLength = min(userEntry.length(), MAX_TEXT_LENGTH-1);
+		for (int i = 0; i < titleLength; i++)
+			title[i] = userEntry[i];
+		title[titleLength] = '\0';
+
+		libraryPtr->setFuzzyIndex(true); //Built once, then kept up to date by the library
+		cout << endl << "Closest titles:" << endl;
+		if (libraryPtr->findClosest(title, MAX_TYPOS, MAX_SUGGESTIONS, displaySuggestion) == 0)
+			cout << setw(INDENT) << "None" << endl;
+	}
 	cout << endl;
 
 	pause();
 }
 
+void displaySuggestion(const MediaEntry& media, int distance)
+{
+	cout << setw(INDENT) << ' ' << media << " (" << media.getMediaType() << ", " << distance
+	     << ((distance == 1) ? " typo)" : " typos)") << endl;
+}
+
 void remove(MediaLibraryInterface* libraryPtr)
 {
 	system("clear");
@@ -373,13 +597,18 @@ void display(MediaLibraryInterface* libraryPtr)
 	int choice;
 	do //Prompts user to select from four display options below until a valid input
 	{
-		cout << "Please select from the four options below: " << endl;
+		cout << "Please select from the nine options below: " << endl;
 
 
 		cout << setw(INDENT) << "1. Display movies" << endl;
 		cout << setw(INDENT) << "2. Display TV shows" << endl;
 		cout << setw(INDENT) << "3. Display music" << endl;
-		cout << setw(INDENT) << "4. Display all media" << endl << endl;
+		cout << setw(INDENT) << "4. Display all media" << endl;
+		cout << setw(INDENT) << "5. Display media starting with a prefix" << endl;
+		cout << setw(INDENT) << "6. Display media within a range of titles" << endl;
+		cout << setw(INDENT) << "7. Display a page of media" << endl;
+		cout << setw(INDENT) << "8. Display the results of a query" << endl;
+		cout << setw(INDENT) << "9. Display media whose titles have some words" << endl << endl;
 		cout << "Choice: ";
 
 		cin >> choice;
@@ -387,7 +616,7 @@ void display(MediaLibraryInterface* libraryPtr)
 		cin.ignore(1000, '\n');
 		cout << endl << endl;
 
-	} while ((choice != 1) && (choice != 2) && (choice != 3) && (choice != 4));
+	} while ((choice < 1) || (choice > 9));
 
 	switch (choice) //Selects the corresponding function depending on their choice
 	{
@@ -400,6 +629,40 @@ void display(MediaLibraryInterface* libraryPtr)
 	case 3:
 		libraryPtr->displayAllMusic();
 		break;
+	case 5:
+		libraryPtr->displayPrefix(getUserTitle("Please enter the beginning of the title: "));
+		break;
+	case 6:
+	{
+		MediaEntry low = getUserTitle("Please enter the first title of the range: ");
+		MediaEntry high = getUserTitle("Please enter the title ending the range (excluded): ");
+		libraryPtr->displayRange(low, high);
+		break;
+	}
+	case 7:
+	{
+		int pageSize;
+		int pageNumber;
+		do //Prompts user for the page size and the page number until they are positive
+		{
+			cout << "Please enter the number of entries per page: ";
+			cin >> pageSize;
+			cout << "Please enter the page number: ";
+			cin >> pageNumber;
+			cin.clear();
+			cin.ignore(1000, '\n');
+			cout << endl << endl;
+		} while ((pageSize < 1) || (pageNumber < 1));
+
+		libraryPtr->display((pageNumber-1)*pageSize, pageSize);
+		break;
+	}
+	case 8:
+		runQuery(libraryPtr);
+		break;
+	case 9:
+		findWords(libraryPtr);
+		break;
 	default:
 		libraryPtr->displayAll();
 		break;
@@ -409,12 +672,117 @@ void display(MediaLibraryInterface* libraryPtr)
 	pause();
 }
 
-void exit(MediaLibraryInterface* libraryPtr)
+void loadTest(MediaLibraryInterface* libraryPtr)
+{
+	system("clear");
+	int numClients;
+	do //Prompts user for the number of clients until it is positive
+	{
+		cout << "Please enter the number of clients submitting requests at once: ";
+		cin >> numClients;
+		cin.clear();
+		cin.ignore(1000, '\n');
+		cout << endl << endl;
+	} while (numClients < 1);
+
+	LoadProfile profile;
+	profile.numClients = numClients;
+	profile.numRequests = LOAD_TEST_REQUESTS;
+	profile.maxOutstanding = LOAD_TEST_IN_FLIGHT;
+	profile.numTitles = LOAD_TEST_TITLES;
+	profile.readShare = LOAD_TEST_READ_SHARE;
+
+	MediaLibraryInterface* copyPtr = libraryPtr->snapshot(); //The requests change the library
+	{
+		AsyncLibrary asyncLibrary(copyPtr);
+		LoadGenerator generator(profile);
+		generator.run(asyncLibrary);
+
+		generator.displayResults(cout);
+		cout << endl;
+		asyncLibrary.displayStatistics(cout);
+	} //The front end stops before the snapshot is deleted
+	delete copyPtr;
+	cout << endl;
+
+	pause();
+}
+
+void runQuery(MediaLibraryInterface* libraryPtr)
+{
+	MediaQuery query;
+	char text[MAX_TEXT_LENGTH];
+
+	cout << "Leave any of the following empty to leave it out of the query." << endl << endl;
+
+	getUserText("Please enter the types to display (M for movies, T for TV shows, S for music): ", text);
+	for (int i = 0; text[i] != '\0'; i++)
+	{
+		char type = toupper(text[i]);
+		if (type == 'M' || type == 'T' || type == 'S')
+			query.addType(type);
+	}
+
+	getUserText("Please enter the beginning of the titles: ", text);
+	if (text[0] != '\0')
+		query.setPrefix(text);
+
+	getUserText("Please enter the first title of the range: ", text);
+	if (text[0] != '\0')
+	{
+		MediaEntry low(text, 'M'); //Movies come first among equal titles
+		query.setRange(&low, NULL);
+	}
+
+	getUserText("Please enter the title ending the range (excluded): ", text);
+	if (text[0] != '\0')
+	{
+		MediaEntry high(text, 'M');
+		query.setRange(NULL, &high);
+	}
+
+	getUserText("Please enter text the titles have to contain: ", text);
+	query.setSubstring(text);
+
+	getUserText("Please enter the number of entries to skip: ", text);
+	query.setOffset(atoi(text));
+
+	getUserText("Please enter the maximum number of entries to display: ", text);
+	if (text[0] != '\0')
+		query.setLimit(atoi(text));
+	cout << endl << endl;
+
+	QueryStatistics stats;
+	libraryPtr->runQuery(query, displayMatch, stats);
+	cout.flush();
+
+	cout << endl;
+	query.explain(stats, cout);
+}
+
+void displayMatch(const MediaEntry& media)
+{
+	cout << media << '\n'; //Flushed once the query is done
+}
+
+void findWords(MediaLibraryInterface* libraryPtr)
+{
+	char text[MAX_TEXT_LENGTH];
+	getUserText("Please enter the words of the title: ", text);
+	cout << endl;
+
+	libraryPtr->setWordIndex(true); //Built once, then kept up to date by the library
+	int numFound = libraryPtr->findWords(text, displayMatch);
+	cout.flush();
+
+	cout << endl << numFound << " entries found." << endl;
+}
+
+bool exit(MediaLibraryInterface* libraryPtr, char fileName[])
 {
 	system("clear");
 	ofstream outFile;
 
-	char fileName[50]; //Asks user to enter the file name of the file
 	cout << "Please enter the file name to save your library, with a .txt after: ";
 	cin.get(fileName, 50);
 	cin.clear();
@@ -428,11 +796,19 @@ void exit(MediaLibraryInterface* libraryPtr)
 	libraryPtr->displayStatistics(outFile);
 	outFile << endl << endl;
 
+	bool isSaved = outFile.good(); //Fails if the file couldn't be opened or the disk is full
 	outFile.close();
+	isSaved = isSaved && !outFile.fail();
 
 	delete libraryPtr;
 
-	cout << "Your media library was successfully exported." << endl;
+	if (isSaved)
+		cout << "Your media library was successfully exported." << endl;
+	else
+		cout << "Your media library could not be saved to " << fileName << ". The changes made to it "
+		     << "are kept, and will be recovered the next time it is opened." << endl;
 	pause();
 	system("clear"); //Takes user back to the program menu
+
+	return isSaved;
 }